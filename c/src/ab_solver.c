@@ -3,7 +3,19 @@
  *
  * @brief Alpha-beta solver module implementation.
  * @details It searches the end of the game for an exact outcome using the Alpha-Beta algorithm.
- * Moves are sorted by their natural order, from A1 to H8 (A1, B1, C1, ... G8, H8).
+ * Moves are sorted as selected by the move ordering policy, see #node_info_move_ordering_set,
+ * by default they keep their natural order, from A1 to H8 (A1, B1, C1, ... G8, H8).
+ * The best move found into the transposition table is always searched first.
+ *
+ * The search is driven by one of the strategies listed by #AbSolverSearchMode: plain alpha-beta,
+ * principal variation search, or MTD(f). The last one relies on the transposition table
+ * to avoid searching again, probe after probe, the same game positions.
+ *
+ * When the win/loss/draw search is on, see #exact_solution_wld_set_enabled, the root window is
+ * [#wld_alpha..#wld_beta]. MTD(f) has then nothing to narrow, and it is replaced by the principal variation search.
+ *
+ * Nodes having at most #LAST_MOVES_SOLVER_MAX_EMPTIES empty squares are handed to the last moves solver,
+ * unless logging is on.
  *
  * @par ab_solver.c
  * <tt>
@@ -37,8 +49,11 @@
 
 #include <glib.h>
 
+#include "bit_works.h"
 #include "random.h"
 #include "game_tree_logger.h"
+#include "transposition_table.h"
+#include "last_moves_solver.h"
 
 #include "ab_solver.h"
 
@@ -52,17 +67,65 @@
  */
 
 static void
-game_position_solve_impl (ExactSolution *const result,
+game_position_solve_impl (SolverContext *const ctx,
+                          ExactSolution *const result,
                           GameTreeStack *const stack);
 
+static gboolean
+pvs_is_on (const SolverContext *const ctx);
+
+static void
+root_search (SolverContext *const ctx,
+             ExactSolution *const result,
+             GameTreeStack *const stack,
+             const int alpha,
+             const int beta);
+
+static void
+mtdf (SolverContext *const ctx,
+      ExactSolution *const result,
+      GameTreeStack *const stack);
+
+static int
+root_move_search (SolverContext *const ctx,
+                  ExactSolution *const result,
+                  GameTreeStack *const stack,
+                  const Square move,
+                  const int alpha,
+                  const int beta);
+
+static void
+all_moves_search (SolverContext *const ctx,
+                  ExactSolution *const result,
+                  GameTreeStack *const stack);
+
+static void
+anytime_search (SolverContext *const ctx,
+                ExactSolution *const result,
+                GameTreeStack *const stack,
+                int *const lower_bound,
+                int *const upper_bound);
+
 
 
 /*
  * Internal variables and constants.
  */
 
-/* The logging environment structure. */
-static LogEnv *log_env = NULL;
+/* Nodes having fewer empty squares are cheaper to search than to look up. */
+static const int tt_min_depth = 4;
+
+/* The search strategy copied by the new solver contexts. */
+static AbSolverSearchMode search_mode = AB_SOLVER_SEARCH_MODE_ALPHA_BETA;
+
+/* The value of the first null window searched by MTD(f), copied by the new solver contexts. */
+static int first_guess = 0;
+
+/* True when every root move is scored, copied by the new solver contexts. */
+static gboolean all_moves_enabled = FALSE;
+
+/* MTD(f) and the all moves search allocate a table of this size when the context has none. */
+static const int mtdf_tt_size_log2 = 20;
 
 /**
  * @endcond
@@ -77,6 +140,8 @@ static LogEnv *log_env = NULL;
 /**
  * @brief Solves the game position returning a new exact solution pointer.
  *
+ * @details It is a wrapper of #game_position_ab_solve_with_context, running on a new context.
+ *
  * @param [in] root     the starting game position to be solved
  * @param [in] log_file if not null turns logging on the given file name
  * @return              a pointer to a new exact solution structure
@@ -85,12 +150,52 @@ ExactSolution *
 game_position_ab_solve (const GamePosition *const root,
                         const gchar *const log_file)
 {
+  SolverContext *ctx = solver_context_new();
+  ctx->log_file = log_file;
+  ExactSolution *result = game_position_ab_solve_with_context(ctx, root);
+  solver_context_free(ctx);
+  return result;
+}
+
+/**
+ * @brief Solves the game position, as selected by the options of the solver context,
+ * returning a new exact solution pointer.
+ *
+ * @invariant Parameters `ctx` and `root` must be not `NULL`.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] ctx  the solver context
+ * @param [in]     root the starting game position to be solved
+ * @return              a pointer to a new exact solution structure
+ */
+ExactSolution *
+game_position_ab_solve_with_context (SolverContext *const ctx,
+                                     const GamePosition *const root)
+{
+  g_assert(ctx);
+  g_assert(root);
+
   ExactSolution *result = NULL;
 
-  log_env = game_tree_log_init(log_file);
+  solver_context_search_start(ctx);
+
+  const gboolean wld = ctx->wld;
+  const gboolean all_moves = ctx->ab_all_moves;
+
+  const gboolean anytime = ctx->budget_is_on && !wld && !all_moves;
 
-  if (log_env->log_is_on) {
-    game_tree_log_open_h(log_env);
+  TranspositionTable *const context_tt = ctx->tt;
+  TranspositionTable *private_tt = NULL;
+  if (!ctx->tt && (ctx->ab_search_mode == AB_SOLVER_SEARCH_MODE_MTDF || all_moves || anytime)) {
+    private_tt = transposition_table_new(mtdf_tt_size_log2);
+    ctx->tt = private_tt;
+  }
+  if (ctx->tt) transposition_table_new_search(ctx->tt);
+
+  ctx->hash_is_on = ctx->log_env->log_is_on || ctx->tt;
+
+  if (ctx->log_env->log_is_on) {
+    game_tree_log_open_h(ctx->log_env);
   }
 
   int game_value = out_of_range_defeat_score;
@@ -104,20 +209,118 @@ game_position_ab_solve (const GamePosition *const root,
   result = exact_solution_new();
   result->solved_game_position = game_position_clone(root);
 
-  game_position_solve_impl(result, stack);
+  int lower_bound = worst_score;
+  int upper_bound = best_score;
+  if (all_moves) {
+    all_moves_search(ctx, result, stack);
+    if (result->root_move_count > 0) lower_bound = result->root_moves[0].value;
+  } else if (anytime) {
+    anytime_search(ctx, result, stack, &lower_bound, &upper_bound);
+  } else if (wld) {
+    root_search(ctx, result, stack, wld_alpha, wld_beta);
+    if (first_node_info->alpha > wld_alpha) lower_bound = first_node_info->alpha;
+  } else if (ctx->ab_search_mode == AB_SOLVER_SEARCH_MODE_MTDF) {
+    mtdf(ctx, result, stack);
+  } else {
+    root_search(ctx, result, stack, worst_score, best_score);
+  }
 
   best_move = first_node_info->best_move;
   game_value = first_node_info->alpha;
 
   game_tree_stack_free(stack);
+  ctx->tt = context_tt;
+  transposition_table_free(private_tt);
 
-  game_tree_log_close(log_env);
+  solver_context_search_end(ctx);
 
   result->pv[0] = best_move;
   result->outcome = game_value;
+  if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) {
+    exact_solution_set_incomplete(result, lower_bound, upper_bound, lower_bound > worst_score ? best_move : invalid_move);
+  } else if (wld && !all_moves) {
+    exact_solution_set_wld_outcome(result);
+  }
   return result;
 }
 
+/**
+ * @brief Sets the search strategy used by #game_position_ab_solve.
+ *
+ * @param [in] mode the search mode
+ */
+void
+ab_solver_set_search_mode (const AbSolverSearchMode mode)
+{
+  search_mode = mode;
+}
+
+/**
+ * @brief Returns the search strategy used by #game_position_ab_solve.
+ *
+ * @return the search mode
+ */
+AbSolverSearchMode
+ab_solver_get_search_mode (void)
+{
+  return search_mode;
+}
+
+/**
+ * @brief Turns on or off the scoring of every legal root move.
+ *
+ * @details When it is on, #game_position_ab_solve computes the exact value of each root move,
+ * and lists them, best first, into the `root_moves` field of the exact solution.
+ * The search strategy applies below the root, and the win/loss/draw window is ignored.
+ *
+ * @param [in] enabled true turns on the all moves search
+ */
+void
+ab_solver_all_moves_set_enabled (const gboolean enabled)
+{
+  all_moves_enabled = enabled;
+}
+
+/**
+ * @brief Returns `TRUE` when every legal root move is scored.
+ *
+ * @return true if the all moves search is on
+ */
+gboolean
+ab_solver_all_moves_is_enabled (void)
+{
+  return all_moves_enabled;
+}
+
+/**
+ * @brief Sets the value of the first null window searched by MTD(f).
+ *
+ * @details The closer the guess is to the game value, the fewer null window searches are needed.
+ * A shallow search, or the value of a previous move, is a good guess.
+ *
+ * @invariant Parameter `guess` must be in the range [worst_score..best_score].
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] guess the first guess
+ */
+void
+ab_solver_set_first_guess (const int guess)
+{
+  g_assert(guess >= worst_score && guess <= best_score);
+  first_guess = guess;
+}
+
+/**
+ * @brief Returns the value of the first null window searched by MTD(f).
+ *
+ * @return the first guess
+ */
+int
+ab_solver_get_first_guess (void)
+{
+  return first_guess;
+}
+
 
 
 /**
@@ -126,6 +329,194 @@ game_position_ab_solve (const GamePosition *const root,
  * @cond
  */
 
+/*
+ * Returns true when the moves following the first one are tested by a null window.
+ * MTD(f) has nothing to narrow on the win/loss/draw window, and it is replaced by PVS.
+ */
+static gboolean
+pvs_is_on (const SolverContext *const ctx)
+{
+  return ctx->ab_search_mode == AB_SOLVER_SEARCH_MODE_PVS || (ctx->wld && ctx->ab_search_mode == AB_SOLVER_SEARCH_MODE_MTDF);
+}
+
+/*
+ * Searches the root game position with the window (alpha, beta).
+ * The result is found in the alpha and best_move fields of the root node.
+ * When the budget is exhausted, alpha is the best value of the moves searched to the end, or the window alpha.
+ */
+static void
+root_search (SolverContext *const ctx,
+             ExactSolution *const result,
+             GameTreeStack *const stack,
+             const int alpha,
+             const int beta)
+{
+  NodeInfo *const first_node_info = &stack->nodes[1];
+  first_node_info->alpha = alpha;
+  first_node_info->beta = beta;
+  game_position_solve_impl(ctx, result, stack);
+}
+
+/*
+ * MTD(f) driver, the game value is narrowed between a lower and an upper bound by null window searches
+ * until the two bounds meet. The first window is centered on the first guess, then each search starts
+ * from the value returned by the previous one.
+ *
+ * A search failing low doesn't prove its best move, so the move kept is the one found by the last search
+ * failing high, that reaches at least the lower bound. The loop always ends with such a search,
+ * because the lower bound starts outside the range of the game values.
+ */
+static void
+mtdf (SolverContext *const ctx,
+      ExactSolution *const result,
+      GameTreeStack *const stack)
+{
+  NodeInfo *const first_node_info = &stack->nodes[1];
+  int lower_bound = out_of_range_defeat_score;
+  int upper_bound = out_of_range_win_score;
+  int g = ctx->ab_first_guess;
+  Square best_move = invalid_move;
+  while (lower_bound < upper_bound) {
+    const int beta = g == lower_bound ? g + 1 : g;
+    root_search(ctx, result, stack, beta - 1, beta);
+    g = first_node_info->alpha;
+    if (g < beta) {
+      upper_bound = g;
+    } else {
+      lower_bound = g;
+      best_move = first_node_info->best_move;
+    }
+  }
+  first_node_info->alpha = lower_bound;
+  first_node_info->best_move = best_move;
+}
+
+/*
+ * Searches the root move with the window (alpha, beta), and returns its value from the root player perspective.
+ * The root node must have its legal move list, and the stack must be positioned on the child node.
+ */
+static int
+root_move_search (SolverContext *const ctx,
+                  ExactSolution *const result,
+                  GameTreeStack *const stack,
+                  const Square move,
+                  const int alpha,
+                  const int beta)
+{
+  NodeInfo *const first_node_info = &stack->nodes[1];
+  NodeInfo *const next_node_info = &stack->nodes[2];
+  next_node_info->gpx = first_node_info->gpx;
+  const SquareSet flips = game_position_x_do_move(&next_node_info->gpx, move);
+  if (ctx->hash_is_on) {
+    next_node_info->hash = game_position_x_delta_hash(first_node_info->hash, flips, move, first_node_info->gpx.player);
+  }
+  next_node_info->alpha = -beta;
+  next_node_info->beta = -alpha;
+  game_position_solve_impl(ctx, result, stack);
+  return -next_node_info->alpha;
+}
+
+/*
+ * Scores exactly every root move.
+ *
+ * The first move is searched with the full window. Each following move is tested by a null window
+ * set on the lowest value found so far, that is likely close, the fail soft bound returned narrows
+ * the window of the search proving the exact value. The transposition table keeps most of the work
+ * done by the test.
+ *
+ * Moves are then sorted best first, ties keep the search order.
+ */
+static void
+all_moves_search (SolverContext *const ctx,
+                  ExactSolution *const result,
+                  GameTreeStack *const stack)
+{
+  NodeInfo *const first_node_info = &stack->nodes[1];
+  NodeInfo *const next_node_info = &stack->nodes[2];
+  const SquareSet move_set = game_position_x_legal_moves(&first_node_info->gpx);
+
+  if (move_set == empty_square_set) {
+    root_search(ctx, result, stack, worst_score, best_score);
+    return;
+  }
+
+  result->node_count++;
+  legal_move_list_from_set(move_set, first_node_info, next_node_info);
+  node_info_order_moves(first_node_info, next_node_info, &ctx->move_ordering, invalid_move);
+
+  stack->fill_index++;
+  SearchNode *const rm = result->root_moves;
+  for (int i = 0; i < first_node_info->move_count; i++) {
+    const Square move = * (first_node_info->head_of_legal_move_list + i);
+    int value;
+    if (i == 0) {
+      value = root_move_search(ctx, result, stack, move, out_of_range_defeat_score, out_of_range_win_score);
+    } else {
+      const int guess = rm[i - 1].value;
+      value = root_move_search(ctx, result, stack, move, guess, guess + 1);
+      if (value <= guess) value = root_move_search(ctx, result, stack, move, out_of_range_defeat_score, value + 1);
+      else value = root_move_search(ctx, result, stack, move, value - 1, out_of_range_win_score);
+    }
+    if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) break;
+    result->root_move_count++;
+    int j = i;
+    for (; j > 0 && rm[j - 1].value < value; j--) rm[j] = rm[j - 1];
+    rm[j].move = move;
+    rm[j].value = value;
+  }
+  stack->fill_index--;
+
+  if (result->root_move_count > 0) {
+    first_node_info->alpha = rm[0].value;
+    first_node_info->best_move = rm[0].move;
+  }
+}
+
+/*
+ * Narrows the bounds of the game value by null window searches, each one set halfway between
+ * the current bounds, until they meet or the budget is exhausted. The best move is the one found
+ * by the last search failing high.
+ *
+ * The lower bound starts outside the range of the game values, so that the last search proving the value
+ * fails high and finds the best move. When the search is stopped, the bounds established so far are returned,
+ * the interrupted search raising the lower bound when one of its root moves has been searched to the end.
+ */
+static void
+anytime_search (SolverContext *const ctx,
+                ExactSolution *const result,
+                GameTreeStack *const stack,
+                int *const lower_bound,
+                int *const upper_bound)
+{
+  NodeInfo *const first_node_info = &stack->nodes[1];
+  int lower = out_of_range_defeat_score;
+  int upper = out_of_range_win_score;
+  Square best_move = invalid_move;
+  while (lower < upper) {
+    const int g = lower + (upper - lower) / 2;
+    root_search(ctx, result, stack, g, g + 1);
+    const int value = first_node_info->alpha;
+    if (solver_context_budget_is_exhausted(ctx)) {
+      /* A root move searched to the end before the stop proves a value above the window. */
+      if (value > g) {
+        lower = value;
+        best_move = first_node_info->best_move;
+      }
+      break;
+    }
+    if (value > g) {
+      lower = value;
+      best_move = first_node_info->best_move;
+    } else {
+      upper = value;
+    }
+  }
+  *lower_bound = MAX(lower, worst_score);
+  *upper_bound = MIN(upper, best_score);
+  first_node_info->alpha = lower;
+  first_node_info->best_move = best_move;
+}
+
 /**
  * @brief Recursive function used to traverse the game tree.
  *
@@ -133,7 +524,8 @@ game_position_ab_solve (const GamePosition *const root,
  * @param [in] stack   a reference to the stack structure
  */
 static void
-game_position_solve_impl (ExactSolution *const result,
+game_position_solve_impl (SolverContext *const ctx,
+                          ExactSolution *const result,
                           GameTreeStack *const stack)
 {
   result->node_count++;
@@ -150,11 +542,28 @@ game_position_solve_impl (ExactSolution *const result,
   NodeInfo *const previous_node_info = &stack->nodes[previous_fill_index];
   const GamePositionX *const current_gpx = &current_node_info->gpx;
   GamePositionX *const next_gpx = &next_node_info->gpx;
-  current_node_info->hash = game_position_x_hash(current_gpx);
+
+  if (ctx->budget_is_on && solver_context_budget_check(ctx, result->node_count)) goto out;
+
+  if (!ctx->log_env->log_is_on && current_fill_index > 1 && previous_node_info->move_count != 0 &&
+      bit_works_popcount(game_position_x_empties(current_gpx)) <= LAST_MOVES_SOLVER_MAX_EMPTIES) {
+    current_node_info->alpha = last_moves_solver_solve(game_position_x_get_player(current_gpx),
+                                                       game_position_x_get_opponent(current_gpx),
+                                                       current_node_info->alpha, current_node_info->beta,
+                                                       &result->node_count, &result->leaf_count);
+    current_node_info->best_move = invalid_move;
+    goto out;
+  }
+
   const SquareSet move_set = game_position_x_legal_moves(current_gpx);
   legal_move_list_from_set(move_set, current_node_info, next_node_info);
+  const int alpha = current_node_info->alpha;
+
+#ifdef REVERSI_DEBUG
+  if (ctx->hash_is_on) g_assert(current_node_info->hash == game_position_x_hash(current_gpx));
+#endif
 
-  if (log_env->log_is_on) {
+  if (ctx->log_env->log_is_on) {
     LogDataH log_data;
     log_data.sub_run_id = sub_run_id;
     log_data.call_id = result->node_count;
@@ -164,41 +573,83 @@ game_position_solve_impl (ExactSolution *const result,
     log_data.whites = current_gpx->whites;
     log_data.player = current_gpx->player;
     log_data.json_doc = "\"{}\"";
-    game_tree_log_write_h(log_env, &log_data);
+    game_tree_log_write_h(ctx->log_env, &log_data);
   }
 
+  const int depth = ctx->tt ? bit_works_popcount(game_position_x_empties(current_gpx)) : 0;
+  const gboolean use_tt = ctx->tt && depth >= tt_min_depth;
+  Square tt_move = invalid_move;
+  if (use_tt) {
+    TranspositionTableEntry entry;
+    if (transposition_table_probe(ctx->tt, current_node_info->hash, depth, &entry)) {
+      int value;
+      if (current_fill_index > 1 && transposition_table_cutoff(ctx->tt, &entry, alpha, current_node_info->beta, &value)) {
+        current_node_info->alpha = value;
+        current_node_info->best_move = entry.best_move;
+        goto out;
+      }
+      tt_move = entry.best_move;
+    }
+  }
+
+  if (ctx->stability_cutoff && current_fill_index > 1 && node_info_stability_cutoff(current_node_info)) goto out;
+
   if (move_set == empty_square_set) {
     const int previous_move_count = previous_node_info->move_count;
     const SquareSet empties = game_position_x_empties(current_gpx);
     if (empties != empty_square_set && previous_move_count != 0) {
       game_position_x_pass(current_gpx, next_gpx);
+      if (ctx->hash_is_on) next_node_info->hash = ~current_node_info->hash;
       next_node_info->alpha = -current_node_info->beta;
       next_node_info->beta = -current_node_info->alpha;
-      game_position_solve_impl(result, stack);
+      game_position_solve_impl(ctx, result, stack);
+      if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) goto out;
       current_node_info->alpha = -next_node_info->alpha;
       current_node_info->best_move = next_node_info->best_move;
     } else {
       result->leaf_count++;
       current_node_info->alpha = game_position_x_final_value(current_gpx);
       current_node_info->best_move = invalid_move;
+      goto out;
     }
   } else {
+    node_info_order_moves(current_node_info, next_node_info, &ctx->move_ordering, tt_move);
     current_node_info->alpha = out_of_range_defeat_score;
     for (int i = 0; i < current_node_info->move_count; i++) {
       const Square move = * (current_node_info->head_of_legal_move_list + i);
-      game_position_x_make_move(current_gpx, move, next_gpx);
-      next_node_info->alpha = -current_node_info->beta;
-      next_node_info->beta = -current_node_info->alpha;
-      game_position_solve_impl(result, stack);
+      *next_gpx = *current_gpx;
+      const SquareSet flips = game_position_x_do_move(next_gpx, move);
+      if (ctx->hash_is_on) {
+        next_node_info->hash = game_position_x_delta_hash(current_node_info->hash, flips, move, current_gpx->player);
+      }
+      const int a = MAX(alpha, current_node_info->alpha);
+      if (pvs_is_on(ctx) && i > 0) {
+        next_node_info->alpha = -(a + 1);
+        next_node_info->beta = -a;
+        game_position_solve_impl(ctx, result, stack);
+        const int value = -next_node_info->alpha;
+        if (value > a && value < current_node_info->beta && !(ctx->budget_is_on && solver_context_budget_is_exhausted(ctx))) {
+          next_node_info->alpha = -current_node_info->beta;
+          next_node_info->beta = -value;
+          game_position_solve_impl(ctx, result, stack);
+        }
+      } else {
+        next_node_info->alpha = -current_node_info->beta;
+        next_node_info->beta = -a;
+        game_position_solve_impl(ctx, result, stack);
+      }
+      if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) goto out;
       if (-next_node_info->alpha > current_node_info->alpha) {
         current_node_info->alpha = -next_node_info->alpha;
         current_node_info->best_move = move;
-        if (current_node_info->alpha >= current_node_info->beta) {
-          goto out;
-        }
+        if (current_node_info->alpha >= current_node_info->beta) break;
       }
     }
   }
+  if (use_tt) {
+    transposition_table_store(ctx->tt, current_node_info->hash, depth, alpha, current_node_info->beta,
+                              current_node_info->alpha, current_node_info->best_move);
+  }
 out:
   stack->fill_index--;
   return;
@@ -36,6 +36,7 @@
 
 #include "board.h"
 #include "game_tree_utils.h"
+#include "solver_context.h"
 #include "exact_solver.h"
 
 
@@ -48,5 +49,27 @@ extern ExactSolution *
 game_position_ab_solve (const GamePosition *const root,
                         const gchar *const log_file);
 
+extern ExactSolution *
+game_position_ab_solve_with_context (SolverContext *const ctx,
+                                     const GamePosition *const root);
+
+extern void
+ab_solver_set_search_mode (const AbSolverSearchMode mode);
+
+extern AbSolverSearchMode
+ab_solver_get_search_mode (void);
+
+extern void
+ab_solver_all_moves_set_enabled (const gboolean enabled);
+
+extern gboolean
+ab_solver_all_moves_is_enabled (void);
+
+extern void
+ab_solver_set_first_guess (const int first_guess);
+
+extern int
+ab_solver_get_first_guess (void);
+
 
 #endif /* AB_SOLVER_H */
@@ -43,6 +43,26 @@
 #include "board.h"
 #include "random.h"
 
+/*
+ * The AVX2 and AVX-512 legal move generators are compiled only when the target is x86 and the compiler is GCC compatible.
+ * The instruction set is enabled function by function, the selection happens at runtime in board_module_init.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BOARD_AVX2_SUPPORT
+#define BOARD_AVX512_SUPPORT
+#include <immintrin.h>
+#endif
+
+/*
+ * The per-square flip functions rely on the inlining of the carry kernel,
+ * so that the ray masks are folded into constants by the compiler.
+ */
+#if defined(__GNUC__)
+#define BOARD_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define BOARD_ALWAYS_INLINE inline
+#endif
+
 
 
 /**
@@ -54,16 +74,89 @@
  */
 
 static void
-board_initialize_bitrow_changes_for_player_array (uint8_t *array);
+board_initialize_shift_square_set_by_amount_mask_array (SquareSet *array);
 
 static void
-board_initialize_shift_square_set_by_amount_mask_array (SquareSet *array);
+edge_play (int *const mover,
+           int *const other,
+           const int x);
+
+static void
+board_initialize_edge_stability_array (void);
+
+static SquareSet
+square_sets_stable_discs (const SquareSet blacks,
+                          const SquareSet whites);
 
 static SquareSet
 direction_shift_back_square_set_by_amount (const Direction dir,
                                            const SquareSet squares,
                                            const int amount);
 
+static SquareSet
+legal_moves_wave (const SquareSet p_bit_board,
+                  const SquareSet o_bit_board);
+
+static SquareSet
+legal_moves_kogge_stone (const SquareSet p_bit_board,
+                         const SquareSet o_bit_board);
+
+#ifdef BOARD_AVX2_SUPPORT
+static SquareSet
+legal_moves_kogge_stone_avx2 (const SquareSet p_bit_board,
+                              const SquareSet o_bit_board);
+#endif
+
+static void
+legal_moves_batch_scalar (const int count,
+                          const SquareSet *const p_bit_boards,
+                          const SquareSet *const o_bit_boards,
+                          SquareSet *const legal_moves,
+                          int *const mobility);
+
+#ifdef BOARD_AVX2_SUPPORT
+static void
+legal_moves_batch_avx2 (const int count,
+                        const SquareSet *const p_bit_boards,
+                        const SquareSet *const o_bit_boards,
+                        SquareSet *const legal_moves,
+                        int *const mobility);
+#endif
+
+#ifdef BOARD_AVX512_SUPPORT
+static void
+legal_moves_batch_avx512 (const int count,
+                          const SquareSet *const p_bit_boards,
+                          const SquareSet *const o_bit_boards,
+                          SquareSet *const legal_moves,
+                          int *const mobility);
+#endif
+
+static SquareSet
+flips_bitrow_table (const SquareSet p_bit_board,
+                    const SquareSet o_bit_board,
+                    const Square move);
+
+static SquareSet
+flips_kogge_stone (const SquareSet p_bit_board,
+                   const SquareSet o_bit_board,
+                   const Square move);
+
+static SquareSet
+flips_carry (const SquareSet p_bit_board,
+             const SquareSet o_bit_board,
+             const Square move);
+
+static SquareSet
+flips_per_square (const SquareSet p_bit_board,
+                  const SquareSet o_bit_board,
+                  const Square move);
+
+static uint64_t
+square_sets_zobrist_hash (const SquareSet blacks,
+                          const SquareSet whites,
+                          const Player player);
+
 
 
 /*
@@ -89,6 +182,9 @@ static const SquareSet all_squares_except_column_a = 0xFEFEFEFEFEFEFEFE;
 /* A square set being all set with the exception of column H. */
 static const SquareSet all_squares_except_column_h = 0x7F7F7F7F7F7F7F7F;
 
+/* A square set being all set with the exception of columns A and H. */
+static const SquareSet all_squares_except_columns_a_and_h = 0x7E7E7E7E7E7E7E7E;
+
 /* A bitboard being set on column A. */
 static const SquareSet column_a = 0x0101010101010101;
 
@@ -102,22 +198,268 @@ static const SquareSet diagonal_h1_a8 = 0x0102040810204080;
 static const SquareSet squares_b1_f1_a2_e2 = 0x1122;
 
 /*
- * This array is an implementation of the precomputed table that contains the effects of moving
- * a piece in any of the eigth squares in a row.
- * The size is so computed:
- *  - there are 256 arrangments of player discs,
- *  - and 256 arrangements of opponent pieces,
- *  - the potential moves are 8.
- * So the array size is 256 * 256 * 8 = 524,288 Bytes = 512kB.
- * Not all the entries are legal! The first set of eigth bits and the second one (opponent row)
- * must not set the same position.
- *
- * The index of the array is computed by this formula:
- * index = playerRow | (opponentRow << 8) | (movePosition << 16);
- *
- * After initialization the array is never changed.
+ * The two tables implement the effects of moving a piece in any of the eight squares in a row.
+ *
+ * The first one is indexed by the move position and by the six interior squares of the opponent row
+ * (B to G, the discs in A and H can never be flipped). It holds the squares next to the runs of opponent
+ * discs adjacent to the move, on both sides. The squares are potential bracketing discs, so they have
+ * to be intersected with the player row.
+ * The second one is indexed by the move position and by the set of bracketing discs, it holds the
+ * flipped discs.
+ * The size is 8 * 64 + 8 * 256 = 2,560 Bytes, the tables are computed at compile time.
+ */
+static const uint8_t bitrow_outflank_array[8][64] = {
+  {
+    0x00, 0x04, 0x00, 0x08, 0x00, 0x04, 0x00, 0x10, 0x00, 0x04, 0x00, 0x08, 0x00, 0x04, 0x00, 0x20,
+    0x00, 0x04, 0x00, 0x08, 0x00, 0x04, 0x00, 0x10, 0x00, 0x04, 0x00, 0x08, 0x00, 0x04, 0x00, 0x40,
+    0x00, 0x04, 0x00, 0x08, 0x00, 0x04, 0x00, 0x10, 0x00, 0x04, 0x00, 0x08, 0x00, 0x04, 0x00, 0x20,
+    0x00, 0x04, 0x00, 0x08, 0x00, 0x04, 0x00, 0x10, 0x00, 0x04, 0x00, 0x08, 0x00, 0x04, 0x00, 0x80
+  },
+  {
+    0x00, 0x00, 0x08, 0x08, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x08, 0x08, 0x00, 0x00, 0x20, 0x20,
+    0x00, 0x00, 0x08, 0x08, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x08, 0x08, 0x00, 0x00, 0x40, 0x40,
+    0x00, 0x00, 0x08, 0x08, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x08, 0x08, 0x00, 0x00, 0x20, 0x20,
+    0x00, 0x00, 0x08, 0x08, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x08, 0x08, 0x00, 0x00, 0x80, 0x80
+  },
+  {
+    0x00, 0x01, 0x00, 0x01, 0x10, 0x11, 0x10, 0x11, 0x00, 0x01, 0x00, 0x01, 0x20, 0x21, 0x20, 0x21,
+    0x00, 0x01, 0x00, 0x01, 0x10, 0x11, 0x10, 0x11, 0x00, 0x01, 0x00, 0x01, 0x40, 0x41, 0x40, 0x41,
+    0x00, 0x01, 0x00, 0x01, 0x10, 0x11, 0x10, 0x11, 0x00, 0x01, 0x00, 0x01, 0x20, 0x21, 0x20, 0x21,
+    0x00, 0x01, 0x00, 0x01, 0x10, 0x11, 0x10, 0x11, 0x00, 0x01, 0x00, 0x01, 0x80, 0x81, 0x80, 0x81
+  },
+  {
+    0x00, 0x00, 0x02, 0x01, 0x00, 0x00, 0x02, 0x01, 0x20, 0x20, 0x22, 0x21, 0x20, 0x20, 0x22, 0x21,
+    0x00, 0x00, 0x02, 0x01, 0x00, 0x00, 0x02, 0x01, 0x40, 0x40, 0x42, 0x41, 0x40, 0x40, 0x42, 0x41,
+    0x00, 0x00, 0x02, 0x01, 0x00, 0x00, 0x02, 0x01, 0x20, 0x20, 0x22, 0x21, 0x20, 0x20, 0x22, 0x21,
+    0x00, 0x00, 0x02, 0x01, 0x00, 0x00, 0x02, 0x01, 0x80, 0x80, 0x82, 0x81, 0x80, 0x80, 0x82, 0x81
+  },
+  {
+    0x00, 0x00, 0x00, 0x00, 0x04, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x04, 0x04, 0x02, 0x01,
+    0x40, 0x40, 0x40, 0x40, 0x44, 0x44, 0x42, 0x41, 0x40, 0x40, 0x40, 0x40, 0x44, 0x44, 0x42, 0x41,
+    0x00, 0x00, 0x00, 0x00, 0x04, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x04, 0x04, 0x02, 0x01,
+    0x80, 0x80, 0x80, 0x80, 0x84, 0x84, 0x82, 0x81, 0x80, 0x80, 0x80, 0x80, 0x84, 0x84, 0x82, 0x81
+  },
+  {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x08, 0x08, 0x04, 0x04, 0x02, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x08, 0x08, 0x08, 0x04, 0x04, 0x02, 0x01,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x88, 0x88, 0x88, 0x88, 0x84, 0x84, 0x82, 0x81,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x88, 0x88, 0x88, 0x88, 0x84, 0x84, 0x82, 0x81
+  },
+  {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x08, 0x08, 0x08, 0x08, 0x04, 0x04, 0x02, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x08, 0x08, 0x08, 0x08, 0x04, 0x04, 0x02, 0x01
+  },
+  {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x08, 0x08, 0x08, 0x08, 0x04, 0x04, 0x02, 0x01
+  }
+};
+
+static const uint8_t bitrow_flipped_array[8][256] = {
+  {
+    0x00, 0x00, 0x00, 0x00, 0x02, 0x02, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06, 0x06,
+    0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E, 0x0E,
+    0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E,
+    0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E,
+    0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E,
+    0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E,
+    0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E,
+    0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E, 0x3E,
+    0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E,
+    0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E,
+    0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E,
+    0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E,
+    0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E,
+    0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E,
+    0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E,
+    0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E, 0x7E
+  },
+  {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C,
+    0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C,
+    0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C,
+    0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C,
+    0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C,
+    0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C,
+    0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C, 0x3C,
+    0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C,
+    0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C,
+    0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C,
+    0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C,
+    0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C,
+    0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C,
+    0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C,
+    0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C, 0x7C
+  },
+  {
+    0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02,
+    0x08, 0x0A, 0x08, 0x0A, 0x08, 0x0A, 0x08, 0x0A, 0x08, 0x0A, 0x08, 0x0A, 0x08, 0x0A, 0x08, 0x0A,
+    0x18, 0x1A, 0x18, 0x1A, 0x18, 0x1A, 0x18, 0x1A, 0x18, 0x1A, 0x18, 0x1A, 0x18, 0x1A, 0x18, 0x1A,
+    0x18, 0x1A, 0x18, 0x1A, 0x18, 0x1A, 0x18, 0x1A, 0x18, 0x1A, 0x18, 0x1A, 0x18, 0x1A, 0x18, 0x1A,
+    0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A,
+    0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A,
+    0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A,
+    0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A, 0x38, 0x3A,
+    0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A,
+    0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A,
+    0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A,
+    0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A,
+    0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A,
+    0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A,
+    0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A,
+    0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A, 0x78, 0x7A
+  },
+  {
+    0x00, 0x06, 0x04, 0x06, 0x00, 0x06, 0x04, 0x06, 0x00, 0x06, 0x04, 0x06, 0x00, 0x06, 0x04, 0x06,
+    0x00, 0x06, 0x04, 0x06, 0x00, 0x06, 0x04, 0x06, 0x00, 0x06, 0x04, 0x06, 0x00, 0x06, 0x04, 0x06,
+    0x10, 0x16, 0x14, 0x16, 0x10, 0x16, 0x14, 0x16, 0x10, 0x16, 0x14, 0x16, 0x10, 0x16, 0x14, 0x16,
+    0x10, 0x16, 0x14, 0x16, 0x10, 0x16, 0x14, 0x16, 0x10, 0x16, 0x14, 0x16, 0x10, 0x16, 0x14, 0x16,
+    0x30, 0x36, 0x34, 0x36, 0x30, 0x36, 0x34, 0x36, 0x30, 0x36, 0x34, 0x36, 0x30, 0x36, 0x34, 0x36,
+    0x30, 0x36, 0x34, 0x36, 0x30, 0x36, 0x34, 0x36, 0x30, 0x36, 0x34, 0x36, 0x30, 0x36, 0x34, 0x36,
+    0x30, 0x36, 0x34, 0x36, 0x30, 0x36, 0x34, 0x36, 0x30, 0x36, 0x34, 0x36, 0x30, 0x36, 0x34, 0x36,
+    0x30, 0x36, 0x34, 0x36, 0x30, 0x36, 0x34, 0x36, 0x30, 0x36, 0x34, 0x36, 0x30, 0x36, 0x34, 0x36,
+    0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76,
+    0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76,
+    0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76,
+    0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76,
+    0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76,
+    0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76,
+    0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76,
+    0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76, 0x70, 0x76, 0x74, 0x76
+  },
+  {
+    0x00, 0x0E, 0x0C, 0x0E, 0x08, 0x0E, 0x0C, 0x0E, 0x00, 0x0E, 0x0C, 0x0E, 0x08, 0x0E, 0x0C, 0x0E,
+    0x00, 0x0E, 0x0C, 0x0E, 0x08, 0x0E, 0x0C, 0x0E, 0x00, 0x0E, 0x0C, 0x0E, 0x08, 0x0E, 0x0C, 0x0E,
+    0x00, 0x0E, 0x0C, 0x0E, 0x08, 0x0E, 0x0C, 0x0E, 0x00, 0x0E, 0x0C, 0x0E, 0x08, 0x0E, 0x0C, 0x0E,
+    0x00, 0x0E, 0x0C, 0x0E, 0x08, 0x0E, 0x0C, 0x0E, 0x00, 0x0E, 0x0C, 0x0E, 0x08, 0x0E, 0x0C, 0x0E,
+    0x20, 0x2E, 0x2C, 0x2E, 0x28, 0x2E, 0x2C, 0x2E, 0x20, 0x2E, 0x2C, 0x2E, 0x28, 0x2E, 0x2C, 0x2E,
+    0x20, 0x2E, 0x2C, 0x2E, 0x28, 0x2E, 0x2C, 0x2E, 0x20, 0x2E, 0x2C, 0x2E, 0x28, 0x2E, 0x2C, 0x2E,
+    0x20, 0x2E, 0x2C, 0x2E, 0x28, 0x2E, 0x2C, 0x2E, 0x20, 0x2E, 0x2C, 0x2E, 0x28, 0x2E, 0x2C, 0x2E,
+    0x20, 0x2E, 0x2C, 0x2E, 0x28, 0x2E, 0x2C, 0x2E, 0x20, 0x2E, 0x2C, 0x2E, 0x28, 0x2E, 0x2C, 0x2E,
+    0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E, 0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E,
+    0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E, 0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E,
+    0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E, 0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E,
+    0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E, 0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E,
+    0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E, 0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E,
+    0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E, 0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E,
+    0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E, 0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E,
+    0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E, 0x60, 0x6E, 0x6C, 0x6E, 0x68, 0x6E, 0x6C, 0x6E
+  },
+  {
+    0x00, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E, 0x10, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E,
+    0x00, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E, 0x10, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E,
+    0x00, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E, 0x10, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E,
+    0x00, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E, 0x10, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E,
+    0x00, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E, 0x10, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E,
+    0x00, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E, 0x10, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E,
+    0x00, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E, 0x10, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E,
+    0x00, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E, 0x10, 0x1E, 0x1C, 0x1E, 0x18, 0x1E, 0x1C, 0x1E,
+    0x40, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E, 0x50, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E,
+    0x40, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E, 0x50, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E,
+    0x40, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E, 0x50, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E,
+    0x40, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E, 0x50, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E,
+    0x40, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E, 0x50, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E,
+    0x40, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E, 0x50, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E,
+    0x40, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E, 0x50, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E,
+    0x40, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E, 0x50, 0x5E, 0x5C, 0x5E, 0x58, 0x5E, 0x5C, 0x5E
+  },
+  {
+    0x00, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x20, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x00, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x20, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x00, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x20, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x00, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x20, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x00, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x20, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x00, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x20, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x00, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x20, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x00, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E,
+    0x20, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E, 0x30, 0x3E, 0x3C, 0x3E, 0x38, 0x3E, 0x3C, 0x3E
+  },
+  {
+    0x00, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x60, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x40, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x60, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x00, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x60, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x40, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x60, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x00, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x60, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x40, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x60, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x00, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x60, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x40, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E,
+    0x60, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E, 0x70, 0x7E, 0x7C, 0x7E, 0x78, 0x7E, 0x7C, 0x7E
+  }
+};
+
+/* Printable names of the legal move generators, indexed by the LegalMoveGenerator enum. */
+static const gchar *const legal_move_generator_names[] = {
+  "wave", "kogge-stone", "kogge-stone-avx2"
+};
+
+/*
+ * The function used to compute legal moves, it is selected by board_module_init.
+ * The scalar Kogge-Stone implementation has no precondition, so it is a safe default.
+ */
+static LegalMoveGenerator legal_move_generator = LEGAL_MOVE_GENERATOR_KOGGE_STONE;
+static SquareSet (*legal_moves_fn) (const SquareSet, const SquareSet) = legal_moves_kogge_stone;
+
+/* Printable names of the legal moves batch backends, indexed by the LegalMovesBatchBackend enum. */
+static const gchar *const legal_moves_batch_backend_names[] = {
+  "scalar", "avx2", "avx512"
+};
+
+/* The function used to compute legal moves in batch, it is selected by board_module_init. */
+static LegalMovesBatchBackend legal_moves_batch_backend = LEGAL_MOVES_BATCH_SCALAR;
+static void (*legal_moves_batch_fn) (const int,
+                                     const SquareSet *const,
+                                     const SquareSet *const,
+                                     SquareSet *const,
+                                     int *const) = legal_moves_batch_scalar;
+
+/* Printable names of the board transformations, indexed by the BoardTransformation enum. */
+static const gchar *const board_transformation_names[] = {
+  "identity", "rotate-90-clockwise", "rotate-180", "rotate-90-anticlockwise",
+  "flip-vertical", "flip-horizontal", "flip-diag-a1-h8", "flip-diag-h1-a8"
+};
+
+/* Inverse of each board transformation, only the two rotations by 90 degrees are not involutions. */
+static const BoardTransformation board_transformation_inverses[] = {
+  BOARD_TRANSFORMATION_IDENTITY,
+  BOARD_TRANSFORMATION_ROTATE_90_ANTICLOCKWISE,
+  BOARD_TRANSFORMATION_ROTATE_180,
+  BOARD_TRANSFORMATION_ROTATE_90_CLOCKWISE,
+  BOARD_TRANSFORMATION_FLIP_VERTICAL,
+  BOARD_TRANSFORMATION_FLIP_HORIZONTAL,
+  BOARD_TRANSFORMATION_FLIP_DIAG_A1_H8,
+  BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8
+};
+
+/* Printable names of the flip backends, indexed by the FlipBackend enum. */
+static const gchar *const flip_backend_names[] = {
+  "bitrow-table", "kogge-stone", "carry", "per-square"
+};
+
+/*
+ * The function used to compute flipped discs, it is selected by board_module_init.
+ * The carry implementation doesn't depend on the initialization of the module tables.
  */
-static uint8_t bitrow_changes_for_player_array[256 * 256 * 8];
+static FlipBackend flip_backend = FLIP_BACKEND_CARRY;
+static SquareSet (*flips_fn) (const SquareSet, const SquareSet, const Square) = flips_carry;
 
 /*
  * This array is a precomputed table used by the direction_shift_square_set_by_amount function.
@@ -128,6 +470,23 @@ static uint8_t bitrow_changes_for_player_array[256 * 256 * 8];
  */
 static SquareSet shift_square_set_by_amount_mask_array[8 * 8];
 
+/*
+ * Base three representation of a bitrow: each bit of the row index is a digit of the value.
+ * A couple of rows, player and opponent, is mapped to the index of the edge stability array by
+ * bitrow_to_base_three[p] + 2 * bitrow_to_base_three[o].
+ */
+static uint16_t bitrow_to_base_three[256];
+
+/*
+ * The edge stability array has an entry for each of the 3^8 configurations of an edge.
+ * The value is the bitrow of the player discs that cannot be flipped whatever the sequence
+ * of moves played on the edge. Moves are not required to be legal for the edge taken alone,
+ * because the two dimensional board can place a disc on any empty square.
+ *
+ * The array is computed by board_module_init.
+ */
+static uint8_t edge_stability_array[6561];
+
 /*
  * This array has sixtyfour entries. The index, having range 0-63, represent one of the squares
  * of the table. Each entry is a bitboard mask having set all the squares that are
@@ -155,6 +514,142 @@ static const SquareSet bitboard_mask_for_all_directions[] = {
   0xEF38549211101010, 0xDF70A82422212020, 0xBFE0504844424140, 0x7FC0A09088848281
 };
 
+/*
+ * For each square, and for each direction, the squares met moving from the square
+ * toward the board edge, the square itself excluded.
+ * The second index follows the order of the Direction enum.
+ */
+static const SquareSet square_ray_masks[64][8] = {
+  { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000,
+    0x00000000000000FE, 0x0000000000000000, 0x0101010101010100, 0x8040201008040200 },
+  { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000001,
+    0x00000000000000FC, 0x0000000000000100, 0x0202020202020200, 0x0080402010080400 },
+  { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000003,
+    0x00000000000000F8, 0x0000000000010200, 0x0404040404040400, 0x0000804020100800 },
+  { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000007,
+    0x00000000000000F0, 0x0000000001020400, 0x0808080808080800, 0x0000008040201000 },
+  { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x000000000000000F,
+    0x00000000000000E0, 0x0000000102040800, 0x1010101010101000, 0x0000000080402000 },
+  { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x000000000000001F,
+    0x00000000000000C0, 0x0000010204081000, 0x2020202020202000, 0x0000000000804000 },
+  { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x000000000000003F,
+    0x0000000000000080, 0x0001020408102000, 0x4040404040404000, 0x0000000000008000 },
+  { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x000000000000007F,
+    0x0000000000000000, 0x0102040810204000, 0x8080808080808000, 0x0000000000000000 },
+  { 0x0000000000000000, 0x0000000000000001, 0x0000000000000002, 0x0000000000000000,
+    0x000000000000FE00, 0x0000000000000000, 0x0101010101010000, 0x4020100804020000 },
+  { 0x0000000000000001, 0x0000000000000002, 0x0000000000000004, 0x0000000000000100,
+    0x000000000000FC00, 0x0000000000010000, 0x0202020202020000, 0x8040201008040000 },
+  { 0x0000000000000002, 0x0000000000000004, 0x0000000000000008, 0x0000000000000300,
+    0x000000000000F800, 0x0000000001020000, 0x0404040404040000, 0x0080402010080000 },
+  { 0x0000000000000004, 0x0000000000000008, 0x0000000000000010, 0x0000000000000700,
+    0x000000000000F000, 0x0000000102040000, 0x0808080808080000, 0x0000804020100000 },
+  { 0x0000000000000008, 0x0000000000000010, 0x0000000000000020, 0x0000000000000F00,
+    0x000000000000E000, 0x0000010204080000, 0x1010101010100000, 0x0000008040200000 },
+  { 0x0000000000000010, 0x0000000000000020, 0x0000000000000040, 0x0000000000001F00,
+    0x000000000000C000, 0x0001020408100000, 0x2020202020200000, 0x0000000080400000 },
+  { 0x0000000000000020, 0x0000000000000040, 0x0000000000000080, 0x0000000000003F00,
+    0x0000000000008000, 0x0102040810200000, 0x4040404040400000, 0x0000000000800000 },
+  { 0x0000000000000040, 0x0000000000000080, 0x0000000000000000, 0x0000000000007F00,
+    0x0000000000000000, 0x0204081020400000, 0x8080808080800000, 0x0000000000000000 },
+  { 0x0000000000000000, 0x0000000000000101, 0x0000000000000204, 0x0000000000000000,
+    0x0000000000FE0000, 0x0000000000000000, 0x0101010101000000, 0x2010080402000000 },
+  { 0x0000000000000100, 0x0000000000000202, 0x0000000000000408, 0x0000000000010000,
+    0x0000000000FC0000, 0x0000000001000000, 0x0202020202000000, 0x4020100804000000 },
+  { 0x0000000000000201, 0x0000000000000404, 0x0000000000000810, 0x0000000000030000,
+    0x0000000000F80000, 0x0000000102000000, 0x0404040404000000, 0x8040201008000000 },
+  { 0x0000000000000402, 0x0000000000000808, 0x0000000000001020, 0x0000000000070000,
+    0x0000000000F00000, 0x0000010204000000, 0x0808080808000000, 0x0080402010000000 },
+  { 0x0000000000000804, 0x0000000000001010, 0x0000000000002040, 0x00000000000F0000,
+    0x0000000000E00000, 0x0001020408000000, 0x1010101010000000, 0x0000804020000000 },
+  { 0x0000000000001008, 0x0000000000002020, 0x0000000000004080, 0x00000000001F0000,
+    0x0000000000C00000, 0x0102040810000000, 0x2020202020000000, 0x0000008040000000 },
+  { 0x0000000000002010, 0x0000000000004040, 0x0000000000008000, 0x00000000003F0000,
+    0x0000000000800000, 0x0204081020000000, 0x4040404040000000, 0x0000000080000000 },
+  { 0x0000000000004020, 0x0000000000008080, 0x0000000000000000, 0x00000000007F0000,
+    0x0000000000000000, 0x0408102040000000, 0x8080808080000000, 0x0000000000000000 },
+  { 0x0000000000000000, 0x0000000000010101, 0x0000000000020408, 0x0000000000000000,
+    0x00000000FE000000, 0x0000000000000000, 0x0101010100000000, 0x1008040200000000 },
+  { 0x0000000000010000, 0x0000000000020202, 0x0000000000040810, 0x0000000001000000,
+    0x00000000FC000000, 0x0000000100000000, 0x0202020200000000, 0x2010080400000000 },
+  { 0x0000000000020100, 0x0000000000040404, 0x0000000000081020, 0x0000000003000000,
+    0x00000000F8000000, 0x0000010200000000, 0x0404040400000000, 0x4020100800000000 },
+  { 0x0000000000040201, 0x0000000000080808, 0x0000000000102040, 0x0000000007000000,
+    0x00000000F0000000, 0x0001020400000000, 0x0808080800000000, 0x8040201000000000 },
+  { 0x0000000000080402, 0x0000000000101010, 0x0000000000204080, 0x000000000F000000,
+    0x00000000E0000000, 0x0102040800000000, 0x1010101000000000, 0x0080402000000000 },
+  { 0x0000000000100804, 0x0000000000202020, 0x0000000000408000, 0x000000001F000000,
+    0x00000000C0000000, 0x0204081000000000, 0x2020202000000000, 0x0000804000000000 },
+  { 0x0000000000201008, 0x0000000000404040, 0x0000000000800000, 0x000000003F000000,
+    0x0000000080000000, 0x0408102000000000, 0x4040404000000000, 0x0000008000000000 },
+  { 0x0000000000402010, 0x0000000000808080, 0x0000000000000000, 0x000000007F000000,
+    0x0000000000000000, 0x0810204000000000, 0x8080808000000000, 0x0000000000000000 },
+  { 0x0000000000000000, 0x0000000001010101, 0x0000000002040810, 0x0000000000000000,
+    0x000000FE00000000, 0x0000000000000000, 0x0101010000000000, 0x0804020000000000 },
+  { 0x0000000001000000, 0x0000000002020202, 0x0000000004081020, 0x0000000100000000,
+    0x000000FC00000000, 0x0000010000000000, 0x0202020000000000, 0x1008040000000000 },
+  { 0x0000000002010000, 0x0000000004040404, 0x0000000008102040, 0x0000000300000000,
+    0x000000F800000000, 0x0001020000000000, 0x0404040000000000, 0x2010080000000000 },
+  { 0x0000000004020100, 0x0000000008080808, 0x0000000010204080, 0x0000000700000000,
+    0x000000F000000000, 0x0102040000000000, 0x0808080000000000, 0x4020100000000000 },
+  { 0x0000000008040201, 0x0000000010101010, 0x0000000020408000, 0x0000000F00000000,
+    0x000000E000000000, 0x0204080000000000, 0x1010100000000000, 0x8040200000000000 },
+  { 0x0000000010080402, 0x0000000020202020, 0x0000000040800000, 0x0000001F00000000,
+    0x000000C000000000, 0x0408100000000000, 0x2020200000000000, 0x0080400000000000 },
+  { 0x0000000020100804, 0x0000000040404040, 0x0000000080000000, 0x0000003F00000000,
+    0x0000008000000000, 0x0810200000000000, 0x4040400000000000, 0x0000800000000000 },
+  { 0x0000000040201008, 0x0000000080808080, 0x0000000000000000, 0x0000007F00000000,
+    0x0000000000000000, 0x1020400000000000, 0x8080800000000000, 0x0000000000000000 },
+  { 0x0000000000000000, 0x0000000101010101, 0x0000000204081020, 0x0000000000000000,
+    0x0000FE0000000000, 0x0000000000000000, 0x0101000000000000, 0x0402000000000000 },
+  { 0x0000000100000000, 0x0000000202020202, 0x0000000408102040, 0x0000010000000000,
+    0x0000FC0000000000, 0x0001000000000000, 0x0202000000000000, 0x0804000000000000 },
+  { 0x0000000201000000, 0x0000000404040404, 0x0000000810204080, 0x0000030000000000,
+    0x0000F80000000000, 0x0102000000000000, 0x0404000000000000, 0x1008000000000000 },
+  { 0x0000000402010000, 0x0000000808080808, 0x0000001020408000, 0x0000070000000000,
+    0x0000F00000000000, 0x0204000000000000, 0x0808000000000000, 0x2010000000000000 },
+  { 0x0000000804020100, 0x0000001010101010, 0x0000002040800000, 0x00000F0000000000,
+    0x0000E00000000000, 0x0408000000000000, 0x1010000000000000, 0x4020000000000000 },
+  { 0x0000001008040201, 0x0000002020202020, 0x0000004080000000, 0x00001F0000000000,
+    0x0000C00000000000, 0x0810000000000000, 0x2020000000000000, 0x8040000000000000 },
+  { 0x0000002010080402, 0x0000004040404040, 0x0000008000000000, 0x00003F0000000000,
+    0x0000800000000000, 0x1020000000000000, 0x4040000000000000, 0x0080000000000000 },
+  { 0x0000004020100804, 0x0000008080808080, 0x0000000000000000, 0x00007F0000000000,
+    0x0000000000000000, 0x2040000000000000, 0x8080000000000000, 0x0000000000000000 },
+  { 0x0000000000000000, 0x0000010101010101, 0x0000020408102040, 0x0000000000000000,
+    0x00FE000000000000, 0x0000000000000000, 0x0100000000000000, 0x0200000000000000 },
+  { 0x0000010000000000, 0x0000020202020202, 0x0000040810204080, 0x0001000000000000,
+    0x00FC000000000000, 0x0100000000000000, 0x0200000000000000, 0x0400000000000000 },
+  { 0x0000020100000000, 0x0000040404040404, 0x0000081020408000, 0x0003000000000000,
+    0x00F8000000000000, 0x0200000000000000, 0x0400000000000000, 0x0800000000000000 },
+  { 0x0000040201000000, 0x0000080808080808, 0x0000102040800000, 0x0007000000000000,
+    0x00F0000000000000, 0x0400000000000000, 0x0800000000000000, 0x1000000000000000 },
+  { 0x0000080402010000, 0x0000101010101010, 0x0000204080000000, 0x000F000000000000,
+    0x00E0000000000000, 0x0800000000000000, 0x1000000000000000, 0x2000000000000000 },
+  { 0x0000100804020100, 0x0000202020202020, 0x0000408000000000, 0x001F000000000000,
+    0x00C0000000000000, 0x1000000000000000, 0x2000000000000000, 0x4000000000000000 },
+  { 0x0000201008040201, 0x0000404040404040, 0x0000800000000000, 0x003F000000000000,
+    0x0080000000000000, 0x2000000000000000, 0x4000000000000000, 0x8000000000000000 },
+  { 0x0000402010080402, 0x0000808080808080, 0x0000000000000000, 0x007F000000000000,
+    0x0000000000000000, 0x4000000000000000, 0x8000000000000000, 0x0000000000000000 },
+  { 0x0000000000000000, 0x0001010101010101, 0x0002040810204080, 0x0000000000000000,
+    0xFE00000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+  { 0x0001000000000000, 0x0002020202020202, 0x0004081020408000, 0x0100000000000000,
+    0xFC00000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+  { 0x0002010000000000, 0x0004040404040404, 0x0008102040800000, 0x0300000000000000,
+    0xF800000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+  { 0x0004020100000000, 0x0008080808080808, 0x0010204080000000, 0x0700000000000000,
+    0xF000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+  { 0x0008040201000000, 0x0010101010101010, 0x0020408000000000, 0x0F00000000000000,
+    0xE000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+  { 0x0010080402010000, 0x0020202020202020, 0x0040800000000000, 0x1F00000000000000,
+    0xC000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+  { 0x0020100804020100, 0x0040404040404040, 0x0080000000000000, 0x3F00000000000000,
+    0x8000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 },
+  { 0x0040201008040201, 0x0080808080808080, 0x0000000000000000, 0x7F00000000000000,
+    0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000 }
+};
+
 /*
  * Zobrist bitstrings generated by the URANDOM Linux generator.
  * The array has 128 entries, 64 for black squares, and 64 for white ones.
@@ -214,8 +709,17 @@ static const uint64_t zobrist_bitstrings[] = {
 void
 board_module_init (void)
 {
-  board_initialize_bitrow_changes_for_player_array(bitrow_changes_for_player_array);
   board_initialize_shift_square_set_by_amount_mask_array(shift_square_set_by_amount_mask_array);
+  board_initialize_edge_stability_array();
+  if (!legal_move_generator_set(LEGAL_MOVE_GENERATOR_KOGGE_STONE_AVX2)) {
+    legal_move_generator_set(LEGAL_MOVE_GENERATOR_KOGGE_STONE);
+  }
+  if (!legal_moves_batch_backend_set(LEGAL_MOVES_BATCH_AVX512)) {
+    if (!legal_moves_batch_backend_set(LEGAL_MOVES_BATCH_AVX2)) {
+      legal_moves_batch_backend_set(LEGAL_MOVES_BATCH_SCALAR);
+    }
+  }
+  flip_backend_set(FLIP_BACKEND_CARRY);
 }
 
 
@@ -377,6 +881,31 @@ square_is_valid_move (const Square move)
   return square_belongs_to_enum_set(move) || move == pass_move;
 }
 
+/**
+ * @brief Returns the square where `sq` is moved by the board transformation.
+ *
+ * @details Values not belonging to the #Square enum, as `pass_move` or `invalid_move`,
+ * are returned unchanged, so that moves can be mapped as well.
+ * A move played in a position is mapped to the corresponding move of the transformed position,
+ * and back by means of the inverse transformation, see #board_transformation_inverse.
+ *
+ * @invariant Parameter `bt` must belong to the #BoardTransformation enum.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] sq the square to transform
+ * @param [in] bt the board transformation
+ * @return        the transformed square
+ */
+Square
+square_transform (const Square sq,
+                  const BoardTransformation bt)
+{
+  g_assert(bt >= BOARD_TRANSFORMATION_IDENTITY && bt <= BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8);
+
+  if (!square_belongs_to_enum_set(sq)) return sq;
+  return (Square) bit_works_bitscanLS1B_64(square_set_transform((SquareSet) 1 << sq, bt));
+}
+
 
 
 /******************************************************/
@@ -559,6 +1088,180 @@ square_set_from_array (const Square sq_array[],
   return squares;
 }
 
+/**
+ * @brief Flips the square set upside down, row 1 is exchanged with row 8.
+ *
+ * @param [in] squares the square set to transform
+ * @return             the transformed square set
+ */
+SquareSet
+square_set_flip_vertical (const SquareSet squares)
+{
+#if defined(__GNUC__)
+  return __builtin_bswap64(squares);
+#else
+  SquareSet s = squares;
+  s = ((s >>  8) & 0x00FF00FF00FF00FF) | ((s & 0x00FF00FF00FF00FF) <<  8);
+  s = ((s >> 16) & 0x0000FFFF0000FFFF) | ((s & 0x0000FFFF0000FFFF) << 16);
+  s = (s >> 32) | (s << 32);
+  return s;
+#endif
+}
+
+/**
+ * @brief Mirrors the square set left to right, column a is exchanged with column h.
+ *
+ * @param [in] squares the square set to transform
+ * @return             the transformed square set
+ */
+SquareSet
+square_set_flip_horizontal (const SquareSet squares)
+{
+  SquareSet s = squares;
+  s = ((s >> 1) & 0x5555555555555555) | ((s & 0x5555555555555555) << 1);
+  s = ((s >> 2) & 0x3333333333333333) | ((s & 0x3333333333333333) << 2);
+  s = ((s >> 4) & 0x0F0F0F0F0F0F0F0F) | ((s & 0x0F0F0F0F0F0F0F0F) << 4);
+  return s;
+}
+
+/**
+ * @brief Mirrors the square set on the A1-H8 diagonal, square B1 is exchanged with A2.
+ *
+ * @details Bits are exchanged by three delta swaps, moving 4x4, 2x2, and 1x1 blocks.
+ *
+ * @param [in] squares the square set to transform
+ * @return             the transformed square set
+ */
+SquareSet
+square_set_flip_diag_a1_h8 (const SquareSet squares)
+{
+  SquareSet s = squares;
+  SquareSet t;
+  t = 0x0F0F0F0F00000000 & (s ^ (s << 28));
+  s ^= t ^ (t >> 28);
+  t = 0x3333000033330000 & (s ^ (s << 14));
+  s ^= t ^ (t >> 14);
+  t = 0x5500550055005500 & (s ^ (s << 7));
+  s ^= t ^ (t >> 7);
+  return s;
+}
+
+/**
+ * @brief Mirrors the square set on the H1-A8 diagonal, square A1 is exchanged with H8.
+ *
+ * @details Bits are exchanged by three delta swaps, moving 4x4, 2x2, and 1x1 blocks.
+ *
+ * @param [in] squares the square set to transform
+ * @return             the transformed square set
+ */
+SquareSet
+square_set_flip_diag_h1_a8 (const SquareSet squares)
+{
+  SquareSet s = squares;
+  SquareSet t;
+  t = s ^ (s << 36);
+  s ^= 0xF0F0F0F00F0F0F0F & (t ^ (s >> 36));
+  t = 0xCCCC0000CCCC0000 & (s ^ (s << 18));
+  s ^= t ^ (t >> 18);
+  t = 0xAA00AA00AA00AA00 & (s ^ (s << 9));
+  s ^= t ^ (t >> 9);
+  return s;
+}
+
+/**
+ * @brief Rotates the square set by 180 degrees, square A1 is exchanged with H8.
+ *
+ * @param [in] squares the square set to transform
+ * @return             the transformed square set
+ */
+SquareSet
+square_set_rotate_180 (const SquareSet squares)
+{
+  return square_set_flip_horizontal(square_set_flip_vertical(squares));
+}
+
+/**
+ * @brief Rotates the square set by 90 degrees clockwise, square A1 goes to H1.
+ *
+ * @param [in] squares the square set to transform
+ * @return             the transformed square set
+ */
+SquareSet
+square_set_rotate_90_clockwise (const SquareSet squares)
+{
+  return square_set_flip_diag_a1_h8(square_set_flip_vertical(squares));
+}
+
+/**
+ * @brief Rotates the square set by 90 degrees anticlockwise, square A1 goes to A8.
+ *
+ * @param [in] squares the square set to transform
+ * @return             the transformed square set
+ */
+SquareSet
+square_set_rotate_90_anticlockwise (const SquareSet squares)
+{
+  return square_set_flip_vertical(square_set_flip_diag_a1_h8(squares));
+}
+
+/**
+ * @brief Applies the board transformation to the square set.
+ *
+ * @invariant Parameter `bt` must belong to the #BoardTransformation enum.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] squares the square set to transform
+ * @param [in] bt      the board transformation
+ * @return             the transformed square set
+ */
+SquareSet
+square_set_transform (const SquareSet squares,
+                      const BoardTransformation bt)
+{
+  switch (bt) {
+  case BOARD_TRANSFORMATION_IDENTITY:
+    return squares;
+  case BOARD_TRANSFORMATION_ROTATE_90_CLOCKWISE:
+    return square_set_rotate_90_clockwise(squares);
+  case BOARD_TRANSFORMATION_ROTATE_180:
+    return square_set_rotate_180(squares);
+  case BOARD_TRANSFORMATION_ROTATE_90_ANTICLOCKWISE:
+    return square_set_rotate_90_anticlockwise(squares);
+  case BOARD_TRANSFORMATION_FLIP_VERTICAL:
+    return square_set_flip_vertical(squares);
+  case BOARD_TRANSFORMATION_FLIP_HORIZONTAL:
+    return square_set_flip_horizontal(squares);
+  case BOARD_TRANSFORMATION_FLIP_DIAG_A1_H8:
+    return square_set_flip_diag_a1_h8(squares);
+  case BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8:
+    return square_set_flip_diag_h1_a8(squares);
+  default:
+    g_assert(FALSE);
+    abort();
+  }
+}
+
+/**
+ * @brief Returns the discs flipped when the player moves in the `move` square.
+ *
+ * @details The flips are computed by the selected flip backend.
+ * No check is done on the parameters, the function is meant for the inner loops
+ * of the solvers. The move square must be empty, when the move is not legal
+ * the returned set is empty.
+ *
+ * @param [in] p_bit_board the square set of the player's discs
+ * @param [in] o_bit_board the square set of the opponent's discs
+ * @param [in] move        the square where the player moves
+ * @return                 the square set of the flipped discs
+ */
+SquareSet
+square_set_flips (const SquareSet p_bit_board,
+                  const SquareSet o_bit_board,
+                  const Square move)
+{
+  return flips_fn(p_bit_board, o_bit_board, move);
+}
+
 /***************************************************/
 /* Function implementations for the Player entity. */
 /***************************************************/
@@ -1066,8 +1769,8 @@ board_is_move_legal (const Board *const b,
  * @brief Returns a list holding the legal moves that the player can do at the board position.
  *        When no moves are available to the player the method returns an empty list.
  *
- * Implements the legal moves call by waveing the potential legal moves up to the bracketing
- * pieces. Directions are computed one by one, squares work in parallel.
+ * The computation is delegated to the legal move generator selected by #board_module_init,
+ * see #legal_move_generator_set.
  *
  * @invariant Parameter `b` must be not `NULL`.
  * Parameter `p` must be a value belonging to the `Player` enum.
@@ -1084,28 +1787,10 @@ board_legal_moves (const Board *const b,
   g_assert(b);
   g_assert(p == BLACK_PLAYER || p == WHITE_PLAYER);
 
-  register SquareSet result;
-
-  result = empty_square_set;
-
-  const Player o = player_opponent(p);
-  const SquareSet empties = board_empties(b);
   const SquareSet p_bit_board = board_get_player(b, p);
-  const SquareSet o_bit_board = board_get_player(b, o);
-
-  for (Direction dir = NW; dir <= SE; dir++) {
-    const Direction opposite = direction_opposite(dir);
-    SquareSet wave = direction_shift_square_set(dir, empties) & o_bit_board;
-    int shift = 1;
-    while (wave != empty_square_set) {
-      wave = direction_shift_square_set(dir, wave);
-      shift++;
-      result |= direction_shift_back_square_set_by_amount(opposite, (wave & p_bit_board), shift);
-      wave &= o_bit_board;
-    }
-  }
+  const SquareSet o_bit_board = board_get_player(b, player_opponent(p));
 
-  return result;
+  return legal_moves_fn(p_bit_board, o_bit_board);
 }
 
 /**
@@ -1126,6 +1811,30 @@ board_has_any_player_any_legal_move (const Board *const b)
           empty_square_set == board_legal_moves(b, WHITE_PLAYER)) ? FALSE : TRUE;
 }
 
+/**
+ * @brief Returns the set of discs, of both colors, that cannot be flipped for the rest of the game.
+ *
+ * @details The computation is conservative, the returned set is a subset of the stable discs.
+ * Edge discs are looked up in a precomputed table, discs lying on lines completely filled in all
+ * the four directions are stable, and stability is then propagated to the inner discs having,
+ * for each direction, a stable neighbour of the same color or a filled line.
+ *
+ * The board module must be initialized by calling #board_module_init.
+ *
+ * @invariant Parameter `b` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] b the given board
+ * @return       the set of stable discs
+ */
+SquareSet
+board_stable_discs (const Board *const b)
+{
+  g_assert(b);
+
+  return square_sets_stable_discs(b->blacks, b->whites);
+}
+
 /**
  * @brief Returns the set of empty squares in the board.
  *
@@ -1329,6 +2038,9 @@ board_compare (const Board *const a,
 /**
  * Returns an 8-bit row representation of the player pieces after applying the move.
  *
+ * When the player and opponent rows overlap, when the move square is not empty,
+ * or when the move doesn't flip any disc, the player row is returned unchanged.
+ *
  * @param [in] player_row    8-bit bitboard corrosponding to player pieces
  * @param [in] opponent_row  8-bit bitboard corrosponding to opponent pieces
  * @param [in] move_position square to move
@@ -1339,8 +2051,16 @@ board_bitrow_changes_for_player (int player_row,
                                  int opponent_row,
                                  int move_position)
 {
-  const int array_index = player_row | (opponent_row << 8) | (move_position << 16);
-  return bitrow_changes_for_player_array[array_index];
+  const uint8_t move = 1 << move_position;
+  const int is_valid = !((player_row & opponent_row) | ((player_row | opponent_row) & move));
+
+  const uint8_t outflank = bitrow_outflank_array[move_position][(opponent_row >> 1) & 0x3F] & player_row;
+  const uint8_t flipped = bitrow_flipped_array[move_position][outflank];
+
+  /* Branch-free selection, the result is the player row when the move is not valid or doesn't flip anything. */
+  const uint8_t changed = (uint8_t) (0 - (is_valid & (flipped != 0)));
+
+  return player_row | ((move | flipped) & changed);
 }
 
 
@@ -1451,81 +2171,535 @@ direction_opposite (const Direction dir)
   }
 }
 
-/********************************************************/
-/* Function implementations for the SquareState entity. */
-/********************************************************/
+/***************************************************************/
+/* Function implementations for the LegalMoveGenerator entity. */
+/***************************************************************/
 
 /**
- * @brief Returns the #SquareState printable representation.
+ * @brief Returns a string representation for the legal move generator.
  *
- * @invariant Parameter `color` must belong to the #SquareState enum.
+ * @details The returned string cannot be changed and must not be deallocated.
+ *
+ * @invariant Parameter `lmg` must belong to the #LegalMoveGenerator enum.
  * The invariant is guarded by an assertion.
  *
- * @param [in] color the given color
- * @return           the color's `symbol`
+ * @param [in] lmg the legal move generator
+ * @return         the generator's name
  */
-char
-square_state_symbol (const SquareState color)
+const gchar *
+legal_move_generator_to_string (const LegalMoveGenerator lmg)
 {
-  g_assert(color >= EMPTY_SQUARE && color <= WHITE_SQUARE);
+  g_assert(lmg >= LEGAL_MOVE_GENERATOR_WAVE && lmg <= LEGAL_MOVE_GENERATOR_KOGGE_STONE_AVX2);
 
-  switch (color) {
-  case EMPTY_SQUARE: return '.';
-  case BLACK_SQUARE: return '@';
-  case WHITE_SQUARE: return 'O';
-  default: abort();
-  }
+  return legal_move_generator_names[lmg];
 }
 
-
-
-/*********************************************************/
-/* Function implementations for the GamePosition entity. */
-/*********************************************************/
-
 /**
- * @brief GamePosition structure constructor.
- *
- * An assertion checks that the received pointer to the allocated
- * game position structure is not `NULL`.
+ * @brief Returns `TRUE` when the legal move generator can run on the current CPU.
  *
- * @invariant Parameter `b` cannot be null.
- * The invariant is guarded by an assertion.
+ * @details The scalar generators are always available, the AVX2 one requires
+ * both the compiler support and the CPU feature, detected at runtime.
  *
- * @invariant Parameter `p` must belong to the `Player` enum set.
+ * @invariant Parameter `lmg` must belong to the #LegalMoveGenerator enum.
  * The invariant is guarded by an assertion.
  *
- * @param [in] b the board field
- * @param [in] p the player field
- * @return       a pointer to a new game position structure
+ * @param [in] lmg the legal move generator
+ * @return         true if the generator can be used
  */
-GamePosition *
-game_position_new (Board *b,
-                   Player p)
+gboolean
+legal_move_generator_is_available (const LegalMoveGenerator lmg)
 {
-  g_assert(b);
-  g_assert(p == BLACK_PLAYER || p == WHITE_PLAYER);
-
-  GamePosition *gp;
-  static const size_t size_of_game_position = sizeof(GamePosition);
-
-  gp = (GamePosition *) malloc(size_of_game_position);
-  g_assert(gp);
-
-  gp->board = b;
-  gp->player = p;
-
-  return gp;
+  g_assert(lmg >= LEGAL_MOVE_GENERATOR_WAVE && lmg <= LEGAL_MOVE_GENERATOR_KOGGE_STONE_AVX2);
+
+  switch (lmg) {
+  case LEGAL_MOVE_GENERATOR_WAVE:
+  case LEGAL_MOVE_GENERATOR_KOGGE_STONE:
+    return TRUE;
+  case LEGAL_MOVE_GENERATOR_KOGGE_STONE_AVX2:
+#ifdef BOARD_AVX2_SUPPORT
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? TRUE : FALSE;
+#else
+    return FALSE;
+#endif
+  default:
+    abort();
+  }
 }
 
 /**
- * @brief Deallocates the memory previously allocated by a call to #game_position_new.
+ * @brief Selects the legal move generator used by #board_legal_moves,
+ * #game_position_x_legal_moves, and the other functions of the module computing mobility.
  *
- * @details If a null pointer is passed as argument, no action occurs.
+ * @details When the generator is not available the selection is left unchanged.
  *
- * @param [in,out] gp the pointer to be deallocated
+ * @invariant Parameter `lmg` must belong to the #LegalMoveGenerator enum.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] lmg the legal move generator to use
+ * @return         true if the generator has been selected
  */
-void
+gboolean
+legal_move_generator_set (const LegalMoveGenerator lmg)
+{
+  g_assert(lmg >= LEGAL_MOVE_GENERATOR_WAVE && lmg <= LEGAL_MOVE_GENERATOR_KOGGE_STONE_AVX2);
+
+  if (!legal_move_generator_is_available(lmg)) return FALSE;
+
+  switch (lmg) {
+  case LEGAL_MOVE_GENERATOR_WAVE:
+    legal_moves_fn = legal_moves_wave;
+    break;
+  case LEGAL_MOVE_GENERATOR_KOGGE_STONE:
+    legal_moves_fn = legal_moves_kogge_stone;
+    break;
+#ifdef BOARD_AVX2_SUPPORT
+  case LEGAL_MOVE_GENERATOR_KOGGE_STONE_AVX2:
+    legal_moves_fn = legal_moves_kogge_stone_avx2;
+    break;
+#endif
+  default:
+    abort();
+  }
+  legal_move_generator = lmg;
+  return TRUE;
+}
+
+/**
+ * @brief Returns the legal move generator currently selected.
+ *
+ * @return the legal move generator in use
+ */
+LegalMoveGenerator
+legal_move_generator_get (void)
+{
+  return legal_move_generator;
+}
+
+/**
+ * @brief Computes the legal moves by means of the given generator, regardless of the one selected.
+ *
+ * @details It is used to cross check and to benchmark the implementations.
+ *
+ * @invariant Parameter `lmg` must be available.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] lmg         the legal move generator
+ * @param [in] p_bit_board the squares of the player having to move
+ * @param [in] o_bit_board the squares of the opponent
+ * @return                 legal moves for the player
+ */
+SquareSet
+legal_move_generator_legal_moves (const LegalMoveGenerator lmg,
+                                  const SquareSet p_bit_board,
+                                  const SquareSet o_bit_board)
+{
+  g_assert(legal_move_generator_is_available(lmg));
+
+  switch (lmg) {
+  case LEGAL_MOVE_GENERATOR_WAVE:
+    return legal_moves_wave(p_bit_board, o_bit_board);
+  case LEGAL_MOVE_GENERATOR_KOGGE_STONE:
+    return legal_moves_kogge_stone(p_bit_board, o_bit_board);
+#ifdef BOARD_AVX2_SUPPORT
+  case LEGAL_MOVE_GENERATOR_KOGGE_STONE_AVX2:
+    return legal_moves_kogge_stone_avx2(p_bit_board, o_bit_board);
+#endif
+  default:
+    abort();
+  }
+}
+
+
+
+/*******************************************************************/
+/* Function implementations for the LegalMovesBatchBackend entity. */
+/*******************************************************************/
+
+/**
+ * @brief Returns a string representation for the legal moves batch backend.
+ *
+ * @details The returned string cannot be changed and must not be deallocated.
+ *
+ * @invariant Parameter `lmbb` must belong to the #LegalMovesBatchBackend enum.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] lmbb the legal moves batch backend
+ * @return          the backend's name
+ */
+const gchar *
+legal_moves_batch_backend_to_string (const LegalMovesBatchBackend lmbb)
+{
+  g_assert(lmbb >= LEGAL_MOVES_BATCH_SCALAR && lmbb <= LEGAL_MOVES_BATCH_AVX512);
+
+  return legal_moves_batch_backend_names[lmbb];
+}
+
+/**
+ * @brief Returns `TRUE` when the legal moves batch backend can run on the current CPU.
+ *
+ * @invariant Parameter `lmbb` must belong to the #LegalMovesBatchBackend enum.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] lmbb the legal moves batch backend
+ * @return          true if the backend can be used
+ */
+gboolean
+legal_moves_batch_backend_is_available (const LegalMovesBatchBackend lmbb)
+{
+  g_assert(lmbb >= LEGAL_MOVES_BATCH_SCALAR && lmbb <= LEGAL_MOVES_BATCH_AVX512);
+
+  switch (lmbb) {
+  case LEGAL_MOVES_BATCH_SCALAR:
+    return TRUE;
+  case LEGAL_MOVES_BATCH_AVX2:
+#ifdef BOARD_AVX2_SUPPORT
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? TRUE : FALSE;
+#else
+    return FALSE;
+#endif
+  case LEGAL_MOVES_BATCH_AVX512:
+#ifdef BOARD_AVX512_SUPPORT
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") ? TRUE : FALSE;
+#else
+    return FALSE;
+#endif
+  default:
+    abort();
+  }
+}
+
+/**
+ * @brief Selects the backend used by #game_position_x_legal_moves_batch.
+ *
+ * @details When the backend is not available the selection is left unchanged.
+ *
+ * @invariant Parameter `lmbb` must belong to the #LegalMovesBatchBackend enum.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] lmbb the legal moves batch backend to use
+ * @return          true if the backend has been selected
+ */
+gboolean
+legal_moves_batch_backend_set (const LegalMovesBatchBackend lmbb)
+{
+  g_assert(lmbb >= LEGAL_MOVES_BATCH_SCALAR && lmbb <= LEGAL_MOVES_BATCH_AVX512);
+
+  if (!legal_moves_batch_backend_is_available(lmbb)) return FALSE;
+
+  switch (lmbb) {
+  case LEGAL_MOVES_BATCH_SCALAR:
+    legal_moves_batch_fn = legal_moves_batch_scalar;
+    break;
+#ifdef BOARD_AVX2_SUPPORT
+  case LEGAL_MOVES_BATCH_AVX2:
+    legal_moves_batch_fn = legal_moves_batch_avx2;
+    break;
+#endif
+#ifdef BOARD_AVX512_SUPPORT
+  case LEGAL_MOVES_BATCH_AVX512:
+    legal_moves_batch_fn = legal_moves_batch_avx512;
+    break;
+#endif
+  default:
+    abort();
+  }
+  legal_moves_batch_backend = lmbb;
+  return TRUE;
+}
+
+/**
+ * @brief Returns the legal moves batch backend currently selected.
+ *
+ * @return the legal moves batch backend in use
+ */
+LegalMovesBatchBackend
+legal_moves_batch_backend_get (void)
+{
+  return legal_moves_batch_backend;
+}
+
+/**
+ * @brief Computes the legal moves of many positions by means of the given backend,
+ * regardless of the one selected.
+ *
+ * @details It is used to cross check and to benchmark the implementations.
+ * See #game_position_x_legal_moves_batch for the description of the parameters.
+ *
+ * @invariant Parameter `lmbb` must be available.
+ * Parameter `count` must be not negative.
+ * Parameters `p_bit_boards`, `o_bit_boards`, and `legal_moves` must be not `NULL`.
+ * Invariants are guarded by assertions.
+ *
+ * @param [in]  lmbb         the legal moves batch backend
+ * @param [in]  count        the number of positions
+ * @param [in]  p_bit_boards the squares of the player having to move, one entry for each position
+ * @param [in]  o_bit_boards the squares of the opponent, one entry for each position
+ * @param [out] legal_moves  the legal moves, one entry for each position
+ * @param [out] mobility     if not `NULL`, the count of legal moves, one entry for each position
+ */
+void
+legal_moves_batch_backend_legal_moves (const LegalMovesBatchBackend lmbb,
+                                       const int count,
+                                       const SquareSet *const p_bit_boards,
+                                       const SquareSet *const o_bit_boards,
+                                       SquareSet *const legal_moves,
+                                       int *const mobility)
+{
+  g_assert(legal_moves_batch_backend_is_available(lmbb));
+  g_assert(count >= 0);
+  g_assert(p_bit_boards && o_bit_boards && legal_moves);
+
+  switch (lmbb) {
+  case LEGAL_MOVES_BATCH_SCALAR:
+    legal_moves_batch_scalar(count, p_bit_boards, o_bit_boards, legal_moves, mobility);
+    break;
+#ifdef BOARD_AVX2_SUPPORT
+  case LEGAL_MOVES_BATCH_AVX2:
+    legal_moves_batch_avx2(count, p_bit_boards, o_bit_boards, legal_moves, mobility);
+    break;
+#endif
+#ifdef BOARD_AVX512_SUPPORT
+  case LEGAL_MOVES_BATCH_AVX512:
+    legal_moves_batch_avx512(count, p_bit_boards, o_bit_boards, legal_moves, mobility);
+    break;
+#endif
+  default:
+    abort();
+  }
+}
+
+
+
+/********************************************************/
+/* Function implementations for the FlipBackend entity. */
+/********************************************************/
+
+/**
+ * @brief Returns a string representation for the flip backend.
+ *
+ * @details The returned string cannot be changed and must not be deallocated.
+ *
+ * @invariant Parameter `fb` must belong to the #FlipBackend enum.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] fb the flip backend
+ * @return        the backend's name
+ */
+const gchar *
+flip_backend_to_string (const FlipBackend fb)
+{
+  g_assert(fb >= FLIP_BACKEND_BITROW_TABLE && fb <= FLIP_BACKEND_PER_SQUARE);
+
+  return flip_backend_names[fb];
+}
+
+/**
+ * @brief Selects the flip backend used by #game_position_x_make_move,
+ * #game_position_make_move, and #game_position_x_flips.
+ *
+ * @invariant Parameter `fb` must belong to the #FlipBackend enum.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] fb the flip backend to use
+ */
+void
+flip_backend_set (const FlipBackend fb)
+{
+  g_assert(fb >= FLIP_BACKEND_BITROW_TABLE && fb <= FLIP_BACKEND_PER_SQUARE);
+
+  switch (fb) {
+  case FLIP_BACKEND_BITROW_TABLE:
+    flips_fn = flips_bitrow_table;
+    break;
+  case FLIP_BACKEND_KOGGE_STONE:
+    flips_fn = flips_kogge_stone;
+    break;
+  case FLIP_BACKEND_CARRY:
+    flips_fn = flips_carry;
+    break;
+  case FLIP_BACKEND_PER_SQUARE:
+    flips_fn = flips_per_square;
+    break;
+  default:
+    abort();
+  }
+  flip_backend = fb;
+}
+
+/**
+ * @brief Returns the flip backend currently selected.
+ *
+ * @return the flip backend in use
+ */
+FlipBackend
+flip_backend_get (void)
+{
+  return flip_backend;
+}
+
+/**
+ * @brief Computes the discs flipped by the move by means of the given backend,
+ * regardless of the one selected.
+ *
+ * @details It is used to cross check and to benchmark the implementations.
+ * When the move is not legal the returned set is empty.
+ *
+ * @invariant Parameter `fb` must belong to the #FlipBackend enum.
+ * Parameter `move` must belong to the #Square enum.
+ * Parameter `move` must be an empty square.
+ * Invariants are guarded by assertions.
+ *
+ * @param [in] fb          the flip backend
+ * @param [in] p_bit_board the squares of the player moving
+ * @param [in] o_bit_board the squares of the opponent
+ * @param [in] move        the square where the player puts the new disc
+ * @return                 the opponent discs flipped by the move
+ */
+SquareSet
+flip_backend_flips (const FlipBackend fb,
+                    const SquareSet p_bit_board,
+                    const SquareSet o_bit_board,
+                    const Square move)
+{
+  g_assert(square_belongs_to_enum_set(move));
+  g_assert(!(((SquareSet) 1 << move) & (p_bit_board | o_bit_board)));
+
+  switch (fb) {
+  case FLIP_BACKEND_BITROW_TABLE:
+    return flips_bitrow_table(p_bit_board, o_bit_board, move);
+  case FLIP_BACKEND_KOGGE_STONE:
+    return flips_kogge_stone(p_bit_board, o_bit_board, move);
+  case FLIP_BACKEND_CARRY:
+    return flips_carry(p_bit_board, o_bit_board, move);
+  case FLIP_BACKEND_PER_SQUARE:
+    return flips_per_square(p_bit_board, o_bit_board, move);
+  default:
+    abort();
+  }
+}
+
+
+
+/****************************************************************/
+/* Function implementations for the BoardTransformation entity. */
+/****************************************************************/
+
+/**
+ * @brief Returns a string representation for the board transformation.
+ *
+ * @details The returned string cannot be changed and must not be deallocated.
+ *
+ * @invariant Parameter `bt` must belong to the #BoardTransformation enum.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] bt the board transformation
+ * @return        the transformation's name
+ */
+const gchar *
+board_transformation_to_string (const BoardTransformation bt)
+{
+  g_assert(bt >= BOARD_TRANSFORMATION_IDENTITY && bt <= BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8);
+
+  return board_transformation_names[bt];
+}
+
+/**
+ * @brief Returns the transformation that takes back the effect of `bt`.
+ *
+ * @invariant Parameter `bt` must belong to the #BoardTransformation enum.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] bt the board transformation
+ * @return        the inverse transformation
+ */
+BoardTransformation
+board_transformation_inverse (const BoardTransformation bt)
+{
+  g_assert(bt >= BOARD_TRANSFORMATION_IDENTITY && bt <= BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8);
+
+  return board_transformation_inverses[bt];
+}
+
+
+
+/********************************************************/
+/* Function implementations for the SquareState entity. */
+/********************************************************/
+
+/**
+ * @brief Returns the #SquareState printable representation.
+ *
+ * @invariant Parameter `color` must belong to the #SquareState enum.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] color the given color
+ * @return           the color's `symbol`
+ */
+char
+square_state_symbol (const SquareState color)
+{
+  g_assert(color >= EMPTY_SQUARE && color <= WHITE_SQUARE);
+
+  switch (color) {
+  case EMPTY_SQUARE: return '.';
+  case BLACK_SQUARE: return '@';
+  case WHITE_SQUARE: return 'O';
+  default: abort();
+  }
+}
+
+
+
+/*********************************************************/
+/* Function implementations for the GamePosition entity. */
+/*********************************************************/
+
+/**
+ * @brief GamePosition structure constructor.
+ *
+ * An assertion checks that the received pointer to the allocated
+ * game position structure is not `NULL`.
+ *
+ * @invariant Parameter `b` cannot be null.
+ * The invariant is guarded by an assertion.
+ *
+ * @invariant Parameter `p` must belong to the `Player` enum set.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] b the board field
+ * @param [in] p the player field
+ * @return       a pointer to a new game position structure
+ */
+GamePosition *
+game_position_new (Board *b,
+                   Player p)
+{
+  g_assert(b);
+  g_assert(p == BLACK_PLAYER || p == WHITE_PLAYER);
+
+  GamePosition *gp;
+  static const size_t size_of_game_position = sizeof(GamePosition);
+
+  gp = (GamePosition *) malloc(size_of_game_position);
+  g_assert(gp);
+
+  gp->board = b;
+  gp->player = p;
+
+  return gp;
+}
+
+/**
+ * @brief Deallocates the memory previously allocated by a call to #game_position_new.
+ *
+ * @details If a null pointer is passed as argument, no action occurs.
+ *
+ * @param [in,out] gp the pointer to be deallocated
+ */
+void
 game_position_free (GamePosition *gp)
 {
   if (gp) {
@@ -1785,65 +2959,11 @@ game_position_make_move (const GamePosition *const gp,
   const Board *b = gp->board;
   const SquareSet p_bit_board = board_get_player(b, p);
   const SquareSet o_bit_board = board_get_player(b, o);
-  const int column = move % 8;
-  const int row = move / 8;
+  const SquareSet flips = flips_fn(p_bit_board, o_bit_board, move);
 
   SquareSet new_bit_board[2];
-  const SquareSet unmodified_mask = ~bitboard_mask_for_all_directions[move];
-  new_bit_board[p] = p_bit_board & unmodified_mask;
-  new_bit_board[o] = o_bit_board & unmodified_mask;
-
-  /*
-  for (Axis axis = HO; axis <= DU; axis++) {
-    const int move_ordinal_position = axis_move_ordinal_position_in_bitrow(axis, column, row);
-    const int shift_distance = axis_shift_distance(axis, column, row);
-    uint8_t p_bitrow = axis_transform_to_row_one(axis, bit_works_signed_left_shift(p_bit_board, shift_distance));
-    uint8_t o_bitrow = axis_transform_to_row_one(axis, bit_works_signed_left_shift(o_bit_board, shift_distance));
-    p_bitrow = board_bitrow_changes_for_player(p_bitrow, o_bitrow, move_ordinal_position);
-    o_bitrow &= ~p_bitrow;
-    new_bit_board[p] |= bit_works_signed_left_shift(axis_transform_back_from_row_one(axis, p_bitrow), -shift_distance);
-    new_bit_board[o] |= bit_works_signed_left_shift(axis_transform_back_from_row_one(axis, o_bitrow), -shift_distance);
-  }
-  */
-
-  int shift_distance;
-  uint8_t p_bitrow;
-  uint8_t o_bitrow;
-
-  /* Axis HO. */
-  const uint8_t right_shift_for_HO = 8 * row;
-  p_bitrow = axis_transform_to_row_one(HO, p_bit_board >> right_shift_for_HO);
-  o_bitrow = axis_transform_to_row_one(HO, o_bit_board >> right_shift_for_HO);
-  p_bitrow = board_bitrow_changes_for_player(p_bitrow, o_bitrow, column);
-  o_bitrow &= ~p_bitrow;
-  new_bit_board[p] |= ((SquareSet) p_bitrow << right_shift_for_HO);
-  new_bit_board[o] |= ((SquareSet) o_bitrow << right_shift_for_HO);
-
-  /* Axis VE. */
-  p_bitrow = axis_transform_to_row_one(VE, p_bit_board >> column);
-  o_bitrow = axis_transform_to_row_one(VE, o_bit_board >> column);
-  p_bitrow = board_bitrow_changes_for_player(p_bitrow, o_bitrow, row);
-  o_bitrow &= ~p_bitrow;
-  new_bit_board[p] |= axis_transform_back_from_row_one(VE, p_bitrow) << column;
-  new_bit_board[o] |= axis_transform_back_from_row_one(VE, o_bitrow) << column;
-
-  /* Axis DD. */
-  shift_distance = axis_shift_distance(DD, column, row);
-  p_bitrow = axis_transform_to_row_one(DD, bit_works_signed_left_shift(p_bit_board, shift_distance));
-  o_bitrow = axis_transform_to_row_one(DD, bit_works_signed_left_shift(o_bit_board, shift_distance));
-  p_bitrow = board_bitrow_changes_for_player(p_bitrow, o_bitrow, column);
-  o_bitrow &= ~p_bitrow;
-  new_bit_board[p] |= bit_works_signed_left_shift(axis_transform_back_from_row_one(DD, p_bitrow), -shift_distance);
-  new_bit_board[o] |= bit_works_signed_left_shift(axis_transform_back_from_row_one(DD, o_bitrow), -shift_distance);
-
-  /* Axis DU. */
-  shift_distance = axis_shift_distance(DU, column, row);
-  p_bitrow = axis_transform_to_row_one(DU, bit_works_signed_left_shift(p_bit_board, shift_distance));
-  o_bitrow = axis_transform_to_row_one(DU, bit_works_signed_left_shift(o_bit_board, shift_distance));
-  p_bitrow = board_bitrow_changes_for_player(p_bitrow, o_bitrow, column);
-  o_bitrow &= ~p_bitrow;
-  new_bit_board[p] |= bit_works_signed_left_shift(axis_transform_back_from_row_one(DU, p_bitrow), -shift_distance);
-  new_bit_board[o] |= bit_works_signed_left_shift(axis_transform_back_from_row_one(DU, o_bitrow), -shift_distance);
+  new_bit_board[p] = p_bit_board | flips | ((SquareSet) 1 << move);
+  new_bit_board[o] = o_bit_board & ~flips;
 
   return game_position_new(board_new(new_bit_board[0], new_bit_board[1]), o);
 }
@@ -1882,16 +3002,7 @@ game_position_hash (const GamePosition *const gp)
   const SquareSet blacks = gp->board->blacks;
   const Player p = gp->player;
 
-  uint64_t hash = 0;
-
-  for (int i = 0; i < 64; i++) {
-    const uint64_t mask = (uint64_t) 1 << i;
-    if (blacks & mask) hash ^= zobrist_bitstrings[i];
-    if (whites & mask) hash ^= zobrist_bitstrings[i + 64];
-  }
-  if (p) hash = ~hash; /* In this way passing doesn't require a full new hash. */
-
-  return hash;
+  return square_sets_zobrist_hash(blacks, whites, p);
 }
 
 /**
@@ -2096,6 +3207,8 @@ game_position_x_pass  (const GamePositionX *const current,
  * @brief Returns the hash value for the game position x.
  *
  * The hash is computed by mean of a zobrist technique.
+ * Search algorithms should rather maintain the value by calling #game_position_x_delta_hash
+ * when moving from one position to the next.
  *
  * @param [in] gpx the current game position
  * @return         the hash value for the game position
@@ -2107,16 +3220,46 @@ game_position_x_hash (const GamePositionX *const gpx)
   const SquareSet blacks = gpx->blacks;
   const Player p = gpx->player;
 
-  uint64_t hash = 0;
+  return square_sets_zobrist_hash(blacks, whites, p);
+}
 
-  for (int i = 0; i < 64; i++) {
-    const uint64_t mask = (uint64_t) 1 << i;
-    if (blacks & mask) hash ^= zobrist_bitstrings[i];
-    if (whites & mask) hash ^= zobrist_bitstrings[i + 64];
+/**
+ * @brief Returns the hash value of the game position reached by a move, given
+ * the hash of the position where the move is played.
+ *
+ * @details The hash value is updated incrementally, a few XOR operations
+ * are executed for the placed disc and for each one of the flipped discs.
+ * Changing the player to move complements the value, following the convention
+ * used by #game_position_x_hash, so the hash after a pass is simply `~hash`.
+ *
+ * Given `gpx` and `next`, being the position after the move, the invariant is:
+ * `game_position_x_hash(next) == game_position_x_delta_hash(game_position_x_hash(gpx), flips, move, gpx->player)`.
+ *
+ * @invariant Parameter `move` must belong to the #Square enum.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] hash   the hash value of the game position before the move
+ * @param [in] flips  the discs flipped by the move, as returned by #game_position_x_do_move
+ * @param [in] move   the square where the disc has been placed
+ * @param [in] player the player that has moved
+ * @return            the hash value of the game position after the move
+ */
+uint64_t
+game_position_x_delta_hash (const uint64_t hash,
+                            const SquareSet flips,
+                            const Square move,
+                            const Player player)
+{
+  g_assert(square_belongs_to_enum_set(move));
+
+  uint64_t h = hash ^ zobrist_bitstrings[move + 64 * player];
+  SquareSet remaining = flips;
+  while (remaining) {
+    const int sq = bit_works_bitscanLS1B_64(remaining);
+    h ^= zobrist_bitstrings[sq] ^ zobrist_bitstrings[sq + 64];
+    remaining &= remaining - 1;
   }
-  if (p) hash = ~hash; /* In this way passing doesn't require a full new hash. */
-
-  return hash;
+  return ~h;
 }
 
 /**
@@ -2199,25 +3342,44 @@ game_position_x_get_square (const GamePositionX *const gpx,
 SquareSet
 game_position_x_legal_moves (const GamePositionX *const gpx)
 {
-  SquareSet result = empty_square_set;
-
-  const SquareSet empties = game_position_x_empties(gpx);
   const SquareSet p_bit_board = game_position_x_get_player(gpx);
   const SquareSet o_bit_board = game_position_x_get_opponent(gpx);
 
-  for (Direction dir = NW; dir <= SE; dir++) {
-    const Direction opposite = direction_opposite(dir);
-    SquareSet wave = direction_shift_square_set(dir, empties) & o_bit_board;
-    int shift = 1;
-    while (wave != empty_square_set) {
-      wave = direction_shift_square_set(dir, wave);
-      shift++;
-      result |= direction_shift_back_square_set_by_amount(opposite, (wave & p_bit_board), shift);
-      wave &= o_bit_board;
-    }
-  }
+  return legal_moves_fn(p_bit_board, o_bit_board);
+}
 
-  return result;
+/**
+ * @brief Computes the legal moves for many positions at once.
+ *
+ * @details Positions are given in a structure of arrays layout: the entry `i` of `p_bit_boards`
+ * holds the discs of the player having to move in the position `i`, the same entry of
+ * `o_bit_boards` holds the opponent ones. The legal moves of position `i` are assigned to
+ * `legal_moves[i]`, and when `mobility` is not `NULL` their count to `mobility[i]`.
+ *
+ * Positions are processed by vector units when available, see #legal_moves_batch_backend_set.
+ * Arrays don't have alignment requirements.
+ *
+ * @invariant Parameter `count` must be not negative.
+ * Parameters `p_bit_boards`, `o_bit_boards`, and `legal_moves` must be not `NULL`.
+ * Invariants are guarded by assertions.
+ *
+ * @param [in]  count        the number of positions
+ * @param [in]  p_bit_boards the squares of the player having to move, one entry for each position
+ * @param [in]  o_bit_boards the squares of the opponent, one entry for each position
+ * @param [out] legal_moves  the legal moves, one entry for each position
+ * @param [out] mobility     if not `NULL`, the count of legal moves, one entry for each position
+ */
+void
+game_position_x_legal_moves_batch (const int count,
+                                   const SquareSet *const p_bit_boards,
+                                   const SquareSet *const o_bit_boards,
+                                   SquareSet *const legal_moves,
+                                   int *const mobility)
+{
+  g_assert(count >= 0);
+  g_assert(p_bit_boards && o_bit_boards && legal_moves);
+
+  legal_moves_batch_fn(count, p_bit_boards, o_bit_boards, legal_moves, mobility);
 }
 
 /**
@@ -2358,6 +3520,20 @@ game_position_x_final_value (const GamePositionX *const gpx)
   return (gpx->player == BLACK_PLAYER) ? +delta : -delta;
 }
 
+/**
+ * @brief Returns the set of discs, of both colors, that cannot be flipped for the rest of the game.
+ *
+ * @details See #board_stable_discs.
+ *
+ * @param [in] gpx a pointer to the game position x structure
+ * @return         the set of stable discs
+ */
+SquareSet
+game_position_x_stable_discs (const GamePositionX *const gpx)
+{
+  return square_sets_stable_discs(gpx->blacks, gpx->whites);
+}
+
 /**
  * @brief Returns a formatted string showing a 2d graphical represention of the game position x.
  *
@@ -2411,31 +3587,10 @@ game_position_x_has_any_player_any_legal_move (const GamePositionX *const gpx)
 {
   g_assert(gpx);
 
-  const SquareSet empties = game_position_x_empties(gpx);
   const SquareSet blacks = gpx->blacks;
   const SquareSet whites = gpx->whites;
 
-  for (Direction dir = NW; dir <= SE; dir++) {
-    SquareSet wave;
-    int shift;
-    wave = direction_shift_square_set(dir, empties) & whites;
-    shift = 1;
-    while (wave != empty_square_set) {
-      wave = direction_shift_square_set(dir, wave);
-      shift++;
-      if ((wave & blacks) != empty_square_set) return TRUE;
-      wave &= whites;
-    }
-    wave = direction_shift_square_set(dir, empties) & blacks;
-    shift = 1;
-    while (wave != empty_square_set) {
-      wave = direction_shift_square_set(dir, wave);
-      shift++;
-      if ((wave & whites) != empty_square_set) return TRUE;
-      wave &= blacks;
-    }
-  }
-  return FALSE;
+  return (legal_moves_fn(blacks, whites) | legal_moves_fn(whites, blacks)) ? TRUE : FALSE;
 }
 
 /**
@@ -2464,6 +3619,31 @@ game_position_x_is_move_legal (const GamePositionX *const gpx,
   return board_is_move_legal(&board, move, gpx->player);
 }
 
+/**
+ * @brief Returns the set of opponent discs flipped when the player places a disc in the `move` square.
+ *
+ * @details When the move is not legal the returned set is empty.
+ *
+ * @invariant Parameter `gpx` must be not `NULL`.
+ * Parameter `move` must belong to the #Square enum.
+ * Parameter `move` must be an empty square.
+ * Invariants are guarded by assertions.
+ *
+ * @param [in] gpx  the given game position x
+ * @param [in] move the square where the player puts the new disc
+ * @return          the flipped discs
+ */
+SquareSet
+game_position_x_flips (const GamePositionX *const gpx,
+                       const Square move)
+{
+  g_assert(gpx);
+  g_assert(square_belongs_to_enum_set(move));
+  g_assert(!(((SquareSet) 1 << move) & (gpx->blacks | gpx->whites)));
+
+  return flips_fn(game_position_x_get_player(gpx), game_position_x_get_opponent(gpx), move);
+}
+
 /**
  * @brief Executes a game move.
  *
@@ -2499,56 +3679,13 @@ game_position_x_make_move (const GamePositionX *const current,
 
   const Player p = current->player;
   const Player o = player_opponent(p);
-  const SquareSet blacks = current->blacks;
-  const SquareSet whites = current->whites;
-  const SquareSet p_bit_board = (p == BLACK_PLAYER) ? blacks : whites;
-  const SquareSet o_bit_board = (p == BLACK_PLAYER) ? whites : blacks;
-  const int column = move % 8;
-  const int row = move / 8;
+  const SquareSet p_bit_board = (p == BLACK_PLAYER) ? current->blacks : current->whites;
+  const SquareSet o_bit_board = (p == BLACK_PLAYER) ? current->whites : current->blacks;
+  const SquareSet flips = flips_fn(p_bit_board, o_bit_board, move);
 
   SquareSet new_bit_board[2];
-  const SquareSet unmodified_mask = ~bitboard_mask_for_all_directions[move];
-  new_bit_board[p] = p_bit_board & unmodified_mask;
-  new_bit_board[o] = o_bit_board & unmodified_mask;
-
-  int shift_distance;
-  uint8_t p_bitrow;
-  uint8_t o_bitrow;
-
-  /* Axis HO. */
-  const uint8_t right_shift_for_HO = 8 * row;
-  p_bitrow = axis_transform_to_row_one(HO, p_bit_board >> right_shift_for_HO);
-  o_bitrow = axis_transform_to_row_one(HO, o_bit_board >> right_shift_for_HO);
-  p_bitrow = board_bitrow_changes_for_player(p_bitrow, o_bitrow, column);
-  o_bitrow &= ~p_bitrow;
-  new_bit_board[p] |= ((SquareSet) p_bitrow << right_shift_for_HO);
-  new_bit_board[o] |= ((SquareSet) o_bitrow << right_shift_for_HO);
-
-  /* Axis VE. */
-  p_bitrow = axis_transform_to_row_one(VE, p_bit_board >> column);
-  o_bitrow = axis_transform_to_row_one(VE, o_bit_board >> column);
-  p_bitrow = board_bitrow_changes_for_player(p_bitrow, o_bitrow, row);
-  o_bitrow &= ~p_bitrow;
-  new_bit_board[p] |= axis_transform_back_from_row_one(VE, p_bitrow) << column;
-  new_bit_board[o] |= axis_transform_back_from_row_one(VE, o_bitrow) << column;
-
-  /* Axis DD. */
-  shift_distance = axis_shift_distance(DD, column, row);
-  p_bitrow = axis_transform_to_row_one(DD, bit_works_signed_left_shift(p_bit_board, shift_distance));
-  o_bitrow = axis_transform_to_row_one(DD, bit_works_signed_left_shift(o_bit_board, shift_distance));
-  p_bitrow = board_bitrow_changes_for_player(p_bitrow, o_bitrow, column);
-  o_bitrow &= ~p_bitrow;
-  new_bit_board[p] |= bit_works_signed_left_shift(axis_transform_back_from_row_one(DD, p_bitrow), -shift_distance);
-  new_bit_board[o] |= bit_works_signed_left_shift(axis_transform_back_from_row_one(DD, o_bitrow), -shift_distance);
-
-  /* Axis DU. */
-  shift_distance = axis_shift_distance(DU, column, row);
-  p_bitrow = axis_transform_to_row_one(DU, bit_works_signed_left_shift(p_bit_board, shift_distance));
-  o_bitrow = axis_transform_to_row_one(DU, bit_works_signed_left_shift(o_bit_board, shift_distance));
-  p_bitrow = board_bitrow_changes_for_player(p_bitrow, o_bitrow, column);
-  o_bitrow &= ~p_bitrow;
-  new_bit_board[p] |= bit_works_signed_left_shift(axis_transform_back_from_row_one(DU, p_bitrow), -shift_distance);
-  new_bit_board[o] |= bit_works_signed_left_shift(axis_transform_back_from_row_one(DU, o_bitrow), -shift_distance);
+  new_bit_board[p] = p_bit_board | flips | ((SquareSet) 1 << move);
+  new_bit_board[o] = o_bit_board & ~flips;
 
   updated->player = o;
   updated->blacks = new_bit_board[0];
@@ -2556,101 +3693,197 @@ game_position_x_make_move (const GamePositionX *const current,
   return;
 }
 
+/**
+ * @brief Executes a game move updating the game position in place.
+ *
+ * @details The moving player places a disc in the square identified by the `move` parameter,
+ *          the flipped discs are returned so that the move can be taken back by calling
+ *          #game_position_x_undo_move.
+ *          The function doesn't allocate memory and doesn't copy the game position, it is
+ *          meant to be used by search algorithms keeping one position for each thread.
+ *
+ * @invariant Parameter `gpx` must be not `NULL`.
+ * Parameter `move` must belong to the #Square enum.
+ * Parameter `move` must be legal.
+ * Invariants are guarded by assertions.
+ *
+ * @param [in,out] gpx  the game position x to update
+ * @param [in]     move the square where to put the new disk
+ * @return              the flipped discs
+ */
+SquareSet
+game_position_x_do_move (GamePositionX *const gpx,
+                         const Square move)
+{
+  g_assert(gpx);
+  g_assert(square_belongs_to_enum_set(move));
+
+  const SquareSet move_bit = (SquareSet) 1 << move;
+  g_assert(!(move_bit & (gpx->blacks | gpx->whites)));
+
+  if (gpx->player == BLACK_PLAYER) {
+    const SquareSet flips = flips_fn(gpx->blacks, gpx->whites, move);
+    g_assert(flips);
+    gpx->blacks |= flips | move_bit;
+    gpx->whites ^= flips;
+    gpx->player = WHITE_PLAYER;
+    return flips;
+  } else {
+    const SquareSet flips = flips_fn(gpx->whites, gpx->blacks, move);
+    g_assert(flips);
+    gpx->whites |= flips | move_bit;
+    gpx->blacks ^= flips;
+    gpx->player = BLACK_PLAYER;
+    return flips;
+  }
+}
 
 /**
- * @cond
+ * @brief Takes back the move executed by #game_position_x_do_move.
+ *
+ * @details Parameters `move` and `flips` must be the ones used and returned by the call
+ *          to #game_position_x_do_move being reverted.
+ *
+ * @invariant Parameter `gpx` must be not `NULL`.
+ * Parameter `move` must belong to the #Square enum.
+ * Invariants are guarded by assertions.
+ *
+ * @param [in,out] gpx   the game position x to restore
+ * @param [in]     move  the move to take back
+ * @param [in]     flips the discs flipped by the move
  */
+void
+game_position_x_undo_move (GamePositionX *const gpx,
+                           const Square move,
+                           const SquareSet flips)
+{
+  g_assert(gpx);
+  g_assert(square_belongs_to_enum_set(move));
 
-/*
- * Internal functions.
+  const SquareSet move_bit = (SquareSet) 1 << move;
+
+  if (gpx->player == WHITE_PLAYER) {
+    g_assert(((flips | move_bit) & gpx->blacks) == (flips | move_bit));
+    gpx->blacks ^= flips | move_bit;
+    gpx->whites |= flips;
+    gpx->player = BLACK_PLAYER;
+  } else {
+    g_assert(((flips | move_bit) & gpx->whites) == (flips | move_bit));
+    gpx->whites ^= flips | move_bit;
+    gpx->blacks |= flips;
+    gpx->player = WHITE_PLAYER;
+  }
+}
+
+/**
+ * @brief Passes the move updating the game position in place.
+ *
+ * The function doesn't check that the current player has to pass.
+ *
+ * @invariant Parameter `gpx` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] gpx the game position x to update
  */
+void
+game_position_x_do_pass (GamePositionX *const gpx)
+{
+  g_assert(gpx);
 
-/*
- * Used to initialize the `bitrow_changes_for_player_array`.
+  gpx->player = player_opponent(gpx->player);
+}
+
+/**
+ * @brief Takes back the pass executed by #game_position_x_do_pass.
  *
- * array a uint8_t array having the row changes for the given index value
+ * @invariant Parameter `gpx` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] gpx the game position x to restore
  */
-static void
-board_initialize_bitrow_changes_for_player_array (uint8_t *array)
-{
-  for (int player_row_count = 0; player_row_count < 256; player_row_count++) {
-    const uint8_t player_row = (uint8_t) player_row_count;
-    for (int opponent_row_count = 0; opponent_row_count < 256; opponent_row_count++) {
-      const uint8_t opponent_row = (uint8_t) opponent_row_count;
-      const uint8_t filled_in_row = player_row | opponent_row;
-      const uint8_t empties_in_row = ~filled_in_row;
-      for (uint8_t move_position = 0; move_position < 8; move_position++) {
-        const uint8_t move = 1 << move_position;
-        const int array_index = player_row
-                                | (opponent_row << 8)
-                                | (move_position << 16);
-
-        uint8_t player_row_after_move;
-
-        /*
-         * It checks two conditions that cannot happen because are illegal.
-         * First player and opponent cannot have overlapping discs.
-         * Second the move cannot overlap existing discs.
-         * When either one of the two condition applies the result is set being equal
-         * to the player row index. Otherwise when black and white do not overlap,
-         * and the move is on an empy square it procede with the else block.
-         */
-        if (((player_row & opponent_row) != 0) || ((move & filled_in_row) != 0)) {
-          player_row_after_move = player_row;
-        } else {
-
-          /* The square of the move is added to the player configuration of the row after the move. */
-          player_row_after_move = player_row | move;
-
-          /*
-           * The potential bracketing disc on the right is the first player disc found moving
-           * on the left starting from the square of the move.
-           */
-          const uint8_t potential_bracketing_disc_on_the_left = bit_works_highest_bit_set_8(player_row & (move - 1));
-
-          /*
-           * The left rank is the sequence of adiacent discs that start from the bracketing disc and end
-           * with the move disc.
-           */
-          const uint8_t left_rank = bit_works_fill_in_between(potential_bracketing_disc_on_the_left | move);
-
-          /*
-           * If the rank contains empy squares, this is a fake flip, and it doesn't do anything.
-           * If the rank is full, it cannot be full of anything different than opponent discs, so
-           * it adds the discs to the after move player configuration.
-           */
-          if ((left_rank & empties_in_row) == 0x00) {
-            player_row_after_move |= left_rank;
-          }
-
-          /* Here it does the same procedure computed on the left also on the right. */
-          const uint8_t potential_bracketing_disc_on_the_right = bit_works_lowest_bit_set_8(player_row & ~(move - 1));
-          const uint8_t right_rank = bit_works_fill_in_between(potential_bracketing_disc_on_the_right | move);
-          if ((right_rank & empties_in_row) == 0x00) {
-            player_row_after_move |= right_rank;
-          }
-
-          /*
-           * It checks that the after move configuration is different from
-           * the starting one for the player.
-           * This case can happen because it never checked that
-           * the bracketing piece was not adjacent to the move disc,
-           * on such a case, on both side, the move is illegal, and it is recorded setting
-           * the result configuation appropriately.
-           */
-          if (player_row_after_move == (player_row | move)) {
-            player_row_after_move = player_row;
-          }
-        }
+void
+game_position_x_undo_pass (GamePositionX *const gpx)
+{
+  g_assert(gpx);
 
-        /* Assigns the computed player row to the proper array position. */
-        array[array_index] = player_row_after_move;
+  gpx->player = player_opponent(gpx->player);
+}
 
-      }
+/**
+ * @brief Applies the board transformation to the game position.
+ *
+ * @details The player to move is not changed. `gpx` and `transformed` may be the same structure.
+ *
+ * @invariant Parameters `gpx` and `transformed` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in]  gpx         the game position to transform
+ * @param [in]  bt          the board transformation
+ * @param [out] transformed the transformed game position
+ */
+void
+game_position_x_transform (const GamePositionX *const gpx,
+                           const BoardTransformation bt,
+                           GamePositionX *const transformed)
+{
+  g_assert(gpx);
+  g_assert(transformed);
+
+  const SquareSet blacks = square_set_transform(gpx->blacks, bt);
+  const SquareSet whites = square_set_transform(gpx->whites, bt);
+  transformed->blacks = blacks;
+  transformed->whites = whites;
+  transformed->player = gpx->player;
+}
+
+/**
+ * @brief Computes the canonical form of the game position, being the minimum,
+ * as ordered by #game_position_x_compare, among its eight symmetric positions.
+ *
+ * @details Symmetric positions share the canonical form, so it can be used as the key of
+ * position caches and databases. The returned transformation maps `gpx` to `canonical`.
+ * Moves are mapped to the canonical position by calling #square_transform with the returned value,
+ * and moves of the canonical position are mapped back by means of its inverse,
+ * see #board_transformation_inverse.
+ * When more transformations give the canonical form, the first one in the enum order is returned.
+ *
+ * @invariant Parameters `gpx` and `canonical` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in]  gpx       the game position
+ * @param [out] canonical the canonical game position
+ * @return                the transformation mapping the game position to the canonical one
+ */
+BoardTransformation
+game_position_x_canonical (const GamePositionX *const gpx,
+                           GamePositionX *const canonical)
+{
+  g_assert(gpx);
+  g_assert(canonical);
+
+  BoardTransformation result = BOARD_TRANSFORMATION_IDENTITY;
+  GamePositionX best = *gpx;
+  for (BoardTransformation bt = BOARD_TRANSFORMATION_ROTATE_90_CLOCKWISE; bt <= BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8; bt++) {
+    GamePositionX candidate;
+    game_position_x_transform(gpx, bt, &candidate);
+    if (game_position_x_compare(&candidate, &best) < 0) {
+      best = candidate;
+      result = bt;
     }
   }
+  *canonical = best;
+  return result;
 }
 
+
+/**
+ * @cond
+ */
+
+/*
+ * Internal functions.
+ */
+
 /*
  * @brief Used to initialize the `shift_square_set_by_amount_mask_array`.
  *
@@ -2673,6 +3906,190 @@ board_initialize_shift_square_set_by_amount_mask_array (SquareSet *array)
   }
 }
 
+/*
+ * Returns the edge configuration reached when `mover` plays on the empty square `x`,
+ * flipping the bracketed `other` discs along the edge. Moves are not required to flip.
+ */
+static void
+edge_play (int *const mover,
+           int *const other,
+           const int x)
+{
+  int y, run;
+  *mover |= 1 << x;
+  for (y = x - 1, run = 0; y >= 0 && (*other & (1 << y)); y--) run |= 1 << y;
+  if (y >= 0 && (*mover & (1 << y))) { *mover |= run; *other &= ~run; }
+  for (y = x + 1, run = 0; y < 8 && (*other & (1 << y)); y++) run |= 1 << y;
+  if (y < 8 && (*mover & (1 << y))) { *mover |= run; *other &= ~run; }
+}
+
+/*
+ * @brief Used to initialize the `bitrow_to_base_three` and `edge_stability_array` arrays.
+ *
+ * A player disc is stable when it keeps its color in every configuration reachable by filling
+ * the empty squares, in any order and by any of the two colors.
+ * Configurations are computed from the full edges down to the empty one, so the entries of the
+ * configurations reached by one more move are always available.
+ */
+static void
+board_initialize_edge_stability_array (void)
+{
+  for (int row = 0; row < 256; row++) {
+    int value = 0;
+    for (int i = 7; i >= 0; i--) value = 3 * value + ((row >> i) & 1);
+    bitrow_to_base_three[row] = value;
+  }
+  for (int filled_count = 8; filled_count >= 0; filled_count--) {
+    for (int p_row = 0; p_row < 256; p_row++) {
+      for (int o_row = 0; o_row < 256; o_row++) {
+        if ((p_row & o_row) || bit_works_popcount(p_row | o_row) != filled_count) continue;
+        const int empties = ~(p_row | o_row) & 0xFF;
+        int stable = p_row;
+        for (int x = 0; x < 8 && stable; x++) {
+          if (!(empties & (1 << x))) continue;
+          int p = p_row, o = o_row;
+          edge_play(&p, &o, x);
+          stable &= edge_stability_array[bitrow_to_base_three[p] + 2 * bitrow_to_base_three[o]];
+          p = p_row, o = o_row;
+          edge_play(&o, &p, x);
+          stable &= edge_stability_array[bitrow_to_base_three[p] + 2 * bitrow_to_base_three[o]];
+        }
+        edge_stability_array[bitrow_to_base_three[p_row] + 2 * bitrow_to_base_three[o_row]] = stable;
+      }
+    }
+  }
+}
+
+/*
+ * Returns the bitrow collecting the squares of column A, A1 being the lowest bit.
+ */
+static BOARD_ALWAYS_INLINE int
+square_set_pack_column_a (const SquareSet squares)
+{
+  return ((squares & column_a) * 0x0102040810204080) >> 56;
+}
+
+/*
+ * Returns the bitrow collecting the squares of column H, H1 being the lowest bit.
+ */
+static BOARD_ALWAYS_INLINE int
+square_set_pack_column_h (const SquareSet squares)
+{
+  return ((squares & 0x8080808080808080) * 0x0002040810204081) >> 56;
+}
+
+/*
+ * Returns the square set having in column A the squares of the bitrow, A1 being the lowest bit.
+ * The byte is replicated on every row, each row keeps its own bit, that is then moved by the carry.
+ */
+static BOARD_ALWAYS_INLINE SquareSet
+square_set_unpack_column_a (const int bitrow)
+{
+  SquareSet s = (SquareSet) bitrow * 0x0101010101010101;
+  s &= 0x8040201008040201;
+  s += 0x7F7F7F7F7F7F7F7F;
+  return (s >> 7) & column_a;
+}
+
+/*
+ * Returns the stable discs of the player lying on the four edges.
+ */
+static BOARD_ALWAYS_INLINE SquareSet
+square_sets_edge_stable_discs (const SquareSet p,
+                               const SquareSet o)
+{
+#define EDGE_STABILITY(P_ROW, O_ROW) edge_stability_array[bitrow_to_base_three[P_ROW] + 2 * bitrow_to_base_three[O_ROW]]
+  const SquareSet row_1 = EDGE_STABILITY(p & 0xFF, o & 0xFF);
+  const SquareSet row_8 = EDGE_STABILITY(p >> 56, o >> 56);
+  const int col_a = EDGE_STABILITY(square_set_pack_column_a(p), square_set_pack_column_a(o));
+  const int col_h = EDGE_STABILITY(square_set_pack_column_h(p), square_set_pack_column_h(o));
+#undef EDGE_STABILITY
+  return row_1 | (row_8 << 56) | square_set_unpack_column_a(col_a) | (square_set_unpack_column_a(col_h) << 7);
+}
+
+/*
+ * Returns the squares from which all the squares along the direction, up to the board edge, are filled.
+ * The direction moves by `shift` toward the higher squares when `up` is true, toward the lower ones otherwise.
+ * The `edge` set has the squares being the last ones of their line along the direction.
+ *
+ * After step k, `f` has the squares filled for 2^k squares along the line or up to the edge,
+ * and `e` the squares being closer than 2^k squares to the edge.
+ */
+static BOARD_ALWAYS_INLINE SquareSet
+square_set_filled_to_edge (const SquareSet filled,
+                           const SquareSet edge,
+                           const int shift,
+                           const gboolean up)
+{
+  SquareSet f = filled;
+  SquareSet e = edge;
+  for (int amount = shift; amount < 8 * shift; amount *= 2) {
+    if (up) {
+      f &= e | (f >> amount);
+      e |= e >> amount;
+    } else {
+      f &= e | (f << amount);
+      e |= e << amount;
+    }
+  }
+  return f;
+}
+
+/*
+ * Stable discs, see board_stable_discs.
+ */
+static SquareSet
+square_sets_stable_discs (const SquareSet blacks,
+                          const SquareSet whites)
+{
+  const SquareSet inner_squares = 0x007E7E7E7E7E7E00;
+  const SquareSet filled = blacks | whites;
+
+  /* Rows: the AND of the row is collected in column A, and then spread back. */
+  SquareSet f = filled;
+  f &= f >> 1;
+  f &= f >> 2;
+  f &= f >> 4;
+  const SquareSet full_h = (f & column_a) * 0xFF;
+
+  /* Columns: rotations keep the column, after three steps each square has the AND of its column. */
+  f = filled;
+  f &= (f >> 8) | (f << 56);
+  f &= (f >> 16) | (f << 48);
+  f &= (f >> 32) | (f << 32);
+  const SquareSet full_v = f;
+
+  /* Diagonals: each direction is filled up to the board edge, by doubling steps, see square_set_filled_to_edge. */
+  const SquareSet full_d9 = square_set_filled_to_edge(filled, 0xFF80808080808080, 9, TRUE) &
+    square_set_filled_to_edge(filled, 0x01010101010101FF, 9, FALSE);
+  const SquareSet full_d7 = square_set_filled_to_edge(filled, 0xFF01010101010101, 7, TRUE) &
+    square_set_filled_to_edge(filled, 0x80808080808080FF, 7, FALSE);
+
+  const SquareSet full = full_h & full_v & full_d9 & full_d7;
+
+  SquareSet result = empty_square_set;
+  for (int color = 0; color < 2; color++) {
+    const SquareSet p = (color == 0) ? blacks : whites;
+    const SquareSet o = (color == 0) ? whites : blacks;
+    SquareSet stable = square_sets_edge_stable_discs(p, o) | (full & p);
+    const SquareSet candidates = p & inner_squares & ~stable;
+    if (candidates) {
+      SquareSet previous;
+      do {
+        previous = stable;
+        const SquareSet stable_h = (stable >> 1) | (stable << 1) | full_h;
+        const SquareSet stable_v = (stable >> 8) | (stable << 8) | full_v;
+        const SquareSet stable_d9 = (stable >> 9) | (stable << 9) | full_d9;
+        const SquareSet stable_d7 = (stable >> 7) | (stable << 7) | full_d7;
+        stable |= stable_h & stable_v & stable_d9 & stable_d7 & candidates;
+      } while (stable != previous);
+    }
+    result |= stable;
+  }
+
+  return result;
+}
+
 /*
  * @brief Returns a new #SquareSet value by shifting back the `squares` parameter
  * by a number of positions as given by the `amount` parameter.
@@ -2712,6 +4129,646 @@ direction_shift_back_square_set_by_amount (const Direction dir,
   }
 }
 
+/*
+ * The reference legal move generator.
+ *
+ * Implements the legal moves call by waveing the potential legal moves up to the bracketing
+ * pieces. Directions are computed one by one, squares work in parallel.
+ * The number of iterations of the inner loop depends on the length of the opponent runs,
+ * so branches are hard to predict.
+ */
+static SquareSet
+legal_moves_wave (const SquareSet p_bit_board,
+                  const SquareSet o_bit_board)
+{
+  SquareSet result = empty_square_set;
+
+  const SquareSet empties = ~(p_bit_board | o_bit_board);
+
+  for (Direction dir = NW; dir <= SE; dir++) {
+    const Direction opposite = direction_opposite(dir);
+    SquareSet wave = direction_shift_square_set(dir, empties) & o_bit_board;
+    int shift = 1;
+    while (wave != empty_square_set) {
+      wave = direction_shift_square_set(dir, wave);
+      shift++;
+      result |= direction_shift_back_square_set_by_amount(opposite, (wave & p_bit_board), shift);
+      wave &= o_bit_board;
+    }
+  }
+
+  return result;
+}
+
+/*
+ * Kogge-Stone occluded fill toward the direction shifting left the bitboard by `shift`.
+ *
+ * The generator is the set of opponent discs adjacent to the player ones, the propagator
+ * is the set of opponent discs. Three steps fill runs up to six squares long.
+ * The returned set is one square beyond the runs, it has to be masked with the empties.
+ */
+static inline SquareSet
+kogge_stone_left (const SquareSet p_bit_board,
+                  const SquareSet propagator,
+                  const int shift)
+{
+  SquareSet g = propagator & (p_bit_board << shift);
+  SquareSet p = propagator;
+  g |= p & (g << shift);
+  p &= p << shift;
+  g |= p & (g << (2 * shift));
+  p &= p << (2 * shift);
+  g |= p & (g << (4 * shift));
+  return g << shift;
+}
+
+/*
+ * Kogge-Stone occluded fill toward the direction shifting right the bitboard by `shift`.
+ */
+static inline SquareSet
+kogge_stone_right (const SquareSet p_bit_board,
+                   const SquareSet propagator,
+                   const int shift)
+{
+  SquareSet g = propagator & (p_bit_board >> shift);
+  SquareSet p = propagator;
+  g |= p & (g >> shift);
+  p &= p >> shift;
+  g |= p & (g >> (2 * shift));
+  p &= p >> (2 * shift);
+  g |= p & (g >> (4 * shift));
+  return g >> shift;
+}
+
+/*
+ * Branch-free legal move generator.
+ *
+ * Opponent discs on columns A and H are removed from the propagator for the directions
+ * having an horizontal component, this prevents the fill from wrapping around the board.
+ */
+static SquareSet
+legal_moves_kogge_stone (const SquareSet p_bit_board,
+                         const SquareSet o_bit_board)
+{
+  const SquareSet empties = ~(p_bit_board | o_bit_board);
+  const SquareSet o_inner = o_bit_board & all_squares_except_columns_a_and_h;
+
+  SquareSet result;
+
+  result  = kogge_stone_left(p_bit_board, o_inner, 1);      /* E  */
+  result |= kogge_stone_right(p_bit_board, o_inner, 1);     /* W  */
+  result |= kogge_stone_left(p_bit_board, o_bit_board, 8);  /* S  */
+  result |= kogge_stone_right(p_bit_board, o_bit_board, 8); /* N  */
+  result |= kogge_stone_left(p_bit_board, o_inner, 7);      /* SW */
+  result |= kogge_stone_right(p_bit_board, o_inner, 7);     /* NE */
+  result |= kogge_stone_left(p_bit_board, o_inner, 9);      /* SE */
+  result |= kogge_stone_right(p_bit_board, o_inner, 9);     /* NW */
+
+  return result & empties;
+}
+
+#ifdef BOARD_AVX2_SUPPORT
+/*
+ * AVX2 legal move generator.
+ *
+ * The four lanes of each vector hold the E, SW, S, SE directions when shifting left,
+ * and the W, NE, N, NW ones when shifting right.
+ * Variable shifts (vpsllvq, vpsrlvq) apply a different amount to each lane.
+ */
+__attribute__((target("avx2")))
+static SquareSet
+legal_moves_kogge_stone_avx2 (const SquareSet p_bit_board,
+                              const SquareSet o_bit_board)
+{
+  const __m256i shift_1 = _mm256_set_epi64x(9, 8, 7, 1);
+  const __m256i shift_2 = _mm256_set_epi64x(18, 16, 14, 2);
+  const __m256i shift_4 = _mm256_set_epi64x(36, 32, 28, 4);
+  const __m256i o_mask = _mm256_set_epi64x(all_squares_except_columns_a_and_h,
+                                           0xFFFFFFFFFFFFFFFF,
+                                           all_squares_except_columns_a_and_h,
+                                           all_squares_except_columns_a_and_h);
+
+  const __m256i p = _mm256_set1_epi64x(p_bit_board);
+  const __m256i o = _mm256_and_si256(_mm256_set1_epi64x(o_bit_board), o_mask);
+
+  __m256i gl, gr, pl, pr;
+
+  gl = _mm256_and_si256(o, _mm256_sllv_epi64(p, shift_1));
+  gr = _mm256_and_si256(o, _mm256_srlv_epi64(p, shift_1));
+
+  gl = _mm256_or_si256(gl, _mm256_and_si256(o, _mm256_sllv_epi64(gl, shift_1)));
+  gr = _mm256_or_si256(gr, _mm256_and_si256(o, _mm256_srlv_epi64(gr, shift_1)));
+  pl = _mm256_and_si256(o, _mm256_sllv_epi64(o, shift_1));
+  pr = _mm256_and_si256(o, _mm256_srlv_epi64(o, shift_1));
+
+  gl = _mm256_or_si256(gl, _mm256_and_si256(pl, _mm256_sllv_epi64(gl, shift_2)));
+  gr = _mm256_or_si256(gr, _mm256_and_si256(pr, _mm256_srlv_epi64(gr, shift_2)));
+  pl = _mm256_and_si256(pl, _mm256_sllv_epi64(pl, shift_2));
+  pr = _mm256_and_si256(pr, _mm256_srlv_epi64(pr, shift_2));
+
+  gl = _mm256_or_si256(gl, _mm256_and_si256(pl, _mm256_sllv_epi64(gl, shift_4)));
+  gr = _mm256_or_si256(gr, _mm256_and_si256(pr, _mm256_srlv_epi64(gr, shift_4)));
+
+  const __m256i m = _mm256_or_si256(_mm256_sllv_epi64(gl, shift_1), _mm256_srlv_epi64(gr, shift_1));
+  __m128i m2 = _mm_or_si128(_mm256_castsi256_si128(m), _mm256_extracti128_si256(m, 1));
+  m2 = _mm_or_si128(m2, _mm_unpackhi_epi64(m2, m2));
+
+  return (SquareSet) _mm_cvtsi128_si64(m2) & ~(p_bit_board | o_bit_board);
+}
+#endif
+
+/*
+ * Returns the count of squares in the set, by means of the popcnt instruction when available.
+ */
+static BOARD_ALWAYS_INLINE int
+square_set_count (const SquareSet squares)
+{
+#if defined(__GNUC__)
+  return __builtin_popcountll(squares);
+#else
+  return bit_works_popcount(squares);
+#endif
+}
+
+/*
+ * Batch legal moves, computed one position at a time.
+ * It also completes the positions left over by the vector implementations.
+ */
+static void
+legal_moves_batch_scalar (const int count,
+                          const SquareSet *const p_bit_boards,
+                          const SquareSet *const o_bit_boards,
+                          SquareSet *const legal_moves,
+                          int *const mobility)
+{
+  for (int i = 0; i < count; i++) {
+    legal_moves[i] = legal_moves_kogge_stone(p_bit_boards[i], o_bit_boards[i]);
+  }
+  if (mobility) {
+    for (int i = 0; i < count; i++) mobility[i] = square_set_count(legal_moves[i]);
+  }
+}
+
+#ifdef BOARD_AVX2_SUPPORT
+/*
+ * Kogge-Stone fill on four positions, toward the direction shifting left by `shift`.
+ */
+__attribute__((target("avx2")))
+static BOARD_ALWAYS_INLINE __m256i
+kogge_stone_left_avx2 (const __m256i p_bit_boards,
+                       const __m256i propagators,
+                       const int shift)
+{
+  __m256i g = _mm256_and_si256(propagators, _mm256_slli_epi64(p_bit_boards, shift));
+  __m256i p = propagators;
+  g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_slli_epi64(g, shift)));
+  p = _mm256_and_si256(p, _mm256_slli_epi64(p, shift));
+  g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_slli_epi64(g, 2 * shift)));
+  p = _mm256_and_si256(p, _mm256_slli_epi64(p, 2 * shift));
+  g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_slli_epi64(g, 4 * shift)));
+  return _mm256_slli_epi64(g, shift);
+}
+
+/*
+ * Kogge-Stone fill on four positions, toward the direction shifting right by `shift`.
+ */
+__attribute__((target("avx2")))
+static BOARD_ALWAYS_INLINE __m256i
+kogge_stone_right_avx2 (const __m256i p_bit_boards,
+                        const __m256i propagators,
+                        const int shift)
+{
+  __m256i g = _mm256_and_si256(propagators, _mm256_srli_epi64(p_bit_boards, shift));
+  __m256i p = propagators;
+  g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, shift)));
+  p = _mm256_and_si256(p, _mm256_srli_epi64(p, shift));
+  g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 2 * shift)));
+  p = _mm256_and_si256(p, _mm256_srli_epi64(p, 2 * shift));
+  g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 4 * shift)));
+  return _mm256_srli_epi64(g, shift);
+}
+
+/*
+ * Batch legal moves, each lane of the AVX2 vectors holds a different position.
+ * The remaining positions, less than four, are computed by the scalar implementation.
+ */
+__attribute__((target("avx2")))
+static void
+legal_moves_batch_avx2 (const int count,
+                        const SquareSet *const p_bit_boards,
+                        const SquareSet *const o_bit_boards,
+                        SquareSet *const legal_moves,
+                        int *const mobility)
+{
+  const __m256i inner_mask = _mm256_set1_epi64x(all_squares_except_columns_a_and_h);
+
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m256i p = _mm256_loadu_si256((const __m256i *) (p_bit_boards + i));
+    const __m256i o = _mm256_loadu_si256((const __m256i *) (o_bit_boards + i));
+    const __m256i o_inner = _mm256_and_si256(o, inner_mask);
+    __m256i m;
+    m = kogge_stone_left_avx2(p, o_inner, 1);
+    m = _mm256_or_si256(m, kogge_stone_right_avx2(p, o_inner, 1));
+    m = _mm256_or_si256(m, kogge_stone_left_avx2(p, o, 8));
+    m = _mm256_or_si256(m, kogge_stone_right_avx2(p, o, 8));
+    m = _mm256_or_si256(m, kogge_stone_left_avx2(p, o_inner, 7));
+    m = _mm256_or_si256(m, kogge_stone_right_avx2(p, o_inner, 7));
+    m = _mm256_or_si256(m, kogge_stone_left_avx2(p, o_inner, 9));
+    m = _mm256_or_si256(m, kogge_stone_right_avx2(p, o_inner, 9));
+    m = _mm256_andnot_si256(_mm256_or_si256(p, o), m);
+    _mm256_storeu_si256((__m256i *) (legal_moves + i), m);
+  }
+  legal_moves_batch_scalar(count - i, p_bit_boards + i, o_bit_boards + i, legal_moves + i, NULL);
+
+  if (mobility) {
+    for (int j = 0; j < count; j++) mobility[j] = square_set_count(legal_moves[j]);
+  }
+}
+#endif
+
+#ifdef BOARD_AVX512_SUPPORT
+/*
+ * Kogge-Stone fill on eight positions, toward the direction shifting left by `shift`.
+ */
+__attribute__((target("avx512f")))
+static BOARD_ALWAYS_INLINE __m512i
+kogge_stone_left_avx512 (const __m512i p_bit_boards,
+                         const __m512i propagators,
+                         const unsigned int shift)
+{
+  __m512i g = _mm512_and_si512(propagators, _mm512_slli_epi64(p_bit_boards, shift));
+  __m512i p = propagators;
+  g = _mm512_or_si512(g, _mm512_and_si512(p, _mm512_slli_epi64(g, shift)));
+  p = _mm512_and_si512(p, _mm512_slli_epi64(p, shift));
+  g = _mm512_or_si512(g, _mm512_and_si512(p, _mm512_slli_epi64(g, 2 * shift)));
+  p = _mm512_and_si512(p, _mm512_slli_epi64(p, 2 * shift));
+  g = _mm512_or_si512(g, _mm512_and_si512(p, _mm512_slli_epi64(g, 4 * shift)));
+  return _mm512_slli_epi64(g, shift);
+}
+
+/*
+ * Kogge-Stone fill on eight positions, toward the direction shifting right by `shift`.
+ */
+__attribute__((target("avx512f")))
+static BOARD_ALWAYS_INLINE __m512i
+kogge_stone_right_avx512 (const __m512i p_bit_boards,
+                          const __m512i propagators,
+                          const unsigned int shift)
+{
+  __m512i g = _mm512_and_si512(propagators, _mm512_srli_epi64(p_bit_boards, shift));
+  __m512i p = propagators;
+  g = _mm512_or_si512(g, _mm512_and_si512(p, _mm512_srli_epi64(g, shift)));
+  p = _mm512_and_si512(p, _mm512_srli_epi64(p, shift));
+  g = _mm512_or_si512(g, _mm512_and_si512(p, _mm512_srli_epi64(g, 2 * shift)));
+  p = _mm512_and_si512(p, _mm512_srli_epi64(p, 2 * shift));
+  g = _mm512_or_si512(g, _mm512_and_si512(p, _mm512_srli_epi64(g, 4 * shift)));
+  return _mm512_srli_epi64(g, shift);
+}
+
+/*
+ * Batch legal moves, each lane of the AVX-512 vectors holds a different position.
+ * The remaining positions, less than eight, are computed by the scalar implementation.
+ */
+__attribute__((target("avx512f")))
+static void
+legal_moves_batch_avx512 (const int count,
+                          const SquareSet *const p_bit_boards,
+                          const SquareSet *const o_bit_boards,
+                          SquareSet *const legal_moves,
+                          int *const mobility)
+{
+  const __m512i inner_mask = _mm512_set1_epi64(all_squares_except_columns_a_and_h);
+
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m512i p = _mm512_loadu_si512((const void *) (p_bit_boards + i));
+    const __m512i o = _mm512_loadu_si512((const void *) (o_bit_boards + i));
+    const __m512i o_inner = _mm512_and_si512(o, inner_mask);
+    __m512i m;
+    m = kogge_stone_left_avx512(p, o_inner, 1);
+    m = _mm512_or_si512(m, kogge_stone_right_avx512(p, o_inner, 1));
+    m = _mm512_or_si512(m, kogge_stone_left_avx512(p, o, 8));
+    m = _mm512_or_si512(m, kogge_stone_right_avx512(p, o, 8));
+    m = _mm512_or_si512(m, kogge_stone_left_avx512(p, o_inner, 7));
+    m = _mm512_or_si512(m, kogge_stone_right_avx512(p, o_inner, 7));
+    m = _mm512_or_si512(m, kogge_stone_left_avx512(p, o_inner, 9));
+    m = _mm512_or_si512(m, kogge_stone_right_avx512(p, o_inner, 9));
+    m = _mm512_andnot_si512(_mm512_or_si512(p, o), m);
+    _mm512_storeu_si512((void *) (legal_moves + i), m);
+  }
+  legal_moves_batch_scalar(count - i, p_bit_boards + i, o_bit_boards + i, legal_moves + i, NULL);
+
+  if (mobility) {
+    for (int j = 0; j < count; j++) mobility[j] = square_set_count(legal_moves[j]);
+  }
+}
+#endif
+
+/*
+ * Flips computed by means of the bitrow changes table.
+ *
+ * Each of the four axes crossing the move square is transformed to row one, the new player's row
+ * is looked up into the table, and transformed back. The flipped discs are the opponent ones
+ * belonging to the new player's rows.
+ */
+static SquareSet
+flips_bitrow_table (const SquareSet p_bit_board,
+                    const SquareSet o_bit_board,
+                    const Square move)
+{
+  const int column = move % 8;
+  const int row = move / 8;
+
+  SquareSet flips;
+  int shift_distance;
+  uint8_t p_bitrow;
+  uint8_t o_bitrow;
+
+  /* Axis HO. */
+  const uint8_t right_shift_for_HO = 8 * row;
+  p_bitrow = axis_transform_to_row_one(HO, p_bit_board >> right_shift_for_HO);
+  o_bitrow = axis_transform_to_row_one(HO, o_bit_board >> right_shift_for_HO);
+  p_bitrow = board_bitrow_changes_for_player(p_bitrow, o_bitrow, column);
+  flips = (SquareSet) p_bitrow << right_shift_for_HO;
+
+  /* Axis VE. */
+  p_bitrow = axis_transform_to_row_one(VE, p_bit_board >> column);
+  o_bitrow = axis_transform_to_row_one(VE, o_bit_board >> column);
+  p_bitrow = board_bitrow_changes_for_player(p_bitrow, o_bitrow, row);
+  flips |= axis_transform_back_from_row_one(VE, p_bitrow) << column;
+
+  /* Axis DD. */
+  shift_distance = axis_shift_distance(DD, column, row);
+  p_bitrow = axis_transform_to_row_one(DD, bit_works_signed_left_shift(p_bit_board, shift_distance));
+  o_bitrow = axis_transform_to_row_one(DD, bit_works_signed_left_shift(o_bit_board, shift_distance));
+  p_bitrow = board_bitrow_changes_for_player(p_bitrow, o_bitrow, column);
+  flips |= bit_works_signed_left_shift(axis_transform_back_from_row_one(DD, p_bitrow), -shift_distance);
+
+  /* Axis DU. */
+  shift_distance = axis_shift_distance(DU, column, row);
+  p_bitrow = axis_transform_to_row_one(DU, bit_works_signed_left_shift(p_bit_board, shift_distance));
+  o_bitrow = axis_transform_to_row_one(DU, bit_works_signed_left_shift(o_bit_board, shift_distance));
+  p_bitrow = board_bitrow_changes_for_player(p_bitrow, o_bitrow, column);
+  flips |= bit_works_signed_left_shift(axis_transform_back_from_row_one(DU, p_bitrow), -shift_distance);
+
+  return flips & o_bit_board;
+}
+
+/*
+ * Kogge-Stone fill from the move square toward the direction shifting left the bitboard by `shift`.
+ *
+ * The run of opponent discs adjacent to the move is flipped when the square following it
+ * belongs to the player.
+ */
+static inline SquareSet
+flips_kogge_stone_left (const SquareSet move_bit,
+                        const SquareSet p_bit_board,
+                        const SquareSet propagator,
+                        const int shift)
+{
+  SquareSet g = move_bit;
+  SquareSet p = propagator;
+  g |= p & (g << shift);
+  p &= p << shift;
+  g |= p & (g << (2 * shift));
+  p &= p << (2 * shift);
+  g |= p & (g << (4 * shift));
+  const SquareSet bracketed = (SquareSet) 0 - (SquareSet) (((g << shift) & p_bit_board) != 0);
+  return (g ^ move_bit) & bracketed;
+}
+
+/*
+ * Kogge-Stone fill from the move square toward the direction shifting right the bitboard by `shift`.
+ */
+static inline SquareSet
+flips_kogge_stone_right (const SquareSet move_bit,
+                         const SquareSet p_bit_board,
+                         const SquareSet propagator,
+                         const int shift)
+{
+  SquareSet g = move_bit;
+  SquareSet p = propagator;
+  g |= p & (g >> shift);
+  p &= p >> shift;
+  g |= p & (g >> (2 * shift));
+  p &= p >> (2 * shift);
+  g |= p & (g >> (4 * shift));
+  const SquareSet bracketed = (SquareSet) 0 - (SquareSet) (((g >> shift) & p_bit_board) != 0);
+  return (g ^ move_bit) & bracketed;
+}
+
+/*
+ * Flips computed by a branch-free fill in the eight directions.
+ *
+ * Opponent discs on columns A and H are removed from the propagator for the directions
+ * having an horizontal component, as it is done by the legal move generator.
+ */
+static SquareSet
+flips_kogge_stone (const SquareSet p_bit_board,
+                   const SquareSet o_bit_board,
+                   const Square move)
+{
+  const SquareSet m = (SquareSet) 1 << move;
+  const SquareSet o_inner = o_bit_board & all_squares_except_columns_a_and_h;
+
+  SquareSet flips;
+
+  flips  = flips_kogge_stone_left(m, p_bit_board, o_inner, 1);      /* E  */
+  flips |= flips_kogge_stone_right(m, p_bit_board, o_inner, 1);     /* W  */
+  flips |= flips_kogge_stone_left(m, p_bit_board, o_bit_board, 8);  /* S  */
+  flips |= flips_kogge_stone_right(m, p_bit_board, o_bit_board, 8); /* N  */
+  flips |= flips_kogge_stone_left(m, p_bit_board, o_inner, 7);      /* SW */
+  flips |= flips_kogge_stone_right(m, p_bit_board, o_inner, 7);     /* NE */
+  flips |= flips_kogge_stone_left(m, p_bit_board, o_inner, 9);      /* SE */
+  flips |= flips_kogge_stone_right(m, p_bit_board, o_inner, 9);     /* NW */
+
+  return flips;
+}
+
+/*
+ * Returns the most significant bit of the square set, that must not be empty.
+ */
+static BOARD_ALWAYS_INLINE SquareSet
+square_set_highest_bit (const SquareSet squares)
+{
+#if defined(__GNUC__)
+  return (SquareSet) 1 << (63 - __builtin_clzll(squares));
+#else
+  return (SquareSet) 1 << bit_works_bitscanMS1B_64(squares);
+#endif
+}
+
+/*
+ * The carry kernel, it computes the flips walking the rays of the move square.
+ *
+ * Toward higher squares (E, SW, S, SE) the outflank is the lowest square of the ray not occupied
+ * by the opponent, isolated with the two's complement carry; when it belongs to the player, the
+ * squares below it along the ray are flipped.
+ * Toward lower squares (NW, N, NE, W) the outflank is the highest one, found by a bit scan.
+ * The square A1 is added to the scanned set to keep it not empty, it cannot match a player disc
+ * on the ray when all the ray is occupied by the opponent.
+ */
+static BOARD_ALWAYS_INLINE SquareSet
+flips_carry_kernel (const SquareSet p_bit_board,
+                    const SquareSet o_bit_board,
+                    const Square move)
+{
+  const SquareSet *const rays = square_ray_masks[move];
+  const SquareSet not_o = ~o_bit_board;
+
+  SquareSet flips = empty_square_set;
+  SquareSet outflank;
+
+  for (Direction dir = E; dir <= SE; dir++) {
+    outflank = not_o & rays[dir];
+    outflank &= ((SquareSet) 0 - outflank) & p_bit_board;
+    flips |= (outflank - (SquareSet) (outflank != 0)) & rays[dir];
+  }
+
+  for (Direction dir = NW; dir <= W; dir++) {
+    outflank = square_set_highest_bit((not_o & rays[dir]) | 1) & rays[dir] & p_bit_board;
+    flips |= ((SquareSet) 0 - (outflank << 1)) & rays[dir];
+  }
+
+  return flips;
+}
+
+/*
+ * Flips computed by the carry kernel, the ray masks are loaded at runtime.
+ */
+static SquareSet
+flips_carry (const SquareSet p_bit_board,
+             const SquareSet o_bit_board,
+             const Square move)
+{
+  return flips_carry_kernel(p_bit_board, o_bit_board, move);
+}
+
+/*
+ * Defines the function computing flips for the given square,
+ * being a constant, the ray masks are folded and the empty rays removed.
+ */
+#define FLIPS_FOR_SQUARE(sq)                                            \
+  static SquareSet                                                      \
+  flips_square_##sq (const SquareSet p_bit_board,                       \
+                     const SquareSet o_bit_board)                       \
+  {                                                                     \
+    return flips_carry_kernel(p_bit_board, o_bit_board, sq);            \
+  }
+
+FLIPS_FOR_SQUARE(0)
+FLIPS_FOR_SQUARE(1)
+FLIPS_FOR_SQUARE(2)
+FLIPS_FOR_SQUARE(3)
+FLIPS_FOR_SQUARE(4)
+FLIPS_FOR_SQUARE(5)
+FLIPS_FOR_SQUARE(6)
+FLIPS_FOR_SQUARE(7)
+FLIPS_FOR_SQUARE(8)
+FLIPS_FOR_SQUARE(9)
+FLIPS_FOR_SQUARE(10)
+FLIPS_FOR_SQUARE(11)
+FLIPS_FOR_SQUARE(12)
+FLIPS_FOR_SQUARE(13)
+FLIPS_FOR_SQUARE(14)
+FLIPS_FOR_SQUARE(15)
+FLIPS_FOR_SQUARE(16)
+FLIPS_FOR_SQUARE(17)
+FLIPS_FOR_SQUARE(18)
+FLIPS_FOR_SQUARE(19)
+FLIPS_FOR_SQUARE(20)
+FLIPS_FOR_SQUARE(21)
+FLIPS_FOR_SQUARE(22)
+FLIPS_FOR_SQUARE(23)
+FLIPS_FOR_SQUARE(24)
+FLIPS_FOR_SQUARE(25)
+FLIPS_FOR_SQUARE(26)
+FLIPS_FOR_SQUARE(27)
+FLIPS_FOR_SQUARE(28)
+FLIPS_FOR_SQUARE(29)
+FLIPS_FOR_SQUARE(30)
+FLIPS_FOR_SQUARE(31)
+FLIPS_FOR_SQUARE(32)
+FLIPS_FOR_SQUARE(33)
+FLIPS_FOR_SQUARE(34)
+FLIPS_FOR_SQUARE(35)
+FLIPS_FOR_SQUARE(36)
+FLIPS_FOR_SQUARE(37)
+FLIPS_FOR_SQUARE(38)
+FLIPS_FOR_SQUARE(39)
+FLIPS_FOR_SQUARE(40)
+FLIPS_FOR_SQUARE(41)
+FLIPS_FOR_SQUARE(42)
+FLIPS_FOR_SQUARE(43)
+FLIPS_FOR_SQUARE(44)
+FLIPS_FOR_SQUARE(45)
+FLIPS_FOR_SQUARE(46)
+FLIPS_FOR_SQUARE(47)
+FLIPS_FOR_SQUARE(48)
+FLIPS_FOR_SQUARE(49)
+FLIPS_FOR_SQUARE(50)
+FLIPS_FOR_SQUARE(51)
+FLIPS_FOR_SQUARE(52)
+FLIPS_FOR_SQUARE(53)
+FLIPS_FOR_SQUARE(54)
+FLIPS_FOR_SQUARE(55)
+FLIPS_FOR_SQUARE(56)
+FLIPS_FOR_SQUARE(57)
+FLIPS_FOR_SQUARE(58)
+FLIPS_FOR_SQUARE(59)
+FLIPS_FOR_SQUARE(60)
+FLIPS_FOR_SQUARE(61)
+FLIPS_FOR_SQUARE(62)
+FLIPS_FOR_SQUARE(63)
+
+#undef FLIPS_FOR_SQUARE
+
+/* The per-square flip functions, indexed by the move square. */
+static SquareSet (*const flips_square_fn[]) (const SquareSet, const SquareSet) = {
+  flips_square_0, flips_square_1, flips_square_2, flips_square_3, flips_square_4, flips_square_5, flips_square_6, flips_square_7,
+  flips_square_8, flips_square_9, flips_square_10, flips_square_11, flips_square_12, flips_square_13, flips_square_14, flips_square_15,
+  flips_square_16, flips_square_17, flips_square_18, flips_square_19, flips_square_20, flips_square_21, flips_square_22, flips_square_23,
+  flips_square_24, flips_square_25, flips_square_26, flips_square_27, flips_square_28, flips_square_29, flips_square_30, flips_square_31,
+  flips_square_32, flips_square_33, flips_square_34, flips_square_35, flips_square_36, flips_square_37, flips_square_38, flips_square_39,
+  flips_square_40, flips_square_41, flips_square_42, flips_square_43, flips_square_44, flips_square_45, flips_square_46, flips_square_47,
+  flips_square_48, flips_square_49, flips_square_50, flips_square_51, flips_square_52, flips_square_53, flips_square_54, flips_square_55,
+  flips_square_56, flips_square_57, flips_square_58, flips_square_59, flips_square_60, flips_square_61, flips_square_62, flips_square_63
+};
+
+/*
+ * Flips computed by the function specialized for the move square.
+ */
+static SquareSet
+flips_per_square (const SquareSet p_bit_board,
+                  const SquareSet o_bit_board,
+                  const Square move)
+{
+  return flips_square_fn[move](p_bit_board, o_bit_board);
+}
+
+/*
+ * Computes the zobrist hash from scratch, only the occupied squares are visited.
+ * When white is to move the value is complemented, in this way passing doesn't require a full new hash.
+ */
+static uint64_t
+square_sets_zobrist_hash (const SquareSet blacks,
+                          const SquareSet whites,
+                          const Player player)
+{
+  uint64_t hash = 0;
+
+  for (SquareSet remaining = blacks; remaining; remaining &= remaining - 1) {
+    hash ^= zobrist_bitstrings[bit_works_bitscanLS1B_64(remaining)];
+  }
+  for (SquareSet remaining = whites; remaining; remaining &= remaining - 1) {
+    hash ^= zobrist_bitstrings[bit_works_bitscanLS1B_64(remaining) + 64];
+  }
+  if (player) hash = ~hash;
+
+  return hash;
+}
+
 /**
  * @endcond
  */
@@ -187,6 +187,68 @@ typedef struct {
   Player    player;   /**< @brief Next player to move. */
 } GamePositionX;
 
+/**
+ * @enum LegalMoveGenerator
+ * @brief The implementations available for computing the set of legal moves.
+ *
+ * @details The generator used by #board_legal_moves and #game_position_x_legal_moves
+ * is selected by #board_module_init, choosing the fastest one supported by the CPU.
+ * It can be changed afterward calling #legal_move_generator_set.
+ */
+typedef enum {
+  LEGAL_MOVE_GENERATOR_WAVE,               /**< The reference implementation, each direction is waved up to the bracketing discs. */
+  LEGAL_MOVE_GENERATOR_KOGGE_STONE,        /**< Branch-free parallel prefix fill, directions are computed one by one. */
+  LEGAL_MOVE_GENERATOR_KOGGE_STONE_AVX2    /**< Parallel prefix fill computing four directions in each AVX2 vector. */
+} LegalMoveGenerator;
+
+/**
+ * @enum LegalMovesBatchBackend
+ * @brief The implementations available for computing legal moves of many positions at once.
+ *
+ * @details Positions are given in a structure of arrays layout, see #game_position_x_legal_moves_batch.
+ * The backend is selected by #board_module_init, choosing the widest vector unit supported by the CPU.
+ */
+typedef enum {
+  LEGAL_MOVES_BATCH_SCALAR,    /**< One position at a time by means of the scalar Kogge-Stone generator. */
+  LEGAL_MOVES_BATCH_AVX2,      /**< Four positions in each AVX2 vector. */
+  LEGAL_MOVES_BATCH_AVX512     /**< Eight positions in each AVX-512 vector. */
+} LegalMovesBatchBackend;
+
+/**
+ * @enum FlipBackend
+ * @brief The implementations available for computing the set of discs flipped by a move.
+ *
+ * @details The backend used by #game_position_x_make_move, #game_position_make_move,
+ * and #game_position_x_flips is selected by #board_module_init.
+ * It can be changed afterward calling #flip_backend_set.
+ */
+typedef enum {
+  FLIP_BACKEND_BITROW_TABLE,   /**< Each axis is transformed to row one and looked up into the bitrow changes table. */
+  FLIP_BACKEND_KOGGE_STONE,    /**< Parallel prefix fill from the move square, directions are computed one by one. */
+  FLIP_BACKEND_CARRY,          /**< Ray masks, carry propagation toward higher squares and outflank bit scan toward lower ones. */
+  FLIP_BACKEND_PER_SQUARE      /**< The carry kernel specialized into one function for each square. */
+} FlipBackend;
+
+/**
+ * @enum BoardTransformation
+ * @brief The eight symmetries of the board.
+ *
+ * @details Rotations are intended looking at the board as drawn in the #Square documentation,
+ * having row 1 on top and column a on the left.
+ * A game position and its transformed ones have the same game value, and legal moves
+ * are transformed accordingly, see #game_position_x_canonical.
+ */
+typedef enum {
+  BOARD_TRANSFORMATION_IDENTITY,                   /**< No change. */
+  BOARD_TRANSFORMATION_ROTATE_90_CLOCKWISE,        /**< A1 goes to H1, H1 goes to H8. */
+  BOARD_TRANSFORMATION_ROTATE_180,                 /**< A1 goes to H8, H1 goes to A8. */
+  BOARD_TRANSFORMATION_ROTATE_90_ANTICLOCKWISE,    /**< A1 goes to A8, H1 goes to A1. */
+  BOARD_TRANSFORMATION_FLIP_VERTICAL,              /**< Rows are reversed, A1 goes to A8. */
+  BOARD_TRANSFORMATION_FLIP_HORIZONTAL,            /**< Columns are reversed, A1 goes to H1. */
+  BOARD_TRANSFORMATION_FLIP_DIAG_A1_H8,            /**< Mirror on the A1-H8 diagonal, B1 goes to A2. */
+  BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8             /**< Mirror on the H1-A8 diagonal, A1 goes to H8. */
+} BoardTransformation;
+
 
 
 /**********************************************/
@@ -253,6 +315,10 @@ square_belongs_to_enum_set (const Square sq);
 extern gboolean
 square_is_valid_move (const Square move);
 
+extern Square
+square_transform (const Square sq,
+                  const BoardTransformation bt);
+
 
 
 /*************************************************/
@@ -278,6 +344,36 @@ extern SquareSet
 square_set_from_array (const Square sq_array[],
                        const int sq_count);
 
+extern SquareSet
+square_set_flip_vertical (const SquareSet squares);
+
+extern SquareSet
+square_set_flip_horizontal (const SquareSet squares);
+
+extern SquareSet
+square_set_flip_diag_a1_h8 (const SquareSet squares);
+
+extern SquareSet
+square_set_flip_diag_h1_a8 (const SquareSet squares);
+
+extern SquareSet
+square_set_rotate_180 (const SquareSet squares);
+
+extern SquareSet
+square_set_rotate_90_clockwise (const SquareSet squares);
+
+extern SquareSet
+square_set_rotate_90_anticlockwise (const SquareSet squares);
+
+extern SquareSet
+square_set_transform (const SquareSet squares,
+                      const BoardTransformation bt);
+
+extern SquareSet
+square_set_flips (const SquareSet p_bit_board,
+                  const SquareSet o_bit_board,
+                  const Square move);
+
 
 
 /********************************************/
@@ -390,6 +486,9 @@ board_compare (const Board *const a,
 extern gboolean
 board_has_any_player_any_legal_move (const Board *const b);
 
+extern SquareSet
+board_stable_discs (const Board *const b);
+
 
 
 /*************************************************/
@@ -410,6 +509,88 @@ direction_opposite (const Direction dir);
 
 
 
+/**********************************************************/
+/* Function prototypes for the LegalMoveGenerator entity. */
+/**********************************************************/
+
+extern const gchar *
+legal_move_generator_to_string (const LegalMoveGenerator lmg);
+
+extern gboolean
+legal_move_generator_is_available (const LegalMoveGenerator lmg);
+
+extern gboolean
+legal_move_generator_set (const LegalMoveGenerator lmg);
+
+extern LegalMoveGenerator
+legal_move_generator_get (void);
+
+extern SquareSet
+legal_move_generator_legal_moves (const LegalMoveGenerator lmg,
+                                  const SquareSet p_bit_board,
+                                  const SquareSet o_bit_board);
+
+
+
+/**************************************************************/
+/* Function prototypes for the LegalMovesBatchBackend entity. */
+/**************************************************************/
+
+extern const gchar *
+legal_moves_batch_backend_to_string (const LegalMovesBatchBackend lmbb);
+
+extern gboolean
+legal_moves_batch_backend_is_available (const LegalMovesBatchBackend lmbb);
+
+extern gboolean
+legal_moves_batch_backend_set (const LegalMovesBatchBackend lmbb);
+
+extern LegalMovesBatchBackend
+legal_moves_batch_backend_get (void);
+
+extern void
+legal_moves_batch_backend_legal_moves (const LegalMovesBatchBackend lmbb,
+                                       const int count,
+                                       const SquareSet *const p_bit_boards,
+                                       const SquareSet *const o_bit_boards,
+                                       SquareSet *const legal_moves,
+                                       int *const mobility);
+
+
+
+/***************************************************/
+/* Function prototypes for the FlipBackend entity. */
+/***************************************************/
+
+extern const gchar *
+flip_backend_to_string (const FlipBackend fb);
+
+extern void
+flip_backend_set (const FlipBackend fb);
+
+extern FlipBackend
+flip_backend_get (void);
+
+extern SquareSet
+flip_backend_flips (const FlipBackend fb,
+                    const SquareSet p_bit_board,
+                    const SquareSet o_bit_board,
+                    const Square move);
+
+
+
+/***********************************************************/
+/* Function prototypes for the BoardTransformation entity. */
+/***********************************************************/
+
+extern const gchar *
+board_transformation_to_string (const BoardTransformation bt);
+
+extern BoardTransformation
+board_transformation_inverse (const BoardTransformation bt);
+
+
+
 /***************************************************/
 /* Function prototypes for the SquareState entity. */
 /***************************************************/
@@ -521,6 +702,13 @@ game_position_x_get_square (const GamePositionX *const gpx,
 extern SquareSet
 game_position_x_legal_moves (const GamePositionX *const gpx);
 
+extern void
+game_position_x_legal_moves_batch (const int count,
+                                   const SquareSet *const p_bit_boards,
+                                   const SquareSet *const o_bit_boards,
+                                   SquareSet *const legal_moves,
+                                   int *const mobility);
+
 extern int
 game_position_x_count_difference (const GamePositionX *const gpx);
 
@@ -539,9 +727,18 @@ game_position_x_pass (const GamePositionX *const current,
 extern uint64_t
 game_position_x_hash (const GamePositionX *const gpx);
 
+extern uint64_t
+game_position_x_delta_hash (const uint64_t hash,
+                            const SquareSet flips,
+                            const Square move,
+                            const Player player);
+
 extern int
 game_position_x_final_value (const GamePositionX *const gpx);
 
+extern SquareSet
+game_position_x_stable_discs (const GamePositionX *const gpx);
+
 extern gchar *
 game_position_x_print (const GamePositionX *const gpx);
 
@@ -555,11 +752,39 @@ extern gboolean
 game_position_x_is_move_legal (const GamePositionX *const gpx,
                                const Square move);
 
+extern SquareSet
+game_position_x_flips (const GamePositionX *const gpx,
+                       const Square move);
+
 extern void
 game_position_x_make_move (const GamePositionX *const current,
                            const Square move,
                            GamePositionX *const updated);
 
+extern SquareSet
+game_position_x_do_move (GamePositionX *const gpx,
+                         const Square move);
+
+extern void
+game_position_x_undo_move (GamePositionX *const gpx,
+                           const Square move,
+                           const SquareSet flips);
+
+extern void
+game_position_x_do_pass (GamePositionX *const gpx);
+
+extern void
+game_position_x_undo_pass (GamePositionX *const gpx);
+
+extern void
+game_position_x_transform (const GamePositionX *const gpx,
+                           const BoardTransformation bt,
+                           GamePositionX *const transformed);
+
+extern BoardTransformation
+game_position_x_canonical (const GamePositionX *const gpx,
+                           GamePositionX *const canonical);
+
 
 
 #endif /* BOARD_H */
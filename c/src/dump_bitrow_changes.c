@@ -3,7 +3,7 @@
  *
  * @brief Dump bitrow changes for player array.
  * @details This executable create a file that contains the
- * values computed by the function bitrow_changes_for_player_array.
+ * values computed by the function board_bitrow_changes_for_player.
  *
  * @par dump_bitrow_changes.c
  * <tt>
@@ -129,6 +129,7 @@
  */
 
 #include <stdio.h>
+#include <inttypes.h>
 
 #include "game_position_db.h"
 #include "exact_solver.h"
@@ -137,6 +138,11 @@
 #include "minimax_solver.h"
 #include "rab_solver.h"
 #include "ab_solver.h"
+#include "pab_solver.h"
+#include "mcts_solver.h"
+#include "transposition_table.h"
+#include "lock_free_hash_table.h"
+#include "solver_batch.h"
 
 
 
@@ -144,18 +150,37 @@
  * @cond
  */
 
+/*
+ * Prototypes for internal functions.
+ */
+
+static ExactSolution *
+random_sampler_adapter (const GamePosition *const root,
+                        const gchar *const log_file);
+
+static ExactSolution *
+rab_solve_adapter (const GamePosition *const root,
+                   const gchar *const log_file);
+
+
+
 /*
  * Static constants.
  */
 
-static const gchar *solvers[] = {"es", "ifes", "rand", "minimax", "rab", "ab"};
+static const gchar *solvers[] = {"es", "ifes", "rand", "minimax", "rab", "ab", "pab", "mcts"};
 static const int solvers_count = sizeof(solvers) / sizeof(solvers[0]);
 
+/* The solver functions, in the same order of the solvers array. */
+static const SolverFunction solver_functions[] = {game_position_solve, game_position_ifes_solve, random_sampler_adapter,
+                                                  game_position_minimax_solve, rab_solve_adapter, game_position_ab_solve,
+                                                  game_position_pab_solve, game_position_mcts_solve};
+
 static const gchar *program_documentation_string =
   "Description:\n"
   "Endgame solver is the front end for a group of algorithms aimed to analyze the final part of the game and to asses the game tree structure.\n"
   "Available engines are: es (exact solver), ifes (improved fast endgame solver), rand (random game sampler), minimax (minimax solver),\n"
-  "ab (alpha-beta solver), and rab (random alpha-beta solver).\n"
+  "ab (alpha-beta solver), rab (random alpha-beta solver), pab (parallel alpha-beta solver), and mcts (Monte Carlo tree search).\n"
   "\n"
   " - es (exact solver)\n"
   "   My fully featured implementation of a Reversi Endgame Exact Solver. A sample call is:\n"
@@ -169,19 +194,105 @@ static const gchar *program_documentation_string =
   "   The rand solver is a way to play a sequence of random game from the given position.\n"
   "   This option works together with the -n flag, that assigns the number of repeats, a sample call is:\n"
   "     $ endgame_solver -f db/gpdb-sample-games.txt -q initial -s rand -n 100 -l logfile\n"
+  "   The --rollouts flag plays the -n games on -T threads, zero, the default, means one for each processor, and prints\n"
+  "   the games per second, and the mean, the variance, and the win/draw/loss counts of the game values, for all the games\n"
+  "   and for each root move. The first move of each game is drawn among the root moves, a sample call is:\n"
+  "     $ endgame_solver -f db/gpdb-ffo.txt -q ffo-40 -s rand -n 1000000 --rollouts -T 4\n"
+  "   The --tree-size flag runs -n random probes, estimating by the Knuth method the node and leaf counts, with their 95%\n"
+  "   confidence intervals, of the minimax tree, and of the minimal tree searched by alpha-beta under a perfect move ordering.\n"
+  "   The tree searched by the ab solver falls in between. A sample call is:\n"
+  "     $ endgame_solver -f db/gpdb-ffo.txt -q ffo-40 -s rand -n 100000 --tree-size\n"
   "\n"
   " - minimax (minimax solver)\n"
   "   It applies the plain vanilla minimax algorithm, a sample call is:\n"
   "     $ endgame_solver -f db/gpdb-sample-games.txt -q ffo-01-simplified -s minimax\n"
   "\n"
   " - ab (alpha-beta solver)\n"
-  "   It applies the alpha-beta algorithm sorting legal moves by their natural order, a sample call is:\n"
+  "   It applies the alpha-beta algorithm sorting legal moves by their natural order, or by the --fastest-first,\n"
+  "   --parity, and --priority flags, a sample call is:\n"
   "     $ endgame_solver -f db/gpdb-sample-games.txt -q ffo-01-simplified -s ab\n"
   "\n"
   " - rab (random alpha-beta solver)\n"
   "   It uses the alpha-beta pruning, ordering the moves by mean of a random criteria, a sample call is:\n"
   "     $ endgame_solver -f db/gpdb-sample-games.txt -q ffo-01-simplified-4 -s rab -l out/log -n 3\n"
   "\n"
+  " - pab (parallel alpha-beta solver)\n"
+  "   It applies the alpha-beta algorithm on a pool of threads, splitting the work by the Young Brothers Wait Concept.\n"
+  "   The -T flag sets the count of threads, zero, the default, means one for each processor. A sample call is:\n"
+  "     $ endgame_solver -f db/gpdb-ffo.txt -q ffo-05 -s pab -T 4\n"
+  "\n"
+  " - mcts (Monte Carlo tree search)\n"
+  "   It grows a tree by the UCT policy, scoring the leaves by random games, and plays the most visited move.\n"
+  "   The value is not proven, the solution is reported as incomplete. The search runs for the --time-limit seconds,\n"
+  "   or the --node-limit playouts, 100000 playouts by default. The -T flag sets the count of threads, zero means one\n"
+  "   for each processor, --mcts-parallelism selects whether they share one tree (tree, the default), or grow one each (root).\n"
+  "   The visits and the win rates of the root moves are printed. A sample call is:\n"
+  "     $ endgame_solver -f db/gpdb-ffo.txt -q ffo-40 -s mcts -T 4 --time-limit 5\n"
+  "\n"
+  ;
+
+/* The description is split in parts, each one fitting the string length supported by C99 compilers. */
+static const gchar *program_documentation_options_string =
+  "Solver options:\n"
+  "   The ab, rab, and pab solvers accept the --stability-cutoff flag, that prunes the nodes whose value is proven\n"
+  "   out of the alpha-beta window by the count of stable discs, a sample call is:\n"
+  "     $ endgame_solver -f db/gpdb-ffo.txt -q ffo-05 -s ab --stability-cutoff\n"
+  "\n"
+  "   The es, ab, and rab solvers accept the -t flag, that turns on the transposition table, the argument is the base two logarithm\n"
+  "   of its number of entries. The ab and rab solvers skip the nodes whose value is decided by the stored bounds, and ab searches\n"
+  "   the stored best move first, es uses the table only to order moves. Statistics are printed at the end of the run, a sample call is:\n"
+  "     $ endgame_solver -f db/gpdb-ffo.txt -q ffo-05 -s ab -t 20\n"
+  "   The pab solver accepts the -t flag too, its threads share a lock free table, used as by ab, that doesn't collect statistics.\n"
+  "\n"
+  "   The ab solver accepts the --search flag, that selects the search strategy: alpha-beta (the default) searches the full window,\n"
+  "   pvs (principal variation search) tests by a null window the moves following the first one, and searches them again only\n"
+  "   when they turn out to be better, mtdf (MTD(f)) solves the position by a sequence of null window searches, starting from\n"
+  "   the value given by the --first-guess flag, zero by default. MTD(f) keeps the searched bounds in the transposition table,\n"
+  "   when the -t flag is missing a table of 2^20 entries is used, a sample call is:\n"
+  "     $ endgame_solver -f db/gpdb-ffo.txt -q ffo-05 -s ab --search mtdf --first-guess 32 -t 20\n"
+  "\n"
+  "   The ab solver sorts the legal moves of a node as selected by the --fastest-first, --parity, and --priority flags,\n"
+  "   whose arguments are the fewest empty squares a node must have for the method to apply. Above the --fastest-first\n"
+  "   threshold moves leaving the opponent with fewer replies go first, then above the --parity one moves in quadrants\n"
+  "   having an odd count of empty squares go first, then above the --priority one moves are sorted by a static priority\n"
+  "   of the squares, corners first. Below all of them, the natural order is kept. A sample call is:\n"
+  "     $ endgame_solver -f db/gpdb-ffo.txt -q ffo-05 -s ab -t 20 --fastest-first 8 --parity 4 --priority 0\n"
+  "\n"
+  "   The es, ifes, ab, rab, and pab solvers accept the --wld flag, that searches the window [-1..+1], enough to tell\n"
+  "   whether the position is a win, a loss, or a draw, at a fraction of the cost of the exact value.\n"
+  "   The best move is reported, the principal variation is not, a sample call is:\n"
+  "     $ endgame_solver -f db/gpdb-ffo.txt -q ffo-05 -s ab --wld\n"
+  "\n"
+  "   The ab solver accepts the --all-moves flag, that scores exactly every legal move of the root position. Moves after\n"
+  "   the first are tested by a null window and then proven by a narrowed one, the transposition table, 2^20 entries\n"
+  "   when -t is missing, keeps the work shared by the searches. Moves are listed best first, formatted as the description\n"
+  "   of the ffo entries, a sample call is:\n"
+  "     $ endgame_solver -f db/gpdb-ffo.txt -q ffo-01 -s ab --all-moves --fastest-first 8 --parity 4 --priority 0\n"
+  "\n"
+  "   All the solvers accept the --node-limit and --time-limit flags, that stop the search after the given count of nodes,\n"
+  "   or seconds. The solution is then marked as incomplete, and reports the bounds of the game value proven so far.\n"
+  "   The ab solver narrows the bounds by a sequence of null window searches, halving the window each time, this search\n"
+  "   replaces the strategy selected by the --search flag, pvs or mtdf, that is then ignored. The other solvers report\n"
+  "   as lower bound the best value among the root moves searched to the end. A sample call is:\n"
+  "     $ endgame_solver -f db/gpdb-ffo.txt -q ffo-20 -s ab -t 20 --time-limit 1.5\n"
+  "\n"
+  "   The es solver accepts the --pv flag, that selects how the principal variation is collected: triangular (the default)\n"
+  "   keeps the main line in a fixed array, none reports only the best move, full records also the variants having\n"
+  "   the same value, searching a wider window at a higher cost in nodes and memory. A sample call is:\n"
+  "     $ endgame_solver -f db/gpdb-ffo.txt -q ffo-05 -s es --pv full\n"
+  "\n"
+  ;
+
+static const gchar *program_documentation_batch_string =
+  "Batch mode:\n"
+  "   The -b flag solves, with any of the solvers, all the entries of the database whose id matches the -q pattern,\n"
+  "   where * and ? are wildcards, all entries are solved when -q is missing. The database is loaded once, positions are\n"
+  "   solved by -w worker processes, zero, the default, means one for each processor, starting from the ones having more empty squares.\n"
+  "   The report lists for each position the outcome, the best move, the time, the node count, and the nodes per second.\n"
+  "   It is written to the -o file, or to the standard output, formatted as selected by --format, csv (the default) or json.\n"
+  "   In batch mode the pab and mcts solvers use one thread, unless -T is given. A sample call is:\n"
+  "     $ endgame_solver -f db/gpdb-ffo.txt -q 'ffo-2?' -s es -b -w 4 -o out/ffo-20-29.csv\n"
+  "\n"
   "Author:\n"
   "   Written by Roberto Corradini <rob_corradini@yahoo.it>\n"
   "\n"
@@ -199,14 +310,54 @@ static gchar   *lookup_entry = NULL;
 static gchar   *solver       = NULL;
 static gint     repeats      = 1;
 static gchar   *log_file     = NULL;
+static gboolean stability_cutoff = FALSE;
+static gint     tt_size      = 0;
+static gint     threads      = 0;
+static gboolean batch        = FALSE;
+static gint     workers      = 0;
+static gchar   *output_file  = NULL;
+static gchar   *format       = NULL;
+static gchar   *search       = NULL;
+static gint     first_guess  = 0;
+static gboolean wld          = FALSE;
+static gboolean all_moves    = FALSE;
+static gint     fastest_first_min_empties = -1;
+static gint     parity_min_empties        = -1;
+static gint     priority_min_empties      = -1;
+static gint64   node_limit   = 0;
+static gdouble  time_limit   = 0.0;
+static gchar   *pv           = NULL;
+static gboolean rollouts     = FALSE;
+static gchar   *mcts_parallelism = NULL;
+static gboolean tree_size    = FALSE;
 
 static const GOptionEntry entries[] =
   {
     { "file",          'f', 0, G_OPTION_ARG_FILENAME, &input_file,   "Input file name   - Mandatory",                                            NULL },
     { "lookup-entry",  'q', 0, G_OPTION_ARG_STRING,   &lookup_entry, "Lookup entry      - Mandatory",                                            NULL },
-    { "solver",        's', 0, G_OPTION_ARG_STRING,   &solver,       "Solver            - Mandatory - Must be in [es|ifes|rand|minimax|ab|rab]", NULL },
+    { "solver",        's', 0, G_OPTION_ARG_STRING,   &solver,       "Solver            - Mandatory - Must be in [es|ifes|rand|minimax|ab|rab|pab|mcts]", NULL },
     { "repeats",       'n', 0, G_OPTION_ARG_INT,      &repeats,      "N. of repetitions - Used with the rand/rab solvers",                       NULL },
     { "log",           'l', 0, G_OPTION_ARG_FILENAME, &log_file,     "Turns logging on  - Requires a filename prefx",                            NULL },
+    { "stability-cutoff", 0, 0, G_OPTION_ARG_NONE,    &stability_cutoff, "Prunes by means of stable discs - Used with the ab/rab/pab solvers",   NULL },
+    { "tt-size",       't', 0, G_OPTION_ARG_INT,      &tt_size,      "Transposition table - Log2 of the entry count, used with es/ab/rab/pab", NULL },
+    { "threads",       'T', 0, G_OPTION_ARG_INT,      &threads,      "Threads           - Used with the pab/mcts solvers and the rollouts, 0 means one for each processor", NULL },
+    { "batch",         'b', 0, G_OPTION_ARG_NONE,     &batch,        "Batch mode        - Solves all the entries matching the -q pattern",       NULL },
+    { "workers",       'w', 0, G_OPTION_ARG_INT,      &workers,      "Workers           - Used in batch mode, 0 means one for each processor",   NULL },
+    { "output",        'o', 0, G_OPTION_ARG_FILENAME, &output_file,  "Output file       - Used in batch mode, the default is the standard output", NULL },
+    { "format",          0, 0, G_OPTION_ARG_STRING,   &format,       "Output format     - Used in batch mode, must be in [csv|json]",              NULL },
+    { "search",          0, 0, G_OPTION_ARG_STRING,   &search,       "Search strategy   - Used with the ab solver, must be in [alpha-beta|pvs|mtdf]", NULL },
+    { "first-guess",     0, 0, G_OPTION_ARG_INT,      &first_guess,  "First guess       - Used with the mtdf search, in the range [-64..+64]",     NULL },
+    { "wld",             0, 0, G_OPTION_ARG_NONE,     &wld,          "Win/loss/draw     - Used with the es/ifes/ab/rab/pab solvers",              NULL },
+    { "all-moves",       0, 0, G_OPTION_ARG_NONE,     &all_moves,    "All moves         - Used with the ab solver, scores every root move",        NULL },
+    { "fastest-first",   0, 0, G_OPTION_ARG_INT,      &fastest_first_min_empties, "Move ordering - Used with the ab solver, fewest empties sorted by opponent mobility", NULL },
+    { "parity",          0, 0, G_OPTION_ARG_INT,      &parity_min_empties,        "Move ordering - Used with the ab solver, fewest empties sorted by quadrant parity",  NULL },
+    { "priority",        0, 0, G_OPTION_ARG_INT,      &priority_min_empties,      "Move ordering - Used with the ab solver, fewest empties sorted by square priority",   NULL },
+    { "node-limit",      0, 0, G_OPTION_ARG_INT64,    &node_limit,   "Node limit        - Stops the search after the given count of nodes",       NULL },
+    { "time-limit",      0, 0, G_OPTION_ARG_DOUBLE,   &time_limit,   "Time limit        - Stops the search after the given count of seconds",     NULL },
+    { "pv",              0, 0, G_OPTION_ARG_STRING,   &pv,           "PV recording      - Used with the es solver, must be in [none|triangular|full]", NULL },
+    { "rollouts",        0, 0, G_OPTION_ARG_NONE,     &rollouts,     "Rollouts          - Used with the rand solver, plays the -n games on -T threads", NULL },
+    { "mcts-parallelism", 0, 0, G_OPTION_ARG_STRING,  &mcts_parallelism, "Mcts parallelism - Used with the mcts solver, must be in [tree|root]",   NULL },
+    { "tree-size",       0, 0, G_OPTION_ARG_NONE,     &tree_size,    "Tree size         - Used with the rand solver, estimates the tree size by -n probes", NULL },
     { NULL }
   };
 
@@ -246,7 +397,9 @@ main (int argc, char *argv[])
   context = g_option_context_new("- Solve an endgame position");
   g_option_context_add_main_entries(context, entries, NULL);
   g_option_context_add_group(context, option_group);
-  g_option_context_set_description(context, program_documentation_string);
+  gchar *program_documentation = g_strconcat(program_documentation_string, program_documentation_options_string,
+                                             program_documentation_batch_string, NULL);
+  g_option_context_set_description(context, program_documentation);
   if (!g_option_context_parse (context, &argc, &argv, &error)) {
     g_print("Option parsing failed: %s\n", error->message);
     return -1;
@@ -278,6 +431,103 @@ main (int argc, char *argv[])
     g_print("Option -s, --solver is mandatory.\n.");
     return -5;
   }
+  if (tt_size != 0 && (tt_size < 2 || tt_size > 40)) {
+    g_print("Option -t, --tt-size is out of range.\n.");
+    return -10;
+  }
+  if (threads < 0) {
+    g_print("Option -T, --threads is out of range.\n.");
+    return -11;
+  }
+  if (workers < 0) {
+    g_print("Option -w, --workers is out of range.\n.");
+    return -12;
+  }
+  SolverBatchFormat batch_format = SOLVER_BATCH_FORMAT_CSV;
+  if (format) {
+    if (g_strcmp0(format, "csv") == 0) {
+      batch_format = SOLVER_BATCH_FORMAT_CSV;
+    } else if (g_strcmp0(format, "json") == 0) {
+      batch_format = SOLVER_BATCH_FORMAT_JSON;
+    } else {
+      g_print("Option --format is out of range.\n.");
+      return -13;
+    }
+  }
+  AbSolverSearchMode search_mode = AB_SOLVER_SEARCH_MODE_ALPHA_BETA;
+  if (search) {
+    if (g_strcmp0(search, "alpha-beta") == 0) {
+      search_mode = AB_SOLVER_SEARCH_MODE_ALPHA_BETA;
+    } else if (g_strcmp0(search, "pvs") == 0) {
+      search_mode = AB_SOLVER_SEARCH_MODE_PVS;
+    } else if (g_strcmp0(search, "mtdf") == 0) {
+      search_mode = AB_SOLVER_SEARCH_MODE_MTDF;
+    } else {
+      g_print("Option --search is out of range.\n.");
+      return -16;
+    }
+  }
+  if (first_guess < worst_score || first_guess > best_score) {
+    g_print("Option --first-guess is out of range.\n.");
+    return -17;
+  }
+  if (fastest_first_min_empties < -1 || fastest_first_min_empties > 60 ||
+      parity_min_empties < -1 || parity_min_empties > 60 ||
+      priority_min_empties < -1 || priority_min_empties > 60) {
+    g_print("Options --fastest-first, --parity, and --priority must be in the range [0..60].\n.");
+    return -19;
+  }
+  if (wld && (solver_index == 2 || solver_index == 3 || solver_index == 7)) {
+    g_print("Option --wld cannot be used with the rand, minimax, and mcts solvers.\n.");
+    return -18;
+  }
+  if (all_moves && (solver_index != 5 || wld || batch)) {
+    g_print("Option --all-moves can be used only with the ab solver, and not with the --wld and -b flags.\n.");
+    return -20;
+  }
+  if (node_limit < 0 || time_limit < 0.0 || ((node_limit || time_limit) && batch)) {
+    g_print("Options --node-limit and --time-limit must not be negative, and cannot be used in batch mode.\n.");
+    return -21;
+  }
+  ExactSolverPVRecording pv_recording = EXACT_SOLVER_PV_RECORDING_TRIANGULAR;
+  if (pv) {
+    if (g_strcmp0(pv, "none") == 0) {
+      pv_recording = EXACT_SOLVER_PV_RECORDING_NONE;
+    } else if (g_strcmp0(pv, "triangular") == 0) {
+      pv_recording = EXACT_SOLVER_PV_RECORDING_TRIANGULAR;
+    } else if (g_strcmp0(pv, "full") == 0) {
+      pv_recording = EXACT_SOLVER_PV_RECORDING_FULL;
+    } else {
+      g_print("Option --pv is out of range.\n.");
+      return -22;
+    }
+  }
+  if (rollouts && (solver_index != 2 || batch || log_file)) {
+    g_print("Option --rollouts can be used only with the rand solver, and not with the -b and -l flags.\n.");
+    return -23;
+  }
+  MctsSolverParallelism mcts_mode = MCTS_SOLVER_PARALLELISM_TREE;
+  if (mcts_parallelism) {
+    if (solver_index != 7) {
+      g_print("Option --mcts-parallelism can be used only with the mcts solver.\n.");
+      return -24;
+    } else if (g_strcmp0(mcts_parallelism, "tree") == 0) {
+      mcts_mode = MCTS_SOLVER_PARALLELISM_TREE;
+    } else if (g_strcmp0(mcts_parallelism, "root") == 0) {
+      mcts_mode = MCTS_SOLVER_PARALLELISM_ROOT;
+    } else {
+      g_print("Option --mcts-parallelism is out of range.\n.");
+      return -24;
+    }
+  }
+  if (tree_size && (solver_index != 2 || batch || log_file || rollouts)) {
+    g_print("Option --tree-size can be used only with the rand solver, and not with the -b, -l, and --rollouts flags.\n.");
+    return -25;
+  }
+  if (batch && log_file) {
+    g_print("Option -l, --log cannot be used in batch mode.\n.");
+    return -14;
+  }
 
   /* Opens the source file for reading. */
   fp = fopen(source, "r");
@@ -301,56 +551,131 @@ main (int argc, char *argv[])
   }
 
   /* Lookup for a given key. */
-  if (lookup_entry) {
-    entry = gpdb_lookup(db, lookup_entry);
-    if (entry) {
-      gchar *tmp = gpdb_entry_print(entry);
-      g_print("%s", tmp);
-      g_free(tmp);
+  if (!batch) {
+    if (lookup_entry) {
+      entry = gpdb_lookup(db, lookup_entry);
+      if (entry) {
+        gchar *tmp = gpdb_entry_print(entry);
+        g_print("%s", tmp);
+        g_free(tmp);
+      } else {
+        g_print("Entry %s not found in file %s.\n", lookup_entry, source);
+        return -6;
+      }
     } else {
-      g_print("Entry %s not found in file %s.\n", lookup_entry, source);
-      return -6;
+      g_print("No entry provided.\n");
+      return -7;
     }
-  } else {
-    g_print("No entry provided.\n");
-    return -7;
   }
 
   /* Initialize the board module. */
   board_module_init();
 
+  /* Sets the solver options. */
+  node_info_stability_cutoff_set_enabled(stability_cutoff);
+  exact_solution_wld_set_enabled(wld);
+  const MoveOrdering move_ordering = { fastest_first_min_empties < 0 ? 61 : fastest_first_min_empties,
+                                       parity_min_empties < 0 ? 61 : parity_min_empties,
+                                       priority_min_empties < 0 ? 61 : priority_min_empties };
+  node_info_move_ordering_set(&move_ordering);
+  pab_solver_set_thread_count(threads);
+  ab_solver_set_search_mode(search_mode);
+  ab_solver_set_first_guess(first_guess);
+  ab_solver_all_moves_set_enabled(all_moves);
+  const SearchBudget budget = { (uint64_t) node_limit, time_limit };
+  search_budget_set(&budget);
+  exact_solver_set_pv_recording(pv_recording);
+  mcts_solver_set_parallelism(mcts_mode);
+  mcts_solver_set_thread_count(threads);
+  const gboolean is_parallel = solver_index == 6;
+  TranspositionTable *tt = tt_size && !is_parallel ? transposition_table_new(tt_size) : NULL;
+  transposition_table_set_default(tt);
+  LockFreeHashTable *lfht = tt_size && is_parallel ? lock_free_hash_table_new(tt_size) : NULL;
+  lock_free_hash_table_set_default(lfht);
+
+  /* Solving the batch. */
+  if (batch) {
+    if (solver_index == 6 && threads == 0) pab_solver_set_thread_count(1);
+    if (solver_index == 7 && threads == 0) mcts_solver_set_thread_count(1);
+    const int worker_count = workers ? workers : (int) g_get_num_processors();
+    SolverBatch *sb = solver_batch_new(db, lookup_entry);
+    solver_batch_sort_longest_first(sb);
+    g_print("Solving %d game positions, from source %s, using solver %s and %d workers ...\n",
+            sb->item_count, source, solvers[solver_index], worker_count);
+    const gint64 start = g_get_monotonic_time();
+    solver_batch_run(sb, solver_functions[solver_index], worker_count);
+    const double elapsed = (g_get_monotonic_time() - start) / 1.0e6;
+    FILE *out = output_file ? fopen(output_file, "w") : stdout;
+    if (!out) {
+      g_print("Unable to open file \"%s\" for writing.\n", output_file);
+      return -15;
+    }
+    solver_batch_write(sb, batch_format, out);
+    if (output_file) fclose(out);
+    int solved_count = 0;
+    uint64_t node_count = 0;
+    for (int i = 0; i < sb->item_count; i++) {
+      if (!sb->items[i].is_solved) continue;
+      solved_count++;
+      node_count += sb->items[i].node_count;
+    }
+    g_print("Solved %d of %d game positions in %.3f seconds, %" PRIu64 " nodes, %.0f nodes per second.\n",
+            solved_count, sb->item_count, elapsed, node_count, elapsed > 0.0 ? node_count / elapsed : 0.0);
+    solver_batch_free(sb);
+  }
+
+  /* Playing the rollouts. */
+  if (rollouts) {
+    g_print("Playing %d random games from game position %s, from source %s ...\n", repeats, entry->id, source);
+    SolverContext *ctx = solver_context_new();
+    RolloutReport *report = game_position_rollout(ctx, entry->game_position, repeats, threads);
+    gchar *report_to_string = rollout_report_to_string(report);
+    printf("\n%s", report_to_string);
+    g_free(report_to_string);
+    rollout_report_free(report);
+    solver_context_free(ctx);
+  }
+
+  /* Estimating the tree size. */
+  if (tree_size) {
+    g_print("Running %d random probes from game position %s, from source %s ...\n", repeats, entry->id, source);
+    SolverContext *ctx = solver_context_new();
+    TreeSizeReport *report = game_position_tree_size_estimate(ctx, entry->game_position, repeats);
+    gchar *report_to_string = tree_size_report_to_string(report);
+    printf("\n%s", report_to_string);
+    g_free(report_to_string);
+    tree_size_report_free(report);
+    solver_context_free(ctx);
+  }
+
   /* Solving the position. */
-  GamePosition *gp = entry->game_position;
   ExactSolution *solution = NULL;
-  g_print("Solving game position %s, from source %s, using solver %s ...\n", entry->id, source, solvers[solver_index]);
-  switch (solver_index) {
-  case 0:
-    solution = game_position_solve(gp, log_file);
-    break;
-  case 1:
-    solution = game_position_ifes_solve(gp, log_file);
-    break;
-  case 2:
-    solution = game_position_random_sampler(gp, log_file, repeats);
-    break;
-  case 3:
-    solution = game_position_minimax_solve(gp, log_file);
-    break;
-  case 4:
-    solution = game_position_rab_solve(gp, log_file, repeats);
-    break;
-  case 5:
-    solution = game_position_ab_solve(gp, log_file);
-    break;
-  default:
-    g_print("This should never happen! solver_index = %d. Aborting ...\n", solver_index);
-    return -9;
-  }
+  if (!batch && !rollouts && !tree_size) {
+    g_print("Solving game position %s, from source %s, using solver %s ...\n", entry->id, source, solvers[solver_index]);
+    if (solver_index == 7) {
+      SolverContext *ctx = solver_context_new();
+      MctsTree *tree = mcts_tree_new(entry->game_position, ctx->mcts_parallelism, ctx->mcts_thread_count, 0);
+      mcts_tree_search(tree, ctx);
+      gchar *tree_to_string = mcts_tree_to_string(tree);
+      printf("\n%s", tree_to_string);
+      g_free(tree_to_string);
+      solution = mcts_tree_to_exact_solution(tree);
+      mcts_tree_free(tree);
+      solver_context_free(ctx);
+    } else {
+      solution = solver_functions[solver_index](entry->game_position, log_file);
+    }
 
-  /* Printing results. */
-  gchar *solution_to_string = exact_solution_to_string(solution);
-  printf("\n%s\n", solution_to_string);
-  g_free(solution_to_string);
+    /* Printing results. */
+    gchar *solution_to_string = exact_solution_to_string(solution);
+    printf("\n%s\n", solution_to_string);
+    g_free(solution_to_string);
+    if (tt) {
+      gchar *tt_stats_to_string = transposition_table_stats_to_string(tt);
+      printf("%s", tt_stats_to_string);
+      g_free(tt_stats_to_string);
+    }
+  }
 
   /* Frees the resources. */
   g_free(error);
@@ -358,8 +683,47 @@ main (int argc, char *argv[])
   if (syntax_error_log)
     gpdb_syntax_error_log_free(syntax_error_log);
   g_option_context_free(context);
+  g_free(program_documentation);
   g_free(source);
   exact_solution_free(solution);
+  transposition_table_set_default(NULL);
+  transposition_table_free(tt);
+  lock_free_hash_table_set_default(NULL);
+  lock_free_hash_table_free(lfht);
 
   return 0;
 }
+
+
+
+/**
+ * @cond
+ */
+
+/*
+ * Internal functions.
+ */
+
+/*
+ * Adapts the random game sampler to the common solver signature, repeats are taken from the -n option.
+ */
+static ExactSolution *
+random_sampler_adapter (const GamePosition *const root,
+                        const gchar *const log_file)
+{
+  return game_position_random_sampler(root, log_file, repeats);
+}
+
+/*
+ * Adapts the rab solver to the common solver signature, repeats are taken from the -n option.
+ */
+static ExactSolution *
+rab_solve_adapter (const GamePosition *const root,
+                   const gchar *const log_file)
+{
+  return game_position_rab_solve(root, log_file, repeats);
+}
+
+/**
+ * @endcond
+ */
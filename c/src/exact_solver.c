@@ -39,8 +39,11 @@
 #include <glib.h>
 #include <glib/gstdio.h>
 
+#include "bit_works.h"
 #include "game_tree_logger.h"
 #include "game_tree_utils.h"
+#include "transposition_table.h"
+#include "solver_context.h"
 
 #include "exact_solver.h"
 
@@ -51,29 +54,19 @@
  */
 
 /*
- * Internal structures.
+ * Internal types.
  */
 
 /*
- * Elements of a doubly linked list that collects moves.
- */
-typedef struct MoveListElement_ {
-  Square                   sq;           /**< @brief The square field. */
-  uint8_t                  mobility;     /**< @brief The mobility field. */
-  struct MoveListElement_ *pred;         /**< @brief A pointer to the predecesor element. */
-  struct MoveListElement_ *succ;         /**< @brief A pointer to the successor element. */
-} MoveListElement;
-
-/*
- * Move list, having head, tail, and elements fields.
+ * The triangular array collecting the principal variation.
  *
- * Head and tail are not part of the list.
+ * Row `i` holds the best line found for the node at index `i` of the game tree stack,
+ * it is the best move followed by the row `i + 1` of the child.
  */
 typedef struct {
-  MoveListElement elements[64];          /**< @brief Elements array. */
-  MoveListElement head;                  /**< @brief Head element, it is not part of the list. */
-  MoveListElement tail;                  /**< @brief Tail element, it is not part of the list. */
-} MoveList;
+  Square lines[GAME_TREE_MAX_DEPTH + 1][GAME_TREE_MAX_DEPTH]; /* The best lines, one for each stack index. */
+  int    lengths[GAME_TREE_MAX_DEPTH + 1];                    /* The count of moves of each line. */
+} PVTriangle;
 
 
 
@@ -82,61 +75,35 @@ typedef struct {
  */
 
 static void
-sort_moves_by_mobility_count (MoveList *move_list,
-                              const GamePosition *const gp);
-
-static SearchNode *
-game_position_solve_impl (ExactSolution *const result,
-                          const GamePosition  *const gp,
-                          const int achievable,
-                          const int cutoff,
+game_position_solve_impl (SolverContext *const ctx,
+                          ExactSolution *const result,
+                          GameTreeStack *const stack,
+                          PVTriangle *const pvt,
                           PVCell ***pve_parent_line_p);
 
 static void
-move_list_init (MoveList *ml);
+pv_triangle_update (PVTriangle *const pvt,
+                    const int index,
+                    const Square move);
 
 /*
  * Internal variables and constants.
  */
 
-/* Principal Variation Environmenat. */
-static PVEnv *pve = NULL;
-
-/* The logging environment structure. */
-static LogEnv *log_env = NULL;
-
-/* The total number of call to the recursive function that traverse the game DAG. */
-static uint64_t call_count = 0;
-
-/* The predecessor-successor array of game position hash values. */
-static uint64_t gp_hash_stack[128];
-
-/* The index of the last entry into gp_hash_stack. */
-static int gp_hash_stack_fill_point = 0;
-
 /* The sub_run_id used for logging. */
 static const int sub_run_id = 0;
 
-/* Used d to sort the legal moves based on an heuristic knowledge. */
-static const uint64_t legal_moves_priority_mask[] = {
-  /* D4, E4, E5, D5 */                 0x0000001818000000,
-  /* A1, H1, H8, A8 */                 0x8100000000000081,
-  /* C1, F1, F8, C8, A3, H3, H6, A6 */ 0x2400810000810024,
-  /* C3, F3, F6, C6 */                 0x0000240000240000,
-  /* D1, E1, E8, D8, A4, H4, H5, A5 */ 0x1800008181000018,
-  /* D3, E3, E6, D6, C4, F4, F5, C5 */ 0x0000182424180000,
-  /* D2, E2, E7, D7, B4, G4, G5, B5 */ 0x0018004242001800,
-  /* C2, F2, F7, C7, B3, G3, G6, B6 */ 0x0024420000422400,
-  /* B1, G1, G8, B8, A2, H2, H7, A7 */ 0x4281000000008142,
-  /* B2, G2, G7, B7 */                 0x0042000000004200
-};
-
-/* The size of the legal_moves_priority_mask array. */
-static const int legal_moves_priority_cluster_count =
-  sizeof(legal_moves_priority_mask) / sizeof(legal_moves_priority_mask[0]);
-
-/* Turn on full PV recording. Should be a parameter coming from command line. */
-static const bool pv_full_recording = true;
+/*
+ * The transposition table is used only to search first the best move, a cutoff would break the principal variation.
+ * Nodes having fewer empty squares are cheaper to search than to look up.
+ */
+static const int tt_min_depth = 4;
+
+/* Moves are sorted fastest first at every node. */
+static const MoveOrdering move_ordering = { 0, 61, 61 };
+
+/* The principal variation collected by default. */
+static ExactSolverPVRecording pv_recording = EXACT_SOLVER_PV_RECORDING_TRIANGULAR;
 
 /**
  * @endcond
@@ -151,6 +118,8 @@ static const bool pv_full_recording = true;
 /**
  * @brief Solves the game position returning a new exact solution pointer.
  *
+ * @details It is a wrapper of #game_position_solve_with_context, running on a new context.
+ *
  * @param [in] root     the starting game position to be solved
  * @param [in] log_file if not null turns logging on the given file name
  * @return              a pointer to a new exact solution structure
@@ -159,72 +128,146 @@ ExactSolution *
 game_position_solve (const GamePosition *const root,
                      const gchar *const log_file)
 {
+  SolverContext *ctx = solver_context_new();
+  ctx->log_file = log_file;
+  ExactSolution *result = game_position_solve_with_context(ctx, root);
+  solver_context_free(ctx);
+  return result;
+}
+
+/**
+ * @brief Solves the game position, as selected by the options of the solver context,
+ * returning a new exact solution pointer.
+ *
+ * @invariant Parameters `ctx` and `root` must be not `NULL`.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] ctx  the solver context
+ * @param [in]     root the starting game position to be solved
+ * @return              a pointer to a new exact solution structure
+ */
+ExactSolution *
+game_position_solve_with_context (SolverContext *const ctx,
+                                  const GamePosition *const root)
+{
+  g_assert(ctx);
+  g_assert(root);
+
   ExactSolution *result;
-  SearchNode    *sn;
-  int            alpha;
-  int            beta;
 
-  log_env = game_tree_log_init(log_file);
+  solver_context_search_start(ctx);
+
+  if (ctx->tt) transposition_table_new_search(ctx->tt);
 
-  pve = pve_new(game_position_empty_count(root));
-  PVCell **pve_root_line = pve_line_create(pve);
+  ctx->hash_is_on = ctx->log_env->log_is_on || ctx->tt;
 
-  if (log_env->log_is_on) {
-    gp_hash_stack[0] = 0;
-    game_tree_log_open_h(log_env);
+  const bool wld = ctx->wld;
+  const bool pv_full_recording = ctx->pv_recording == EXACT_SOLVER_PV_RECORDING_FULL;
+
+  PVEnv *const pve = pv_full_recording ? pve_new(game_position_empty_count(root)) : NULL;
+  ctx->pve = pve;
+  PVCell **pve_root_line = pve ? pve_line_create(pve) : NULL;
+
+  PVTriangle triangle;
+  PVTriangle *const pvt = ctx->pv_recording == EXACT_SOLVER_PV_RECORDING_TRIANGULAR ? &triangle : NULL;
+
+  if (ctx->log_env->log_is_on) {
+    game_tree_log_open_h(ctx->log_env);
   }
 
-  if (pv_full_recording) {
-    alpha = out_of_range_defeat_score;
-    beta = out_of_range_win_score;
+  GameTreeStack *stack = game_tree_stack_new();
+  game_tree_stack_init(root, stack);
+  NodeInfo *first_node_info = &stack->nodes[1];
+
+  if (wld) {
+    first_node_info->alpha = wld_alpha;
+    first_node_info->beta = wld_beta;
+  } else if (pv_full_recording) {
+    first_node_info->alpha = out_of_range_defeat_score;
+    first_node_info->beta = out_of_range_win_score;
   } else {
-    alpha = worst_score;
-    beta = best_score;
+    first_node_info->alpha = worst_score;
+    first_node_info->beta = best_score;
   }
 
   result = exact_solution_new();
 
   result->solved_game_position = game_position_clone(root);
 
-  sn = game_position_solve_impl(result,
-                                result->solved_game_position,
-                                alpha,
-                                beta,
-                                &pve_root_line);
-
-  if (sn) {
-    result->pv[0] = sn->move;
-    result->outcome = sn->value;
+  const int root_alpha = first_node_info->alpha;
+
+  game_position_solve_impl(ctx, result, stack, pvt, &pve_root_line);
+
+  result->pv[0] = first_node_info->best_move;
+  result->outcome = first_node_info->alpha;
+  if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) {
+    /* The root value is the best one among the moves searched to the end, if any. */
+    const bool has_lower_bound = first_node_info->alpha > root_alpha;
+    exact_solution_set_incomplete(result,
+                                  has_lower_bound ? first_node_info->alpha : worst_score,
+                                  best_score,
+                                  has_lower_bound ? first_node_info->best_move : invalid_move);
+  } else if (wld) {
+    /* Lines searched out of the window are bounds, the PV and the final board are meaningless. */
+    exact_solution_set_wld_outcome(result);
+  } else if (pve) {
     pve_line_copy_to_exact_solution(pve, (const PVCell **const) pve_root_line, result);
     exact_solution_compute_final_board(result);
-  }
-  //---
-  if (pv_full_recording) {
-    printf("PVE: $$$ --- $$$\n");
-    gchar *pve_root_line_to_s = pve_line_with_variants_to_string(pve, (const PVCell **const ) pve_root_line);
-    printf("\n");
-    printf(" --- --- pve_line_with_variants_to_string(pve, pve_root_line) --- ---\n");
-    printf("%s\n", pve_root_line_to_s);
-    printf("\n");
+    gchar *pve_root_line_to_s = pve_line_with_variants_to_string(pve, (const PVCell **const) pve_root_line);
+    printf("Principal variation, and variants having the same value:\n%s\n", pve_root_line_to_s);
     g_free(pve_root_line_to_s);
-    printf("PVE: $$$ --- $$$\n");
+  } else if (pvt) {
+    const int root_index = 1;
+    for (int i = 0; i < pvt->lengths[root_index]; i++) result->pv[i] = pvt->lines[root_index][i];
+    result->pv_length = pvt->lengths[root_index];
+    exact_solution_compute_final_board(result);
   }
-  if (true) {
+
+#ifdef REVERSI_DEBUG
+  if (pve) {
     pve_verify_consistency(pve, NULL, NULL);
     char *s = pve_internals_to_string(pve);
     printf("%s\n", s);
     free(s);
   }
+#endif
 
-  //---
-  search_node_free(sn);
-  pve_free(pve);
+  game_tree_stack_free(stack);
+  if (pve) pve_free(pve);
 
-  game_tree_log_close(log_env);
+  ctx->pve = NULL;
+  solver_context_search_end(ctx);
 
   return result;
 }
 
+/**
+ * @brief Sets the principal variation collected by #game_position_solve.
+ *
+ * @details It is the process wide option, copied by the solver contexts when they are created.
+ * The full recording searches the root with a window one point wider, in order to collect
+ * the moves having the same value as the best one, and pays an allocation for each node.
+ * The triangular array collects the main line only, the none level reports only the best move.
+ *
+ * @param [in] level the principal variation recording level
+ */
+void
+exact_solver_set_pv_recording (const ExactSolverPVRecording level)
+{
+  pv_recording = level;
+}
+
+/**
+ * @brief Returns the principal variation collected by #game_position_solve.
+ *
+ * @return the principal variation recording level
+ */
+ExactSolverPVRecording
+exact_solver_get_pv_recording (void)
+{
+  return pv_recording;
+}
+
 
 
 /**
@@ -235,155 +278,165 @@ game_position_solve (const GamePosition *const root,
  * Internal functions.
  */
 
-/*
- * Sorts moves in ascending order of mobility.
- */
-static void
-sort_moves_by_mobility_count (MoveList *move_list,
-                              const GamePosition *const gp)
-{
-  MoveListElement *curr = NULL;
-  int move_index = 0;
-  const SquareSet moves = game_position_legal_moves(gp);
-  SquareSet moves_to_search = moves;
-  for (int i = 0; i < legal_moves_priority_cluster_count; i++) {
-    moves_to_search = legal_moves_priority_mask[i] & moves;
-    while (moves_to_search) {
-      curr = &move_list->elements[move_index];
-      const Square move = bit_works_bitscanLS1B_64(moves_to_search);
-      moves_to_search &= ~(1ULL << move);
-      GamePosition *next_gp = game_position_make_move(gp, move);
-      const SquareSet next_moves = game_position_legal_moves(next_gp);
-      game_position_free(next_gp);
-      const int next_move_count = bit_works_popcount(next_moves);
-      curr->sq = move;
-      curr->mobility = next_move_count;
-      for (MoveListElement *element = move_list->head.succ; element != NULL; element = element->succ) {
-        if (curr->mobility < element->mobility) { /* Insert current before element. */
-          MoveListElement *left  = element->pred;
-          MoveListElement *right = element;
-          curr->pred  = left;
-          curr->succ  = right;
-          left->succ  = curr;
-          right->pred = curr;
-          goto out;
-        }
-      }
-    out:
-      move_index++;
-    }
-  }
-  return;
-}
-
 /*
  * Main recursive search function.
+ *
+ * The node being searched is the one at the top of the stack, its alpha and beta fields
+ * are the achievable and cutoff values. When the function returns, alpha holds the node value
+ * and best_move the move leading to it.
+ * The principal variation is collected into `pvt` when it is not `NULL`,
+ * or into the lines of the PV environment of the context when it is not `NULL`.
  */
-static SearchNode *
-game_position_solve_impl (ExactSolution *const result,
-                          const GamePosition  *const gp,
-                          const int achievable,
-                          const int cutoff,
+static void
+game_position_solve_impl (SolverContext *const ctx,
+                          ExactSolution *const result,
+                          GameTreeStack *const stack,
+                          PVTriangle *const pvt,
                           PVCell ***pve_parent_line_p)
 {
+  PVEnv *const pve = ctx->pve;
+  const bool pv_full_recording = pve != NULL;
+  TranspositionTable *const tt = ctx->tt;
+
   result->node_count++;
-  SearchNode *node  = NULL;
-  SearchNode *node2 = NULL;
   PVCell **pve_line = NULL;
 
-  if (log_env->log_is_on) {
-    call_count++;
-    gp_hash_stack_fill_point++;
+  if (ctx->budget_is_on && solver_context_budget_check(ctx, result->node_count)) return;
+
+  const int current_fill_index = stack->fill_index;
+  const int next_fill_index = current_fill_index + 1;
+  const int previous_fill_index = current_fill_index - 1;
+
+  stack->fill_index++;
+
+  if (pvt) pvt->lengths[current_fill_index] = 0;
+
+  NodeInfo *const current_node_info = &stack->nodes[current_fill_index];
+  NodeInfo *const next_node_info = &stack->nodes[next_fill_index];
+  NodeInfo *const previous_node_info = &stack->nodes[previous_fill_index];
+  const GamePositionX *const current_gpx = &current_node_info->gpx;
+  GamePositionX *const next_gpx = &next_node_info->gpx;
+
+#ifdef REVERSI_DEBUG
+  if (ctx->hash_is_on) g_assert(current_node_info->hash == game_position_x_hash(current_gpx));
+#endif
+
+  if (ctx->log_env->log_is_on) {
     LogDataH log_data;
-    log_data.sub_run_id = 0;
-    log_data.call_id = call_count;
-    log_data.hash = game_position_hash(gp);
-    gp_hash_stack[gp_hash_stack_fill_point] = log_data.hash;
-    log_data.parent_hash = gp_hash_stack[gp_hash_stack_fill_point - 1];
-    log_data.blacks = (gp->board)->blacks;
-    log_data.whites = (gp->board)->whites;
-    log_data.player = gp->player;
-    gchar *json_doc = game_tree_log_data_h_json_doc(gp_hash_stack_fill_point, gp);
+    log_data.sub_run_id = sub_run_id;
+    log_data.call_id = result->node_count;
+    log_data.hash = current_node_info->hash;
+    log_data.parent_hash = previous_node_info->hash;
+    log_data.blacks = current_gpx->blacks;
+    log_data.whites = current_gpx->whites;
+    log_data.player = current_gpx->player;
+    gchar *json_doc = game_tree_log_data_h_json_doc_gpx(current_fill_index, current_gpx);
     log_data.json_doc = json_doc;
-    game_tree_log_write_h(log_env, &log_data);
+    game_tree_log_write_h(ctx->log_env, &log_data);
     g_free(json_doc);
   }
 
-  const SquareSet moves = game_position_legal_moves(gp);
-  if (0ULL == moves) {
-    pve_line = pve_line_create(pve);
-    GamePosition *flipped_players = game_position_pass(gp);
-    if (game_position_has_any_legal_move(flipped_players)) {
-      node = search_node_negated(game_position_solve_impl(result, flipped_players, -cutoff, -achievable, &pve_line));
+  current_node_info->move_set = game_position_x_legal_moves(current_gpx);
+  if (empty_square_set == current_node_info->move_set) {
+    current_node_info->move_count = 0;
+    next_node_info->head_of_legal_move_list = current_node_info->head_of_legal_move_list;
+    if (pve) pve_line = pve_line_create(pve);
+    if (pvt) pvt->lengths[next_fill_index] = 0;
+    if (game_position_x_has_any_player_any_legal_move(current_gpx)) {
+      game_position_x_pass(current_gpx, next_gpx);
+      if (ctx->hash_is_on) next_node_info->hash = ~current_node_info->hash;
+      next_node_info->alpha = -current_node_info->beta;
+      next_node_info->beta = -current_node_info->alpha;
+      game_position_solve_impl(ctx, result, stack, pvt, &pve_line);
+      if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) {
+        stack->fill_index--;
+        return;
+      }
+      current_node_info->alpha = -next_node_info->alpha;
     } else {
       result->leaf_count++;
-      node = search_node_new(pass_move, game_position_final_value(gp));
+      current_node_info->alpha = game_position_x_final_value(current_gpx);
+    }
+    current_node_info->best_move = pass_move;
+    if (pvt) pv_triangle_update(pvt, current_fill_index, pass_move);
+    if (pve) {
+      pve_line_add_move(pve, pve_line, pass_move);
+      pve_line_delete(pve, *pve_parent_line_p);
+      *pve_parent_line_p = pve_line;
     }
-    pve_line_add_move(pve, pve_line, pass_move);
-    pve_line_delete(pve, *pve_parent_line_p);
-    *pve_parent_line_p = pve_line;
-    game_position_free(flipped_players);
   } else {
-    MoveList move_list;
     bool branch_is_active = false;
-    move_list_init(&move_list);
-    sort_moves_by_mobility_count(&move_list, gp);
-    for (MoveListElement *element = move_list.head.succ; element != &move_list.tail; element = element->succ) {
-      const Square move = element->sq;
-      if (!node) node = search_node_new(move, (pv_full_recording) ? achievable - 1 : achievable);
-      GamePosition *gp2 = game_position_make_move(gp, move);
-      pve_line = pve_line_create(pve);
-      node2 = search_node_negated(game_position_solve_impl(result, gp2, -cutoff, -node->value, &pve_line));
-      game_position_free(gp2);
-      if (node2->value > node->value || (!branch_is_active && node2->value == node->value)) {
+    legal_move_list_from_set(current_node_info->move_set, current_node_info, next_node_info);
+    const int depth = tt ? bit_works_popcount(game_position_x_empties(current_gpx)) : 0;
+    const bool use_tt = tt && depth >= tt_min_depth;
+    Square tt_move = invalid_move;
+    if (use_tt) {
+      TranspositionTableEntry entry;
+      if (transposition_table_probe(tt, current_node_info->hash, depth, &entry)) tt_move = entry.best_move;
+    }
+    node_info_order_moves(current_node_info, next_node_info, &move_ordering, tt_move);
+    current_node_info->best_move = *current_node_info->head_of_legal_move_list;
+    if (pv_full_recording) current_node_info->alpha--;
+    const int alpha = current_node_info->alpha;
+    for (int i = 0; i < current_node_info->move_count; i++) {
+      const Square move = *(current_node_info->head_of_legal_move_list + i);
+      *next_gpx = *current_gpx;
+      const SquareSet flips = game_position_x_do_move(next_gpx, move);
+      if (ctx->hash_is_on) {
+        next_node_info->hash = game_position_x_delta_hash(current_node_info->hash, flips, move, current_gpx->player);
+      }
+      next_node_info->alpha = -current_node_info->beta;
+      next_node_info->beta = -current_node_info->alpha;
+      if (pve) pve_line = pve_line_create(pve);
+      game_position_solve_impl(ctx, result, stack, pvt, &pve_line);
+      if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) {
+        if (pve) pve_line_delete(pve, pve_line);
+        break;
+      }
+      const int value = -next_node_info->alpha;
+      if (value > current_node_info->alpha || (!branch_is_active && value == current_node_info->alpha)) {
         branch_is_active = true;
-        search_node_free(node);
-        node = node2;
-        node->move = move;
-        node2 = NULL;
-        pve_line_add_move(pve, pve_line, move);
-        pve_line_delete(pve, *pve_parent_line_p);
-        *pve_parent_line_p = pve_line;
-        if (node->value > cutoff) goto out;
-        if (!pv_full_recording && node->value == cutoff) goto out;
-      } else {
-        if (pv_full_recording && node2->value == node->value) {
+        current_node_info->alpha = value;
+        current_node_info->best_move = move;
+        if (pvt) pv_triangle_update(pvt, current_fill_index, move);
+        if (pve) {
+          pve_line_add_move(pve, pve_line, move);
+          pve_line_delete(pve, *pve_parent_line_p);
+          *pve_parent_line_p = pve_line;
+        }
+        if (current_node_info->alpha > current_node_info->beta) break;
+        if (!pv_full_recording && current_node_info->alpha == current_node_info->beta) break;
+      } else if (pve) {
+        if (value == current_node_info->alpha) {
           pve_line_add_move(pve, pve_line, move);
           pve_line_add_variant(pve, *pve_parent_line_p, pve_line);
         } else {
           pve_line_delete(pve, pve_line);
         }
-        search_node_free(node2);
       }
     }
+    if (use_tt && !(ctx->budget_is_on && solver_context_budget_is_exhausted(ctx))) {
+      transposition_table_store(tt, current_node_info->hash, depth, alpha, current_node_info->beta,
+                                current_node_info->alpha, current_node_info->best_move);
+    }
   }
- out:
-  if (log_env->log_is_on) {
-    gp_hash_stack_fill_point--;
-  }
-  return node;
+  stack->fill_index--;
+  return;
 }
 
 /*
- * Initializes the move list.
+ * Sets the line of the node at stack `index` to the move followed by the line of the child.
  */
 static void
-move_list_init (MoveList *ml)
+pv_triangle_update (PVTriangle *const pvt,
+                    const int index,
+                    const Square move)
 {
-  for (int i = 0; i < 64; i++) {
-    ml->elements[i].sq = -1;
-    ml->elements[i].mobility = -1;
-    ml->elements[i].pred = NULL;
-    ml->elements[i].succ = NULL;
-  }
-  ml->head.sq = -1;
-  ml->head.mobility = -1;
-  ml->head.pred = NULL;
-  ml->head.succ = &ml->tail;
-  ml->tail.sq = -1;
-  ml->tail.mobility = -1;
-  ml->tail.pred = &ml->head;
-  ml->tail.succ = NULL;
+  const int child_length = pvt->lengths[index + 1];
+  g_assert(child_length < GAME_TREE_MAX_DEPTH);
+  pvt->lines[index][0] = move;
+  memcpy(&pvt->lines[index][1], pvt->lines[index + 1], child_length * sizeof(Square));
+  pvt->lengths[index] = child_length + 1;
 }
 
 /**
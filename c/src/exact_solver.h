@@ -37,6 +37,7 @@
 #include <glib.h>
 
 #include "game_tree_utils.h"
+#include "solver_context.h"
 #include "board.h"
 
 
@@ -49,5 +50,15 @@ extern ExactSolution *
 game_position_solve (const GamePosition *const root,
                      const gchar *const log_file);
 
+extern ExactSolution *
+game_position_solve_with_context (SolverContext *const ctx,
+                                  const GamePosition *const root);
+
+extern void
+exact_solver_set_pv_recording (const ExactSolverPVRecording pv_recording);
+
+extern ExactSolverPVRecording
+exact_solver_get_pv_recording (void);
+
 
 #endif /* EXACT_SOLVER_H */
@@ -224,7 +224,7 @@ game_tree_log_init (const gchar *const file_name_prefix)
 }
 
 /**
- * @brief Returns the json_doc used in the head log by exact_solver and ifes solvers.
+ * @brief Returns the json_doc used in the head log by the ifes solver.
  *
  * @param [in] call_level call level value
  * @param [in] gp         the current game position
@@ -233,14 +233,30 @@ game_tree_log_init (const gchar *const file_name_prefix)
 gchar *
 game_tree_log_data_h_json_doc (const int call_level,
                                const GamePosition *const gp)
+{
+  GamePositionX gpx;
+  game_position_x_copy_from_gp(gp, &gpx);
+  return game_tree_log_data_h_json_doc_gpx(call_level, &gpx);
+}
+
+/**
+ * @brief Returns the json_doc used in the head log by solvers searching on a game position x.
+ *
+ * @param [in] call_level call level value
+ * @param [in] gpx        the current game position x
+ * @return                the newly constucted json string
+ */
+gchar *
+game_tree_log_data_h_json_doc_gpx (const int call_level,
+                                   const GamePositionX *const gpx)
 {
   gchar *ret = NULL;
   GString *json_doc;
   json_doc = g_string_sized_new(256);
-  const gboolean is_leaf = !game_position_has_any_player_any_legal_move(gp);
-  const SquareSet legal_moves = game_position_legal_moves(gp);
+  const gboolean is_leaf = !game_position_x_has_any_player_any_legal_move(gpx);
+  const SquareSet legal_moves = game_position_x_legal_moves(gpx);
   const int legal_move_count = bit_works_popcount(legal_moves);
-  const SquareSet empties = board_empties(gp->board);
+  const SquareSet empties = game_position_x_empties(gpx);
   const int empty_count = bit_works_popcount(empties);
   const int legal_move_count_adj = legal_move_count + ((legal_moves == 0 && !is_leaf) ? 1 : 0);
   gchar *legal_moves_pg_json_array = square_set_to_pg_json_array(legal_moves);
@@ -105,4 +105,8 @@ extern gchar *
 game_tree_log_data_h_json_doc (const int                  call_level,
                                const GamePosition * const gp);
 
+extern gchar *
+game_tree_log_data_h_json_doc_gpx (const int                   call_level,
+                                   const GamePositionX * const gpx);
+
 #endif /* GAME_TREE_LOGGER_H */
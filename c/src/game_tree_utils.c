@@ -71,6 +71,47 @@ pve_index_lines (const PVEnv *const pve);
  * Internal variables and constants.
  */
 
+/* True when the solvers prune nodes by means of the stable discs. */
+static gboolean stability_cutoff_enabled = FALSE;
+
+/* True when the solvers search the win/loss/draw window. */
+static gboolean wld_enabled = FALSE;
+
+/* The move ordering policy returned by node_info_move_ordering_get, all methods are off, moves keep the natural order. */
+static MoveOrdering move_ordering = { 61, 61, 61 };
+
+/* The budget given to the searches, no limit by default. */
+static SearchBudget search_budget = { 0, 0.0 };
+
+/* The squares grouped by their static priority, from the highest to the lowest. */
+static const SquareSet legal_moves_priority_mask[] = {
+  /* D4, E4, E5, D5 */                 0x0000001818000000,
+  /* A1, H1, H8, A8 */                 0x8100000000000081,
+  /* C1, F1, F8, C8, A3, H3, H6, A6 */ 0x2400810000810024,
+  /* C3, F3, F6, C6 */                 0x0000240000240000,
+  /* D1, E1, E8, D8, A4, H4, H5, A5 */ 0x1800008181000018,
+  /* D3, E3, E6, D6, C4, F4, F5, C5 */ 0x0000182424180000,
+  /* D2, E2, E7, D7, B4, G4, G5, B5 */ 0x0018004242001800,
+  /* C2, F2, F7, C7, B3, G3, G6, B6 */ 0x0024420000422400,
+  /* B1, G1, G8, B8, A2, H2, H7, A7 */ 0x4281000000008142,
+  /* B2, G2, G7, B7 */                 0x0042000000004200
+};
+
+/* The size of the legal_moves_priority_mask array. */
+static const int legal_moves_priority_cluster_count =
+  sizeof(legal_moves_priority_mask) / sizeof(legal_moves_priority_mask[0]);
+
+/* The four quadrants of the board: A1-D4, E1-H4, A5-D8, E5-H8. */
+static const SquareSet quadrant_mask[] = {
+  0x000000000F0F0F0F,
+  0x00000000F0F0F0F0,
+  0x0F0F0F0F00000000,
+  0xF0F0F0F000000000
+};
+
+/* Below this number of empty squares the stability cutoff is not tried. */
+static const int stability_cutoff_min_empties = 9;
+
 /**
  * @endcond
  */
@@ -104,6 +145,11 @@ exact_solution_new (void)
   es->final_board = NULL;
   es->node_count = 0;
   es->leaf_count = 0;
+  es->is_wld = FALSE;
+  es->root_move_count = 0;
+  es->is_incomplete = FALSE;
+  es->lower_bound = worst_score;
+  es->upper_bound = best_score;
 
   return es;
 }
@@ -150,9 +196,26 @@ exact_solution_to_string (const ExactSolution *const es)
   g_string_append_printf(tmp, "[node_count=%" PRIu64 ", leaf_count=%" PRIu64 "]\n",
                          es->node_count,
                          es->leaf_count);
-  g_string_append_printf(tmp, "Final outcome: best move=%s, position value=%d\n",
-                         square_as_move_to_string(es->pv[0]),
-                         es->outcome);
+  if (es->is_incomplete) {
+    g_string_append_printf(tmp, "Final outcome: best move=%s, position value in [%+d..%+d], the search is incomplete\n",
+                           square_as_move_to_string(es->pv[0]),
+                           es->lower_bound,
+                           es->upper_bound);
+  } else if (es->is_wld) {
+    g_string_append_printf(tmp, "Final outcome: best move=%s, position value=%s\n",
+                           square_as_move_to_string(es->pv[0]),
+                           es->outcome > 0 ? "win" : (es->outcome < 0 ? "loss" : "draw"));
+  } else {
+    g_string_append_printf(tmp, "Final outcome: best move=%s, position value=%d\n",
+                           square_as_move_to_string(es->pv[0]),
+                           es->outcome);
+  }
+
+  if (es->root_move_count != 0) {
+    gchar *rm_to_s = exact_solution_root_moves_to_string(es);
+    g_string_append_printf(tmp, "Root moves: %s\n", rm_to_s);
+    g_free(rm_to_s);
+  }
 
   if (es->pv_length != 0) {
     gchar *pv_to_s = square_as_move_array_to_string(es->pv, es->pv_length);
@@ -195,6 +258,162 @@ exact_solution_compute_final_board (ExactSolution *const es)
   game_position_free(gp);
 }
 
+/**
+ * @brief Turns on or off the win/loss/draw search in the alpha-beta based solvers.
+ *
+ * @details When on, the solvers search the root game position with the window
+ * [#wld_alpha..#wld_beta], that is enough to tell a win from a draw or a loss,
+ * and report the outcome by means of #exact_solution_set_wld_outcome.
+ *
+ * @param [in] enabled true to turn the win/loss/draw search on
+ */
+void
+exact_solution_wld_set_enabled (const gboolean enabled)
+{
+  wld_enabled = enabled;
+}
+
+/**
+ * @brief Returns `TRUE` when the win/loss/draw search is turned on.
+ *
+ * @return true if the win/loss/draw search is on
+ */
+gboolean
+exact_solution_wld_is_enabled (void)
+{
+  return wld_enabled;
+}
+
+/**
+ * @brief Reduces the outcome to its sign, and marks the solution as a win/loss/draw one.
+ *
+ * @details The value returned by a search of the win/loss/draw window is exact only when it is a draw,
+ * otherwise it is a bound having the right sign.
+ *
+ * @invariant Parameter `es` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] es a pointer to the exact solution structure
+ */
+void
+exact_solution_set_wld_outcome (ExactSolution *const es)
+{
+  g_assert(es);
+
+  es->outcome = (es->outcome > 0) - (es->outcome < 0);
+  es->is_wld = TRUE;
+}
+
+/**
+ * @brief Returns the scored root moves formatted as the description field of the ffo entries
+ * of the game position database, for instance `G8:+18. H1:+12. H7:+6.`
+ *
+ * @details The string is empty when the root moves are not scored.
+ * The returned string has to be deallocated by the caller.
+ *
+ * @invariant Parameter `es` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] es a pointer to the exact solution structure
+ * @return        a string listing the root moves and their values
+ */
+gchar *
+exact_solution_root_moves_to_string (const ExactSolution *const es)
+{
+  g_assert(es);
+
+  GString *tmp = g_string_sized_new(32);
+  for (int i = 0; i < es->root_move_count; i++) {
+    g_string_append_printf(tmp, "%s%s:%+d.",
+                           i == 0 ? "" : " ",
+                           square_as_move_to_string(es->root_moves[i].move),
+                           es->root_moves[i].value);
+  }
+  gchar *s = tmp->str;
+  g_string_free(tmp, FALSE);
+  return s;
+}
+
+
+
+/**
+ * @brief Marks the solution as the result of a search stopped by the budget.
+ *
+ * @details The outcome is set to the lower bound. When the search has not found a move
+ * reaching the lower bound, `best_move` is `invalid_move`, and the first legal move of
+ * the solved game position is reported, or the pass move when there is none.
+ * The principal variation and the final board are not given.
+ *
+ * @invariant Parameter `es` must be not `NULL`.
+ * Parameters `lower_bound` and `upper_bound` must satisfy `worst_score <= lower_bound <= upper_bound <= best_score`.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] es          a pointer to the exact solution structure
+ * @param [in]     lower_bound the lower bound of the game value
+ * @param [in]     upper_bound the upper bound of the game value
+ * @param [in]     best_move   the move reaching the lower bound, or `invalid_move`
+ */
+void
+exact_solution_set_incomplete (ExactSolution *const es,
+                               const int lower_bound,
+                               const int upper_bound,
+                               const Square best_move)
+{
+  g_assert(es);
+  g_assert(worst_score <= lower_bound && lower_bound <= upper_bound && upper_bound <= best_score);
+
+  Square move = best_move;
+  if (move == invalid_move && es->solved_game_position) {
+    const SquareSet moves = game_position_legal_moves(es->solved_game_position);
+    move = moves ? bit_works_bitscanLS1B_64(moves) : pass_move;
+  }
+
+  es->is_incomplete = TRUE;
+  es->lower_bound = lower_bound;
+  es->upper_bound = upper_bound;
+  es->outcome = lower_bound;
+  es->pv[0] = move;
+  es->pv_length = 0;
+}
+
+
+
+/*********************************************************/
+/* Function implementations for the SearchBudget entity. */
+/*********************************************************/
+
+/**
+ * @brief Sets the budget given to the searches.
+ *
+ * @details It is the process wide option, copied by the solver contexts when they are created.
+ *
+ * @invariant Parameter `sb` must be not `NULL`, and the time limit must not be negative.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] sb the search budget
+ */
+void
+search_budget_set (const SearchBudget *const sb)
+{
+  g_assert(sb && sb->time_limit >= 0.0);
+  search_budget = *sb;
+}
+
+/**
+ * @brief Copies the budget given to the searches into `sb`.
+ *
+ * @invariant Parameter `sb` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [out] sb the search budget
+ */
+void
+search_budget_get (SearchBudget *const sb)
+{
+  g_assert(sb);
+  *sb = search_budget;
+}
+
 
 
 /**************************************************/
@@ -936,6 +1155,222 @@ search_node_negated (SearchNode *sn)
 
 
 
+/*****************************************************/
+/* Function implementations for the NodeInfo entity. */
+/*****************************************************/
+
+/**
+ * @brief Turns on or off the stability cutoff in the solvers calling #node_info_stability_cutoff.
+ *
+ * @param [in] enabled true to turn the stability cutoff on
+ */
+void
+node_info_stability_cutoff_set_enabled (const gboolean enabled)
+{
+  stability_cutoff_enabled = enabled;
+}
+
+/**
+ * @brief Returns `TRUE` when the stability cutoff is turned on.
+ *
+ * @return true if the stability cutoff is on
+ */
+gboolean
+node_info_stability_cutoff_is_enabled (void)
+{
+  return stability_cutoff_enabled;
+}
+
+/**
+ * @brief Checks if the stable discs prove the node value being outside the alpha-beta window.
+ *
+ * @details The opponent stable discs set an upper bound to the node value, when it is not
+ * greater than alpha the node fails low. The player stable discs set a lower bound, when it
+ * is not less than beta the node fails high. In both cases the bound is assigned to the alpha field,
+ * best_move is set to `invalid_move`, and the function returns `TRUE`.
+ *
+ * Discs are counted only when the disc count of each side allows the cutoff, and the node
+ * has enough empty squares to make the computation worthwhile.
+ *
+ * @param [in,out] node_info the node to be checked
+ * @return                   true when the node has been cut off
+ */
+gboolean
+node_info_stability_cutoff (NodeInfo *const node_info)
+{
+  const GamePositionX *const gpx = &node_info->gpx;
+  const SquareSet p = game_position_x_get_player(gpx);
+  const SquareSet o = game_position_x_get_opponent(gpx);
+  const int p_count = bit_works_popcount(p);
+  const int o_count = bit_works_popcount(o);
+
+  if (64 - (p_count + o_count) < stability_cutoff_min_empties) return FALSE;
+
+  const gboolean may_fail_low = 64 - 2 * o_count <= node_info->alpha;
+  const gboolean may_fail_high = 2 * p_count - 64 >= node_info->beta;
+  if (!may_fail_low && !may_fail_high) return FALSE;
+
+  const SquareSet stable = game_position_x_stable_discs(gpx);
+  if (may_fail_low) {
+    const int upper_bound = 64 - 2 * bit_works_popcount(stable & o);
+    if (upper_bound <= node_info->alpha) {
+      node_info->alpha = upper_bound;
+      node_info->best_move = invalid_move;
+      return TRUE;
+    }
+  }
+  if (may_fail_high) {
+    const int lower_bound = 2 * bit_works_popcount(stable & p) - 64;
+    if (lower_bound >= node_info->beta) {
+      node_info->alpha = lower_bound;
+      node_info->best_move = invalid_move;
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/**
+ * @brief Moves `move` to the head of the legal move list of the node.
+ *
+ * @details The moves preceding it are shifted by one position, the relative order of the
+ * other moves is preserved. When `move` is not in the list, as for `pass_move` or
+ * `invalid_move`, the list is not changed.
+ *
+ * @param [in,out] node_info the node whose move list is reordered
+ * @param [in]     move      the move to be searched first
+ */
+void
+node_info_move_list_put_first (NodeInfo *const node_info,
+                               const Square move)
+{
+  uint8_t *const head = node_info->head_of_legal_move_list;
+  for (int i = 1; i < node_info->move_count; i++) {
+    if (head[i] == move) {
+      for (; i > 0; i--) head[i] = head[i - 1];
+      head[0] = move;
+      return;
+    }
+  }
+}
+
+
+
+/**
+ * @brief Sets the move ordering policy returned by #node_info_move_ordering_get.
+ *
+ * @invariant Parameter `mo` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] mo the move ordering policy
+ */
+void
+node_info_move_ordering_set (const MoveOrdering *const mo)
+{
+  g_assert(mo);
+
+  move_ordering = *mo;
+}
+
+/**
+ * @brief Copies the move ordering policy, set by #node_info_move_ordering_set, into `mo`.
+ *
+ * @details The initial policy keeps the natural order of the moves.
+ *
+ * @invariant Parameter `mo` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [out] mo the move ordering policy
+ */
+void
+node_info_move_ordering_get (MoveOrdering *const mo)
+{
+  g_assert(mo);
+
+  *mo = move_ordering;
+}
+
+/**
+ * @brief Sorts the legal move list of the node as selected by the move ordering policy.
+ *
+ * @details The list must be already populated, see #legal_move_list_from_set, the moves are sorted in place.
+ * The game position of the next node is used as a scratch area by the fastest first method.
+ * Finally `first_move`, usually the best move found into the transposition table, is moved to the head
+ * of the list, see #node_info_move_list_put_first.
+ *
+ * @invariant Parameters `current_node_info`, `next_node_info`, and `mo` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] current_node_info the node whose move list is sorted
+ * @param [out]    next_node_info    the next node, used as a scratch area
+ * @param [in]     mo                the move ordering policy
+ * @param [in]     first_move        the move searched first, or `invalid_move`
+ */
+void
+node_info_order_moves (NodeInfo *const current_node_info,
+                       NodeInfo *const next_node_info,
+                       const MoveOrdering *const mo,
+                       const Square first_move)
+{
+  g_assert(current_node_info);
+  g_assert(next_node_info);
+  g_assert(mo);
+
+  const GamePositionX *const current_gpx = &current_node_info->gpx;
+  const SquareSet empties = game_position_x_empties(current_gpx);
+  const int empty_count = bit_works_popcount(empties);
+  const gboolean fastest_first = empty_count >= mo->fastest_first_min_empties;
+  const gboolean parity = !fastest_first && empty_count >= mo->parity_min_empties;
+  const gboolean priority = fastest_first || parity || empty_count >= mo->priority_min_empties;
+
+  if (priority && current_node_info->move_count > 1) {
+    uint8_t *const moves = current_node_info->head_of_legal_move_list;
+    SquareSet move_set = empty_square_set;
+    for (int i = 0; i < current_node_info->move_count; i++) move_set |= (SquareSet) 1 << moves[i];
+
+    SquareSet preferred = move_set;
+    if (parity) {
+      SquareSet odd_quadrants = empty_square_set;
+      for (int q = 0; q < 4; q++) {
+        if (bit_works_popcount(empties & quadrant_mask[q]) & 1) odd_quadrants |= quadrant_mask[q];
+      }
+      preferred &= odd_quadrants;
+    }
+
+    GamePositionX *const next_gpx = &next_node_info->gpx;
+    int mobility[64];
+    int move_count = 0;
+    for (int pass = 0; pass < 2; pass++) {
+      const SquareSet pass_set = pass == 0 ? preferred : move_set & ~preferred;
+      for (int i = 0; i < legal_moves_priority_cluster_count; i++) {
+        SquareSet moves_to_search = legal_moves_priority_mask[i] & pass_set;
+        while (moves_to_search) {
+          const Square move = bit_works_bitscanLS1B_64(moves_to_search);
+          moves_to_search &= ~(1ULL << move);
+          int next_move_count = 0;
+          if (fastest_first) {
+            game_position_x_make_move(current_gpx, move, next_gpx);
+            next_move_count = bit_works_popcount(game_position_x_legal_moves(next_gpx));
+          }
+          int j = move_count;
+          for (; j > 0 && mobility[j - 1] > next_move_count; j--) {
+            moves[j] = moves[j - 1];
+            mobility[j] = mobility[j - 1];
+          }
+          moves[j] = move;
+          mobility[j] = next_move_count;
+          move_count++;
+        }
+      }
+    }
+    g_assert(move_count == current_node_info->move_count);
+  }
+
+  node_info_move_list_put_first(current_node_info, first_move);
+}
+
+
+
 /**********************************************************/
 /* Function implementations for the GameTreeStack entity. */
 /**********************************************************/
@@ -990,6 +1425,7 @@ game_tree_stack_init (const GamePosition *const root,
 
   NodeInfo* first_node_info  = &stack->nodes[1];
   game_position_x_copy_from_gp(root, &first_node_info->gpx);
+  first_node_info->hash = game_position_x_hash(&first_node_info->gpx);
   first_node_info->head_of_legal_move_list = &stack->legal_move_stack[0];
   first_node_info->alpha = worst_score;
   first_node_info->beta = best_score;
@@ -1138,11 +1574,12 @@ pve_index_lines (const PVEnv *const pve)
   const int lines_segments_in_use_count = pve->lines_segments_head - pve->lines_segments;
   PVCell ***used_lines_stack_p = index;
   PVCell ***free_lines_stack_p = index + lines_in_use_count;
+  PVCell ***const index_end = index + pve->lines_size;
   for (int i = 0; i < lines_segments_in_use_count; i++) {
     size_t segment_size = *(pve->lines_segments_sizes + i);
     for (int j = 0; j < segment_size; j++) {
       PVCell **line = *(pve->lines_segments_sorted + i) + j;
-      if (line < *free_lines_stack_p) {
+      if (free_lines_stack_p == index_end || line < *free_lines_stack_p) {
         *used_lines_stack_p++ = line;
       } else {
         free_lines_stack_p++;
@@ -57,6 +57,11 @@
  */
 #define MAX_LEGAL_MOVE_STACK_COUNT 1024
 
+/*
+ * Max number of root moves scored by an exact solution, the legal moves are never more than the squares.
+ */
+#define ROOT_MOVES_MAX_COUNT 64
+
 #include <glib.h>
 
 #include "board.h"
@@ -67,6 +72,14 @@
 /* Type declarations.                         */
 /**********************************************/
 
+/**
+ * @brief A search node is the most simple structure returned by the implementations of the search function.
+ */
+typedef struct {
+  Square move;       /**< @brief The move to play. */
+  int    value;      /**< @brief The move's value. */
+} SearchNode;
+
 /**
  * @brief An exact solution is an entity that holds the result of a #game_position_solve run.
  */
@@ -78,6 +91,12 @@ typedef struct {
   Board        *final_board;                 /**< @brief The final board state. */
   uint64_t      leaf_count;                  /**< @brief The count of leaf nodes searched by the solver. */
   uint64_t      node_count;                  /**< @brief The count of all nodes touched by the solver. */
+  gboolean      is_wld;                      /**< @brief True when the outcome is just -1, 0, or +1, for a loss, a draw, or a win. */
+  SearchNode    root_moves[ROOT_MOVES_MAX_COUNT]; /**< @brief The exact value of each legal root move, best first. */
+  int           root_move_count;             /**< @brief The count of scored root moves, zero when they are not scored. */
+  gboolean      is_incomplete;               /**< @brief True when the search has been stopped by the budget. */
+  int           lower_bound;                 /**< @brief The lower bound of the game value, established by an incomplete search. */
+  int           upper_bound;                 /**< @brief The upper bound of the game value, established by an incomplete search. */
 } ExactSolution;
 
 /**
@@ -119,14 +138,6 @@ typedef struct {
   PVCell ***lines_stack_head;       /**< @brief The pointer to the next, free to be assigned, pointer in the lines array. */
 } PVEnv;
 
-/**
- * @brief A search node is the most simple structure returned by the implementations of the search function.
- */
-typedef struct {
-  Square move;       /**< @brief The move to play. */
-  int    value;      /**< @brief The move's value. */
-} SearchNode;
-
 /**
  * @brief The info collected on each node.
  */
@@ -141,6 +152,34 @@ typedef struct {
   int            beta;                        /**< @brief The node cutoff value. */
 } NodeInfo;
 
+/**
+ * @brief The move ordering policy, it selects how the legal moves of a node are sorted by the count of empty squares.
+ *
+ * @details Nodes having at least `fastest_first_min_empties` empty squares search first the moves leaving
+ * the opponent with the fewest replies. Otherwise, nodes having at least `parity_min_empties` empty squares
+ * search first the moves falling in the quadrants having an odd count of empty squares. Otherwise, nodes having
+ * at least `priority_min_empties` empty squares sort the moves by a static priority of the squares, corners first.
+ * Remaining nodes keep the natural order, from A1 to H8.
+ *
+ * A threshold greater than 60 turns the method off. Ties are always broken by the static priority.
+ */
+typedef struct {
+  int fastest_first_min_empties;              /**< @brief The fewest empty squares sorted by the opponent mobility. */
+  int parity_min_empties;                     /**< @brief The fewest empty squares sorted by the quadrant parity. */
+  int priority_min_empties;                   /**< @brief The fewest empty squares sorted by the static square priority. */
+} MoveOrdering;
+
+/**
+ * @brief The limits given to a search, a zero field means no limit.
+ *
+ * @details A search running out of the budget stops, and returns the bounds of the game value
+ * established so far, see #exact_solution_set_incomplete.
+ */
+typedef struct {
+  uint64_t node_limit;                        /**< @brief The count of nodes the search can visit. */
+  double   time_limit;                        /**< @brief The seconds the search can run, measured on the wall clock. */
+} SearchBudget;
+
 /**
  * @brief The info collected by deepening the game tree.
  *
@@ -183,6 +222,16 @@ static const int best_score = +64;
  */
 static const int worst_score = -64;
 
+/**
+ * @brief The lower limit of the window searched by a win/loss/draw solve.
+ */
+static const int wld_alpha = -1;
+
+/**
+ * @brief The upper limit of the window searched by a win/loss/draw solve.
+ */
+static const int wld_beta = +1;
+
 
 
 /*****************************************************/
@@ -201,6 +250,24 @@ exact_solution_to_string (const ExactSolution *const es);
 extern void
 exact_solution_compute_final_board (ExactSolution *const es);
 
+extern void
+exact_solution_wld_set_enabled (const gboolean enabled);
+
+extern gboolean
+exact_solution_wld_is_enabled (void);
+
+extern void
+exact_solution_set_wld_outcome (ExactSolution *const es);
+
+extern gchar *
+exact_solution_root_moves_to_string (const ExactSolution *const es);
+
+extern void
+exact_solution_set_incomplete (ExactSolution *const es,
+                               const int lower_bound,
+                               const int upper_bound,
+                               const Square best_move);
+
 
 
 /*********************************************/
@@ -273,6 +340,49 @@ search_node_negated (SearchNode *sn);
 
 
 
+/************************************************/
+/* Function prototypes for the NodeInfo entity. */
+/************************************************/
+
+extern void
+node_info_stability_cutoff_set_enabled (const gboolean enabled);
+
+extern gboolean
+node_info_stability_cutoff_is_enabled (void);
+
+extern gboolean
+node_info_stability_cutoff (NodeInfo *const node_info);
+
+extern void
+node_info_move_list_put_first (NodeInfo *const node_info,
+                               const Square move);
+
+extern void
+node_info_move_ordering_set (const MoveOrdering *const mo);
+
+extern void
+node_info_move_ordering_get (MoveOrdering *const mo);
+
+extern void
+node_info_order_moves (NodeInfo *const current_node_info,
+                       NodeInfo *const next_node_info,
+                       const MoveOrdering *const mo,
+                       const Square first_move);
+
+
+
+/****************************************************/
+/* Function prototypes for the SearchBudget entity. */
+/****************************************************/
+
+extern void
+search_budget_set (const SearchBudget *const sb);
+
+extern void
+search_budget_get (SearchBudget *const sb);
+
+
+
 /*****************************************************/
 /* Function prototypes for the GameTreeStack entity. */
 /*****************************************************/
@@ -37,6 +37,7 @@
 #include <inttypes.h>
 
 #include "game_tree_logger.h"
+#include "solver_context.h"
 #include "improved_fast_endgame_solver.h"
 
 
@@ -70,6 +71,61 @@ typedef struct {
   int8_t  value;     /**< @brief The game value of moving into the square. */
 } Node;
 
+/*
+ * The state of a search, allocated by the entry function and passed to the recursive ones.
+ *
+ * The board is represented by a 1D array of 91 uint8_ts board[0..90]:
+ * ddddddddd
+ * dxxxxxxxx
+ * dxxxxxxxx
+ * dxxxxxxxx
+ * dxxxxxxxx
+ * dxxxxxxxx
+ * dxxxxxxxx
+ * dxxxxxxxx       where A1 is board[10], H8 is board[80].
+ * dxxxxxxxx       square(a,b) = board[10+a+b*9] for 0 <= a, b <= 7.
+ * dddddddddd
+ * where d (dummy) squares contain DUMMY, x are EMPTY, BLACK, or WHITE:
+ *
+ *       A   B   C   D   E   F   G   H
+ *       -   -   -   -   -   -   -   -
+ *  1 - 10  11  12  13  14  15  16  17
+ *  2 - 19  20  21  22  23  24  25  26
+ *  3 - 28  29  30  31  32  33  34  35
+ *  4 - 37  38  39  40  41  42  43  44
+ *  5 - 46  47  48  49  50  51  52  53
+ *  6 - 55  56  57  58  59  60  61  62
+ *  7 - 64  65  66  67  68  69  70  71
+ *  8 - 73  74  75  76  77  78  79  80
+ *
+ * Also there is a doubly linked list of the empty squares.
+ * em_head points to the first empty square in the list (or NULL if none).
+ * The list in maintained in a fixed best-to-worst order.
+ *
+ * Also, and finally, each empty square knows the region it is in
+ * and knows the directions you can flip in via some bit masks.
+ * There are up to 32 regions. The parities of the regions are in
+ * the region_parity bit vector.
+ *
+ * The flip stack stores the pointers to the board element that are flipped
+ * by each move during the search tree expansion.
+ * An upper bound of the size of the stack is:
+ * number_of_moves_in_a_game * max_flips_per_move = 60 * (3*6) = 1080.
+ * But, first move flips always one discs (not sixteen), second the same,
+ * so in a game 1024 is a trusted upper bound.
+ * The flip_stack pointer identifies the next empty position in the stack.
+ */
+typedef struct {
+  SolverContext  *ctx;                   /**< @brief The solver context. */
+  ExactSolution  *solution;              /**< @brief The solution, collecting the counters. */
+  uint8_t         board[91];             /**< @brief The game board. */
+  EmList          em_head;               /**< @brief The head of the list of empty squares. */
+  EmList          ems[64];               /**< @brief The elements of the list of empty squares. */
+  uint64_t        region_parity;         /**< @brief The parities of the regions. */
+  uint8_t        *flip_stack_base[1024]; /**< @brief The flip stack. */
+  uint8_t       **flip_stack;            /**< @brief The next empty position in the flip stack. */
+} IfesSearch;
+
 
 
 /*
@@ -90,11 +146,11 @@ game_position_to_ifes_board (const GamePosition *const gp,
 static IFES_SquareState
 game_position_get_ifes_player (const GamePosition *const gp);
 
-inline static void
-directional_flips (uint8_t *sq, int inc, int color, int oppcol);
+inline static uint8_t **
+directional_flips (uint8_t **flip_stack, uint8_t *sq, int inc, int color, int oppcol);
 
 static int
-do_flips (uint8_t *board, int sqnum, int color, int oppcol);
+do_flips (IfesSearch *const s, int sqnum, int color, int oppcol);
 
 inline static int
 ct_directional_flips (uint8_t *sq, int inc, int color, int oppcol);
@@ -109,31 +165,31 @@ static int
 any_flips (uint8_t *board, int sqnum, int color, int oppcol);
 
 inline static void
-undo_flips (int flip_count, int oppcol);
+undo_flips (IfesSearch *const s, int flip_count, int oppcol);
 
 inline static uint64_t
 minu (uint64_t a, uint64_t b);
 
 static int
-count_mobility (uint8_t *board, int color);
+count_mobility (IfesSearch *const s, int color);
 
 static void
-prepare_to_solve (uint8_t *board);
+prepare_to_solve (IfesSearch *const s);
 
 inline static Node
-no_parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int beta,
+no_parity_end_solve (IfesSearch *const s, int alpha, int beta,
                      int color, int empties, int discdiff, int prevmove);
 
 static Node
-parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int beta,
+parity_end_solve (IfesSearch *const s, int alpha, int beta,
                   int color, int empties, int discdiff, int prevmove);
 
 static Node
-fastest_first_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int beta,
+fastest_first_end_solve (IfesSearch *const s, int alpha, int beta,
                          int color, int empties, int discdiff, int prevmove);
 
 static Node
-end_solve (ExactSolution *solution, uint8_t *board, int alpha, int beta,
+end_solve (IfesSearch *const s, int alpha, int beta,
            int color, int empties, int discdiff, int prevmove);
 
 static char *
@@ -306,88 +362,6 @@ static const uint8_t flipping_dir_mask_table[91] =
     0,   0,   0,   0,   0,   0,   0,   0,   0, 0
   };
 
-
-
-/*
- * Internal variables.
- */
-
-/* The logging environment structure. */
-static LogEnv *log_env = NULL;
-
-/* The total number of call to the recursive function that traverse the game DAG. */
-static uint64_t call_count = 0;
-
-/* The predecessor-successor array of game position hash values. */
-static uint64_t gp_hash_stack[128];
-
-/* The index of the last entry into gp_hash_stack. */
-static int gp_hash_stack_fill_point = 0;
-
-/* The sub_run_id used for logging. */
-static const int sub_run_id = 0;
-
-/*
- * Inside this fast endgame solver, the board is represented by
- * a 1D array of 91 uint8_ts board[0..90]:
- * ddddddddd
- * dxxxxxxxx
- * dxxxxxxxx
- * dxxxxxxxx
- * dxxxxxxxx
- * dxxxxxxxx
- * dxxxxxxxx
- * dxxxxxxxx       where A1 is board[10], H8 is board[80].
- * dxxxxxxxx       square(a,b) = board[10+a+b*9] for 0 <= a, b <= 7.
- * dddddddddd
- * where d (dummy) squares contain DUMMY, x are EMPTY, BLACK, or WHITE:
- *
- *       A   B   C   D   E   F   G   H
- *       -   -   -   -   -   -   -   -
- *  1 - 10  11  12  13  14  15  16  17
- *  2 - 19  20  21  22  23  24  25  26
- *  3 - 28  29  30  31  32  33  34  35
- *  4 - 37  38  39  40  41  42  43  44
- *  5 - 46  47  48  49  50  51  52  53
- *  6 - 55  56  57  58  59  60  61  62
- *  7 - 64  65  66  67  68  69  70  71
- *  8 - 73  74  75  76  77  78  79  80
- *
- */
-static uint8_t board[91];
-
-/*
- * Also there is a doubly linked list of the empty squares.
- * em_head points to the first empty square in the list (or NULL if none).
- * The list in maintained in a fixed best-to-worst order.
- */
-static EmList em_head, ems[64];
-
-/*
- * Also, and finally, each empty square knows the region it is in
- * and knows the directions you can flip in via some bit masks.
- * There are up to 32 regions. The parities of the regions are in
- * the region_parity bit vector:
- */
-static uint64_t region_parity;
-
-/*
- * Stores the pointers to the board element that are flipped
- * by each move during the search tree expansion.
- *
- * An upper bound of the size of the stack is:
- * number_of_moves_in_a_game * max_flips_per_move = 60 * (3*6) = 1080.
- * But, first move flips always one discs (not sixteen), second the same,
- * so in a game 1024 is a trusted upper bound.
- */
-static uint8_t *global_flip_stack[1024];
-
-/*
- * A global pointer to one element of `global_flip_stack`,
- * it identify the next empty position in the stack.
- */
-static uint8_t **flip_stack = &(global_flip_stack[0]);
-
 /**
  * @endcond
  */
@@ -403,6 +377,7 @@ static uint8_t **flip_stack = &(global_flip_stack[0]);
  *        applying the ifes solver.
  *
  * The "Improved Fast Endgame Solver" is described by the module documentation.
+ * It is a wrapper of #game_position_ifes_solve_with_context, running on a new context.
  *
  * @invariant Parameters `root` must be not `NULL`.
  * The invariants are guarded by assertions.
@@ -414,58 +389,105 @@ static uint8_t **flip_stack = &(global_flip_stack[0]);
 ExactSolution *
 game_position_ifes_solve (const GamePosition * const root,
                           const gchar        * const log_file)
+{
+  g_assert(root);
+
+  SolverContext *ctx = solver_context_new();
+  ctx->log_file = log_file;
+  ExactSolution *result = game_position_ifes_solve_with_context(ctx, root);
+  solver_context_free(ctx);
+  return result;
+}
+
+/**
+ * @brief Solves the game position defined by the `root` parameter,
+ *        applying the ifes solver with the options of the solver context.
+ *
+ * The board, the list of empty squares, and the flip stack are allocated on
+ * the stack of the function, searches on distinct contexts can run concurrently.
+ *
+ * @invariant Parameters `ctx` and `root` must be not `NULL`.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] ctx  the solver context
+ * @param [in]     root the game position to be solved
+ * @return              the exact solution is the collector for results
+ */
+ExactSolution *
+game_position_ifes_solve_with_context (SolverContext *const ctx,
+                                       const GamePosition *const root)
 {
   ExactSolution *result;    /* The solution structure returned by the function. */
   int            emp;       /* Empty discs count. */
   int            wc, bc;    /* White and Black discs count. */
   int            discdiff;  /* Disc difference between player and opponent. */
   Node           n;         /* Best node returned by the search. */
+  IfesSearch     search;    /* The state of the search. */
+  IfesSearch    *s;         /* A pointer to the state of the search. */
 
+  g_assert(ctx);
   g_assert(root);
 
-  log_env = game_tree_log_init(log_file);
+  solver_context_search_start(ctx);
 
-  if (log_env->log_is_on) {
-    gp_hash_stack[0] = 0;
-    game_tree_log_open_h(log_env);
+  if (ctx->log_env->log_is_on) {
+    ctx->gp_hash_stack[0] = 0;
+    game_tree_log_open_h(ctx->log_env);
   }
 
   result = exact_solution_new();
   result->solved_game_position = game_position_clone(root);
 
-  game_position_to_ifes_board(root, board, &emp, &wc, &bc);
+  s = &search;
+  s->ctx = ctx;
+  s->solution = result;
+  s->flip_stack = &(s->flip_stack_base[0]);
+
+  game_position_to_ifes_board(root, s->board, &emp, &wc, &bc);
 
   IFES_SquareState player = game_position_get_ifes_player(root);
 
   discdiff = player == IFES_BLACK ? bc - wc : wc - bc;
 
-  prepare_to_solve(board);
+  prepare_to_solve(s);
 
   /** Debug info **/
   if (FALSE) {
     printf("\nEmpty Square Doubly linked List debug info:\n");
     printf("em_head: address=%p [square=%2d (%s), hole_id=%" PRIu64 "] pred=%p succ=%p\n",
-           (void*) &em_head, em_head.square, ifes_square_to_string(em_head.square), em_head.hole_id,
-           (void*) em_head.pred, (void*) em_head.succ);
+           (void*) &s->em_head, s->em_head.square, ifes_square_to_string(s->em_head.square), s->em_head.hole_id,
+           (void*) s->em_head.pred, (void*) s->em_head.succ);
     for (int k = 0; k < 64; k++) {
-      if (ems[k].square != 0)
+      if (s->ems[k].square != 0)
         printf("ems[%2d]: address=%p [square=%2d (%s), hole_id=%" PRIu64 "] pred=%p succ=%p\n",
-               k, (void*) &ems[k], ems[k].square, ifes_square_to_string(ems[k].square), ems[k].hole_id,
-               (void*) ems[k].pred, (void*) ems[k].succ);
+               k, (void*) &s->ems[k], s->ems[k].square, ifes_square_to_string(s->ems[k].square), s->ems[k].hole_id,
+               (void*) s->ems[k].pred, (void*) s->ems[k].succ);
     }
-    printf("region_parity=%" PRIu64 "\n", region_parity);
+    printf("region_parity=%" PRIu64 "\n", s->region_parity);
     printf("\n");
     printf("use_parity=%d. fastest_first=%d.\n",
            use_parity, fastest_first);
   }
   /** **/
 
-  n = end_solve(result, board, -64, 64, player, emp, discdiff, 1);
+  const gboolean wld = ctx->wld;
+  const int root_alpha = wld ? wld_alpha : worst_score;
+  n = end_solve(s, root_alpha, wld ? wld_beta : best_score, player, emp, discdiff, 1);
 
   result->outcome = n.value;
   result->pv[0] = ifes_square_to_square(n.square);
+  if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) {
+    /* Only a value above the root window, coming from a move searched to the end, is a lower bound. */
+    const gboolean has_lower_bound = n.value > root_alpha;
+    exact_solution_set_incomplete(result,
+                                  has_lower_bound ? n.value : worst_score,
+                                  best_score,
+                                  has_lower_bound ? result->pv[0] : invalid_move);
+  } else if (wld) {
+    exact_solution_set_wld_outcome(result);
+  }
 
-  game_tree_log_close(log_env);
+  solver_context_search_end(ctx);
 
   return result;
 }
@@ -610,13 +632,15 @@ ifes_square_to_string (const int sq)
 /**
  * @brief Executes board flips from a square `sq` in the `inc` direction.
  *
- * @param [in] sq     a pointer to the square the move is to
- * @param [in] inc    the increment to go in some direction
- * @param [in] color  the color of the mover
- * @param [in] oppcol the opposite color
+ * @param [in] flip_stack the next empty position in the flip stack
+ * @param [in] sq         a pointer to the square the move is to
+ * @param [in] inc        the increment to go in some direction
+ * @param [in] color      the color of the mover
+ * @param [in] oppcol     the opposite color
+ * @return                the next empty position in the flip stack, after pushing the flips
  */
-inline static void
-directional_flips (uint8_t *sq, int inc, int color, int oppcol)
+inline static uint8_t **
+directional_flips (uint8_t **flip_stack, uint8_t *sq, int inc, int color, int oppcol)
 {
   uint8_t *pt = sq + inc;
   if (*pt == oppcol) {
@@ -645,6 +669,7 @@ directional_flips (uint8_t *sq, int inc, int color, int oppcol)
       } while (pt != sq);
     }
   }
+  return flip_stack;
 }
 
 /**
@@ -653,36 +678,38 @@ directional_flips (uint8_t *sq, int inc, int color, int oppcol)
  *
  * If the move is not legal the returned value is zero.
  *
- * @param [in,out] board  a pointer to the board to modify
+ * @param [in,out] s      the search, having the board to modify and the flip stack
  * @param [in]     sqnum  move square number
  * @param [in]     color  player color
  * @param [in]     oppcol opponent color
  * @return                the flip count
  */
 static int
-do_flips (uint8_t *board, int sqnum, int color, int oppcol)
+do_flips (IfesSearch *const s, int sqnum, int color, int oppcol)
 {
   const uint8_t flipping_dir_mask = flipping_dir_mask_table[sqnum];
-  uint8_t **previous_flip_stack = flip_stack;
-  uint8_t *sq = sqnum + board;
+  uint8_t **previous_flip_stack = s->flip_stack;
+  uint8_t **flip_stack = s->flip_stack;
+  uint8_t *sq = sqnum + s->board;
 
   if (flipping_dir_mask & (1 << 7))
-    directional_flips(sq, dir_inc[7], color, oppcol);
+    flip_stack = directional_flips(flip_stack, sq, dir_inc[7], color, oppcol);
   if (flipping_dir_mask & (1 << 6))
-    directional_flips(sq, dir_inc[6], color, oppcol);
+    flip_stack = directional_flips(flip_stack, sq, dir_inc[6], color, oppcol);
   if (flipping_dir_mask & (1 << 5))
-    directional_flips(sq, dir_inc[5], color, oppcol);
+    flip_stack = directional_flips(flip_stack, sq, dir_inc[5], color, oppcol);
   if (flipping_dir_mask & (1 << 4))
-    directional_flips(sq, dir_inc[4], color, oppcol);
+    flip_stack = directional_flips(flip_stack, sq, dir_inc[4], color, oppcol);
   if (flipping_dir_mask & (1 << 3))
-    directional_flips(sq, dir_inc[3], color, oppcol);
+    flip_stack = directional_flips(flip_stack, sq, dir_inc[3], color, oppcol);
   if (flipping_dir_mask & (1 << 2))
-    directional_flips(sq, dir_inc[2], color, oppcol);
+    flip_stack = directional_flips(flip_stack, sq, dir_inc[2], color, oppcol);
   if (flipping_dir_mask & (1 << 1))
-    directional_flips(sq, dir_inc[1], color, oppcol);
+    flip_stack = directional_flips(flip_stack, sq, dir_inc[1], color, oppcol);
   if (flipping_dir_mask & (1 << 0))
-    directional_flips(sq, dir_inc[0], color, oppcol);
+    flip_stack = directional_flips(flip_stack, sq, dir_inc[0], color, oppcol);
 
+  s->flip_stack = flip_stack;
   return flip_stack - previous_flip_stack;
 }
 
@@ -851,13 +878,14 @@ any_flips (uint8_t *board, int sqnum, int color, int oppcol)
 /**
  * @brief Call this function right after `flip_count = do_flips()` to undo those flips!
  *
- * @param [in] flip_count number of disc flipped
- * @param [in] oppcol     opponent color
+ * @param [in,out] s          the search, having the flip stack
+ * @param [in]     flip_count number of disc flipped
+ * @param [in]     oppcol     opponent color
  */
 inline static void
-undo_flips (int flip_count, int oppcol)
+undo_flips (IfesSearch *const s, int flip_count, int oppcol)
 {
-  while (flip_count) { flip_count--; *(*(--flip_stack)) = oppcol; }
+  while (flip_count) { flip_count--; *(*(--s->flip_stack)) = oppcol; }
 }
 
 /**
@@ -877,12 +905,12 @@ minu (uint64_t a, uint64_t b)
 /**
  * @brief Returns the number of available legal moves.
  *
- * @param [in] board the game board
+ * @param [in] s     the search, having the game board
  * @param [in] color the player having the move
  * @return           the legal move count
  */
 static int
-count_mobility (uint8_t *board, int color)
+count_mobility (IfesSearch *const s, int color)
 {
   int     mobility;
   int     square;
@@ -891,9 +919,9 @@ count_mobility (uint8_t *board, int color)
   const int oppcol = opponent_color(color);
 
   mobility = 0;
-  for (em = em_head.succ; em != NULL; em = em->succ) {
+  for (em = s->em_head.succ; em != NULL; em = em->succ) {
     square = em->square;
-    if (any_flips(board, square, color, oppcol))
+    if (any_flips(s->board, square, color, oppcol))
       mobility++;
   }
 
@@ -908,11 +936,12 @@ count_mobility (uint8_t *board, int color)
  * and prepares the linked list `em_head`, hosted by the arry `ems` having the
  * list of empty squares.
  *
- * @param [in] board a given board
+ * @param [in,out] s the search, having the given board
  */
 static void
-prepare_to_solve (uint8_t *board)
+prepare_to_solve (IfesSearch *const s)
 {
+  const uint8_t *const board = s->board;
   uint64_t hole_id_map[91];
   uint8_t sqnum;
   int i;
@@ -964,19 +993,19 @@ prepare_to_solve (uint8_t *board)
     }
   }
   /* find parity of holes: */
-  region_parity = 0;
+  s->region_parity = 0;
   for (i = 10; i <= 80; i++) {
-    region_parity ^= hole_id_map[i];
+    s->region_parity ^= hole_id_map[i];
   }
   /* create list of empty squares: */
   k = 0;
-  pt = &em_head;
+  pt = &s->em_head;
   pt->pred = NULL;
   for (i = 60-1; i >= 0; i--) {
     sqnum = worst_to_best[i];
     if (board[sqnum] == IFES_EMPTY) {
-      pt->succ = &(ems[k]);
-      ems[k].pred = pt;
+      pt->succ = &(s->ems[k]);
+      s->ems[k].pred = pt;
       k++;
       pt = pt->succ;
       pt->square = sqnum;
@@ -991,8 +1020,7 @@ prepare_to_solve (uint8_t *board)
  *
  * The last two discs are placed without recursion.
  *
- * @param [in, out] solution the solution object
- * @param [in]      board    a pointer to the game board
+ * @param [in, out] s        the search, having the solution object and the game board
  * @param [in]      alpha    the alpha value
  * @param [in]      beta     the beta value
  * @param [in]      color    the color of the player having to move
@@ -1002,7 +1030,7 @@ prepare_to_solve (uint8_t *board)
  * @return                   the best node (move/value pairs) available
  */
 static Node
-no_parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int beta,
+no_parity_end_solve (IfesSearch *const s, int alpha, int beta,
                      int color, int empties, int discdiff, int prevmove)
 {
   uint8_t move_square;
@@ -1013,32 +1041,32 @@ no_parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int bet
 
   const int oppcol = opponent_color(color);
 
-  solution->node_count++;
+  s->solution->node_count++;
 
   Node selected_n = init_node(); /* Best node, selected, and then returned. */
 
-  for (previous_move = &em_head, current_move = previous_move->succ;
+  for (previous_move = &s->em_head, current_move = previous_move->succ;
        current_move != NULL;
        previous_move = current_move, current_move = current_move->succ) {
     /* Goes thru list of possible move-squares. */
     move_square = current_move->square;
-    flip_count = do_flips(board, move_square, color, oppcol);
+    flip_count = do_flips(s, move_square, color, oppcol);
     if (flip_count) { /* Legal move. */
       /* Places the player disc. */
-      *(board + move_square) = color;
+      *(s->board + move_square) = color;
       /* Deletes square from empties list. */
       previous_move->succ = current_move->succ;
       if (empties == 2) { /* One empty square is there. */
-        solution->leaf_count++;
-        solution->node_count++;
+        s->solution->leaf_count++;
+        s->solution->node_count++;
         int last_move_flip_count;
-        last_move_flip_count = count_flips(board, em_head.succ->square, oppcol, color);
+        last_move_flip_count = count_flips(s->board, s->em_head.succ->square, oppcol, color);
         if (last_move_flip_count) { /* Oppenent does the last move. */
           evaluated_n.value = discdiff + 2 * (flip_count - last_move_flip_count);
         }
         else { /* Opponent has to pass. */
-          solution->node_count++;
-          last_move_flip_count = count_flips(board, em_head.succ->square, color, oppcol);
+          s->solution->node_count++;
+          last_move_flip_count = count_flips(s->board, s->em_head.succ->square, color, oppcol);
           evaluated_n.value = discdiff + 2 * flip_count;
           if (last_move_flip_count) { /* Player put the last disc. */
             evaluated_n.value += 2 * (last_move_flip_count + 1);
@@ -1049,8 +1077,7 @@ no_parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int bet
           }
         }
       } else {
-        evaluated_n = node_negate(no_parity_end_solve(solution,
-                                                      board,
+        evaluated_n = node_negate(no_parity_end_solve(s,
                                                       -beta,
                                                       -alpha,
                                                       oppcol,
@@ -1058,9 +1085,9 @@ no_parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int bet
                                                       -discdiff - 2 * flip_count - 1,
                                                       move_square));
       }
-      undo_flips(flip_count, oppcol);
+      undo_flips(s, flip_count, oppcol);
       /* Un-places player disc. */
-      *(board + move_square) = IFES_EMPTY;
+      *(s->board + move_square) = IFES_EMPTY;
       /* Restores deleted empty square. */
       previous_move->succ = current_move;
 
@@ -1078,7 +1105,7 @@ no_parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int bet
   }
   if (selected_n.value == -infinity) {  /* No legal move found. */
     if (prevmove == 0) { /* Game over. */
-      solution->leaf_count++;
+      s->solution->leaf_count++;
       if (discdiff > 0) {
         selected_n.value = discdiff + empties;
       } else if (discdiff < 0) {
@@ -1088,8 +1115,7 @@ no_parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int bet
       }
     }
     else { /* Pass. */
-      selected_n = node_negate(no_parity_end_solve(solution,
-                                                   board,
+      selected_n = node_negate(no_parity_end_solve(s,
                                                    -beta,
                                                    -alpha,
                                                    oppcol,
@@ -1105,8 +1131,7 @@ no_parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int bet
 /**
  * @brief Searches by sorting the available moves using the parity heuristic.
  *
- * @param [in, out] solution the solution object
- * @param [in]      board    a pointer to the game board
+ * @param [in, out] s        the search, having the solution object and the game board
  * @param [in]      alpha    the alpha value
  * @param [in]      beta     the beta value
  * @param [in]      color    the color of the player having to move
@@ -1116,7 +1141,7 @@ no_parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int bet
  * @return                   the best node (move/value pairs) available
  */
 static Node
-parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int beta,
+parity_end_solve (IfesSearch *const s, int alpha, int beta,
                   int color, int empties, int discdiff, int prevmove)
 {
   uint8_t move_square;
@@ -1129,40 +1154,39 @@ parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int beta,
 
   const int oppcol = opponent_color(color);
 
-  solution->node_count++;
+  s->solution->node_count++;
 
   Node selected_n = init_node(); /* Best node, selected, and then returned. */
 
-  for (par = 1, parity_mask = region_parity; par >= 0;
+  for (par = 1, parity_mask = s->region_parity; par >= 0;
        par--, parity_mask = ~parity_mask) {
-    for (previous_move = &em_head, current_move = previous_move->succ;
+    for (previous_move = &s->em_head, current_move = previous_move->succ;
          current_move != NULL;
          previous_move = current_move, current_move = current_move->succ) {
       /* Go thru list of possible move-squares. */
       holepar = current_move->hole_id;
       if (holepar & parity_mask) {
         move_square = current_move->square;
-        flip_count = do_flips(board, move_square, color, oppcol);
+        flip_count = do_flips(s, move_square, color, oppcol);
         if (flip_count) { /* legal move */
           /* Place your disc. */
-          *(board + move_square) = color;
+          *(s->board + move_square) = color;
           /* Update parity. */
-          region_parity ^= holepar;
+          s->region_parity ^= holepar;
           /* Delete square from empties list. */
           previous_move->succ = current_move->succ;
-          evaluated_n = node_negate(end_solve(solution,
-                                              board,
+          evaluated_n = node_negate(end_solve(s,
                                               -beta,
                                               -alpha,
                                               oppcol,
                                               empties - 1,
                                               -discdiff - 2 * flip_count - 1,
                                               move_square));
-          undo_flips(flip_count, oppcol);
+          undo_flips(s, flip_count, oppcol);
           /* Restore parity of hole. */
-          region_parity ^= holepar;
+          s->region_parity ^= holepar;
           /* Un-place your disc. */
-          *(board + move_square) = IFES_EMPTY;
+          *(s->board + move_square) = IFES_EMPTY;
           /* Restore deleted empty square. */
           previous_move->succ = current_move;
 
@@ -1182,7 +1206,7 @@ parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int beta,
   }
   if (selected_n.value == -infinity) {  /* No legal move found. */
     if (prevmove == 0) { /* Game over. */
-      solution->leaf_count++;
+      s->solution->leaf_count++;
       if (discdiff > 0) {
         selected_n.value = discdiff + empties;
       } else if (discdiff < 0) {
@@ -1192,8 +1216,7 @@ parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int beta,
       }
     }
     else { /* Pass. */
-      selected_n = node_negate(parity_end_solve(solution,
-                                                board,
+      selected_n = node_negate(parity_end_solve(s,
                                                 -beta,
                                                 -alpha,
                                                 oppcol,
@@ -1209,8 +1232,12 @@ parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int beta,
 /**
  * @brief Searches by sorting the legal moves minimizing the opponent's mobility.
  *
- * @param [in, out] solution the solution object
- * @param [in]      board    a pointer to the game board
+ * The budget of the search is checked here, the nodes searched by the other
+ * functions are close to the leafs, and are not interrupted.
+ * When the budget is exhausted the value returned is the best one among the
+ * moves searched to the end, and it is ignored by the caller.
+ *
+ * @param [in, out] s        the search, having the solution object and the game board
  * @param [in]      alpha    the alpha value
  * @param [in]      beta     the beta value
  * @param [in]      color    the color of the player having to move
@@ -1220,7 +1247,7 @@ parity_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int beta,
  * @return                   the best node (move/value pairs) available
  */
 static Node
-fastest_first_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int beta,
+fastest_first_end_solve (IfesSearch *const s, int alpha, int beta,
                          int color, int empties, int discdiff, int prevmove)
 {
   uint8_t move_square;
@@ -1236,23 +1263,25 @@ fastest_first_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int
 
   const int oppcol = opponent_color(color);
 
-  solution->node_count++;
+  s->solution->node_count++;
 
   Node selected_n = init_node(); /* Best node, selected, and then returned. */
 
+  if (s->ctx->budget_is_on && solver_context_budget_check(s->ctx, s->solution->node_count)) return selected_n;
+
   moves = 0;
-  for (previous_move = &em_head, current_move = previous_move->succ;
+  for (previous_move = &s->em_head, current_move = previous_move->succ;
        current_move != NULL;
        previous_move = current_move, current_move = current_move->succ ) {
     move_square = current_move->square;
-    flip_count = do_flips(board, move_square, color, oppcol);
+    flip_count = do_flips(s, move_square, color, oppcol);
     if (flip_count) {
-      board[move_square] = color;
+      s->board[move_square] = color;
       previous_move->succ = current_move->succ;
-      mobility = count_mobility(board, oppcol);
+      mobility = count_mobility(s, oppcol);
       previous_move->succ = current_move;
-      undo_flips(flip_count, oppcol);
-      board[move_square] = IFES_EMPTY;
+      undo_flips(s, flip_count, oppcol);
+      s->board[move_square] = IFES_EMPTY;
       move_ptr[moves] = current_move;
 
       /* Goodness is computed negating mobility, and sorting equal moves by the worst_to_best heuristic. */
@@ -1261,22 +1290,22 @@ fastest_first_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int
     }
   }
 
-  if (log_env->log_is_on) {
-    call_count++;
-    gp_hash_stack_fill_point++;
-    GamePosition *gp = ifes_game_position_translation(board, color);
+  if (s->ctx->log_env->log_is_on) {
+    s->ctx->call_count++;
+    s->ctx->gp_hash_stack_fill_point++;
+    GamePosition *gp = ifes_game_position_translation(s->board, color);
     LogDataH log_data;
     log_data.sub_run_id = 0;
-    log_data.call_id = call_count;
+    log_data.call_id = s->ctx->call_count;
     log_data.hash = game_position_hash(gp);
-    gp_hash_stack[gp_hash_stack_fill_point] = log_data.hash;
-    log_data.parent_hash = gp_hash_stack[gp_hash_stack_fill_point - 1];
+    s->ctx->gp_hash_stack[s->ctx->gp_hash_stack_fill_point] = log_data.hash;
+    log_data.parent_hash = s->ctx->gp_hash_stack[s->ctx->gp_hash_stack_fill_point - 1];
     log_data.blacks = (gp->board)->blacks;
     log_data.whites = (gp->board)->whites;
     log_data.player = gp->player;
-    gchar *json_doc = game_tree_log_data_h_json_doc(gp_hash_stack_fill_point, gp);
+    gchar *json_doc = game_tree_log_data_h_json_doc(s->ctx->gp_hash_stack_fill_point, gp);
     log_data.json_doc = json_doc;
-    game_tree_log_write_h(log_env, &log_data);
+    game_tree_log_write_h(s->ctx->log_env, &log_data);
     g_free(json_doc);
   }
 
@@ -1295,27 +1324,28 @@ fastest_first_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int
 
       move_square = current_move->square;
       holepar = current_move->hole_id;
-      flip_count = do_flips(board, move_square, color, oppcol);
-      board[move_square] = color;
-      region_parity ^= holepar;
+      flip_count = do_flips(s, move_square, color, oppcol);
+      s->board[move_square] = color;
+      s->region_parity ^= holepar;
       current_move->pred->succ = current_move->succ;
       if (current_move->succ != NULL)
         current_move->succ->pred = current_move->pred;
-      evaluated_n = node_negate(fastest_first_end_solve(solution, //MODIFIED must be end_solve(....
-                                                        board,
+      evaluated_n = node_negate(fastest_first_end_solve(s, //MODIFIED must be end_solve(....
                                                         -beta,
                                                         -alpha,
                                                         oppcol,
                                                         empties - 1,
                                                         -discdiff - 2 * flip_count - 1,
                                                         move_square));
-      undo_flips(flip_count, oppcol);
-      region_parity ^= holepar;
-      board[move_square] = IFES_EMPTY;
+      undo_flips(s, flip_count, oppcol);
+      s->region_parity ^= holepar;
+      s->board[move_square] = IFES_EMPTY;
       current_move->pred->succ = current_move;
       if (current_move->succ != NULL)
         current_move->succ->pred = current_move;
 
+      if (s->ctx->budget_is_on && solver_context_budget_is_exhausted(s->ctx)) goto end;
+
       if (evaluated_n.value > selected_n.value) { /* Better move. */
         selected_n.value = evaluated_n.value;
         selected_n.square = move_square;
@@ -1329,7 +1359,7 @@ fastest_first_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int
     }
   } else {
     if (prevmove == 0) { /* Game over. */
-      solution->leaf_count++;
+      s->solution->leaf_count++;
       if (discdiff > 0) {
         selected_n.value = discdiff + empties;
       } else if (discdiff < 0) {
@@ -1339,21 +1369,21 @@ fastest_first_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int
       }
       ;
     } else { /* Pass. */
-      selected_n = node_negate(fastest_first_end_solve(solution,
-                                                       board,
+      selected_n = node_negate(fastest_first_end_solve(s,
                                                        -beta,
                                                        -alpha,
                                                        oppcol,
                                                        empties,
                                                        -discdiff,
                                                        0));
+      if (s->ctx->budget_is_on && solver_context_budget_is_exhausted(s->ctx)) selected_n.value = -infinity;
     }
   }
  end:
   ;
 
-  if (log_env->log_is_on) {
-    gp_hash_stack_fill_point--;
+  if (s->ctx->log_env->log_is_on) {
+    s->ctx->gp_hash_stack_fill_point--;
   }
 
   return selected_n;
@@ -1371,8 +1401,7 @@ fastest_first_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int
  *
  * Assumes relevant data structures have been set up with prepare_to_solve().
  *
- * @param [in,out] solution
- * @param [in]     board
+ * @param [in,out] s        the search
  * @param [in]     alpha
  * @param [in]     beta
  * @param [in]     color    the color on move
@@ -1382,16 +1411,16 @@ fastest_first_end_solve (ExactSolution *solution, uint8_t *board, int alpha, int
  * @return                  the node having the best value among the legal moves
  */
 inline static Node
-end_solve (ExactSolution *solution, uint8_t *board, int alpha, int beta,
+end_solve (IfesSearch *const s, int alpha, int beta,
            int color, int empties, int discdiff, int prevmove)
 {
   if (empties > fastest_first)
-    return fastest_first_end_solve(solution, board, alpha, beta, color, empties, discdiff, prevmove);
+    return fastest_first_end_solve(s, alpha, beta, color, empties, discdiff, prevmove);
   else {
     if (empties <= (2 > use_parity ? 2 : use_parity))
-      return no_parity_end_solve(solution, board, alpha, beta, color, empties, discdiff, prevmove);
+      return no_parity_end_solve(s, alpha, beta, color, empties, discdiff, prevmove);
     else
-      return parity_end_solve(solution, board, alpha, beta, color, empties, discdiff, prevmove);
+      return parity_end_solve(s, alpha, beta, color, empties, discdiff, prevmove);
   }
 }
 
@@ -40,4 +40,8 @@ extern ExactSolution *
 game_position_ifes_solve (const GamePosition *const root,
                           const gchar *const log_file);
 
+extern ExactSolution *
+game_position_ifes_solve_with_context (SolverContext *const ctx,
+                                       const GamePosition *const root);
+
 #endif /* IMPROVED_FAST_ENDGAME_SOLVER_H */
@@ -0,0 +1,459 @@
+/**
+ * @file
+ *
+ * @brief Last moves solver module implementation.
+ *
+ * @details The game positions having one, two, three, or four empty squares are solved
+ * by a dedicated function each. The functions receive the empty squares as parameters,
+ * try them in the given order without any move list, and call the function solving one
+ * empty square less. The search is a fail soft alpha-beta.
+ *
+ * The position having one empty square is solved without making the last move, the value is
+ * computed from the count of the discs flipped by the move, that has a cheap computation
+ * when the board is full.
+ *
+ * @par last_moves_solver.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <glib.h>
+
+#include "bit_works.h"
+#include "game_tree_utils.h"
+#include "last_moves_solver.h"
+
+
+
+/**
+ * @cond
+ */
+
+/*
+ * Prototypes for internal functions.
+ */
+
+static int
+final_value (const SquareSet p,
+             const SquareSet o);
+
+static int
+solve_1 (const SquareSet p,
+         const Square x1,
+         uint64_t *const node_count,
+         uint64_t *const leaf_count);
+
+static int
+solve_2 (const SquareSet p,
+         const SquareSet o,
+         const int alpha,
+         const int beta,
+         const Square x1,
+         const Square x2,
+         const gboolean passed,
+         uint64_t *const node_count,
+         uint64_t *const leaf_count);
+
+static int
+solve_3 (const SquareSet p,
+         const SquareSet o,
+         const int alpha,
+         const int beta,
+         const Square x1,
+         const Square x2,
+         const Square x3,
+         const gboolean passed,
+         uint64_t *const node_count,
+         uint64_t *const leaf_count);
+
+static int
+solve_4 (const SquareSet p,
+         const SquareSet o,
+         const int alpha,
+         const int beta,
+         const Square x1,
+         const Square x2,
+         const Square x3,
+         const Square x4,
+         const gboolean passed,
+         uint64_t *const node_count,
+         uint64_t *const leaf_count);
+
+
+
+/*
+ * Internal variables and constants.
+ */
+
+/* The four quadrants of the board. */
+static const SquareSet quadrants[4] = {
+  0x000000000F0F0F0F,
+  0x00000000F0F0F0F0,
+  0x0F0F0F0F00000000,
+  0xF0F0F0F000000000
+};
+
+/**
+ * @endcond
+ */
+
+
+
+/*********************************************************/
+/* Function implementations for the last moves solver.   */
+/*********************************************************/
+
+/**
+ * @brief Returns the count of the discs flipped by the last move.
+ *
+ * @details The board must be full but the `move` square, all the squares not belonging
+ * to the player are then owned by the opponent. Along each line through the move square,
+ * the discs flipped are the ones between the move and the nearest player's disc.
+ * No check is done on the parameters, when the move is not legal the count is zero.
+ *
+ * @param [in] p_bit_board the square set of the player's discs
+ * @param [in] move        the empty square
+ * @return                 the count of flipped discs
+ */
+int
+last_moves_solver_count_flips (const SquareSet p_bit_board,
+                               const Square move)
+{
+  const SquareSet move_bit = (SquareSet) 1 << move;
+  const SquareSet above = ~((move_bit << 1) - 1);
+  const SquareSet below = move_bit - 1;
+  const int column = move & 7;
+  const int row = move >> 3;
+  const int diagonal = column - row;
+  const int anti_diagonal = column + row - 7;
+
+  const SquareSet lines[4] = {
+    (SquareSet) 0x00000000000000FF << (8 * row),
+    (SquareSet) 0x0101010101010101 << column,
+    diagonal >= 0
+    ? (SquareSet) 0x8040201008040201 >> (8 * diagonal)
+    : (SquareSet) 0x8040201008040201 << (8 * -diagonal),
+    anti_diagonal >= 0
+    ? (SquareSet) 0x0102040810204080 << (8 * anti_diagonal)
+    : (SquareSet) 0x0102040810204080 >> (8 * -anti_diagonal)
+  };
+
+  int count = 0;
+  for (int i = 0; i < 4; i++) {
+    const SquareSet upper = lines[i] & above;
+    const SquareSet upper_p = upper & p_bit_board;
+    if (upper_p) count += bit_works_popcount(upper & (bit_works_lowest_bit_set_64(upper_p) - 1));
+    const SquareSet lower = lines[i] & below;
+    const SquareSet lower_p = lower & p_bit_board;
+    if (lower_p) count += bit_works_popcount(lower & ~(((SquareSet) 2 << bit_works_bitscanMS1B_64(lower_p)) - 1));
+  }
+  return count;
+}
+
+/**
+ * @brief Solves a game position having at most #LAST_MOVES_SOLVER_MAX_EMPTIES empty squares.
+ *
+ * @details The search is a fail soft alpha-beta: the value is exact when it is inside the window,
+ * an upper bound when it is not greater than `alpha`, a lower bound when it is not less than `beta`.
+ *
+ * The empty squares lying in a quadrant having an odd count of empties are tried first.
+ *
+ * Counters are incremented by the game positions reached from the given one, by a move or a pass,
+ * and by the terminal game positions evaluated, the given one included.
+ *
+ * @invariant The count of empty squares must not be greater than #LAST_MOVES_SOLVER_MAX_EMPTIES.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in]     p_bit_board the square set of the discs of the player having to move
+ * @param [in]     o_bit_board the square set of the opponent's discs
+ * @param [in]     alpha       the lower limit of the search window
+ * @param [in]     beta        the upper limit of the search window
+ * @param [in,out] node_count  the count of game positions searched
+ * @param [in,out] leaf_count  the count of terminal game positions
+ * @return                     the game value
+ */
+int
+last_moves_solver_solve (const SquareSet p_bit_board,
+                         const SquareSet o_bit_board,
+                         const int alpha,
+                         const int beta,
+                         uint64_t *const node_count,
+                         uint64_t *const leaf_count)
+{
+  const SquareSet empties = ~(p_bit_board | o_bit_board);
+  const int empty_count = bit_works_popcount(empties);
+
+  g_assert(empty_count <= LAST_MOVES_SOLVER_MAX_EMPTIES);
+
+  SquareSet odd = empty_square_set;
+  for (int i = 0; i < 4; i++) {
+    if (bit_works_popcount(empties & quadrants[i]) & 1) odd |= quadrants[i];
+  }
+
+  Square x[LAST_MOVES_SOLVER_MAX_EMPTIES];
+  int n = 0;
+  for (SquareSet s = empties & odd; s; s &= s - 1) x[n++] = bit_works_bitscanLS1B_64(s);
+  for (SquareSet s = empties & ~odd; s; s &= s - 1) x[n++] = bit_works_bitscanLS1B_64(s);
+
+  switch (empty_count) {
+  case 0:
+    (*leaf_count)++;
+    return final_value(p_bit_board, o_bit_board);
+  case 1:
+    return solve_1(p_bit_board, x[0], node_count, leaf_count);
+  case 2:
+    return solve_2(p_bit_board, o_bit_board, alpha, beta, x[0], x[1], FALSE, node_count, leaf_count);
+  case 3:
+    return solve_3(p_bit_board, o_bit_board, alpha, beta, x[0], x[1], x[2], FALSE, node_count, leaf_count);
+  default:
+    return solve_4(p_bit_board, o_bit_board, alpha, beta, x[0], x[1], x[2], x[3], FALSE, node_count, leaf_count);
+  }
+}
+
+
+
+/**
+ * @cond
+ */
+
+/*
+ * Internal functions.
+ */
+
+/*
+ * Returns the value of the game position when the game is over, the empty squares go to the winner.
+ */
+static int
+final_value (const SquareSet p,
+             const SquareSet o)
+{
+  const int p_count = bit_works_popcount(p);
+  const int o_count = bit_works_popcount(o);
+  const int difference = p_count - o_count;
+  if (difference == 0) return 0;
+  const int empties = 64 - (p_count + o_count);
+  return (difference > 0) ? difference + empties : difference - empties;
+}
+
+/*
+ * Solves the game position having the single empty square x1.
+ *
+ * The opponent's discs are all the squares but x1 and the player's ones. The game ends after
+ * the move of either the player or the opponent, the value is computed from the flip count.
+ * When no one can move the winner takes the empty square.
+ */
+static int
+solve_1 (const SquareSet p,
+         const Square x1,
+         uint64_t *const node_count,
+         uint64_t *const leaf_count)
+{
+  const int p_count = bit_works_popcount(p);
+  (*leaf_count)++;
+
+  int flip_count = last_moves_solver_count_flips(p, x1);
+  if (flip_count) {
+    (*node_count)++;
+    return 2 * (p_count + flip_count + 1) - 64;
+  }
+
+  const SquareSet o = ~(p | ((SquareSet) 1 << x1));
+  flip_count = last_moves_solver_count_flips(o, x1);
+  if (flip_count) {
+    (*node_count) += 2;
+    return 2 * (p_count - flip_count) - 64;
+  }
+
+  (*node_count)++;
+  const int difference = 2 * p_count - 63;
+  return (difference > 0) ? difference + 1 : difference - 1;
+}
+
+/*
+ * Solves the game position having the two empty squares x1 and x2.
+ */
+static int
+solve_2 (const SquareSet p,
+         const SquareSet o,
+         const int alpha,
+         const int beta,
+         const Square x1,
+         const Square x2,
+         const gboolean passed,
+         uint64_t *const node_count,
+         uint64_t *const leaf_count)
+{
+  int best_value = out_of_range_defeat_score;
+  SquareSet flips;
+
+  if ((flips = square_set_flips(p, o, x1))) {
+    (*node_count)++;
+    best_value = -solve_1(o ^ flips, x2, node_count, leaf_count);
+    if (best_value >= beta) return best_value;
+  }
+
+  if ((flips = square_set_flips(p, o, x2))) {
+    (*node_count)++;
+    const int value = -solve_1(o ^ flips, x1, node_count, leaf_count);
+    if (value > best_value) best_value = value;
+  }
+
+  if (best_value == out_of_range_defeat_score) {
+    if (passed) {
+      (*leaf_count)++;
+      return final_value(p, o);
+    }
+    (*node_count)++;
+    return -solve_2(o, p, -beta, -alpha, x1, x2, TRUE, node_count, leaf_count);
+  }
+
+  return best_value;
+}
+
+/*
+ * Solves the game position having the three empty squares x1, x2 and x3.
+ */
+static int
+solve_3 (const SquareSet p,
+         const SquareSet o,
+         const int alpha,
+         const int beta,
+         const Square x1,
+         const Square x2,
+         const Square x3,
+         const gboolean passed,
+         uint64_t *const node_count,
+         uint64_t *const leaf_count)
+{
+  int best_value = out_of_range_defeat_score;
+  SquareSet flips;
+
+  if ((flips = square_set_flips(p, o, x1))) {
+    (*node_count)++;
+    best_value = -solve_2(o ^ flips, p | flips | ((SquareSet) 1 << x1), -beta, -alpha,
+                          x2, x3, FALSE, node_count, leaf_count);
+    if (best_value >= beta) return best_value;
+  }
+
+  if ((flips = square_set_flips(p, o, x2))) {
+    (*node_count)++;
+    const int value = -solve_2(o ^ flips, p | flips | ((SquareSet) 1 << x2), -beta, -MAX(alpha, best_value),
+                               x1, x3, FALSE, node_count, leaf_count);
+    if (value > best_value) {
+      best_value = value;
+      if (best_value >= beta) return best_value;
+    }
+  }
+
+  if ((flips = square_set_flips(p, o, x3))) {
+    (*node_count)++;
+    const int value = -solve_2(o ^ flips, p | flips | ((SquareSet) 1 << x3), -beta, -MAX(alpha, best_value),
+                               x1, x2, FALSE, node_count, leaf_count);
+    if (value > best_value) best_value = value;
+  }
+
+  if (best_value == out_of_range_defeat_score) {
+    if (passed) {
+      (*leaf_count)++;
+      return final_value(p, o);
+    }
+    (*node_count)++;
+    return -solve_3(o, p, -beta, -alpha, x1, x2, x3, TRUE, node_count, leaf_count);
+  }
+
+  return best_value;
+}
+
+/*
+ * Solves the game position having the four empty squares x1, x2, x3 and x4.
+ */
+static int
+solve_4 (const SquareSet p,
+         const SquareSet o,
+         const int alpha,
+         const int beta,
+         const Square x1,
+         const Square x2,
+         const Square x3,
+         const Square x4,
+         const gboolean passed,
+         uint64_t *const node_count,
+         uint64_t *const leaf_count)
+{
+  int best_value = out_of_range_defeat_score;
+  SquareSet flips;
+
+  if ((flips = square_set_flips(p, o, x1))) {
+    (*node_count)++;
+    best_value = -solve_3(o ^ flips, p | flips | ((SquareSet) 1 << x1), -beta, -alpha,
+                          x2, x3, x4, FALSE, node_count, leaf_count);
+    if (best_value >= beta) return best_value;
+  }
+
+  if ((flips = square_set_flips(p, o, x2))) {
+    (*node_count)++;
+    const int value = -solve_3(o ^ flips, p | flips | ((SquareSet) 1 << x2), -beta, -MAX(alpha, best_value),
+                               x1, x3, x4, FALSE, node_count, leaf_count);
+    if (value > best_value) {
+      best_value = value;
+      if (best_value >= beta) return best_value;
+    }
+  }
+
+  if ((flips = square_set_flips(p, o, x3))) {
+    (*node_count)++;
+    const int value = -solve_3(o ^ flips, p | flips | ((SquareSet) 1 << x3), -beta, -MAX(alpha, best_value),
+                               x1, x2, x4, FALSE, node_count, leaf_count);
+    if (value > best_value) {
+      best_value = value;
+      if (best_value >= beta) return best_value;
+    }
+  }
+
+  if ((flips = square_set_flips(p, o, x4))) {
+    (*node_count)++;
+    const int value = -solve_3(o ^ flips, p | flips | ((SquareSet) 1 << x4), -beta, -MAX(alpha, best_value),
+                               x1, x2, x3, FALSE, node_count, leaf_count);
+    if (value > best_value) best_value = value;
+  }
+
+  if (best_value == out_of_range_defeat_score) {
+    if (passed) {
+      (*leaf_count)++;
+      return final_value(p, o);
+    }
+    (*node_count)++;
+    return -solve_4(o, p, -beta, -alpha, x1, x2, x3, x4, TRUE, node_count, leaf_count);
+  }
+
+  return best_value;
+}
+
+/**
+ * @endcond
+ */
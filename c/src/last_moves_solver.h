@@ -0,0 +1,68 @@
+/**
+ * @file
+ *
+ * @brief Last moves solver module definitions.
+ * @details This module solves the game positions having at most
+ * #LAST_MOVES_SOLVER_MAX_EMPTIES empty squares. The search works directly
+ * on the two bit boards, without the game tree stack used by the generic solvers.
+ *
+ * @par last_moves_solver.h
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#ifndef LAST_MOVES_SOLVER_H
+#define LAST_MOVES_SOLVER_H
+
+#include <glib.h>
+
+#include "board.h"
+
+/**
+ * @brief The largest count of empty squares handled by the last moves solver.
+ */
+#define LAST_MOVES_SOLVER_MAX_EMPTIES 4
+
+
+
+/*********************************************************/
+/* Function prototypes for the last moves solver.        */
+/*********************************************************/
+
+extern int
+last_moves_solver_count_flips (const SquareSet p_bit_board,
+                               const Square move);
+
+extern int
+last_moves_solver_solve (const SquareSet p_bit_board,
+                         const SquareSet o_bit_board,
+                         const int alpha,
+                         const int beta,
+                         uint64_t *const node_count,
+                         uint64_t *const leaf_count);
+
+
+
+#endif /* LAST_MOVES_SOLVER_H */
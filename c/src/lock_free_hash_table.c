@@ -0,0 +1,355 @@
+/**
+ * @file
+ *
+ * @brief Lock free hash table module implementation.
+ *
+ * @details The table has the layout of the transposition table, a power of two count
+ * of 64 bytes buckets holding #LOCK_FREE_HASH_TABLE_BUCKET_SIZE entries each, but the
+ * entries are sixteen bytes words pairs, verified by the xor of the hash and the data.
+ *
+ * Writers never coordinate, the last store wins. A reader can observe a pair of words
+ * written by two different stores, the xor check rejects it.
+ *
+ * @par lock_free_hash_table.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "game_tree_utils.h"
+#include "lock_free_hash_table.h"
+
+
+
+/**
+ * @cond
+ */
+
+/*
+ * Internal variables and constants.
+ */
+
+/* The table used by the parallel solvers, NULL when the table is turned off. */
+static LockFreeHashTable *default_table = NULL;
+
+/* Set in every stored data word, so that an all zero entry is never valid. */
+static const uint64_t data_valid_flag = (uint64_t) 1 << 40;
+
+/* The alignment of the bucket array, the size of a cache line. */
+static const size_t bucket_alignment = 64;
+
+
+
+/*
+ * Prototypes for internal functions.
+ */
+
+static uint64_t
+data_pack (const LockFreeHashTableData *const d);
+
+static void
+data_unpack (const uint64_t packed,
+             LockFreeHashTableData *const d);
+
+/**
+ * @endcond
+ */
+
+
+
+/***************************************************************/
+/* Function implementations for the LockFreeHashTable entity.  */
+/***************************************************************/
+
+/**
+ * @brief Lock free hash table structure constructor.
+ *
+ * @details The table has `2^size_log2` entries, grouped into buckets.
+ * The bucket array is aligned to the cache line.
+ *
+ * @invariant Parameter `size_log2` must be in the range [2..40].
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] size_log2 the base two logarithm of the number of entries
+ * @return               a pointer to a new lock free hash table structure
+ */
+LockFreeHashTable *
+lock_free_hash_table_new (const int size_log2)
+{
+  g_assert(size_log2 >= 2 && size_log2 <= 40);
+
+  LockFreeHashTable *lfht = (LockFreeHashTable *) malloc(sizeof(LockFreeHashTable));
+  g_assert(lfht);
+
+  lfht->bucket_count = ((size_t) 1 << size_log2) / LOCK_FREE_HASH_TABLE_BUCKET_SIZE;
+  lfht->mask = lfht->bucket_count - 1;
+  void *memory = NULL;
+  const int ret = posix_memalign(&memory, bucket_alignment, lfht->bucket_count * sizeof(LockFreeHashTableBucket));
+  g_assert(ret == 0 && memory);
+  lfht->buckets = (LockFreeHashTableBucket *) memory;
+
+  lfht->generation = 0;
+  lock_free_hash_table_clear(lfht);
+
+  return lfht;
+}
+
+/**
+ * @brief Deallocates the memory previously allocated by a call to #lock_free_hash_table_new.
+ *
+ * @details If a null pointer is passed as argument, no action occurs.
+ *
+ * @param [in,out] lfht the pointer to be deallocated
+ */
+void
+lock_free_hash_table_free (LockFreeHashTable *lfht)
+{
+  if (lfht) {
+    free(lfht->buckets);
+    free(lfht);
+  }
+}
+
+/**
+ * @brief Removes all the entries.
+ *
+ * @details The function must not run concurrently with probes or stores.
+ *
+ * @invariant Parameter `lfht` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] lfht the lock free hash table
+ */
+void
+lock_free_hash_table_clear (LockFreeHashTable *lfht)
+{
+  g_assert(lfht);
+
+  memset((void *) lfht->buckets, 0, lfht->bucket_count * sizeof(LockFreeHashTableBucket));
+}
+
+/**
+ * @brief Marks the start of a new search.
+ *
+ * @details Entries written by the previous searches are kept and can be found by the probes,
+ * but they are the first ones to be replaced.
+ *
+ * @invariant Parameter `lfht` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] lfht the lock free hash table
+ */
+void
+lock_free_hash_table_new_search (LockFreeHashTable *lfht)
+{
+  g_assert(lfht);
+
+  g_atomic_int_inc(&lfht->generation);
+}
+
+/**
+ * @brief Looks up the game position identified by `hash`.
+ *
+ * @details The probe is successful when a verified entry is found, and it has been computed
+ * by a search at least `depth` deep. The entry data is then copied into `data`.
+ *
+ * The function can run concurrently with any other probe or store.
+ *
+ * @invariant Parameters `lfht` and `data` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in]  lfht  the lock free hash table
+ * @param [in]  hash  the hash of the game position
+ * @param [in]  depth the depth of the search
+ * @param [out] data  the data found
+ * @return            true when the entry is found
+ */
+gboolean
+lock_free_hash_table_probe (const LockFreeHashTable *const lfht,
+                            const uint64_t hash,
+                            const int depth,
+                            LockFreeHashTableData *const data)
+{
+  g_assert(lfht);
+  g_assert(data);
+
+  const LockFreeHashTableBucket *const bucket = &lfht->buckets[hash & lfht->mask];
+  for (int i = 0; i < LOCK_FREE_HASH_TABLE_BUCKET_SIZE; i++) {
+    const uint64_t d = bucket->entries[i].data;
+    const uint64_t k = bucket->entries[i].key;
+    if ((k ^ d) == hash && (d & data_valid_flag)) {
+      data_unpack(d, data);
+      return data->depth >= depth;
+    }
+  }
+  return FALSE;
+}
+
+/**
+ * @brief Stores the result of a search.
+ *
+ * @details The bound type is derived from the search window as done by #transposition_table_store,
+ * and so are the merge and replacement rules.
+ *
+ * The function can run concurrently with any other probe or store. The merge of the bounds
+ * reads and writes the entry without any lock, when two threads race on the same entry
+ * one of the two updates is lost, or the entry is torn and no longer verifies.
+ * Either way the table never returns a wrong bound.
+ *
+ * @invariant Parameter `lfht` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] lfht      the lock free hash table
+ * @param [in]     hash      the hash of the game position
+ * @param [in]     depth     the depth of the search
+ * @param [in]     alpha     the lower limit of the search window
+ * @param [in]     beta      the upper limit of the search window
+ * @param [in]     value     the value returned by the search
+ * @param [in]     best_move the best move found by the search
+ */
+void
+lock_free_hash_table_store (LockFreeHashTable *const lfht,
+                            const uint64_t hash,
+                            const int depth,
+                            const int alpha,
+                            const int beta,
+                            const int value,
+                            const Square best_move)
+{
+  g_assert(lfht);
+
+  const uint8_t generation = g_atomic_int_get(&lfht->generation);
+  LockFreeHashTableData nd;
+  nd.lower = value <= alpha ? worst_score : value;
+  nd.upper = value >= beta ? best_score : value;
+  nd.best_move = best_move;
+  nd.depth = depth;
+  nd.generation = generation;
+
+  LockFreeHashTableBucket *const bucket = &lfht->buckets[hash & lfht->mask];
+  LockFreeHashTableEntry *victim = NULL;
+  LockFreeHashTableData vd = { 0, 0, 0, 0, 0 };
+  for (int i = 0; i < LOCK_FREE_HASH_TABLE_BUCKET_SIZE; i++) {
+    LockFreeHashTableEntry *const e = &bucket->entries[i];
+    const uint64_t d = e->data;
+    const uint64_t k = e->key;
+    LockFreeHashTableData ed;
+    data_unpack(d, &ed);
+    if ((k ^ d) == hash && (d & data_valid_flag)) {
+      if (ed.depth > depth) return;
+      if (ed.depth == depth) {
+        nd.lower = MAX(ed.lower, nd.lower);
+        nd.upper = MIN(ed.upper, nd.upper);
+      }
+      victim = e;
+      break;
+    }
+    if (!victim) {
+      victim = e;
+      vd = ed;
+      continue;
+    }
+    const gboolean e_is_stale = ed.generation != generation;
+    const gboolean v_is_stale = vd.generation != generation;
+    if ((e_is_stale && !v_is_stale) || (e_is_stale == v_is_stale && ed.depth < vd.depth)) {
+      victim = e;
+      vd = ed;
+    }
+  }
+  const uint64_t packed = data_pack(&nd);
+  victim->key = hash ^ packed;
+  victim->data = packed;
+}
+
+/**
+ * @brief Assigns the lock free hash table used by the parallel solvers.
+ *
+ * @details The table is owned by the caller, `NULL` turns the table off.
+ *
+ * @param [in] lfht the lock free hash table
+ */
+void
+lock_free_hash_table_set_default (LockFreeHashTable *lfht)
+{
+  default_table = lfht;
+}
+
+/**
+ * @brief Returns the lock free hash table used by the parallel solvers.
+ *
+ * @return the lock free hash table, or `NULL` when the table is turned off
+ */
+LockFreeHashTable *
+lock_free_hash_table_get_default (void)
+{
+  return default_table;
+}
+
+
+
+/**
+ * @cond
+ */
+
+/*
+ * Internal functions.
+ */
+
+/*
+ * Packs the data into a word, the valid flag is set.
+ */
+static uint64_t
+data_pack (const LockFreeHashTableData *const d)
+{
+  return (uint64_t) (uint8_t) d->lower
+    | (uint64_t) (uint8_t) d->upper << 8
+    | (uint64_t) (uint8_t) d->best_move << 16
+    | (uint64_t) d->depth << 24
+    | (uint64_t) d->generation << 32
+    | data_valid_flag;
+}
+
+/*
+ * Unpacks a word into the data structure.
+ */
+static void
+data_unpack (const uint64_t packed,
+             LockFreeHashTableData *const d)
+{
+  d->lower = (int8_t) (packed & 0xFF);
+  d->upper = (int8_t) ((packed >> 8) & 0xFF);
+  d->best_move = (int8_t) ((packed >> 16) & 0xFF);
+  d->depth = (uint8_t) ((packed >> 24) & 0xFF);
+  d->generation = (uint8_t) ((packed >> 32) & 0xFF);
+}
+
+/**
+ * @endcond
+ */
@@ -0,0 +1,149 @@
+/**
+ * @file
+ *
+ * @brief Lock free hash table module definitions.
+ * @details This module defines a fixed size hash table that can be shared by many threads
+ * without locks. It stores the same data as the transposition table: the bounds of the game
+ * position value, the best move, and the depth of the search.
+ *
+ * @par lock_free_hash_table.h
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#ifndef LOCK_FREE_HASH_TABLE_H
+#define LOCK_FREE_HASH_TABLE_H
+
+#include <glib.h>
+
+#include "board.h"
+
+/**
+ * @brief The number of entries in a bucket, a bucket fills a 64 bytes cache line.
+ */
+#define LOCK_FREE_HASH_TABLE_BUCKET_SIZE 4
+
+
+
+/**********************************************/
+/* Type declarations.                         */
+/**********************************************/
+
+/**
+ * @brief The data stored for a game position.
+ *
+ * @details The value of the game position lies in the range [lower..upper].
+ * The structure is packed into a single 64 bits word when stored.
+ */
+typedef struct {
+  int8_t   lower;                     /**< @brief The lower bound of the game position value. */
+  int8_t   upper;                     /**< @brief The upper bound of the game position value. */
+  int8_t   best_move;                 /**< @brief The best move, or the refutation move, found by the search. */
+  uint8_t  depth;                     /**< @brief The depth of the search that computed the bounds. */
+  uint8_t  generation;                /**< @brief The generation of the table when the data has been written. */
+} LockFreeHashTableData;
+
+/**
+ * @brief A lock free hash table entry, sixteen bytes.
+ *
+ * @details The entry holds the packed data, and the hash xor-ed with the packed data.
+ * A reader loads the two words and accepts them only when the xor of the two gives back
+ * the hash being searched. An entry torn by two writers racing, or read while being written,
+ * fails the check and is treated as missing.
+ */
+typedef struct {
+  volatile uint64_t key;              /**< @brief The hash of the game position xor the packed data. */
+  volatile uint64_t data;             /**< @brief The packed data. */
+} LockFreeHashTableEntry;
+
+/**
+ * @brief A bucket collects the entries sharing the same index.
+ */
+typedef struct {
+  LockFreeHashTableEntry entries[LOCK_FREE_HASH_TABLE_BUCKET_SIZE]; /**< @brief The bucket entries. */
+} LockFreeHashTableBucket;
+
+/**
+ * @brief A lock free hash table is an array of buckets, sized as a power of two.
+ *
+ * @details Probes and stores never block, and never fail because of other threads.
+ * The price is that a concurrent store can be lost, and that a probe can miss an entry
+ * being written. Both cases cost search effort, never correctness.
+ *
+ * The replacement policy is the one of the transposition table: entries written by
+ * a previous search go first, then the ones having the smallest depth.
+ *
+ * The scheme relies on aligned 64 bits loads and stores being atomic, as they are
+ * on the 64 bits targets the program is built for.
+ */
+typedef struct {
+  size_t                   bucket_count; /**< @brief The count of buckets, a power of two. */
+  size_t                   mask;         /**< @brief The mask that maps a hash value to a bucket index. */
+  LockFreeHashTableBucket *buckets;      /**< @brief The array of buckets, aligned to the cache line. */
+  volatile gint            generation;   /**< @brief The current generation, incremented by each new search. */
+} LockFreeHashTable;
+
+
+
+/***************************************************************/
+/* Function implementations for the LockFreeHashTable entity.  */
+/***************************************************************/
+
+extern LockFreeHashTable *
+lock_free_hash_table_new (const int size_log2);
+
+extern void
+lock_free_hash_table_free (LockFreeHashTable *lfht);
+
+extern void
+lock_free_hash_table_clear (LockFreeHashTable *lfht);
+
+extern void
+lock_free_hash_table_new_search (LockFreeHashTable *lfht);
+
+extern gboolean
+lock_free_hash_table_probe (const LockFreeHashTable *const lfht,
+                            const uint64_t hash,
+                            const int depth,
+                            LockFreeHashTableData *const data);
+
+extern void
+lock_free_hash_table_store (LockFreeHashTable *const lfht,
+                            const uint64_t hash,
+                            const int depth,
+                            const int alpha,
+                            const int beta,
+                            const int value,
+                            const Square best_move);
+
+extern void
+lock_free_hash_table_set_default (LockFreeHashTable *lfht);
+
+extern LockFreeHashTable *
+lock_free_hash_table_get_default (void);
+
+
+
+#endif /* LOCK_FREE_HASH_TABLE_H */
@@ -0,0 +1,810 @@
+/**
+ * @file
+ *
+ * @brief Monte Carlo tree search solver module implementation.
+ *
+ * @details The solver grows a tree by the UCT policy: from the root, the child maximizing
+ * the mean score plus an exploration term is selected, until a node not yet expanded is reached.
+ * A random game is played from there, by the random game sampler, and its outcome is
+ * backed up along the path.
+ *
+ * Nodes are allocated from a fixed size arena, the children of a node fill consecutive records,
+ * and are referenced by the index of the first one. When the arena is full, leaves are no more
+ * expanded, and the search keeps playing games from them.
+ *
+ * The threads can share one tree (tree parallelism): each of them adds a virtual loss to the nodes
+ * on its path, moving the others away while its playout runs. Or they can grow a tree each
+ * (root parallelism), the visits of the root moves are then summed.
+ *
+ * @par mcts_solver.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <math.h>
+
+#include <glib.h>
+
+#include "bit_works.h"
+#include "random.h"
+#include "board.h"
+#include "exact_solver.h"
+#include "random_game_sampler.h"
+#include "mcts_solver.h"
+
+
+
+/**
+ * @cond
+ */
+
+/* The longest path from the root to a leaf, moves and passes. */
+#define MCTS_MAX_PATH_LENGTH 128
+
+/*
+ * The state of a search, shared by the threads.
+ */
+typedef struct {
+  MctsTree      *tree;                /* The tree being searched. */
+  SolverContext *ctx;                 /* The solver context, giving the budget. */
+  gboolean       virtual_loss;        /* True when threads share a tree. */
+} MctsSearch;
+
+/*
+ * The state owned by each thread.
+ */
+typedef struct {
+  MctsSearch            *search;          /* The shared state. */
+  MctsArena             *arena;           /* The tree grown by the thread. */
+  RandomNumberGenerator *rng;             /* The generator of the playouts. */
+  uint64_t               playout_limit;   /* The count of playouts to run, zero means until the deadline. */
+  uint64_t               playout_count;   /* The count of playouts run. */
+} MctsWorker;
+
+
+
+/*
+ * Prototypes for internal functions.
+ */
+
+static void
+mcts_arena_init (MctsArena *const arena,
+                 const int capacity);
+
+static gboolean
+mcts_arena_reroot (MctsArena *const arena,
+                   const Square move);
+
+static int
+mcts_moves (const GamePositionX *const gpx,
+            Square *const moves);
+
+static gboolean
+mcts_node_expand (MctsArena *const arena,
+                  MctsNode *const node,
+                  const GamePositionX *const gpx);
+
+static int
+mcts_node_select (const MctsArena *const arena,
+                  const MctsNode *const node);
+
+static void
+mcts_playout (MctsWorker *const w);
+
+static gpointer
+mcts_worker_run (gpointer data);
+
+
+
+/*
+ * Internal variables and constants.
+ */
+
+/* How the threads share the work. */
+static MctsSolverParallelism parallelism = MCTS_SOLVER_PARALLELISM_TREE;
+
+/* The count of threads, zero means one for each processor. */
+static int thread_count = 0;
+
+/* The weight of the exploration term of the UCT formula, scores range in [0..1]. */
+static const double exploration_constant = 1.0;
+
+/* The count of node records of a tree, shared among the trees by the root parallelism. */
+static const int default_node_capacity = 1 << 21;
+
+/* The count of playouts of a search having no budget. */
+static const uint64_t default_playout_count = 100000;
+
+/* Each thread reads the clock once every 64 playouts. */
+static const uint64_t time_check_interval = 64;
+
+/**
+ * @endcond
+ */
+
+
+
+/*********************************************************/
+/* Function implementations for the GamePosition entity. */
+/*********************************************************/
+
+/**
+ * @brief Searches the game position returning a new exact solution pointer.
+ *
+ * @details It is a wrapper of #game_position_mcts_solve_with_context, running on a new context.
+ *
+ * @param [in] root     the starting game position to be searched
+ * @param [in] log_file not used, the mcts solver doesn't log the game tree
+ * @return              a pointer to a new exact solution structure
+ */
+ExactSolution *
+game_position_mcts_solve (const GamePosition *const root,
+                          const gchar *const log_file)
+{
+  g_assert(root);
+
+  SolverContext *ctx = solver_context_new();
+  ExactSolution *result = game_position_mcts_solve_with_context(ctx, root);
+  solver_context_free(ctx);
+  return result;
+}
+
+/**
+ * @brief Searches the game position, with the options of the solver context,
+ * returning a new exact solution pointer.
+ *
+ * @details A new tree is grown for the call, by `ctx->mcts_thread_count` threads,
+ * sharing the work as selected by `ctx->mcts_parallelism`.
+ * The search runs until the budget of the context is exhausted, the node limit counting
+ * the playouts, or for 100000 playouts when the context has no budget.
+ *
+ * The game value is not proven, the solution is marked as incomplete, having the bounds
+ * of the full range, and the most visited move as best move.
+ *
+ * @invariant Parameters `ctx` and `root` must be not `NULL`.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] ctx  the solver context
+ * @param [in]     root the starting game position to be searched
+ * @return              a pointer to a new exact solution structure
+ */
+ExactSolution *
+game_position_mcts_solve_with_context (SolverContext *const ctx,
+                                       const GamePosition *const root)
+{
+  g_assert(ctx);
+  g_assert(root);
+
+  const int tc = ctx->mcts_thread_count ? ctx->mcts_thread_count : (int) g_get_num_processors();
+  MctsTree *tree = mcts_tree_new(root, ctx->mcts_parallelism, tc, 0);
+  mcts_tree_search(tree, ctx);
+  ExactSolution *result = mcts_tree_to_exact_solution(tree);
+  mcts_tree_free(tree);
+  return result;
+}
+
+/**
+ * @brief Sets how the threads of #game_position_mcts_solve share the work.
+ * It is the process wide option, copied by the solver contexts when they are created.
+ *
+ * @param [in] p the parallelism mode
+ */
+void
+mcts_solver_set_parallelism (const MctsSolverParallelism p)
+{
+  parallelism = p;
+}
+
+/**
+ * @brief Returns how the threads of #game_position_mcts_solve share the work.
+ *
+ * @return the parallelism mode
+ */
+MctsSolverParallelism
+mcts_solver_get_parallelism (void)
+{
+  return parallelism;
+}
+
+/**
+ * @brief Sets the count of threads used by #game_position_mcts_solve.
+ * It is the process wide option, copied by the solver contexts when they are created.
+ *
+ * @details The count includes the calling thread, zero selects one thread for each processor.
+ *
+ * @invariant Parameter `thread_count` must be not negative.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] tc the count of threads
+ */
+void
+mcts_solver_set_thread_count (const int tc)
+{
+  g_assert(tc >= 0);
+  thread_count = tc;
+}
+
+/**
+ * @brief Returns the count of threads used by #game_position_mcts_solve.
+ *
+ * @return the count of threads
+ */
+int
+mcts_solver_get_thread_count (void)
+{
+  return thread_count ? thread_count : (int) g_get_num_processors();
+}
+
+
+
+/*****************************************************/
+/* Function implementations for the MctsTree entity. */
+/*****************************************************/
+
+/**
+ * @brief Mcts tree structure constructor.
+ *
+ * @details The tree holds only the root node. The root parallelism creates one tree
+ * for each thread, sharing the node capacity.
+ *
+ * @invariant Parameter `root` must be not `NULL`, `thread_count` must be positive,
+ * and `node_capacity` must be not negative.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in] root          the game position at the root of the tree
+ * @param [in] parallelism   how the threads share the work
+ * @param [in] thread_count  the count of threads
+ * @param [in] node_capacity the count of node records, zero selects the default of 2^21
+ * @return                   a pointer to a new mcts tree structure
+ */
+MctsTree *
+mcts_tree_new (const GamePosition *const root,
+               const MctsSolverParallelism parallelism,
+               const int thread_count,
+               const int node_capacity)
+{
+  g_assert(root);
+  g_assert(thread_count > 0);
+  g_assert(node_capacity >= 0);
+
+  MctsTree *tree = (MctsTree *) malloc(sizeof(MctsTree));
+  g_assert(tree);
+
+  game_position_x_copy_from_gp(root, &tree->root);
+  tree->parallelism = parallelism;
+  tree->thread_count = thread_count;
+  tree->arena_count = parallelism == MCTS_SOLVER_PARALLELISM_ROOT ? thread_count : 1;
+  tree->playout_count = 0;
+  tree->elapsed = 0.0;
+
+  const int capacity = (node_capacity ? node_capacity : default_node_capacity) / tree->arena_count;
+  g_assert(capacity > 0);
+  tree->arenas = (MctsArena *) malloc(tree->arena_count * sizeof(MctsArena));
+  g_assert(tree->arenas);
+  for (int i = 0; i < tree->arena_count; i++) {
+    tree->arenas[i].nodes = NULL;
+    mcts_arena_init(&tree->arenas[i], capacity);
+  }
+
+  return tree;
+}
+
+/**
+ * @brief Deallocates the memory previously allocated by a call to #mcts_tree_new.
+ *
+ * @details If a null pointer is passed as argument, no action occurs.
+ *
+ * @param [in,out] tree the pointer to be deallocated
+ */
+void
+mcts_tree_free (MctsTree *tree)
+{
+  if (tree) {
+    for (int i = 0; i < tree->arena_count; i++) free(tree->arenas[i].nodes);
+    free(tree->arenas);
+    free(tree);
+  }
+}
+
+/**
+ * @brief Grows the tree, until the budget of the context is exhausted.
+ *
+ * @details The node limit of the budget is the count of playouts, split evenly among the threads,
+ * when the context has no budget 100000 playouts are run. Each thread has its own random number generator,
+ * seeded by the generator of the context. The statistics collected by earlier searches are kept.
+ * Logging, and the options of the context selecting the threads, are not used.
+ *
+ * @invariant Parameters `tree` and `ctx` must be not `NULL`.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] tree the mcts tree
+ * @param [in,out] ctx  the solver context
+ */
+void
+mcts_tree_search (MctsTree *const tree,
+                  SolverContext *const ctx)
+{
+  g_assert(tree);
+  g_assert(ctx);
+
+  const int tc = tree->thread_count;
+
+  solver_context_search_start(ctx);
+  const uint64_t playout_count = ctx->budget_is_on ? ctx->budget.node_limit : default_playout_count;
+
+  MctsSearch search;
+  search.tree = tree;
+  search.ctx = ctx;
+  search.virtual_loss = tree->parallelism == MCTS_SOLVER_PARALLELISM_TREE && tc > 1;
+
+  /* Roots are expanded before the threads start, so that every playout visits a root move. */
+  for (int i = 0; i < tree->arena_count; i++) {
+    MctsArena *const arena = &tree->arenas[i];
+    if (g_atomic_int_compare_and_exchange(&arena->nodes[0].state, 0, 1)) mcts_node_expand(arena, &arena->nodes[0], &tree->root);
+  }
+
+  RandomNumberGenerator *const seed_rng = solver_context_get_rng(ctx);
+  MctsWorker *workers = (MctsWorker *) malloc(tc * sizeof(MctsWorker));
+  GThread **threads = (GThread **) malloc(tc * sizeof(GThread *));
+  g_assert(workers && threads);
+  for (int i = 0; i < tc; i++) {
+    workers[i].search = &search;
+    workers[i].arena = &tree->arenas[tree->arena_count > 1 ? i : 0];
+    workers[i].rng = rng_new(rng_random_choice_from_finite_set(seed_rng, 0xFFFFFFFF));
+    workers[i].playout_limit = playout_count ? playout_count / tc + ((uint64_t) i < playout_count % tc ? 1 : 0) : 0;
+    workers[i].playout_count = 0;
+  }
+
+  const gint64 start = g_get_monotonic_time();
+  for (int i = 1; i < tc; i++) threads[i] = g_thread_new("mcts", mcts_worker_run, &workers[i]);
+  mcts_worker_run(&workers[0]);
+  for (int i = 1; i < tc; i++) g_thread_join(threads[i]);
+  tree->elapsed = (g_get_monotonic_time() - start) / 1.0e6;
+
+  tree->playout_count = 0;
+  for (int i = 0; i < tc; i++) {
+    tree->playout_count += workers[i].playout_count;
+    rng_free(workers[i].rng);
+  }
+  free(threads);
+  free(workers);
+
+  solver_context_search_end(ctx);
+}
+
+/**
+ * @brief Returns the root move having the most visits, summed over the trees.
+ *
+ * @details Ties are broken by the score. When no root move has been visited yet,
+ * or the game is over, #invalid_move is returned.
+ *
+ * @invariant Parameter `tree` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] tree the mcts tree
+ * @return          the best move
+ */
+Square
+mcts_tree_best_move (const MctsTree *const tree)
+{
+  g_assert(tree);
+
+  Square moves[64];
+  const int move_count = mcts_moves(&tree->root, moves);
+  Square best_move = invalid_move;
+  uint64_t best_visit_count = 0;
+  uint64_t best_move_score = 0;
+  for (int i = 0; i < move_count; i++) {
+    const Square move = moves[i];
+    uint64_t visit_count, score;
+    mcts_tree_root_move_stats(tree, move, &visit_count, &score);
+    if (visit_count == 0) continue;
+    if (best_move == invalid_move || visit_count > best_visit_count ||
+        (visit_count == best_visit_count && score > best_move_score)) {
+      best_move = move;
+      best_visit_count = visit_count;
+      best_move_score = score;
+    }
+  }
+  return best_move;
+}
+
+/**
+ * @brief Moves the root of the tree forward, keeping the subtree below the move.
+ *
+ * @details The subtree is copied at the start of the arena, releasing the records of the
+ * other nodes. When the move has not been expanded, the tree is cleared.
+ * The root parallelism moves forward each one of the trees.
+ *
+ * @invariant Parameter `tree` must be not `NULL`, and `move` must be legal at the root,
+ * or be #pass_move when no move is legal.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] tree the mcts tree
+ * @param [in]     move the move played
+ * @return              true when the subtree of the move has been kept
+ */
+gboolean
+mcts_tree_advance (MctsTree *const tree,
+                   const Square move)
+{
+  g_assert(tree);
+
+  const SquareSet moves = game_position_x_legal_moves(&tree->root);
+  if (move == pass_move) {
+    g_assert(!moves);
+    game_position_x_do_pass(&tree->root);
+  } else {
+    g_assert(moves & ((SquareSet) 1 << move));
+    game_position_x_do_move(&tree->root, move);
+  }
+
+  gboolean reused = TRUE;
+  for (int i = 0; i < tree->arena_count; i++) {
+    if (!mcts_arena_reroot(&tree->arenas[i], move)) reused = FALSE;
+  }
+  return reused;
+}
+
+/**
+ * @brief Returns the visits, and the score, of a root move, summed over the trees.
+ *
+ * @details The score is twice the count of wins plus the count of draws.
+ * A move that has not been expanded has no visits.
+ *
+ * @invariant Parameters `tree`, `visit_count`, and `score` must be not `NULL`.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in]  tree        the mcts tree
+ * @param [in]  move        the root move
+ * @param [out] visit_count the count of visits
+ * @param [out] score       the score
+ */
+void
+mcts_tree_root_move_stats (const MctsTree *const tree,
+                           const Square move,
+                           uint64_t *const visit_count,
+                           uint64_t *const score)
+{
+  g_assert(tree);
+  g_assert(visit_count);
+  g_assert(score);
+
+  *visit_count = 0;
+  *score = 0;
+  for (int i = 0; i < tree->arena_count; i++) {
+    const MctsArena *const arena = &tree->arenas[i];
+    const MctsNode *const root = &arena->nodes[0];
+    for (int j = 0; j < root->child_count; j++) {
+      const MctsNode *const child = &arena->nodes[root->first_child + j];
+      if (child->move != (int8_t) move) continue;
+      *visit_count += child->visit_count;
+      *score += child->score;
+    }
+  }
+}
+
+/**
+ * @brief Returns a new exact solution, reporting the search.
+ *
+ * @details The game value is not proven, the solution is incomplete with the bounds of the full range.
+ * The best move is the most visited one, the node and leaf counts are the count of playouts of the last search.
+ *
+ * @invariant Parameter `tree` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] tree the mcts tree
+ * @return          a pointer to a new exact solution structure
+ */
+ExactSolution *
+mcts_tree_to_exact_solution (const MctsTree *const tree)
+{
+  g_assert(tree);
+
+  ExactSolution *result = exact_solution_new();
+  result->solved_game_position = game_position_x_gpx_to_gp(&tree->root);
+  result->node_count = tree->playout_count;
+  result->leaf_count = tree->playout_count;
+  exact_solution_set_incomplete(result, worst_score, best_score, mcts_tree_best_move(tree));
+  return result;
+}
+
+/**
+ * @brief Returns a formatted string describing the tree.
+ *
+ * @details The first line reports the playouts of the last search, and the nodes in use,
+ * then the root moves follow, most visited first, with their visits and win rates.
+ * A draw counts as half a win.
+ *
+ * The returned string has a dynamic extent set by a call to malloc. It must then properly
+ * garbage collected by a call to free when no more referenced.
+ *
+ * @invariant Parameter `tree` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] tree the mcts tree
+ * @return          a string being a representation of the tree
+ */
+gchar *
+mcts_tree_to_string (const MctsTree *const tree)
+{
+  g_assert(tree);
+
+  uint64_t node_count = 0;
+  uint64_t capacity = 0;
+  for (int i = 0; i < tree->arena_count; i++) {
+    const MctsArena *const arena = &tree->arenas[i];
+    node_count += MIN(arena->fill_point, arena->capacity);
+    capacity += arena->capacity;
+  }
+
+  GString *str = g_string_new(NULL);
+  g_string_append_printf(str, "Mcts: %" PRIu64 " playouts, %d threads, %s parallelism, %.3f seconds, %.0f playouts per second\n",
+                         tree->playout_count, tree->thread_count,
+                         tree->parallelism == MCTS_SOLVER_PARALLELISM_ROOT ? "root" : "tree", tree->elapsed,
+                         tree->elapsed > 0.0 ? tree->playout_count / tree->elapsed : 0.0);
+  g_string_append_printf(str, "Nodes: %" PRIu64 " of %" PRIu64 "\n", node_count, capacity);
+
+  Square moves[64];
+  uint64_t visit_counts[64];
+  uint64_t scores[64];
+  const int move_count = mcts_moves(&tree->root, moves);
+  for (int i = 0; i < move_count; i++) {
+    mcts_tree_root_move_stats(tree, moves[i], &visit_counts[i], &scores[i]);
+    for (int j = i; j > 0 && visit_counts[j] > visit_counts[j - 1]; j--) {
+      const Square m = moves[j]; moves[j] = moves[j - 1]; moves[j - 1] = m;
+      const uint64_t v = visit_counts[j]; visit_counts[j] = visit_counts[j - 1]; visit_counts[j - 1] = v;
+      const uint64_t s = scores[j]; scores[j] = scores[j - 1]; scores[j - 1] = s;
+    }
+  }
+
+  g_string_append_printf(str, "%-5s %12s %9s\n", "move", "visits", "win rate");
+  for (int i = 0; i < move_count; i++) {
+    g_string_append_printf(str, "%-5s %12" PRIu64 " %9.4f\n",
+                           square_as_move_to_string(moves[i]), visit_counts[i],
+                           visit_counts[i] ? scores[i] / (2.0 * visit_counts[i]) : 0.0);
+  }
+
+  return g_string_free(str, FALSE);
+}
+
+
+
+/**
+ * Internal functions.
+ *
+ * @cond
+ */
+
+/*
+ * Allocates the records of the arena, when missing, and clears it, leaving only the root node.
+ */
+static void
+mcts_arena_init (MctsArena *const arena,
+                 const int capacity)
+{
+  if (!arena->nodes) {
+    arena->nodes = (MctsNode *) malloc(capacity * sizeof(MctsNode));
+    g_assert(arena->nodes);
+    arena->capacity = capacity;
+  }
+  arena->nodes[0] = (MctsNode) { 0, 0, 0, 0, 0, 0, 0 };
+  arena->fill_point = 1;
+}
+
+/*
+ * Makes the child reached by the move the new root, copying its subtree at the start of the arena.
+ * Returns false, and clears the arena, when the child is missing.
+ *
+ * The copy runs breadth first, a node is always copied after its parent, so the children
+ * of the node being scanned are appended, as a block, at the fill point of the new records.
+ */
+static gboolean
+mcts_arena_reroot (MctsArena *const arena,
+                   const Square move)
+{
+  const MctsNode *const root = &arena->nodes[0];
+  int child_index = -1;
+  for (int i = 0; i < root->child_count; i++) {
+    if (arena->nodes[root->first_child + i].move == (int8_t) move) child_index = root->first_child + i;
+  }
+  if (child_index < 0) {
+    mcts_arena_init(arena, arena->capacity);
+    return FALSE;
+  }
+
+  MctsNode *nodes = (MctsNode *) malloc(arena->capacity * sizeof(MctsNode));
+  g_assert(nodes);
+  nodes[0] = arena->nodes[child_index];
+  int fill_point = 1;
+  for (int i = 0; i < fill_point; i++) {
+    MctsNode *const node = &nodes[i];
+    if (node->child_count) {
+      memcpy(&nodes[fill_point], &arena->nodes[node->first_child], node->child_count * sizeof(MctsNode));
+      node->first_child = fill_point;
+      fill_point += node->child_count;
+    }
+  }
+  free(arena->nodes);
+  arena->nodes = nodes;
+  arena->fill_point = fill_point;
+  return TRUE;
+}
+
+/*
+ * Fills the moves of the children of a node, returning their count.
+ * A game position having no legal moves has a single child, the pass, unless the game is over.
+ */
+static int
+mcts_moves (const GamePositionX *const gpx,
+            Square *const moves)
+{
+  int move_count = 0;
+  const SquareSet move_set = game_position_x_legal_moves(gpx);
+  if (move_set) {
+    for (SquareSet s = move_set; s; s &= s - 1) moves[move_count++] = bit_works_bitscanLS1B_64(s);
+  } else {
+    GamePositionX next;
+    game_position_x_pass(gpx, &next);
+    if (game_position_x_legal_moves(&next)) moves[move_count++] = pass_move;
+  }
+  return move_count;
+}
+
+/*
+ * Allocates and clears the children of the node.
+ *
+ * The caller owns the node, having moved its state from zero to one. The state is set to two
+ * when the children are ready, or back to zero when the arena is full.
+ */
+static gboolean
+mcts_node_expand (MctsArena *const arena,
+                  MctsNode *const node,
+                  const GamePositionX *const gpx)
+{
+  Square moves[64];
+  const int move_count = mcts_moves(gpx, moves);
+  if (move_count) {
+    if (g_atomic_int_get(&arena->fill_point) + move_count > arena->capacity) {
+      g_atomic_int_set(&node->state, 0);
+      return FALSE;
+    }
+    const gint first_child = g_atomic_int_add(&arena->fill_point, move_count);
+    if (first_child + move_count > arena->capacity) {
+      g_atomic_int_set(&node->state, 0);
+      return FALSE;
+    }
+    for (int i = 0; i < move_count; i++) {
+      arena->nodes[first_child + i] = (MctsNode) { 0, 0, (int8_t) moves[i], 0, 0, 0, 0 };
+    }
+    node->first_child = first_child;
+    node->child_count = move_count;
+  }
+  g_atomic_int_set(&node->state, 2);
+  return TRUE;
+}
+
+/*
+ * Returns the index of the child maximizing the UCT value, children not yet visited come first.
+ * The virtual losses count as visits having no score.
+ */
+static int
+mcts_node_select (const MctsArena *const arena,
+                  const MctsNode *const node)
+{
+  const double log_parent = log((double) (g_atomic_int_get(&node->visit_count) + g_atomic_int_get(&node->virtual_loss) + 1));
+  int best_index = node->first_child;
+  double best_value = -1.0;
+  for (int i = node->first_child; i < node->first_child + node->child_count; i++) {
+    const MctsNode *const child = &arena->nodes[i];
+    const int n = g_atomic_int_get(&child->visit_count) + g_atomic_int_get(&child->virtual_loss);
+    if (n == 0) return i;
+    const double value = g_atomic_int_get(&child->score) / (2.0 * n) + exploration_constant * sqrt(log_parent / n);
+    if (value > best_value) {
+      best_value = value;
+      best_index = i;
+    }
+  }
+  return best_index;
+}
+
+/*
+ * Runs one playout: selects a path down to a leaf, expanding it when it has been visited already,
+ * plays a random game, and backs up the outcome.
+ *
+ * The score of a node belongs to the player moving into it, that is the player to move at the parent.
+ */
+static void
+mcts_playout (MctsWorker *const w)
+{
+  MctsArena *const arena = w->arena;
+  const gboolean virtual_loss = w->search->virtual_loss;
+  int path[MCTS_MAX_PATH_LENGTH];
+  Player players[MCTS_MAX_PATH_LENGTH];
+  int length = 0;
+
+  GamePositionX gpx = w->search->tree->root;
+  int index = 0;
+  for (;;) {
+    MctsNode *const node = &arena->nodes[index];
+    path[length] = index;
+    players[length] = gpx.player;
+    length++;
+    if (virtual_loss) g_atomic_int_inc(&node->virtual_loss);
+
+    gint state = g_atomic_int_get(&node->state);
+    if (state == 0 && (length == 1 || g_atomic_int_get(&node->visit_count) > 0) &&
+        g_atomic_int_compare_and_exchange(&node->state, 0, 1)) {
+      if (mcts_node_expand(arena, node, &gpx)) state = 2;
+    }
+    if (state != 2 || node->child_count == 0) break;
+
+    g_assert(length < MCTS_MAX_PATH_LENGTH);
+    index = mcts_node_select(arena, node);
+    const int move = arena->nodes[index].move;
+    if (move == pass_move) game_position_x_do_pass(&gpx);
+    else game_position_x_do_move(&gpx, move);
+  }
+
+  const int value = game_position_x_random_game(w->rng, &gpx);
+  for (int i = 0; i < length; i++) {
+    MctsNode *const node = &arena->nodes[path[i]];
+    if (i > 0) {
+      const int v = players[i - 1] == gpx.player ? value : -value;
+      if (v >= 0) g_atomic_int_add(&node->score, v > 0 ? 2 : 1);
+    }
+    g_atomic_int_inc(&node->visit_count);
+    if (virtual_loss) g_atomic_int_add(&node->virtual_loss, -1);
+  }
+}
+
+/*
+ * Runs playouts until the thread quota is done, or the deadline is reached.
+ */
+static gpointer
+mcts_worker_run (gpointer data)
+{
+  MctsWorker *const w = (MctsWorker *) data;
+  SolverContext *const ctx = w->search->ctx;
+
+  while (!g_atomic_int_get(&ctx->budget_exhausted)) {
+    if (w->playout_limit && w->playout_count >= w->playout_limit) break;
+    if (ctx->deadline && w->playout_count % time_check_interval == 0 && g_get_monotonic_time() >= ctx->deadline) {
+      g_atomic_int_set(&ctx->budget_exhausted, 1);
+      break;
+    }
+    mcts_playout(w);
+    w->playout_count++;
+  }
+  return NULL;
+}
+
+/**
+ * @endcond
+ */
@@ -0,0 +1,156 @@
+/**
+ * @file
+ *
+ * @brief Monte Carlo tree search solver module definitions.
+ * @details This module defines the #game_position_mcts_solve function, and the #MctsTree entity.
+ *
+ * @par mcts_solver.h
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#ifndef MCTS_SOLVER_H
+#define MCTS_SOLVER_H
+
+#include <glib.h>
+
+#include "board.h"
+#include "exact_solver.h"
+#include "solver_context.h"
+
+
+
+/**********************************************/
+/* Type declarations.                         */
+/**********************************************/
+
+/**
+ * @brief A node of the search tree.
+ *
+ * @details The children of a node are allocated together, in consecutive records of the arena.
+ * The score is twice the count of wins plus the count of draws, for the player moving into the node.
+ * The counters are updated by atomic operations, the threads of the tree parallelism share them.
+ */
+typedef struct {
+  uint32_t      first_child;    /**< @brief The arena index of the first child. */
+  uint8_t       child_count;    /**< @brief The count of children, zero when the node is a leaf or the game is over. */
+  int8_t        move;           /**< @brief The move leading to the node, or #pass_move. */
+  volatile gint state;          /**< @brief Zero when not expanded, one while being expanded, two when expanded. */
+  volatile gint visit_count;    /**< @brief The count of playouts that went through the node. */
+  volatile gint score;          /**< @brief The sum of the playout scores, two for a win, one for a draw. */
+  volatile gint virtual_loss;   /**< @brief The count of playouts running below the node. */
+} MctsNode;
+
+/**
+ * @brief A fixed size block of nodes, holding one tree.
+ */
+typedef struct {
+  MctsNode     *nodes;          /**< @brief The node records. */
+  gint          capacity;       /**< @brief The count of node records. */
+  volatile gint fill_point;     /**< @brief The count of node records in use, the root is the first one. */
+} MctsArena;
+
+/**
+ * @brief A search tree, or a set of them when the work is shared by root parallelism.
+ *
+ * @details The tree is kept between consecutive searches, see #mcts_tree_advance.
+ */
+typedef struct {
+  GamePositionX          root;             /**< @brief The game position at the root. */
+  MctsSolverParallelism  parallelism;      /**< @brief How the threads share the work. */
+  int                    thread_count;     /**< @brief The count of threads. */
+  int                    arena_count;      /**< @brief The count of trees, one for each thread with the root parallelism. */
+  MctsArena             *arenas;           /**< @brief The trees. */
+  uint64_t               playout_count;    /**< @brief The count of playouts of the last search. */
+  double                 elapsed;          /**< @brief The wall clock time of the last search, in seconds. */
+} MctsTree;
+
+
+
+/*********************************************************/
+/* Function implementations for the GamePosition entity. */
+/*********************************************************/
+
+extern ExactSolution *
+game_position_mcts_solve (const GamePosition *const root,
+                          const gchar *const log_file);
+
+extern ExactSolution *
+game_position_mcts_solve_with_context (SolverContext *const ctx,
+                                       const GamePosition *const root);
+
+extern void
+mcts_solver_set_parallelism (const MctsSolverParallelism parallelism);
+
+extern MctsSolverParallelism
+mcts_solver_get_parallelism (void);
+
+extern void
+mcts_solver_set_thread_count (const int thread_count);
+
+extern int
+mcts_solver_get_thread_count (void);
+
+
+
+/************************************************/
+/* Function prototypes for the MctsTree entity. */
+/************************************************/
+
+extern MctsTree *
+mcts_tree_new (const GamePosition *const root,
+               const MctsSolverParallelism parallelism,
+               const int thread_count,
+               const int node_capacity);
+
+extern void
+mcts_tree_free (MctsTree *tree);
+
+extern void
+mcts_tree_search (MctsTree *const tree,
+                  SolverContext *const ctx);
+
+extern Square
+mcts_tree_best_move (const MctsTree *const tree);
+
+extern gboolean
+mcts_tree_advance (MctsTree *const tree,
+                   const Square move);
+
+extern void
+mcts_tree_root_move_stats (const MctsTree *const tree,
+                           const Square move,
+                           uint64_t *const visit_count,
+                           uint64_t *const score);
+
+extern ExactSolution *
+mcts_tree_to_exact_solution (const MctsTree *const tree);
+
+extern gchar *
+mcts_tree_to_string (const MctsTree *const tree);
+
+
+
+#endif /* MCTS_SOLVER_H */
@@ -50,29 +50,9 @@
  */
 
 static SearchNode *
-game_position_solve_impl (ExactSolution *const result,
-                          const GamePosition *const gp);
-
-
-
-/*
- * Internal variables and constants.
- */
-
-/* The logging environment structure. */
-static LogEnv *log_env = NULL;
-
-/* The total number of call to the recursive function that traverse the game DAG. */
-static uint64_t call_count = 0;
-
-/* The predecessor-successor array of game position hash values. */
-static uint64_t gp_hash_stack[128];
-
-/* The index of the last entry into gp_hash_stack. */
-static int gp_hash_stack_fill_point = 0;
-
-/* The sub_run_id used for logging. */
-static const int sub_run_id = 0;
+game_position_solve_impl (SolverContext *const ctx,
+                          ExactSolution *const result,
+                          GamePositionX *const gpx);
 
 /**
  * @endcond
@@ -87,6 +67,8 @@ static const int sub_run_id = 0;
 /**
  * @brief Solves the game position returning a new exact solution pointer.
  *
+ * @details It is a wrapper of #game_position_minimax_solve_with_context, running on a new context.
+ *
  * @param [in] root the starting game position to be solved
  * @param [in] log_file if not null turns logging on the given file name
  * @return          a pointer to a new exact solution structure
@@ -95,28 +77,64 @@ ExactSolution *
 game_position_minimax_solve (const GamePosition *const root,
                              const gchar *const log_file)
 {
-  log_env = game_tree_log_init(log_file);
+  SolverContext *ctx = solver_context_new();
+  ctx->log_file = log_file;
+  ExactSolution *result = game_position_minimax_solve_with_context(ctx, root);
+  solver_context_free(ctx);
+  return result;
+}
+
+/**
+ * @brief Solves the game position, as selected by the options of the solver context,
+ * returning a new exact solution pointer.
+ *
+ * @invariant Parameters `ctx` and `root` must be not `NULL`.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] ctx  the solver context
+ * @param [in]     root the starting game position to be solved
+ * @return              a pointer to a new exact solution structure
+ */
+ExactSolution *
+game_position_minimax_solve_with_context (SolverContext *const ctx,
+                                          const GamePosition *const root)
+{
+  g_assert(ctx);
+  g_assert(root);
+
+  solver_context_search_start(ctx);
 
-  if (log_env->log_is_on) {
+  if (ctx->log_env->log_is_on) {
     GamePosition *ground = game_position_new(board_new(root->board->blacks,
                                                        root->board->whites),
                                              player_opponent(root->player));
-    gp_hash_stack[0] = game_position_hash(ground);
+    ctx->gp_hash_stack[0] = game_position_hash(ground);
     game_position_free(ground);
-    game_tree_log_open_h(log_env);
+    game_tree_log_open_h(ctx->log_env);
   }
 
   ExactSolution *result = exact_solution_new();
 
   result->solved_game_position = game_position_clone(root);
 
-  SearchNode *sn = game_position_solve_impl(result, result->solved_game_position);
+  GamePositionX gpx;
+  game_position_x_copy_from_gp(root, &gpx);
+
+  SearchNode *sn = game_position_solve_impl(ctx, result, &gpx);
 
   result->pv[0] = sn->move;
   result->outcome = sn->value;
+  if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) {
+    /* The root value is the best one among the moves searched to the end, if any. */
+    const gboolean has_lower_bound = sn->value > out_of_range_defeat_score;
+    exact_solution_set_incomplete(result,
+                                  has_lower_bound ? sn->value : worst_score,
+                                  best_score,
+                                  has_lower_bound ? sn->move : invalid_move);
+  }
   search_node_free(sn);
 
-  game_tree_log_close(log_env);
+  solver_context_search_end(ctx);
 
   return result;
 }
@@ -134,57 +152,72 @@ game_position_minimax_solve (const GamePosition *const root,
 /**
  * @brief Recursive function used to traverse the game tree.
  *
- * @param [in] result a reference to the exact solution data structure
- * @param [in] gp     the game position to traverse
- * @return            a pointer to a new serch node structure
+ * The game position is updated in place by moving forward and back,
+ * it is restored to the original value when the function returns.
+ *
+ * When the budget is exhausted the search unwinds, each node keeps the best value
+ * of the moves searched to the end, and the parent ignores it.
+ *
+ * @param [in,out] ctx    the solver context
+ * @param [in]     result a reference to the exact solution data structure
+ * @param [in,out] gpx    the game position to traverse
+ * @return                a pointer to a new serch node structure
  */
 static SearchNode *
-game_position_solve_impl (ExactSolution *const result,
-                          const GamePosition *const gp)
+game_position_solve_impl (SolverContext *const ctx,
+                          ExactSolution *const result,
+                          GamePositionX *const gpx)
 {
   SearchNode *node  = NULL;
   SearchNode *node2 = NULL;
 
   result->node_count++;
 
-  const SquareSet moves = game_position_legal_moves(gp);
+  if (ctx->budget_is_on && solver_context_budget_check(ctx, result->node_count)) return search_node_new(invalid_move, out_of_range_defeat_score);
 
-  if (log_env->log_is_on) {
-    call_count++;
-    gp_hash_stack_fill_point++;
+  const SquareSet moves = game_position_x_legal_moves(gpx);
+
+  if (ctx->log_env->log_is_on) {
+    ctx->call_count++;
+    ctx->gp_hash_stack_fill_point++;
     LogDataH log_data;
     log_data.sub_run_id = 0;
-    log_data.call_id = call_count;
-    log_data.hash = game_position_hash(gp);
-    gp_hash_stack[gp_hash_stack_fill_point] = log_data.hash;
-    log_data.parent_hash = gp_hash_stack[gp_hash_stack_fill_point - 1];
-    log_data.blacks = (gp->board)->blacks;
-    log_data.whites = (gp->board)->whites;
-    log_data.player = gp->player;
-    gchar *json_doc = game_tree_log_data_h_json_doc(gp_hash_stack_fill_point, gp);
+    log_data.call_id = ctx->call_count;
+    log_data.hash = game_position_x_hash(gpx);
+    ctx->gp_hash_stack[ctx->gp_hash_stack_fill_point] = log_data.hash;
+    log_data.parent_hash = ctx->gp_hash_stack[ctx->gp_hash_stack_fill_point - 1];
+    log_data.blacks = gpx->blacks;
+    log_data.whites = gpx->whites;
+    log_data.player = gpx->player;
+    gchar *json_doc = game_tree_log_data_h_json_doc_gpx(ctx->gp_hash_stack_fill_point, gpx);
     log_data.json_doc = json_doc;
-    game_tree_log_write_h(log_env, &log_data);
+    game_tree_log_write_h(ctx->log_env, &log_data);
     g_free(json_doc);
   }
 
   if (moves == empty_square_set) {
-    GamePosition *flipped_players = game_position_pass(gp);
-    if (game_position_has_any_legal_move(flipped_players)) {
-      node = search_node_negated(game_position_solve_impl(result, flipped_players));
+    if (game_position_x_has_any_player_any_legal_move(gpx)) {
+      game_position_x_do_pass(gpx);
+      node = search_node_negated(game_position_solve_impl(ctx, result, gpx));
+      game_position_x_undo_pass(gpx);
+      if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) node->value = out_of_range_defeat_score;
     } else {
       result->leaf_count++;
-      node = search_node_new(pass_move, game_position_final_value(gp));
+      node = search_node_new(pass_move, game_position_x_final_value(gpx));
     }
-    game_position_free(flipped_players);
   } else {
     node = search_node_new(-1, -65);
     SquareSet remaining_moves = moves;
     while (remaining_moves) {
       const Square move = bit_works_bitscanLS1B_64(remaining_moves);
       remaining_moves ^= 1ULL << move;
-      GamePosition *gp2 = game_position_make_move(gp, move);
-      node2 = search_node_negated(game_position_solve_impl(result, gp2));
-      game_position_free(gp2);
+      const SquareSet flips = game_position_x_do_move(gpx, move);
+      node2 = search_node_negated(game_position_solve_impl(ctx, result, gpx));
+      game_position_x_undo_move(gpx, move, flips);
+      if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) {
+        search_node_free(node2);
+        break;
+      }
       if (node2->value > node->value) {
         search_node_free(node);
         node = node2;
@@ -196,8 +229,8 @@ game_position_solve_impl (ExactSolution *const result,
     }
   }
 
-  if (log_env->log_is_on) {
-    gp_hash_stack_fill_point--;
+  if (ctx->log_env->log_is_on) {
+    ctx->gp_hash_stack_fill_point--;
   }
 
   return node;
@@ -47,5 +47,9 @@ extern ExactSolution *
 game_position_minimax_solve (const GamePosition * const root,
                              const gchar        * const log_file);
 
+extern ExactSolution *
+game_position_minimax_solve_with_context (SolverContext      *const ctx,
+                                          const GamePosition *const root);
+
 
 #endif /* MINIMAX_SOLVER_H */
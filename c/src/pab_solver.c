@@ -0,0 +1,631 @@
+/**
+ * @file
+ *
+ * @brief Parallel alpha-beta solver module implementation.
+ * @details It searches the end of the game for an exact outcome using the Alpha-Beta algorithm,
+ * the work is shared by a pool of threads following the Young Brothers Wait Concept.
+ *
+ * A node having enough empty squares searches its eldest child alone, then, when the child
+ * does not cut off and some thread of the pool is idle, it becomes a split point: the remaining
+ * moves are published and any idle thread can join and search them, together with the owner of
+ * the node. The window of the split point narrows as results come back, a value not less than
+ * beta sets the abort flag that stops every thread searching below the split point.
+ * The owner waits for its helpers before returning the node value.
+ *
+ * Moves are sorted by their natural order, from A1 to H8, the move found in the lock free hash
+ * table, when it is turned on, is searched first.
+ * Nodes having at most #LAST_MOVES_SOLVER_MAX_EMPTIES empty squares are handed to the last moves solver.
+ *
+ * @par pab_solver.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <glib.h>
+
+#include "bit_works.h"
+#include "lock_free_hash_table.h"
+#include "last_moves_solver.h"
+#include "solver_context.h"
+
+#include "pab_solver.h"
+
+
+
+/**
+ * @cond
+ */
+
+/*
+ * Internal types.
+ */
+
+/*
+ * A node whose remaining moves are shared by the threads of the pool.
+ *
+ * The structure lives on the C stack of the owner thread, that doesn't return
+ * until all the helpers have left.
+ */
+typedef struct SplitPoint_ {
+  GMutex               lock;           /* Guards the mutable fields, but abort. */
+  GCond                helpers_done;   /* Signaled when the last helper leaves. */
+  struct SplitPoint_  *parent;         /* The split point the owner was working for, NULL at the top. */
+  struct SplitPoint_  *next;           /* The next split point in the pool list. */
+  GamePositionX        gpx;            /* The game position of the node. */
+  uint64_t             hash;           /* The hash of the game position. */
+  int                  ply;            /* The distance from the root. */
+  int                  empty_count;    /* The count of empty squares. */
+  Square               moves[64];      /* The moves left to be searched after the eldest child. */
+  int                  move_count;     /* The count of moves. */
+  int                  next_move;      /* The index of the next move to be searched. */
+  int                  alpha;          /* The current lower limit of the window. */
+  int                  beta;           /* The upper limit of the window. */
+  int                  best_value;     /* The best value found so far. */
+  Square               best_move;      /* The move having the best value. */
+  int                  helper_count;   /* The count of threads, other than the owner, working on the node. */
+  volatile gint        abort;          /* Set when the node cuts off. */
+} SplitPoint;
+
+/*
+ * The pool of threads, one for each search.
+ */
+typedef struct {
+  SolverContext       *ctx;            /* The solver context, giving the options and the budget. */
+  GMutex               lock;           /* Guards the split point list and the shutdown flag. */
+  GCond                work_available; /* Signaled when a split point is published, or on shutdown. */
+  SplitPoint          *split_points;   /* The list of the published split points. */
+  volatile gint        idle_count;     /* The count of threads waiting for work. */
+  uint64_t             node_count;     /* The count of nodes searched by all the threads, guarded by the lock. */
+  gboolean             shutdown;       /* Set when the search is over. */
+} PabPool;
+
+/*
+ * The data owned by each thread.
+ */
+typedef struct {
+  PabPool             *pool;           /* The pool the thread belongs to. */
+  uint64_t             node_count;     /* The count of nodes searched by the thread. */
+  uint64_t             leaf_count;     /* The count of leaves searched by the thread. */
+  uint64_t             split_count;    /* The count of split points created by the thread. */
+  uint64_t             shared_count;   /* The count of nodes already added to the count shared by the pool. */
+} PabWorker;
+
+
+
+/*
+ * Prototypes for internal functions.
+ */
+
+static int
+pab_search (PabWorker *const w,
+            SplitPoint *const sp,
+            const GamePositionX *const gpx,
+            const uint64_t hash,
+            const int alpha,
+            const int beta,
+            const int ply,
+            const gboolean passed,
+            Square *const best_move);
+
+static void
+pab_split (PabWorker *const w,
+           SplitPoint *const parent,
+           const GamePositionX *const gpx,
+           const uint64_t hash,
+           const int ply,
+           const int empty_count,
+           const Square *const moves,
+           const int move_count,
+           const int alpha,
+           const int beta,
+           int *const best_value,
+           Square *const best_move);
+
+static void
+split_point_work (PabWorker *const w,
+                  SplitPoint *const sp);
+
+static gboolean
+split_point_is_aborted (PabPool *const pool,
+                        const SplitPoint *sp);
+
+static gpointer
+pab_worker_run (gpointer data);
+
+
+
+/*
+ * Internal variables and constants.
+ */
+
+/* The count of threads, zero means one for each processor. */
+static int thread_count = 0;
+
+/* Nodes having fewer empty squares are cheaper to search than to look up. */
+static const int tt_min_depth = 4;
+
+/* Nodes having fewer empty squares are searched by a single thread. */
+static const int split_min_empties = 10;
+
+/* Each thread adds its nodes to the shared count, and checks the budget, once every 1024 nodes. */
+static const uint64_t budget_check_interval = 1024;
+
+/**
+ * @endcond
+ */
+
+
+
+/*********************************************************/
+/* Function implementations for the GamePosition entity. */
+/*********************************************************/
+
+/**
+ * @brief Solves the game position returning a new exact solution pointer.
+ *
+ * @details It is a wrapper of #game_position_pab_solve_with_context, running on a new context.
+ *
+ * @param [in] root     the starting game position to be solved
+ * @param [in] log_file not used, the parallel solver doesn't log the game tree
+ * @return              a pointer to a new exact solution structure
+ */
+ExactSolution *
+game_position_pab_solve (const GamePosition *const root,
+                         const gchar *const log_file)
+{
+  g_assert(root);
+
+  SolverContext *ctx = solver_context_new();
+  ExactSolution *result = game_position_pab_solve_with_context(ctx, root);
+  solver_context_free(ctx);
+  return result;
+}
+
+/**
+ * @brief Solves the game position, with the options of the solver context,
+ * returning a new exact solution pointer.
+ *
+ * @details The search runs on the calling thread, helped by a pool of
+ * `ctx->pab_thread_count - 1` threads started for the call.
+ * The lock free hash table of the context is shared by the threads of the pool.
+ *
+ * @invariant Parameters `ctx` and `root` must be not `NULL`.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] ctx  the solver context
+ * @param [in]     root the starting game position to be solved
+ * @return              a pointer to a new exact solution structure
+ */
+ExactSolution *
+game_position_pab_solve_with_context (SolverContext *const ctx,
+                                      const GamePosition *const root)
+{
+  g_assert(ctx);
+  g_assert(root);
+
+  const int tc = ctx->pab_thread_count ? ctx->pab_thread_count : (int) g_get_num_processors();
+  const gboolean wld = ctx->wld;
+
+  if (ctx->lfht) lock_free_hash_table_new_search(ctx->lfht);
+
+  PabPool pool;
+  pool.ctx = ctx;
+  g_mutex_init(&pool.lock);
+  g_cond_init(&pool.work_available);
+  pool.split_points = NULL;
+  pool.idle_count = 0;
+  pool.node_count = 0;
+  pool.shutdown = FALSE;
+
+  solver_context_search_start(ctx);
+
+  PabWorker *workers = (PabWorker *) malloc(tc * sizeof(PabWorker));
+  GThread **threads = (GThread **) malloc(tc * sizeof(GThread *));
+  g_assert(workers && threads);
+  for (int i = 0; i < tc; i++) workers[i] = (PabWorker) { &pool, 0, 0, 0, 0 };
+  for (int i = 1; i < tc; i++) threads[i] = g_thread_new("pab", pab_worker_run, &workers[i]);
+
+  GamePositionX gpx;
+  game_position_x_copy_from_gp(root, &gpx);
+  Square best_move = invalid_move;
+  const int root_alpha = wld ? wld_alpha : worst_score;
+  const int game_value = pab_search(&workers[0], NULL, &gpx, game_position_x_hash(&gpx),
+                                    root_alpha, wld ? wld_beta : best_score,
+                                    0, FALSE, &best_move);
+
+  g_mutex_lock(&pool.lock);
+  pool.shutdown = TRUE;
+  g_cond_broadcast(&pool.work_available);
+  g_mutex_unlock(&pool.lock);
+  for (int i = 1; i < tc; i++) g_thread_join(threads[i]);
+
+  ExactSolution *result = exact_solution_new();
+  result->solved_game_position = game_position_clone(root);
+  for (int i = 0; i < tc; i++) {
+    result->node_count += workers[i].node_count;
+    result->leaf_count += workers[i].leaf_count;
+  }
+  result->pv[0] = best_move;
+  result->outcome = game_value;
+  if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) {
+    /* Only a value above the root window, coming from a move searched to the end, is a lower bound. */
+    const gboolean has_lower_bound = best_move != pass_move && game_value > root_alpha;
+    exact_solution_set_incomplete(result,
+                                  has_lower_bound ? game_value : worst_score,
+                                  best_score,
+                                  has_lower_bound ? best_move : invalid_move);
+  } else if (wld) {
+    exact_solution_set_wld_outcome(result);
+  }
+
+  free(threads);
+  free(workers);
+  g_cond_clear(&pool.work_available);
+  g_mutex_clear(&pool.lock);
+
+  solver_context_search_end(ctx);
+
+  return result;
+}
+
+/**
+ * @brief Sets the count of threads used by #game_position_pab_solve.
+ * It is the process wide option, copied by the solver contexts when they are created.
+ *
+ * @details The count includes the calling thread, zero selects one thread for each processor.
+ *
+ * @invariant Parameter `thread_count` must be not negative.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] tc the count of threads
+ */
+void
+pab_solver_set_thread_count (const int tc)
+{
+  g_assert(tc >= 0);
+  thread_count = tc;
+}
+
+/**
+ * @brief Returns the count of threads used by #game_position_pab_solve.
+ *
+ * @return the count of threads
+ */
+int
+pab_solver_get_thread_count (void)
+{
+  return thread_count ? thread_count : (int) g_get_num_processors();
+}
+
+
+
+/**
+ * Internal functions.
+ *
+ * @cond
+ */
+
+/*
+ * Recursive alpha-beta search, fail soft.
+ *
+ * The value is exact when it is inside the window, an upper bound when it is not greater than alpha,
+ * a lower bound when it is not less than beta.
+ * When the split point `sp`, or one of its ancestors, is aborted the returned value is meaningless.
+ * When the budget is exhausted the root returns the best value among the moves searched to the end.
+ */
+static int
+pab_search (PabWorker *const w,
+            SplitPoint *const sp,
+            const GamePositionX *const gpx,
+            const uint64_t hash,
+            const int alpha,
+            const int beta,
+            const int ply,
+            const gboolean passed,
+            Square *const best_move)
+{
+  PabPool *const pool = w->pool;
+  LockFreeHashTable *const lfht = pool->ctx->lfht;
+
+  w->node_count++;
+  *best_move = invalid_move;
+
+  if (pool->ctx->budget_is_on && w->node_count - w->shared_count >= budget_check_interval) {
+    g_mutex_lock(&pool->lock);
+    pool->node_count += w->node_count - w->shared_count;
+    solver_context_budget_check(pool->ctx, pool->node_count);
+    g_mutex_unlock(&pool->lock);
+    w->shared_count = w->node_count;
+  }
+
+  if (split_point_is_aborted(pool, sp)) return 0;
+
+  const SquareSet empties = game_position_x_empties(gpx);
+
+  if (ply > 0 && bit_works_popcount(empties) <= LAST_MOVES_SOLVER_MAX_EMPTIES) {
+    return last_moves_solver_solve(game_position_x_get_player(gpx), game_position_x_get_opponent(gpx),
+                                   alpha, beta, &w->node_count, &w->leaf_count);
+  }
+
+  const SquareSet move_set = game_position_x_legal_moves(gpx);
+
+  if (move_set == empty_square_set) {
+    if (empties != empty_square_set && !passed) {
+      GamePositionX next_gpx;
+      Square next_best_move;
+      game_position_x_pass(gpx, &next_gpx);
+      *best_move = pass_move;
+      return -pab_search(w, sp, &next_gpx, ~hash, -beta, -alpha, ply + 1, TRUE, &next_best_move);
+    }
+    w->leaf_count++;
+    return game_position_x_final_value(gpx);
+  }
+
+  const int empty_count = bit_works_popcount(empties);
+
+  Square moves[64];
+  int move_count = 0;
+  for (SquareSet remaining_moves = move_set; remaining_moves; remaining_moves &= remaining_moves - 1) {
+    moves[move_count++] = bit_works_bitscanLS1B_64(remaining_moves);
+  }
+
+  const gboolean use_tt = lfht && empty_count >= tt_min_depth;
+  if (use_tt) {
+    LockFreeHashTableData data;
+    if (lock_free_hash_table_probe(lfht, hash, empty_count, &data)) {
+      if (ply > 0) {
+        if (data.lower >= beta || data.lower == data.upper) {
+          *best_move = data.best_move;
+          return data.lower;
+        }
+        if (data.upper <= alpha) {
+          *best_move = data.best_move;
+          return data.upper;
+        }
+      }
+      for (int i = 1; i < move_count; i++) {
+        if (moves[i] == data.best_move) {
+          for (; i > 0; i--) moves[i] = moves[i - 1];
+          moves[0] = data.best_move;
+          break;
+        }
+      }
+    }
+  }
+
+  if (pool->ctx->stability_cutoff && ply > 0) {
+    NodeInfo node_info;
+    node_info.gpx = *gpx;
+    node_info.alpha = alpha;
+    node_info.beta = beta;
+    if (node_info_stability_cutoff(&node_info)) return node_info.alpha;
+  }
+
+  int best_value = out_of_range_defeat_score;
+  Square bm = invalid_move;
+  for (int i = 0; i < move_count; i++) {
+    GamePositionX next_gpx = *gpx;
+    const SquareSet flips = game_position_x_do_move(&next_gpx, moves[i]);
+    const uint64_t next_hash = lfht ? game_position_x_delta_hash(hash, flips, moves[i], gpx->player) : 0;
+    Square next_best_move;
+    const int value = -pab_search(w, sp, &next_gpx, next_hash, -beta, -MAX(alpha, best_value), ply + 1, FALSE, &next_best_move);
+    if (split_point_is_aborted(pool, sp)) {
+      if (ply == 0) break;
+      return 0;
+    }
+    if (value > best_value) {
+      best_value = value;
+      bm = moves[i];
+      if (best_value >= beta) break;
+    }
+    if (i == 0 && move_count > 1 && empty_count >= split_min_empties && g_atomic_int_get(&pool->idle_count) > 0) {
+      pab_split(w, sp, gpx, hash, ply, empty_count, moves + 1, move_count - 1, alpha, beta, &best_value, &bm);
+      if (split_point_is_aborted(pool, sp) && ply > 0) return 0;
+      break;
+    }
+  }
+
+  if (split_point_is_aborted(pool, sp)) {
+    *best_move = bm;
+    return best_value;
+  }
+
+  if (use_tt) lock_free_hash_table_store(lfht, hash, empty_count, alpha, beta, best_value, bm);
+
+  *best_move = bm;
+  return best_value;
+}
+
+/*
+ * Publishes the node as a split point, works on it, and waits for the helpers.
+ *
+ * The best value and move found by the eldest child are given, and then updated.
+ */
+static void
+pab_split (PabWorker *const w,
+           SplitPoint *const parent,
+           const GamePositionX *const gpx,
+           const uint64_t hash,
+           const int ply,
+           const int empty_count,
+           const Square *const moves,
+           const int move_count,
+           const int alpha,
+           const int beta,
+           int *const best_value,
+           Square *const best_move)
+{
+  PabPool *const pool = w->pool;
+  SplitPoint sp;
+  g_mutex_init(&sp.lock);
+  g_cond_init(&sp.helpers_done);
+  sp.parent = parent;
+  sp.next = NULL;
+  sp.gpx = *gpx;
+  sp.hash = hash;
+  sp.ply = ply;
+  sp.empty_count = empty_count;
+  for (int i = 0; i < move_count; i++) sp.moves[i] = moves[i];
+  sp.move_count = move_count;
+  sp.next_move = 0;
+  sp.alpha = MAX(alpha, *best_value);
+  sp.beta = beta;
+  sp.best_value = *best_value;
+  sp.best_move = *best_move;
+  sp.helper_count = 0;
+  sp.abort = 0;
+
+  w->split_count++;
+
+  g_mutex_lock(&pool->lock);
+  sp.next = pool->split_points;
+  pool->split_points = &sp;
+  g_cond_broadcast(&pool->work_available);
+  g_mutex_unlock(&pool->lock);
+
+  split_point_work(w, &sp);
+
+  g_mutex_lock(&pool->lock);
+  for (SplitPoint **p = &pool->split_points; *p; p = &(*p)->next) {
+    if (*p == &sp) {
+      *p = sp.next;
+      break;
+    }
+  }
+  g_mutex_unlock(&pool->lock);
+
+  g_mutex_lock(&sp.lock);
+  while (sp.helper_count > 0) g_cond_wait(&sp.helpers_done, &sp.lock);
+  g_mutex_unlock(&sp.lock);
+
+  *best_value = sp.best_value;
+  *best_move = sp.best_move;
+
+  g_cond_clear(&sp.helpers_done);
+  g_mutex_clear(&sp.lock);
+}
+
+/*
+ * Searches the moves of the split point until none is left, or the node cuts off.
+ *
+ * Each move is searched with the window current when it is taken, values coming back
+ * narrow the window for the moves taken afterwards.
+ */
+static void
+split_point_work (PabWorker *const w,
+                  SplitPoint *const sp)
+{
+  PabPool *const pool = w->pool;
+  LockFreeHashTable *const lfht = pool->ctx->lfht;
+
+  for (;;) {
+    g_mutex_lock(&sp->lock);
+    if (sp->next_move >= sp->move_count || sp->best_value >= sp->beta || split_point_is_aborted(pool, sp)) {
+      g_mutex_unlock(&sp->lock);
+      return;
+    }
+    const Square move = sp->moves[sp->next_move++];
+    const int alpha = sp->alpha;
+    g_mutex_unlock(&sp->lock);
+
+    GamePositionX next_gpx = sp->gpx;
+    const SquareSet flips = game_position_x_do_move(&next_gpx, move);
+    const uint64_t next_hash = lfht ? game_position_x_delta_hash(sp->hash, flips, move, sp->gpx.player) : 0;
+    Square next_best_move;
+    const int value = -pab_search(w, sp, &next_gpx, next_hash, -sp->beta, -alpha, sp->ply + 1, FALSE, &next_best_move);
+    if (split_point_is_aborted(pool, sp)) return;
+
+    g_mutex_lock(&sp->lock);
+    if (value > sp->best_value) {
+      sp->best_value = value;
+      sp->best_move = move;
+      if (value > sp->alpha) sp->alpha = value;
+      if (value >= sp->beta) g_atomic_int_set(&sp->abort, 1);
+    }
+    g_mutex_unlock(&sp->lock);
+  }
+}
+
+/*
+ * Returns true when the split point, or one of its ancestors, has been aborted,
+ * or when the budget of the search is exhausted.
+ */
+static gboolean
+split_point_is_aborted (PabPool *const pool,
+                        const SplitPoint *sp)
+{
+  if (pool->ctx->budget_is_on && solver_context_budget_is_exhausted(pool->ctx)) return TRUE;
+  for (; sp; sp = sp->parent) {
+    if (g_atomic_int_get(&sp->abort)) return TRUE;
+  }
+  return FALSE;
+}
+
+/*
+ * Thread body of the pool, joins the published split point having the most empty squares,
+ * or waits for one.
+ */
+static gpointer
+pab_worker_run (gpointer data)
+{
+  PabWorker *const w = (PabWorker *) data;
+  PabPool *const pool = w->pool;
+
+  g_mutex_lock(&pool->lock);
+  while (!pool->shutdown) {
+    SplitPoint *sp = NULL;
+    for (SplitPoint *p = pool->split_points; p; p = p->next) {
+      /* The move index is read without the split point lock, it is only a hint. */
+      if (p->next_move < p->move_count && !split_point_is_aborted(pool, p) && (!sp || p->empty_count > sp->empty_count)) sp = p;
+    }
+    if (!sp) {
+      g_atomic_int_inc(&pool->idle_count);
+      g_cond_wait(&pool->work_available, &pool->lock);
+      g_atomic_int_add(&pool->idle_count, -1);
+      continue;
+    }
+    g_mutex_lock(&sp->lock);
+    sp->helper_count++;
+    g_mutex_unlock(&sp->lock);
+    g_mutex_unlock(&pool->lock);
+
+    split_point_work(w, sp);
+
+    g_mutex_lock(&sp->lock);
+    if (--sp->helper_count == 0) g_cond_signal(&sp->helpers_done);
+    g_mutex_unlock(&sp->lock);
+    g_mutex_lock(&pool->lock);
+  }
+  g_mutex_unlock(&pool->lock);
+
+  return NULL;
+}
+
+/**
+ * @endcond
+ */
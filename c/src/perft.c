@@ -0,0 +1,223 @@
+/**
+ * @file
+ *
+ * @brief Perft.
+ * @details This executable counts the nodes of the game tree from a game position
+ * down to a given depth, and measures the speed of the move generator.
+ *
+ * @par perft.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <glib.h>
+
+#include "game_position_db.h"
+#include "perft_utils.h"
+
+
+
+/**
+ * @cond
+ */
+
+/*
+ * Static constants.
+ */
+
+static const gchar *program_documentation_string =
+  "Description:\n"
+  "Perft counts the nodes of the game tree, from the given game position down to the given depth, one depth after the other.\n"
+  "For each depth it reports the count of leaves, passes, game over positions, the count of all the nodes, and the nodes per second.\n"
+  "A pass consumes one ply, positions where the game is over before reaching the depth are counted as leaves.\n"
+  "A sample call is:\n"
+  "  $ perft -f db/gpdb-sample-games.txt -q initial -d 9\n"
+  "\n"
+  "The -c flag turns on the transposition cache, the argument is the base two logarithm of its number of entries,\n"
+  "the -t flag splits the work among the given number of threads, a sample call is:\n"
+  "  $ perft -f db/gpdb-sample-games.txt -q initial -d 11 -c 22 -t 4\n"
+  "\n"
+  "Author:\n"
+  "   Written by Roberto Corradini <rob_corradini@yahoo.it>\n"
+  "\n"
+  "Copyright (c) 2014 Roberto Corradini. All rights reserved.\n"
+  "License GPLv3+: GNU GPL version 3 or later <http://gnu.org/licenses/gpl.html>.\n"
+  "This is free software: you are free to change and redistribute it. There is NO WARRANTY, to the extent permitted by law.\n"
+  ;
+
+
+
+/* Static variables. */
+
+static gchar *input_file   = NULL;
+static gchar *lookup_entry = NULL;
+static gint   depth        = 0;
+static gint   cache_size   = 0;
+static gint   threads      = 1;
+
+static const GOptionEntry entries[] =
+  {
+    { "file",         'f', 0, G_OPTION_ARG_FILENAME, &input_file,   "Input file name   - Mandatory",                                  NULL },
+    { "lookup-entry", 'q', 0, G_OPTION_ARG_STRING,   &lookup_entry, "Lookup entry      - Mandatory",                                  NULL },
+    { "depth",        'd', 0, G_OPTION_ARG_INT,      &depth,        "Depth             - Mandatory - Must be in [1..60]",              NULL },
+    { "cache",        'c', 0, G_OPTION_ARG_INT,      &cache_size,   "Cache size        - Log2 of the entry count, 0 turns it off",     NULL },
+    { "threads",      't', 0, G_OPTION_ARG_INT,      &threads,      "N. of threads     - Default is one",                              NULL },
+    { NULL }
+  };
+
+/**
+ * @endcond
+ */
+
+
+
+/**
+ * @brief Main entry to the perft utility.
+ */
+int
+main (int argc, char *argv[])
+{
+  GamePositionDb               *db;
+  GamePositionDbSyntaxErrorLog *syntax_error_log;
+  FILE                         *fp;
+  GError                       *error;
+  gchar                        *source;
+  int                           number_of_errors;
+
+  GOptionContext *context;
+  GOptionGroup   *option_group;
+
+  GamePositionDbEntry *entry;
+
+  error = NULL;
+  entry = NULL;
+
+  /* GLib command line options and argument parsing. */
+  option_group = g_option_group_new("name", "description", "help_description", NULL, NULL);
+  context = g_option_context_new("- Count the nodes of the game tree");
+  g_option_context_add_main_entries(context, entries, NULL);
+  g_option_context_add_group(context, option_group);
+  g_option_context_set_description(context, program_documentation_string);
+  if (!g_option_context_parse (context, &argc, &argv, &error)) {
+    g_print("Option parsing failed: %s\n", error->message);
+    return -1;
+  }
+
+  /* Checks command line options for consistency. */
+  if (input_file) {
+    source = g_strdup(input_file);
+  } else {
+    g_print("Option -f, --file is mandatory.\n.");
+    return -2;
+  }
+  if (depth < 1 || depth > 60) {
+    g_print("Option -d, --depth is mandatory and must be in the range [1..60].\n.");
+    return -5;
+  }
+  if (cache_size < 0 || cache_size > 32) {
+    g_print("Option -c, --cache is out of range.\n.");
+    return -8;
+  }
+  if (threads < 1) {
+    g_print("Option -t, --threads is out of range.\n.");
+    return -9;
+  }
+
+  /* Opens the source file for reading. */
+  fp = fopen(source, "r");
+  if (!fp) {
+    g_print("Unable to open database resource for reading, file \"%s\" does not exist.\n", source);
+    return -3;
+  }
+
+  /* Loads the game position database. */
+  db = gpdb_new(g_strdup(source));
+  syntax_error_log = NULL;
+  error = NULL;
+  gpdb_load(fp, source, db, &syntax_error_log, &error);
+  fclose(fp);
+
+  /* Compute the number of errors logged. */
+  number_of_errors = gpdb_syntax_error_log_length(syntax_error_log);
+  if (number_of_errors != 0) {
+    g_print("The database resource, file \"%s\" contains errors, debug it using the gpdb_verify utility.\n", source);
+    return -4;
+  }
+
+  /* Lookup for a given key. */
+  if (lookup_entry) {
+    entry = gpdb_lookup(db, lookup_entry);
+    if (entry) {
+      gchar *tmp = gpdb_entry_print(entry);
+      g_print("%s", tmp);
+      g_free(tmp);
+    } else {
+      g_print("Entry %s not found in file %s.\n", lookup_entry, source);
+      return -6;
+    }
+  } else {
+    g_print("No entry provided.\n");
+    return -7;
+  }
+
+  /* Initialize the board module. */
+  board_module_init();
+
+  /* Counts the nodes one depth after the other. */
+  GamePositionX gpx;
+  game_position_x_copy_from_gp(entry->game_position, &gpx);
+  PerftCache *cache = cache_size > 0 ? perft_cache_new(cache_size) : NULL;
+  GTimer *timer = g_timer_new();
+
+  g_print("Running perft on game position %s, from source %s, threads %d, cache %s ...\n",
+          entry->id, source, threads, cache ? "on" : "off");
+  g_print("%5s %16s %14s %14s %16s %14s %10s %12s\n",
+          "depth", "leaves", "passes", "game-over", "nodes", "cache-hits", "time [s]", "Mnodes/s");
+  for (int d = 1; d <= depth; d++) {
+    PerftResult result = { 0, 0, 0, 0, 0 };
+    g_timer_start(timer);
+    game_position_x_perft(&gpx, d, cache, threads, &result);
+    g_timer_stop(timer);
+    const double elapsed = g_timer_elapsed(timer, NULL);
+    g_print("%5d %16" PRIu64 " %14" PRIu64 " %14" PRIu64 " %16" PRIu64 " %14" PRIu64 " %10.3f %12.3f\n",
+            d, result.leaf_count, result.pass_count, result.game_over_count, result.node_count,
+            result.cache_hit_count, elapsed, elapsed > 0.0 ? result.node_count / elapsed / 1.0e6 : 0.0);
+  }
+
+  /* Frees the resources. */
+  g_timer_destroy(timer);
+  perft_cache_free(cache);
+  g_free(error);
+  gpdb_free(db, TRUE);
+  if (syntax_error_log)
+    gpdb_syntax_error_log_free(syntax_error_log);
+  g_option_context_free(context);
+  g_free(source);
+
+  return 0;
+}
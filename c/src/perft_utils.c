@@ -0,0 +1,401 @@
+/**
+ * @file
+ *
+ * @brief Perft utilities module implementation.
+ *
+ * @details Perft walks the complete game tree down to a given depth counting the nodes.
+ * The leaves are not generated, the count of legal moves of the nodes one ply above
+ * is taken instead (bulk counting), so the time is spent mostly into the legal move
+ * generator and into the make move function.
+ *
+ * The work is split among threads by expanding the tree from the root until a
+ * frontier large enough is obtained, positions of the frontier are then
+ * assigned to the threads one at a time.
+ *
+ * @par perft_utils.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <glib.h>
+
+#include "bit_works.h"
+#include "perft_utils.h"
+
+
+
+/**
+ * @cond
+ */
+
+/*
+ * The state shared by the threads of a run, plus the counters owned by each one.
+ */
+typedef struct {
+  const GamePositionX *tasks;         /* The frontier positions to be searched. */
+  int                  task_count;    /* The count of frontier positions. */
+  volatile gint       *next_task;     /* The index of the next frontier position to assign. */
+  int                  depth;         /* The depth to search below each frontier position. */
+  PerftCache          *cache;         /* The shared cache, or NULL. */
+  PerftResult          result;        /* The counters collected by the thread. */
+} PerftWorker;
+
+/*
+ * Prototypes for internal functions.
+ */
+
+static void
+perft_impl (const GamePositionX *const gpx,
+            const uint64_t hash,
+            const int depth,
+            PerftCache *const cache,
+            PerftResult *const result);
+
+static gpointer
+perft_worker_run (gpointer data);
+
+static void
+perft_result_add (PerftResult *const sum,
+                  const PerftResult *const addend);
+
+
+
+/*
+ * Internal variables and constants.
+ */
+
+/* The frontier is expanded until it has at least this number of positions per thread. */
+static const int perft_tasks_per_thread = 16;
+
+/* Subtrees shallower than this depth are too cheap to be worth a cache probe. */
+static const int perft_cache_min_depth = 3;
+
+/* The count of mutexes guarding the cache entries is not larger than this value. */
+static const size_t perft_cache_max_lock_count = 1024;
+
+/**
+ * @endcond
+ */
+
+
+
+/*******************************************************/
+/* Function implementations for the PerftCache entity. */
+/*******************************************************/
+
+/**
+ * @brief Perft cache structure constructor.
+ *
+ * @invariant Parameter `size_log2` must be in the range [0..32].
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] size_log2 the base two logarithm of the number of entries
+ * @return               a pointer to a new perft cache structure
+ */
+PerftCache *
+perft_cache_new (const int size_log2)
+{
+  g_assert(size_log2 >= 0 && size_log2 <= 32);
+
+  PerftCache *cache = (PerftCache *) malloc(sizeof(PerftCache));
+  g_assert(cache);
+
+  cache->size = (size_t) 1 << size_log2;
+  cache->mask = cache->size - 1;
+  cache->entries = (PerftCacheEntry *) calloc(cache->size, sizeof(PerftCacheEntry));
+  g_assert(cache->entries);
+
+  cache->lock_count = cache->size < perft_cache_max_lock_count ? cache->size : perft_cache_max_lock_count;
+  cache->locks = (GMutex *) malloc(cache->lock_count * sizeof(GMutex));
+  g_assert(cache->locks);
+  for (size_t i = 0; i < cache->lock_count; i++) g_mutex_init(&cache->locks[i]);
+
+  return cache;
+}
+
+/**
+ * @brief Deallocates the memory previously allocated by a call to #perft_cache_new.
+ *
+ * @details If a null pointer is passed as argument, no action occurs.
+ *
+ * @param [in,out] cache the pointer to be deallocated
+ */
+void
+perft_cache_free (PerftCache *cache)
+{
+  if (cache) {
+    for (size_t i = 0; i < cache->lock_count; i++) g_mutex_clear(&cache->locks[i]);
+    free(cache->locks);
+    free(cache->entries);
+    free(cache);
+  }
+}
+
+
+
+/**********************************************************/
+/* Function implementations for the GamePositionX entity. */
+/**********************************************************/
+
+/**
+ * @brief Counts the nodes of the game tree rooted at `gpx` down to `depth` plies.
+ *
+ * @details The counting rules are documented by the #PerftResult structure.
+ * Counters collected by the run are added to the ones found into `result`,
+ * so the caller has to clear it first.
+ *
+ * When `cache` is not `NULL` the counters of every subtree three plies deep or more
+ * are stored and reused for the transpositions, the cache can be reused by a following run.
+ * Subtrees taken from the cache contribute to the node count with all their nodes,
+ * so the counters do not depend on the cache, and the node rate measures the effective speed.
+ *
+ * When `thread_count` is greater than one, the tree is expanded from the root until
+ * each thread has a few positions to search, then the positions are assigned to the threads
+ * as soon as they become idle.
+ *
+ * @invariant Parameters `gpx` and `result` must be not `NULL`.
+ * Parameter `depth` must be not negative, and `thread_count` must be positive.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in]     gpx          the root of the game tree
+ * @param [in]     depth        the number of plies to search
+ * @param [in,out] cache        the transposition cache, or `NULL`
+ * @param [in]     thread_count the number of threads
+ * @param [in,out] result       the counters
+ */
+void
+game_position_x_perft (const GamePositionX *const gpx,
+                       const int depth,
+                       PerftCache *const cache,
+                       const int thread_count,
+                       PerftResult *const result)
+{
+  g_assert(gpx);
+  g_assert(result);
+  g_assert(depth >= 0);
+  g_assert(thread_count > 0);
+
+  if (thread_count == 1 || depth < 3) {
+    perft_impl(gpx, game_position_x_hash(gpx), depth, cache, result);
+    return;
+  }
+
+  /* Expands the frontier, nodes above it are counted here. */
+  GamePositionX *frontier = (GamePositionX *) malloc(sizeof(GamePositionX));
+  g_assert(frontier);
+  frontier[0] = *gpx;
+  int frontier_count = 1;
+  int frontier_depth = depth;
+  while (frontier_count < thread_count * perft_tasks_per_thread && frontier_depth > 2) {
+    int next_count = 0;
+    for (int i = 0; i < frontier_count; i++) {
+      const int move_count = bit_works_popcount(game_position_x_legal_moves(&frontier[i]));
+      next_count += move_count ? move_count : 1;
+    }
+    GamePositionX *next = (GamePositionX *) malloc(next_count * sizeof(GamePositionX));
+    g_assert(next);
+    next_count = 0;
+    for (int i = 0; i < frontier_count; i++) {
+      const GamePositionX *const current = &frontier[i];
+      SquareSet moves = game_position_x_legal_moves(current);
+      result->node_count++;
+      if (moves) {
+        while (moves) {
+          const Square move = bit_works_bitscanLS1B_64(moves);
+          moves &= moves - 1;
+          game_position_x_make_move(current, move, &next[next_count++]);
+        }
+      } else {
+        game_position_x_pass(current, &next[next_count]);
+        if (game_position_x_legal_moves(&next[next_count])) {
+          result->pass_count++;
+          next_count++;
+        } else {
+          result->leaf_count++;
+          result->game_over_count++;
+        }
+      }
+    }
+    free(frontier);
+    frontier = next;
+    frontier_count = next_count;
+    frontier_depth--;
+  }
+
+  /* Searches the frontier positions. */
+  volatile gint next_task = 0;
+  PerftWorker *workers = (PerftWorker *) malloc(thread_count * sizeof(PerftWorker));
+  GThread **threads = (GThread **) malloc(thread_count * sizeof(GThread *));
+  g_assert(workers && threads);
+  for (int i = 0; i < thread_count; i++) {
+    workers[i].tasks = frontier;
+    workers[i].task_count = frontier_count;
+    workers[i].next_task = &next_task;
+    workers[i].depth = frontier_depth;
+    workers[i].cache = cache;
+    memset(&workers[i].result, 0, sizeof(PerftResult));
+    threads[i] = g_thread_new("perft", perft_worker_run, &workers[i]);
+  }
+  for (int i = 0; i < thread_count; i++) {
+    g_thread_join(threads[i]);
+    perft_result_add(result, &workers[i].result);
+  }
+
+  free(threads);
+  free(workers);
+  free(frontier);
+}
+
+
+
+/**
+ * @cond
+ */
+
+/*
+ * Internal functions.
+ */
+
+/*
+ * Recursive perft, the node `gpx` is counted together with its subtree.
+ *
+ * The hash is maintained incrementally, it is used only when the cache is given.
+ */
+static void
+perft_impl (const GamePositionX *const gpx,
+            const uint64_t hash,
+            const int depth,
+            PerftCache *const cache,
+            PerftResult *const result)
+{
+  if (depth == 0) {
+    result->leaf_count++;
+    result->node_count++;
+    return;
+  }
+
+  SquareSet moves = game_position_x_legal_moves(gpx);
+
+  if (depth == 1 && moves) {
+    const int move_count = bit_works_popcount(moves);
+    result->leaf_count += move_count;
+    result->node_count += 1 + move_count;
+    return;
+  }
+
+  PerftCacheEntry *entry = NULL;
+  GMutex *lock = NULL;
+  const PerftResult before = *result;
+  const gboolean use_cache = cache && depth >= perft_cache_min_depth;
+  if (use_cache) {
+    entry = &cache->entries[hash & cache->mask];
+    lock = &cache->locks[hash & (cache->lock_count - 1)];
+    g_mutex_lock(lock);
+    const gboolean hit = entry->depth == depth && entry->blacks == gpx->blacks &&
+      entry->whites == gpx->whites && entry->player == gpx->player;
+    if (hit) {
+      result->leaf_count += entry->leaf_count;
+      result->pass_count += entry->pass_count;
+      result->game_over_count += entry->game_over_count;
+      result->node_count += entry->node_count;
+      result->cache_hit_count++;
+    }
+    g_mutex_unlock(lock);
+    if (hit) return;
+  }
+
+  result->node_count++;
+  if (moves) {
+    while (moves) {
+      const Square move = bit_works_bitscanLS1B_64(moves);
+      moves &= moves - 1;
+      GamePositionX next = *gpx;
+      const SquareSet flips = game_position_x_do_move(&next, move);
+      const uint64_t next_hash = cache ? game_position_x_delta_hash(hash, flips, move, gpx->player) : 0;
+      perft_impl(&next, next_hash, depth - 1, cache, result);
+    }
+  } else {
+    GamePositionX next;
+    game_position_x_pass(gpx, &next);
+    if (game_position_x_legal_moves(&next)) {
+      result->pass_count++;
+      perft_impl(&next, ~hash, depth - 1, cache, result);
+    } else {
+      result->leaf_count++;
+      result->game_over_count++;
+    }
+  }
+
+  if (use_cache) {
+    g_mutex_lock(lock);
+    entry->blacks = gpx->blacks;
+    entry->whites = gpx->whites;
+    entry->player = gpx->player;
+    entry->depth = depth;
+    entry->leaf_count = result->leaf_count - before.leaf_count;
+    entry->pass_count = result->pass_count - before.pass_count;
+    entry->game_over_count = result->game_over_count - before.game_over_count;
+    entry->node_count = result->node_count - before.node_count;
+    g_mutex_unlock(lock);
+  }
+}
+
+/*
+ * Thread body, searches the frontier positions until none is left.
+ */
+static gpointer
+perft_worker_run (gpointer data)
+{
+  PerftWorker *const w = (PerftWorker *) data;
+  for (;;) {
+    const int i = g_atomic_int_add(w->next_task, 1);
+    if (i >= w->task_count) break;
+    perft_impl(&w->tasks[i], game_position_x_hash(&w->tasks[i]), w->depth, w->cache, &w->result);
+  }
+  return NULL;
+}
+
+/*
+ * Adds the counters of `addend` to the ones of `sum`.
+ */
+static void
+perft_result_add (PerftResult *const sum,
+                  const PerftResult *const addend)
+{
+  sum->leaf_count += addend->leaf_count;
+  sum->pass_count += addend->pass_count;
+  sum->game_over_count += addend->game_over_count;
+  sum->node_count += addend->node_count;
+  sum->cache_hit_count += addend->cache_hit_count;
+}
+
+/**
+ * @endcond
+ */
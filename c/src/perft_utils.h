@@ -0,0 +1,121 @@
+/**
+ * @file
+ *
+ * @brief Perft utilities module definitions.
+ * @details This module defines the functions that count the nodes of the game tree
+ * down to a given depth, a benchmark for the move generator and the move execution
+ * that does not depend on any solver.
+ *
+ * @par perft_utils.h
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#ifndef PERFT_UTILS_H
+#define PERFT_UTILS_H
+
+#include <glib.h>
+
+#include "board.h"
+
+
+
+/**********************************************/
+/* Type declarations.                         */
+/**********************************************/
+
+/**
+ * @brief The counters collected by a perft run.
+ *
+ * @details A pass is a move, it consumes one ply of the depth.
+ * Game positions where the game is over before reaching the depth are counted as leaves.
+ * Under these rules the counts from the initial position are the published ones:
+ * 4, 12, 56, 244, 1396, 8200, 55092, 390216, 3005288, 24571284, ...
+ */
+typedef struct {
+  uint64_t leaf_count;                /**< @brief The count of leaves, positions at depth plus the game over ones. */
+  uint64_t pass_count;                /**< @brief The count of pass moves. */
+  uint64_t game_over_count;           /**< @brief The count of game over positions met before reaching the depth. */
+  uint64_t node_count;                /**< @brief The count of all the nodes of the tree, root included. */
+  uint64_t cache_hit_count;           /**< @brief The count of subtrees whose counters are taken from the cache. */
+} PerftResult;
+
+/**
+ * @brief An entry of the perft cache.
+ */
+typedef struct {
+  SquareSet blacks;                   /**< @brief The blacks of the cached game position. */
+  SquareSet whites;                   /**< @brief The whites of the cached game position. */
+  uint8_t   player;                   /**< @brief The player to move of the cached game position. */
+  uint8_t   depth;                    /**< @brief The depth of the subtree, zero marks an empty entry. */
+  uint64_t  leaf_count;               /**< @brief The leaf count of the subtree. */
+  uint64_t  pass_count;               /**< @brief The pass count of the subtree. */
+  uint64_t  game_over_count;          /**< @brief The game over count of the subtree. */
+  uint64_t  node_count;               /**< @brief The node count of the subtree. */
+} PerftCacheEntry;
+
+/**
+ * @brief A transposition cache holding the counters of the subtrees already visited.
+ *
+ * @details The cache is an array of entries addressed by the game position hash,
+ * colliding entries are replaced. Entries are guarded by an array of mutexes,
+ * so that the cache can be shared by the threads of a run.
+ */
+typedef struct {
+  size_t           size;              /**< @brief The count of entries, a power of two. */
+  size_t           mask;              /**< @brief The mask that maps a hash value to an entry index. */
+  PerftCacheEntry *entries;           /**< @brief The array of entries. */
+  size_t           lock_count;        /**< @brief The count of mutexes, a power of two. */
+  GMutex          *locks;             /**< @brief The mutexes guarding the entries. */
+} PerftCache;
+
+
+
+/*******************************************************/
+/* Function implementations for the PerftCache entity. */
+/*******************************************************/
+
+extern PerftCache *
+perft_cache_new (const int size_log2);
+
+extern void
+perft_cache_free (PerftCache *cache);
+
+
+
+/**********************************************************/
+/* Function implementations for the GamePositionX entity. */
+/**********************************************************/
+
+extern void
+game_position_x_perft (const GamePositionX *const gpx,
+                       const int depth,
+                       PerftCache *const cache,
+                       const int thread_count,
+                       PerftResult *const result);
+
+
+
+#endif /* PERFT_UTILS_H */
@@ -37,8 +37,10 @@
 
 #include <glib.h>
 
+#include "bit_works.h"
 #include "random.h"
 #include "game_tree_logger.h"
+#include "transposition_table.h"
 
 #include "rab_solver.h"
 
@@ -53,7 +55,8 @@
  */
 
 static void
-game_position_solve_impl (ExactSolution* const result,
+game_position_solve_impl (SolverContext *const ctx,
+                          ExactSolution* const result,
                           GameTreeStack* const stack,
                           const int sub_run_id);
 
@@ -63,8 +66,8 @@ game_position_solve_impl (ExactSolution* const result,
  * Internal variables and constants.
  */
 
-/* The logging environment structure. */
-static LogEnv *log_env = NULL;
+/* Nodes having fewer empty squares are cheaper to search than to look up. */
+static const int tt_min_depth = 4;
 
 /**
  * @endcond
@@ -79,6 +82,8 @@ static LogEnv *log_env = NULL;
 /**
  * @brief Solves the game position returning a new exact solution pointer.
  *
+ * @details It is a wrapper of #game_position_rab_solve_with_context, running on a new context.
+ *
  * @param [in] root     the starting game position to be solved
  * @param [in] log_file if not null turns logging on the given file name
  * @param [in] repeats  number of repetitions
@@ -89,47 +94,108 @@ game_position_rab_solve (const GamePosition *const root,
                          const gchar *const log_file,
                          const int repeats)
 {
+  SolverContext *ctx = solver_context_new();
+  ctx->log_file = log_file;
+  ctx->repeats = repeats;
+  ExactSolution *result = game_position_rab_solve_with_context(ctx, root);
+  solver_context_free(ctx);
+  return result;
+}
+
+/**
+ * @brief Solves the game position, as selected by the options of the solver context,
+ * returning a new exact solution pointer.
+ *
+ * @details The search is repeated as many times as the `repeats` field of the context,
+ * moves are shuffled by the random number generator of the context.
+ *
+ * @invariant Parameters `ctx` and `root` must be not `NULL`.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] ctx  the solver context
+ * @param [in]     root the starting game position to be solved
+ * @return              a pointer to a new exact solution structure
+ */
+ExactSolution*
+game_position_rab_solve_with_context (SolverContext *const ctx,
+                                      const GamePosition *const root)
+{
+  g_assert(ctx);
+  g_assert(root);
+
   ExactSolution* result = NULL;
-  int n;
+  const int n = ctx->repeats < 1 ? 1 : ctx->repeats;
 
-  if (repeats < 1) {
-    n = 1;
-  } else {
-    n = repeats;
-  }
+  solver_context_search_start(ctx);
+
+  const gboolean wld = ctx->wld;
+
+  TranspositionTable *const tt = ctx->tt;
 
-  log_env = game_tree_log_init(log_file);
+  ctx->hash_is_on = ctx->log_env->log_is_on || tt;
 
-  if (log_env->log_is_on) {
-    game_tree_log_open_h(log_env);
+  if (ctx->log_env->log_is_on) {
+    game_tree_log_open_h(ctx->log_env);
   }
 
-  random_init_seed();
+  solver_context_get_rng(ctx);
 
   int game_value = out_of_range_defeat_score;
   Square best_move = invalid_move;
+  const int root_alpha = wld ? wld_alpha : worst_score;
+  gboolean result_is_stopped = FALSE;
 
   for (int sub_run_id = 0; sub_run_id < n; sub_run_id++) {
+    /* Runs are independent samples, the table must not carry results from the previous ones. */
+    if (tt) transposition_table_clear(tt);
+
     GameTreeStack* stack = game_tree_stack_new();
 
     game_tree_stack_init(root, stack);
     NodeInfo* first_node_info = &stack->nodes[1];
+    if (wld) {
+      first_node_info->alpha = wld_alpha;
+      first_node_info->beta = wld_beta;
+    }
 
-    result = exact_solution_new();
-    result->solved_game_position = game_position_clone(root);
+    ExactSolution *run_result = exact_solution_new();
+    run_result->solved_game_position = game_position_clone(root);
 
-    game_position_solve_impl(result, stack, sub_run_id);
+    game_position_solve_impl(ctx, run_result, stack, sub_run_id);
 
+    /* A run stopped by the budget is discarded when a previous one is complete. */
+    const gboolean run_is_stopped = ctx->budget_is_on && solver_context_budget_is_exhausted(ctx);
+    if (run_is_stopped && result) {
+      exact_solution_free(run_result);
+      game_tree_stack_free(stack);
+      break;
+    }
+
+    if (result) exact_solution_free(result);
+    result = run_result;
+    result_is_stopped = run_is_stopped;
     best_move = first_node_info->best_move;
     game_value = first_node_info->alpha;
 
     game_tree_stack_free(stack);
+
+    if (run_is_stopped) break;
   }
 
-  game_tree_log_close(log_env);
+  solver_context_search_end(ctx);
 
   result->pv[0] = best_move;
   result->outcome = game_value;
+  if (result_is_stopped) {
+    /* The root value is the best one among the moves searched to the end, if any. */
+    const gboolean has_lower_bound = game_value > root_alpha;
+    exact_solution_set_incomplete(result,
+                                  has_lower_bound ? game_value : worst_score,
+                                  best_score,
+                                  has_lower_bound ? best_move : invalid_move);
+  } else if (wld) {
+    exact_solution_set_wld_outcome(result);
+  }
   return result;
 }
 
@@ -146,15 +212,19 @@ game_position_rab_solve (const GamePosition *const root,
 /**
  * @brief Recursive function used to traverse the game tree.
  *
+ * @param [in,out] ctx        the solver context
  * @param [in,out] result     a reference to the exact solution data structure
  * @param [in,out] stack      it holds mostly of the status of the iterative search
  * @param [in]     sub_run_id used to tag the log file with the run counter
  */
 static void
-game_position_solve_impl (ExactSolution* const result,
+game_position_solve_impl (SolverContext *const ctx,
+                          ExactSolution* const result,
                           GameTreeStack* const stack,
                           const int sub_run_id)
 {
+  TranspositionTable *const tt = ctx->tt;
+
   result->node_count++;
 
   const int current_fill_index = stack->fill_index;
@@ -168,12 +238,19 @@ game_position_solve_impl (ExactSolution* const result,
   NodeInfo* const previous_node_info = &stack->nodes[previous_fill_index];
   const GamePositionX* const current_gpx = &current_node_info->gpx;
   GamePositionX* const next_gpx = &next_node_info->gpx;
-  current_node_info->hash = game_position_x_hash(current_gpx);
+
+  if (ctx->budget_is_on && solver_context_budget_check(ctx, result->node_count)) goto out;
+
   const SquareSet move_set = game_position_x_legal_moves(current_gpx);
   legal_move_list_from_set(move_set, current_node_info, next_node_info);
-  random_shuffle_array_uint8(current_node_info->head_of_legal_move_list, current_node_info->move_count);
+  rng_shuffle_array_uint8(ctx->rng, current_node_info->head_of_legal_move_list, current_node_info->move_count);
+  const int alpha = current_node_info->alpha;
 
-  if (log_env->log_is_on) {
+#ifdef REVERSI_DEBUG
+  if (ctx->hash_is_on) g_assert(current_node_info->hash == game_position_x_hash(current_gpx));
+#endif
+
+  if (ctx->log_env->log_is_on) {
     LogDataH log_data;
     log_data.sub_run_id = sub_run_id;
     log_data.call_id = result->node_count;
@@ -183,41 +260,66 @@ game_position_solve_impl (ExactSolution* const result,
     log_data.whites = current_gpx->whites;
     log_data.player = current_gpx->player;
     log_data.json_doc = "\"{}\"";
-    game_tree_log_write_h(log_env, &log_data);
+    game_tree_log_write_h(ctx->log_env, &log_data);
+  }
+
+  const int depth = tt ? bit_works_popcount(game_position_x_empties(current_gpx)) : 0;
+  const gboolean use_tt = tt && depth >= tt_min_depth;
+  if (use_tt && current_fill_index > 1) {
+    TranspositionTableEntry entry;
+    int value;
+    if (transposition_table_probe(tt, current_node_info->hash, depth, &entry) &&
+        transposition_table_cutoff(tt, &entry, alpha, current_node_info->beta, &value)) {
+      current_node_info->alpha = value;
+      current_node_info->best_move = entry.best_move;
+      goto out;
+    }
   }
 
+  if (ctx->stability_cutoff && current_fill_index > 1 && node_info_stability_cutoff(current_node_info)) goto out;
+
   if (move_set == empty_square_set) {
     const int previous_move_count = previous_node_info->move_count;
     const SquareSet empties = game_position_x_empties(current_gpx);
     if (empties != empty_square_set && previous_move_count != 0) {
       game_position_x_pass(current_gpx, next_gpx);
+      if (ctx->hash_is_on) next_node_info->hash = ~current_node_info->hash;
       next_node_info->alpha = -current_node_info->beta;
       next_node_info->beta = -current_node_info->alpha;
-      game_position_solve_impl(result, stack, sub_run_id);
+      game_position_solve_impl(ctx, result, stack, sub_run_id);
+      if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) goto out;
       current_node_info->alpha = -next_node_info->alpha;
       current_node_info->best_move = next_node_info->best_move;
     } else {
       result->leaf_count++;
       current_node_info->alpha = game_position_x_final_value(current_gpx);
       current_node_info->best_move = invalid_move;
+      goto out;
     }
   } else {
     current_node_info->alpha = out_of_range_defeat_score;
     for (int i = 0; i < current_node_info->move_count; i++) {
       const Square move = * (current_node_info->head_of_legal_move_list + i);
-      game_position_x_make_move(current_gpx, move, next_gpx);
+      *next_gpx = *current_gpx;
+      const SquareSet flips = game_position_x_do_move(next_gpx, move);
+      if (ctx->hash_is_on) {
+        next_node_info->hash = game_position_x_delta_hash(current_node_info->hash, flips, move, current_gpx->player);
+      }
       next_node_info->alpha = -current_node_info->beta;
-      next_node_info->beta = -current_node_info->alpha;
-      game_position_solve_impl(result, stack, sub_run_id);
+      next_node_info->beta = -MAX(alpha, current_node_info->alpha);
+      game_position_solve_impl(ctx, result, stack, sub_run_id);
+      if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) goto out;
       if (-next_node_info->alpha > current_node_info->alpha) {
         current_node_info->alpha = -next_node_info->alpha;
         current_node_info->best_move = move;
-        if (current_node_info->alpha >= current_node_info->beta) {
-          goto out;
-        }
+        if (current_node_info->alpha >= current_node_info->beta) break;
       }
     }
   }
+  if (use_tt) {
+    transposition_table_store(tt, current_node_info->hash, depth, alpha, current_node_info->beta,
+                              current_node_info->alpha, current_node_info->best_move);
+  }
 out:
   stack->fill_index--;
   return;
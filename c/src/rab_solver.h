@@ -48,4 +48,8 @@ game_position_rab_solve (const GamePosition *const root,
                          const gchar *const log_file,
                          const int repeats);
 
+extern ExactSolution *
+game_position_rab_solve_with_context (SolverContext *const ctx,
+                                      const GamePosition *const root);
+
 #endif /* RAB_SOLVER_H */
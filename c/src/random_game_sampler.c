@@ -33,6 +33,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <inttypes.h>
+#include <math.h>
 
 #include <glib.h>
 
@@ -49,34 +51,66 @@
  */
 
 /*
- * Prototypes for internal functions.
+ * Internal types.
  */
 
-static SearchNode *
-game_position_random_sampler_impl (ExactSolution *const result,
-                                   const GamePosition  *const gp,
-                                   RandomNumberGenerator *const rng);
+/*
+ * The data owned by each thread playing rollouts.
+ */
+typedef struct {
+  const GamePositionX   *root;           /* The root game position. */
+  const Square          *moves;          /* The root moves. */
+  int                    move_count;     /* The count of root moves. */
+  uint64_t               game_count;     /* The count of games to be played by the thread. */
+  RandomNumberGenerator *rng;            /* The random number generator, one stream for each thread. */
+  RolloutStats           root_stats;     /* The statistics of the games played by the thread. */
+  RolloutStats           move_stats[64]; /* The statistics for each root move. */
+} RolloutWorker;
+
+/*
+ * The node types of the minimal alpha-beta tree, as classified by Knuth and Moore.
+ */
+typedef enum {
+  TREE_SIZE_NODE_PV,    /* All the children are searched, the first one is a PV node, the others are CUT nodes. */
+  TREE_SIZE_NODE_CUT,   /* Only the best child is searched, it is an ALL node. */
+  TREE_SIZE_NODE_ALL    /* All the children are searched, they are CUT nodes. */
+} TreeSizeNodeType;
 
 
 
 /*
- * Internal variables and constants.
+ * Prototypes for internal functions.
  */
 
-/* The logging environment structure. */
-static LogEnv *log_env = NULL;
+static SearchNode *
+game_position_random_sampler_impl (SolverContext *const ctx,
+                                   ExactSolution *const result,
+                                   GamePositionX *const gpx);
+
+static int
+rollout_play (RandomNumberGenerator *const rng,
+              const GamePositionX *const root,
+              const Square first_move);
+
+static void
+rollout_stats_add (RolloutStats *const stats,
+                   const int value);
 
-/* The total number of call to the recursive function that traverse the game DAG. */
-static uint64_t call_count = 0;
+static void
+rollout_stats_merge (RolloutStats *const stats,
+                     const RolloutStats *const other);
 
-/* The predecessor-successor array of game position hash values. */
-static uint64_t gp_hash_stack[128];
+static gpointer
+rollout_worker_run (gpointer data);
 
-/* The index of the last entry into gp_hash_stack. */
-static int gp_hash_stack_fill_point = 0;
+static void
+tree_size_probe (RandomNumberGenerator *const rng,
+                 const GamePositionX *const root,
+                 TreeSizeReport *const report);
 
-/* The sub_run_id used for logging. */
-static int sub_run_id = 0;
+static void
+tree_size_stats_add (TreeSizeStats *const stats,
+                     const double estimate);
 
 /**
  * @endcond
@@ -92,6 +126,8 @@ static int sub_run_id = 0;
  * @brief Runs a sequence of random games for number of times equal
  * to the `repeats` parameter, starting from the `root` game position.
  *
+ * @details It is a wrapper of #game_position_random_sampler_with_context, running on a new context.
+ *
  * @param [in] root     the starting game position to be solved
  * @param [in] log_file if not null turns logging on the given file name
  * @param [in] repeats  number of random game to play
@@ -102,38 +138,76 @@ game_position_random_sampler (const GamePosition *const root,
                               const gchar *const log_file,
                               const int repeats)
 {
+  SolverContext *ctx = solver_context_new();
+  ctx->log_file = log_file;
+  ctx->repeats = repeats;
+  ExactSolution *result = game_position_random_sampler_with_context(ctx, root);
+  solver_context_free(ctx);
+  return result;
+}
+
+/**
+ * @brief Runs a sequence of random games for number of times equal
+ * to the `repeats` field of the context, starting from the `root` game position.
+ *
+ * @details The games are drawn from the random number generator of the context.
+ * When the budget is exhausted the sampling stops after the running game,
+ * and the solution is marked as incomplete, without bounds on the game value.
+ *
+ * @invariant Parameters `ctx` and `root` must be not `NULL`.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] ctx  the solver context
+ * @param [in]     root the starting game position to be solved
+ * @return              a pointer to a new exact solution structure
+ */
+ExactSolution *
+game_position_random_sampler_with_context (SolverContext *const ctx,
+                                           const GamePosition *const root)
+{
+  g_assert(ctx);
+  g_assert(root);
+
   ExactSolution *result;
   SearchNode    *sn;
   int            n;
 
-  if (repeats < 1) {
+  if (ctx->repeats < 1) {
     n = 1;
   } else {
-    n = repeats;
+    n = ctx->repeats;
   }
 
-  log_env = game_tree_log_init(log_file);
+  solver_context_search_start(ctx);
 
-  if (log_env->log_is_on) {
+  if (ctx->log_env->log_is_on) {
     GamePosition *ground = game_position_new(board_new(root->board->blacks,
                                                        root->board->whites),
                                              player_opponent(root->player));
-    gp_hash_stack[0] = game_position_hash(ground);
+    ctx->gp_hash_stack[0] = game_position_hash(ground);
     game_position_free(ground);
-    game_tree_log_open_h(log_env);
+    game_tree_log_open_h(ctx->log_env);
   }
 
-  RandomNumberGenerator *rng = rng_new(rng_random_seed());
+  /* The generator is created here, the games read it from the context. */
+  solver_context_get_rng(ctx);
 
   result = exact_solution_new();
   result->solved_game_position = game_position_clone(root);
 
+  GamePositionX gpx;
+  game_position_x_copy_from_gp(root, &gpx);
+
   for (int repetition = 0; repetition < n; repetition++) {
-    if (log_env->log_is_on) {
-      sub_run_id = repetition;
-      call_count = 0;
+    if (ctx->budget_is_on && solver_context_budget_is_exhausted(ctx)) {
+      exact_solution_set_incomplete(result, worst_score, best_score, result->pv[0]);
+      break;
+    }
+    if (ctx->log_env->log_is_on) {
+      ctx->sub_run_id = repetition;
+      ctx->call_count = 0;
     }
-    sn = game_position_random_sampler_impl(result, result->solved_game_position, rng);
+    sn = game_position_random_sampler_impl(ctx, result, &gpx);
     if (sn) {
       result->pv[0] = sn->move;
       result->outcome = sn->value;
@@ -141,14 +215,370 @@ game_position_random_sampler (const GamePosition *const root,
     search_node_free(sn);
   }
 
-  game_tree_log_close(log_env);
-  rng_free(rng);
+  solver_context_search_end(ctx);
 
   return result;
 }
 
 
 
+/**************************************************/
+/* Function implementations for the rollouts.     */
+/**************************************************/
+
+/**
+ * @brief Plays `game_count` random games from the `root` game position, collecting
+ * the distribution of the outcomes, for all the games and for each root move.
+ *
+ * @details Games are played by a loop that moves a game position forward in place,
+ * no memory is allocated while playing. The games are split evenly among the threads,
+ * each one having its own random number generator, seeded by the generator of the context.
+ * The report is then repeatable, for a given seed of the context and count of threads.
+ * Logging and the budget of the context are not used.
+ *
+ * @invariant Parameters `ctx` and `root` must be not `NULL`, `thread_count` must be not negative.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] ctx          the solver context
+ * @param [in]     root         the game position the games are played from
+ * @param [in]     game_count   the count of games
+ * @param [in]     thread_count the count of threads, zero means one for each processor
+ * @return                      a pointer to a new rollout report structure
+ */
+RolloutReport *
+game_position_rollout (SolverContext *const ctx,
+                       const GamePosition *const root,
+                       const uint64_t game_count,
+                       const int thread_count)
+{
+  g_assert(ctx);
+  g_assert(root);
+  g_assert(thread_count >= 0);
+
+  const int tc = thread_count ? thread_count : (int) g_get_num_processors();
+
+  RolloutReport *report = (RolloutReport *) malloc(sizeof(RolloutReport));
+  g_assert(report);
+  *report = (RolloutReport) { 0 };
+  report->root = game_position_clone(root);
+  report->thread_count = tc;
+
+  GamePositionX gpx;
+  game_position_x_copy_from_gp(root, &gpx);
+  const SquareSet move_set = game_position_x_legal_moves(&gpx);
+  if (move_set) {
+    for (SquareSet s = move_set; s; s &= s - 1) report->moves[report->move_count++] = bit_works_bitscanLS1B_64(s);
+  } else {
+    report->moves[report->move_count++] = pass_move;
+  }
+
+  RandomNumberGenerator *const seed_rng = solver_context_get_rng(ctx);
+  RolloutWorker *workers = (RolloutWorker *) malloc(tc * sizeof(RolloutWorker));
+  GThread **threads = (GThread **) malloc(tc * sizeof(GThread *));
+  g_assert(workers && threads);
+  for (int i = 0; i < tc; i++) {
+    workers[i] = (RolloutWorker) { 0 };
+    workers[i].root = &gpx;
+    workers[i].moves = report->moves;
+    workers[i].move_count = report->move_count;
+    workers[i].game_count = game_count / tc + ((uint64_t) i < game_count % tc ? 1 : 0);
+    workers[i].rng = rng_new(rng_random_choice_from_finite_set(seed_rng, 0xFFFFFFFF));
+  }
+
+  const gint64 start = g_get_monotonic_time();
+  for (int i = 1; i < tc; i++) threads[i] = g_thread_new("rollout", rollout_worker_run, &workers[i]);
+  rollout_worker_run(&workers[0]);
+  for (int i = 1; i < tc; i++) g_thread_join(threads[i]);
+  report->elapsed = (g_get_monotonic_time() - start) / 1.0e6;
+
+  for (int i = 0; i < tc; i++) {
+    rollout_stats_merge(&report->root_stats, &workers[i].root_stats);
+    for (int j = 0; j < report->move_count; j++) rollout_stats_merge(&report->move_stats[j], &workers[i].move_stats[j]);
+    rng_free(workers[i].rng);
+  }
+  free(threads);
+  free(workers);
+
+  return report;
+}
+
+/**
+ * @brief Plays a random game from the given game position, and returns its final value
+ * from the point of view of the player to move.
+ *
+ * @details The game is played by a loop moving a copy of the game position forward in place,
+ * no memory is allocated. Moves are drawn uniformly among the legal ones.
+ *
+ * @invariant Parameters `rng` and `gpx` must be not `NULL`.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] rng the random number generator
+ * @param [in]     gpx the game position the game starts from
+ * @return             the final value of the game
+ */
+int
+game_position_x_random_game (RandomNumberGenerator *const rng,
+                             const GamePositionX *const gpx)
+{
+  g_assert(rng);
+  g_assert(gpx);
+
+  GamePositionX current = *gpx;
+  gboolean passed = FALSE;
+  for (;;) {
+    const SquareSet moves = game_position_x_legal_moves(&current);
+    if (moves) {
+      game_position_x_do_move(&current, square_set_random_selection(rng, moves));
+      passed = FALSE;
+    } else if (passed) {
+      break;
+    } else {
+      game_position_x_do_pass(&current);
+      passed = TRUE;
+    }
+  }
+  const int value = game_position_x_final_value(&current);
+  return current.player == gpx->player ? value : -value;
+}
+
+/**
+ * @brief Deallocates the memory previously allocated by a call to #game_position_rollout.
+ *
+ * @details If a null pointer is passed as argument, no action occurs.
+ *
+ * @param [in,out] report the pointer to be deallocated
+ */
+void
+rollout_report_free (RolloutReport *report)
+{
+  if (report) {
+    game_position_free(report->root);
+    free(report);
+  }
+}
+
+/**
+ * @brief Returns a formatted string describing the rollout report.
+ *
+ * @details The games per second are followed by the distribution of the outcomes of all the games,
+ * and by the one of each root move, sorted by their mean value.
+ * The returned string has to be freed by the caller by means of g_free.
+ *
+ * @invariant Parameter `report` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] report the given rollout report
+ * @return            a string being a representation of the report
+ */
+gchar *
+rollout_report_to_string (const RolloutReport *const report)
+{
+  g_assert(report);
+
+  const RolloutStats *const rs = &report->root_stats;
+  GString *str = g_string_new(NULL);
+  g_string_append_printf(str, "Rollouts: %" PRIu64 " games, %d threads, %.3f seconds, %.0f games per second\n",
+                         rs->game_count, report->thread_count, report->elapsed,
+                         report->elapsed > 0.0 ? rs->game_count / report->elapsed : 0.0);
+
+  int order[64];
+  for (int i = 0; i < report->move_count; i++) order[i] = i;
+  for (int i = 1; i < report->move_count; i++) {
+    for (int j = i; j > 0 && rollout_stats_mean(&report->move_stats[order[j]]) > rollout_stats_mean(&report->move_stats[order[j - 1]]); j--) {
+      const int tmp = order[j];
+      order[j] = order[j - 1];
+      order[j - 1] = tmp;
+    }
+  }
+
+  g_string_append_printf(str, "%-5s %12s %8s %9s %12s %12s %12s\n", "move", "games", "mean", "variance", "wins", "draws", "losses");
+  for (int k = -1; k < report->move_count; k++) {
+    const RolloutStats *const st = k < 0 ? rs : &report->move_stats[order[k]];
+    const gchar *const label = k < 0 ? "root" : square_as_move_to_string(report->moves[order[k]]);
+    g_string_append_printf(str, "%-5s %12" PRIu64 " %+8.3f %9.3f %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n",
+                           label, st->game_count, rollout_stats_mean(st), rollout_stats_variance(st),
+                           st->win_count, st->draw_count, st->loss_count);
+  }
+
+  return g_string_free(str, FALSE);
+}
+
+/**
+ * @brief Returns the mean of the game values, zero when no game has been played.
+ *
+ * @param [in] stats the rollout statistics
+ * @return           the mean value
+ */
+double
+rollout_stats_mean (const RolloutStats *const stats)
+{
+  g_assert(stats);
+  return stats->game_count ? (double) stats->value_sum / stats->game_count : 0.0;
+}
+
+/**
+ * @brief Returns the variance of the game values, zero when no game has been played.
+ *
+ * @param [in] stats the rollout statistics
+ * @return           the population variance
+ */
+double
+rollout_stats_variance (const RolloutStats *const stats)
+{
+  g_assert(stats);
+  if (!stats->game_count) return 0.0;
+  const double mean = rollout_stats_mean(stats);
+  return (double) stats->value_square_sum / stats->game_count - mean * mean;
+}
+
+
+
+/***********************************************************/
+/* Function implementations for the tree size estimator.   */
+/***********************************************************/
+
+/**
+ * @brief Estimates the size of the game tree rooted at `root`, by the random probes of Knuth.
+ *
+ * @details Each probe walks a random path from the root down to the end of the game,
+ * drawing each move uniformly among the legal ones, a pass being the only child of a node without moves.
+ * Being `b(0), b(1), ...` the count of children of the nodes along the path, the sum of the products
+ * `1 + b(0) + b(0) * b(1) + ...` is an unbiased estimate of the node count, the last product of the leaf count.
+ * The node count is the one of the minimax solver, passes included.
+ *
+ * The same path gives the estimate for the alpha-beta tree, by classifying its nodes by type: the root
+ * is a PV node, and the count of children of a CUT node is one, its best move being the one drawn by the probe.
+ * It is the minimal tree, searched by alpha-beta under a perfect move ordering, and a lower bound for the
+ * tree searched by any ordering. The minimax tree being the upper bound.
+ *
+ * The estimates have a heavy tailed distribution, the confidence interval is reliable
+ * only for large counts of probes. Probes are drawn from the random number generator of the context,
+ * logging and the budget are not used.
+ *
+ * @invariant Parameters `ctx` and `root` must be not `NULL`.
+ * The invariants are guarded by assertions.
+ *
+ * @param [in,out] ctx         the solver context
+ * @param [in]     root        the game position the probes start from
+ * @param [in]     probe_count the count of probes
+ * @return                     a pointer to a new tree size report structure
+ */
+TreeSizeReport *
+game_position_tree_size_estimate (SolverContext *const ctx,
+                                  const GamePosition *const root,
+                                  const uint64_t probe_count)
+{
+  g_assert(ctx);
+  g_assert(root);
+
+  TreeSizeReport *report = (TreeSizeReport *) malloc(sizeof(TreeSizeReport));
+  g_assert(report);
+  *report = (TreeSizeReport) { 0 };
+  report->root = game_position_clone(root);
+
+  GamePositionX gpx;
+  game_position_x_copy_from_gp(root, &gpx);
+  RandomNumberGenerator *const rng = solver_context_get_rng(ctx);
+
+  const gint64 start = g_get_monotonic_time();
+  for (uint64_t i = 0; i < probe_count; i++) tree_size_probe(rng, &gpx, report);
+  report->elapsed = (g_get_monotonic_time() - start) / 1.0e6;
+
+  return report;
+}
+
+/**
+ * @brief Deallocates the memory previously allocated by a call to #game_position_tree_size_estimate.
+ *
+ * @details If a null pointer is passed as argument, no action occurs.
+ *
+ * @param [in,out] report the pointer to be deallocated
+ */
+void
+tree_size_report_free (TreeSizeReport *report)
+{
+  if (report) {
+    game_position_free(report->root);
+    free(report);
+  }
+}
+
+/**
+ * @brief Returns a formatted string describing the tree size report.
+ *
+ * @details For the node and leaf counts of the two trees, the estimate is given
+ * with its 95% confidence interval.
+ *
+ * The returned string has a dynamic extent set by a call to malloc. It must then properly
+ * garbage collected by a call to free when no more referenced.
+ *
+ * @invariant Parameter `report` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] report the tree size report
+ * @return            a string being a representation of the report
+ */
+gchar *
+tree_size_report_to_string (const TreeSizeReport *const report)
+{
+  g_assert(report);
+
+  const uint64_t probe_count = report->minimax_nodes.probe_count;
+  GString *str = g_string_new(NULL);
+  g_string_append_printf(str, "Tree size: %" PRIu64 " probes, %.3f seconds, %.0f probes per second\n",
+                         probe_count, report->elapsed, report->elapsed > 0.0 ? probe_count / report->elapsed : 0.0);
+
+  const struct { const gchar *label; const TreeSizeStats *stats; } rows[] =
+    { { "minimax nodes",     &report->minimax_nodes },
+      { "minimax leaves",    &report->minimax_leaves },
+      { "alpha-beta nodes",  &report->ab_nodes },
+      { "alpha-beta leaves", &report->ab_leaves } };
+
+  g_string_append_printf(str, "%-17s %12s %12s %12s\n", "tree", "estimate", "ci low", "ci high");
+  for (int i = 0; i < 4; i++) {
+    const double mean = tree_size_stats_mean(rows[i].stats);
+    const double confidence = tree_size_stats_confidence(rows[i].stats);
+    g_string_append_printf(str, "%-17s %12.4e %12.4e %12.4e\n", rows[i].label, mean, mean - confidence, mean + confidence);
+  }
+
+  return g_string_free(str, FALSE);
+}
+
+/**
+ * @brief Returns the mean of the estimates, zero when no probe has been run.
+ *
+ * @param [in] stats the tree size statistics
+ * @return           the estimate of the tree size
+ */
+double
+tree_size_stats_mean (const TreeSizeStats *const stats)
+{
+  g_assert(stats);
+  return stats->probe_count ? stats->sum / stats->probe_count : 0.0;
+}
+
+/**
+ * @brief Returns the half width of the 95% confidence interval of the mean of the estimates.
+ *
+ * @details The interval is given by the normal approximation, as 1.96 standard errors of the mean.
+ * It is zero when fewer than two probes have been run.
+ *
+ * @param [in] stats the tree size statistics
+ * @return           the half width of the confidence interval
+ */
+double
+tree_size_stats_confidence (const TreeSizeStats *const stats)
+{
+  g_assert(stats);
+  if (stats->probe_count < 2) return 0.0;
+  const double n = stats->probe_count;
+  const double mean = stats->sum / n;
+  const double variance = (stats->square_sum - n * mean * mean) / (n - 1.0);
+  return variance > 0.0 ? 1.96 * sqrt(variance / n) : 0.0;
+}
+
+
+
 /**
  * @cond
  */
@@ -157,57 +587,183 @@ game_position_random_sampler (const GamePosition *const root,
  * Internal functions.
  */
 
+/*
+ * Runs one probe of the tree size estimator, adding its estimates to the report.
+ */
+static void
+tree_size_probe (RandomNumberGenerator *const rng,
+                 const GamePositionX *const root,
+                 TreeSizeReport *const report)
+{
+  GamePositionX gpx = *root;
+  TreeSizeNodeType type = TREE_SIZE_NODE_PV;
+  double minimax_width = 1.0;
+  double minimax_nodes = 1.0;
+  double ab_width = 1.0;
+  double ab_nodes = 1.0;
+  for (;;) {
+    const SquareSet moves = game_position_x_legal_moves(&gpx);
+    int child_count = 1;
+    if (moves) {
+      child_count = bit_works_popcount(moves);
+      game_position_x_do_move(&gpx, square_set_random_selection(rng, moves));
+    } else if (game_position_x_has_any_player_any_legal_move(&gpx)) {
+      game_position_x_do_pass(&gpx);
+    } else {
+      break;
+    }
+    minimax_width *= child_count;
+    minimax_nodes += minimax_width;
+    if (type != TREE_SIZE_NODE_CUT) ab_width *= child_count;
+    ab_nodes += ab_width;
+    switch (type) {
+    case TREE_SIZE_NODE_PV:
+      type = rng_random_choice_from_finite_set(rng, child_count) == 0 ? TREE_SIZE_NODE_PV : TREE_SIZE_NODE_CUT;
+      break;
+    case TREE_SIZE_NODE_CUT:
+      type = TREE_SIZE_NODE_ALL;
+      break;
+    case TREE_SIZE_NODE_ALL:
+      type = TREE_SIZE_NODE_CUT;
+      break;
+    }
+  }
+  tree_size_stats_add(&report->minimax_nodes, minimax_nodes);
+  tree_size_stats_add(&report->minimax_leaves, minimax_width);
+  tree_size_stats_add(&report->ab_nodes, ab_nodes);
+  tree_size_stats_add(&report->ab_leaves, ab_width);
+}
+
+/*
+ * Adds the estimate of a probe to the statistics.
+ */
+static void
+tree_size_stats_add (TreeSizeStats *const stats,
+                     const double estimate)
+{
+  stats->probe_count++;
+  stats->sum += estimate;
+  stats->square_sum += estimate * estimate;
+}
+
+/*
+ * Plays a random game from the given position, that is updated in place by
+ * moving forward and back, and restored to the original value when the function returns.
+ */
 static SearchNode *
-game_position_random_sampler_impl (ExactSolution *const result,
-                                   const GamePosition  *const gp,
-                                   RandomNumberGenerator *const rng)
+game_position_random_sampler_impl (SolverContext *const ctx,
+                                   ExactSolution *const result,
+                                   GamePositionX *const gpx)
 {
   result->node_count++;
   SearchNode *node = NULL;
 
-  if (log_env->log_is_on) {
-    call_count++;
-    gp_hash_stack_fill_point++;
+  if (ctx->budget_is_on) solver_context_budget_check(ctx, result->node_count);
+
+  if (ctx->log_env->log_is_on) {
+    ctx->call_count++;
+    ctx->gp_hash_stack_fill_point++;
     LogDataH log_data;
-    log_data.sub_run_id = sub_run_id;
-    log_data.call_id = call_count;
-    log_data.hash = game_position_hash(gp);
-    gp_hash_stack[gp_hash_stack_fill_point] = log_data.hash;
-    log_data.parent_hash = gp_hash_stack[gp_hash_stack_fill_point - 1];
-    log_data.blacks = (gp->board)->blacks;
-    log_data.whites = (gp->board)->whites;
-    log_data.player = gp->player;
-    gchar *json_doc = game_tree_log_data_h_json_doc(gp_hash_stack_fill_point, gp);
+    log_data.sub_run_id = ctx->sub_run_id;
+    log_data.call_id = ctx->call_count;
+    log_data.hash = game_position_x_hash(gpx);
+    ctx->gp_hash_stack[ctx->gp_hash_stack_fill_point] = log_data.hash;
+    log_data.parent_hash = ctx->gp_hash_stack[ctx->gp_hash_stack_fill_point - 1];
+    log_data.blacks = gpx->blacks;
+    log_data.whites = gpx->whites;
+    log_data.player = gpx->player;
+    gchar *json_doc = game_tree_log_data_h_json_doc_gpx(ctx->gp_hash_stack_fill_point, gpx);
     log_data.json_doc = json_doc;
-    game_tree_log_write_h(log_env, &log_data);
+    game_tree_log_write_h(ctx->log_env, &log_data);
     g_free(json_doc);
   }
 
-  const SquareSet legal_moves = game_position_legal_moves(gp);
+  const SquareSet legal_moves = game_position_x_legal_moves(gpx);
   const int legal_move_count = bit_works_popcount(legal_moves);
-  if (game_position_has_any_player_any_legal_move(gp)) { // the game must go on
+  if (game_position_x_has_any_player_any_legal_move(gpx)) { // the game must go on
     if (legal_move_count == 0) { // player has to pass
-      GamePosition *flipped_players = game_position_pass(gp);
-      node = search_node_negated(game_position_random_sampler_impl(result, flipped_players, rng));
-      game_position_free(flipped_players);
+      game_position_x_do_pass(gpx);
+      node = search_node_negated(game_position_random_sampler_impl(ctx, result, gpx));
+      game_position_x_undo_pass(gpx);
     } else { // regular move
-      const Square random_move = square_set_random_selection(rng, legal_moves);
-      GamePosition *next_gp = game_position_make_move(gp, random_move);
-      node = search_node_negated(game_position_random_sampler_impl(result, next_gp, rng));
-      game_position_free(next_gp);
+      const Square random_move = square_set_random_selection(ctx->rng, legal_moves);
+      const SquareSet flips = game_position_x_do_move(gpx, random_move);
+      node = search_node_negated(game_position_random_sampler_impl(ctx, result, gpx));
+      game_position_x_undo_move(gpx, random_move, flips);
     }
   } else { // game-over
     result->leaf_count++;
-    node = search_node_new(pass_move, game_position_final_value(gp));
+    node = search_node_new(pass_move, game_position_x_final_value(gpx));
   }
 
-  if (log_env->log_is_on) {
-    gp_hash_stack_fill_point--;
+  if (ctx->log_env->log_is_on) {
+    ctx->gp_hash_stack_fill_point--;
   }
 
   return node;
 }
 
+/*
+ * Plays a random game, starting with `first_move` from the root position, and
+ * returns its final value from the point of view of the player to move at the root.
+ */
+static int
+rollout_play (RandomNumberGenerator *const rng,
+              const GamePositionX *const root,
+              const Square first_move)
+{
+  GamePositionX gpx = *root;
+  if (first_move == pass_move) game_position_x_do_pass(&gpx);
+  else game_position_x_do_move(&gpx, first_move);
+  return -game_position_x_random_game(rng, &gpx);
+}
+
+/*
+ * Adds the game value to the statistics.
+ */
+static void
+rollout_stats_add (RolloutStats *const stats,
+                   const int value)
+{
+  stats->game_count++;
+  stats->value_sum += value;
+  stats->value_square_sum += value * value;
+  if (value > 0) stats->win_count++;
+  else if (value < 0) stats->loss_count++;
+  else stats->draw_count++;
+}
+
+/*
+ * Adds the other statistics to the given ones.
+ */
+static void
+rollout_stats_merge (RolloutStats *const stats,
+                     const RolloutStats *const other)
+{
+  stats->game_count += other->game_count;
+  stats->value_sum += other->value_sum;
+  stats->value_square_sum += other->value_square_sum;
+  stats->win_count += other->win_count;
+  stats->draw_count += other->draw_count;
+  stats->loss_count += other->loss_count;
+}
+
+/*
+ * Thread body of the rollouts, the first move is drawn uniformly among the root moves.
+ */
+static gpointer
+rollout_worker_run (gpointer data)
+{
+  RolloutWorker *const w = (RolloutWorker *) data;
+  for (uint64_t i = 0; i < w->game_count; i++) {
+    const int move_index = rng_random_choice_from_finite_set(w->rng, w->move_count);
+    const int value = rollout_play(w->rng, w->root, w->moves[move_index]);
+    rollout_stats_add(&w->root_stats, value);
+    rollout_stats_add(&w->move_stats[move_index], value);
+  }
+  return NULL;
+}
+
 /**
  * @endcond
  */
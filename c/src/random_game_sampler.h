@@ -2,7 +2,8 @@
  * @file
  *
  * @brief Random game sampler module definitions.
- * @details This module defines the #game_position_random_sampler function.
+ * @details This module defines the #game_position_random_sampler function,
+ * the #game_position_rollout engine, and the #game_position_tree_size_estimate function.
  *
  * @par random_game_sampler.h
  * <tt>
@@ -35,6 +36,65 @@
 #define RANDOM_GAME_SAMPLER_H
 
 #include "board.h"
+#include "solver_context.h"
+
+
+
+/**********************************************/
+/* Type declarations.                         */
+/**********************************************/
+
+/**
+ * @brief The outcome distribution of a set of random games.
+ *
+ * @details Values are given from the point of view of the player to move at the root.
+ */
+typedef struct {
+  uint64_t game_count;          /**< @brief The count of games. */
+  int64_t  value_sum;           /**< @brief The sum of the final values. */
+  uint64_t value_square_sum;    /**< @brief The sum of the squares of the final values. */
+  uint64_t win_count;           /**< @brief The count of games won. */
+  uint64_t draw_count;          /**< @brief The count of games drawn. */
+  uint64_t loss_count;          /**< @brief The count of games lost. */
+} RolloutStats;
+
+/**
+ * @brief The statistics collected by #game_position_rollout.
+ */
+typedef struct {
+  GamePosition *root;             /**< @brief The game position the games are played from. */
+  int           thread_count;     /**< @brief The count of threads playing the games. */
+  double        elapsed;          /**< @brief The wall clock time spent, in seconds. */
+  RolloutStats  root_stats;       /**< @brief The statistics of all the games. */
+  int           move_count;       /**< @brief The count of root moves, one when the player has to pass. */
+  Square        moves[64];        /**< @brief The root moves, or #pass_move. */
+  RolloutStats  move_stats[64];   /**< @brief The statistics of the games starting with each root move. */
+} RolloutReport;
+
+/**
+ * @brief The distribution of the estimates given by a set of random probes.
+ */
+typedef struct {
+  uint64_t probe_count;         /**< @brief The count of probes. */
+  double   sum;                 /**< @brief The sum of the estimates. */
+  double   square_sum;          /**< @brief The sum of the squares of the estimates. */
+} TreeSizeStats;
+
+/**
+ * @brief The estimates collected by #game_position_tree_size_estimate.
+ *
+ * @details The minimax tree is the full game tree, as visited by the minimax solver.
+ * The alpha-beta tree is the minimal tree, as visited by alpha-beta under a perfect move ordering,
+ * when the best move of each node is drawn at random among the legal ones.
+ */
+typedef struct {
+  GamePosition *root;             /**< @brief The game position the probes start from. */
+  double        elapsed;          /**< @brief The wall clock time spent, in seconds. */
+  TreeSizeStats minimax_nodes;    /**< @brief The node count of the minimax tree. */
+  TreeSizeStats minimax_leaves;   /**< @brief The leaf count of the minimax tree. */
+  TreeSizeStats ab_nodes;         /**< @brief The node count of the alpha-beta tree. */
+  TreeSizeStats ab_leaves;        /**< @brief The leaf count of the alpha-beta tree. */
+} TreeSizeReport;
 
 
 
@@ -47,4 +107,59 @@ game_position_random_sampler (const GamePosition *const root,
                               const gchar *const log_file,
                               const int repeats);
 
+extern ExactSolution *
+game_position_random_sampler_with_context (SolverContext *const ctx,
+                                           const GamePosition *const root);
+
+
+
+/**********************************************/
+/* Function prototypes for the rollouts.      */
+/**********************************************/
+
+extern RolloutReport *
+game_position_rollout (SolverContext *const ctx,
+                       const GamePosition *const root,
+                       const uint64_t game_count,
+                       const int thread_count);
+
+extern int
+game_position_x_random_game (RandomNumberGenerator *const rng,
+                             const GamePositionX *const gpx);
+
+extern void
+rollout_report_free (RolloutReport *report);
+
+extern gchar *
+rollout_report_to_string (const RolloutReport *const report);
+
+extern double
+rollout_stats_mean (const RolloutStats *const stats);
+
+extern double
+rollout_stats_variance (const RolloutStats *const stats);
+
+
+
+/*****************************************************/
+/* Function prototypes for the tree size estimator.  */
+/*****************************************************/
+
+extern TreeSizeReport *
+game_position_tree_size_estimate (SolverContext *const ctx,
+                                  const GamePosition *const root,
+                                  const uint64_t probe_count);
+
+extern void
+tree_size_report_free (TreeSizeReport *report);
+
+extern gchar *
+tree_size_report_to_string (const TreeSizeReport *const report);
+
+extern double
+tree_size_stats_mean (const TreeSizeStats *const stats);
+
+extern double
+tree_size_stats_confidence (const TreeSizeStats *const stats);
+
 #endif /* RANDOM_GAME_SAMPLER_H */
@@ -0,0 +1,413 @@
+/**
+ * @file
+ *
+ * @brief Solver batch module implementation.
+ *
+ * @details Solvers running on distinct contexts can share a process, but the transposition
+ * tables selected by the process wide options would then be shared by the items too.
+ * Workers are therefore child processes, forked
+ * after the database has been loaded, so that it is shared and never read again.
+ * Each worker solves one item, and sends the result back through a pipe.
+ * A new worker is started as soon as one terminates, items are taken in the batch order.
+ *
+ * @par solver_batch.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <glib.h>
+
+#include "bit_works.h"
+#include "solver_batch.h"
+
+
+
+/**
+ * @cond
+ */
+
+/*
+ * Internal types.
+ */
+
+/*
+ * The message sent by a worker to the parent process.
+ */
+typedef struct {
+  int      outcome;
+  Square   best_move;
+  uint64_t node_count;
+  uint64_t leaf_count;
+  double   time;
+} WorkerResult;
+
+/*
+ * The data used by g_tree_foreach to select the entries.
+ */
+typedef struct {
+  const gchar *pattern;
+  GSList      *entries;
+} SelectData;
+
+
+
+/*
+ * Prototypes for internal functions.
+ */
+
+static gboolean
+select_entry (gchar *key,
+              GamePositionDbEntry *entry,
+              SelectData *data);
+
+static int
+compare_items_longest_first (const void *a,
+                             const void *b);
+
+static void
+worker_run (const SolverBatchItem *const item,
+            const SolverFunction solver,
+            const int fd);
+
+static double
+item_nodes_per_second (const SolverBatchItem *const item);
+
+/**
+ * @endcond
+ */
+
+
+
+/********************************************************/
+/* Function implementations for the SolverBatch entity. */
+/********************************************************/
+
+/**
+ * @brief Solver batch structure constructor.
+ *
+ * @details Items are the entries of the database whose id matches `pattern`,
+ * as defined by `g_pattern_match_simple`, in the database key order.
+ * A `NULL` pattern selects all the entries.
+ *
+ * @invariant Parameter `db` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] db      the game position database
+ * @param [in] pattern the pattern selecting the entries
+ * @return             a pointer to a new solver batch structure
+ */
+SolverBatch *
+solver_batch_new (GamePositionDb *db,
+                  const gchar *const pattern)
+{
+  g_assert(db);
+
+  SelectData data = { pattern, NULL };
+  g_tree_foreach(db->tree, (GTraverseFunc) select_entry, &data);
+  data.entries = g_slist_reverse(data.entries);
+
+  SolverBatch *batch = (SolverBatch *) malloc(sizeof(SolverBatch));
+  g_assert(batch);
+  batch->item_count = g_slist_length(data.entries);
+  batch->items = (SolverBatchItem *) malloc(MAX(1, batch->item_count) * sizeof(SolverBatchItem));
+  g_assert(batch->items);
+
+  int i = 0;
+  for (GSList *e = data.entries; e; e = e->next, i++) {
+    const GamePositionDbEntry *const entry = (GamePositionDbEntry *) e->data;
+    SolverBatchItem *const item = &batch->items[i];
+    GamePositionX gpx;
+    game_position_x_copy_from_gp(entry->game_position, &gpx);
+    memset(item, 0, sizeof(SolverBatchItem));
+    item->entry = entry;
+    item->empty_count = bit_works_popcount(game_position_x_empties(&gpx));
+    item->mobility = bit_works_popcount(game_position_x_legal_moves(&gpx));
+    item->best_move = invalid_move;
+  }
+  g_slist_free(data.entries);
+
+  return batch;
+}
+
+/**
+ * @brief Deallocates the memory previously allocated by a call to #solver_batch_new.
+ *
+ * @details If a null pointer is passed as argument, no action occurs.
+ * Database entries are not freed.
+ *
+ * @param [in,out] batch the pointer to be deallocated
+ */
+void
+solver_batch_free (SolverBatch *batch)
+{
+  if (batch) {
+    free(batch->items);
+    free(batch);
+  }
+}
+
+/**
+ * @brief Sorts the items by their expected solving time, the longest first.
+ *
+ * @details The solving time grows with the count of empty squares, and for the same
+ * count with the number of legal moves. Ties are broken by the entry id.
+ * Starting from the longest items keeps all the workers busy until the end of the batch.
+ *
+ * @invariant Parameter `batch` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] batch the batch to be sorted
+ */
+void
+solver_batch_sort_longest_first (SolverBatch *const batch)
+{
+  g_assert(batch);
+
+  qsort(batch->items, batch->item_count, sizeof(SolverBatchItem), compare_items_longest_first);
+}
+
+/**
+ * @brief Solves the items of the batch, running up to `worker_count` workers at the same time.
+ *
+ * @details Items are assigned to workers following the batch order.
+ * The standard output of the workers is discarded. An item whose worker fails,
+ * is left with the `is_solved` field set to false.
+ *
+ * @invariant Parameter `batch` must be not `NULL`, `solver` must be not `NULL`,
+ * and `worker_count` must be positive.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] batch        the batch to be solved
+ * @param [in]     solver       the solver function
+ * @param [in]     worker_count the maximum count of concurrent workers
+ */
+void
+solver_batch_run (SolverBatch *const batch,
+                  const SolverFunction solver,
+                  const int worker_count)
+{
+  g_assert(batch);
+  g_assert(solver);
+  g_assert(worker_count > 0);
+
+  pid_t *pids = (pid_t *) malloc(worker_count * sizeof(pid_t));
+  int *fds = (int *) malloc(worker_count * sizeof(int));
+  int *item_indexes = (int *) malloc(worker_count * sizeof(int));
+  g_assert(pids && fds && item_indexes);
+  for (int w = 0; w < worker_count; w++) pids[w] = 0;
+
+  fflush(stdout);
+  fflush(stderr);
+
+  int next_item = 0;
+  int running = 0;
+  while (next_item < batch->item_count || running > 0) {
+    for (int w = 0; w < worker_count && next_item < batch->item_count; w++) {
+      if (pids[w]) continue;
+      int pipe_fds[2];
+      const int ret = pipe(pipe_fds);
+      g_assert(ret == 0);
+      const pid_t pid = fork();
+      g_assert(pid >= 0);
+      if (pid == 0) {
+        close(pipe_fds[0]);
+        worker_run(&batch->items[next_item], solver, pipe_fds[1]);
+      }
+      close(pipe_fds[1]);
+      pids[w] = pid;
+      fds[w] = pipe_fds[0];
+      item_indexes[w] = next_item++;
+      running++;
+    }
+
+    int status;
+    const pid_t pid = waitpid(-1, &status, 0);
+    g_assert(pid > 0);
+    for (int w = 0; w < worker_count; w++) {
+      if (pids[w] != pid) continue;
+      SolverBatchItem *const item = &batch->items[item_indexes[w]];
+      WorkerResult wr;
+      if (WIFEXITED(status) && WEXITSTATUS(status) == 0 && read(fds[w], &wr, sizeof(wr)) == sizeof(wr)) {
+        item->is_solved = TRUE;
+        item->outcome = wr.outcome;
+        item->best_move = wr.best_move;
+        item->node_count = wr.node_count;
+        item->leaf_count = wr.leaf_count;
+        item->time = wr.time;
+      }
+      close(fds[w]);
+      pids[w] = 0;
+      running--;
+      break;
+    }
+  }
+
+  free(item_indexes);
+  free(fds);
+  free(pids);
+}
+
+/**
+ * @brief Writes the report of the batch to `stream`.
+ *
+ * @details Each item reports the entry id, the empty count, the outcome, the best move,
+ * the time in seconds, the node and leaf counts, and the nodes per second.
+ * Items that are not solved have empty (CSV) or null (JSON) result fields.
+ *
+ * @invariant Parameters `batch` and `stream` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] batch  the solved batch
+ * @param [in] format the report format
+ * @param [in] stream the output stream
+ */
+void
+solver_batch_write (const SolverBatch *const batch,
+                    const SolverBatchFormat format,
+                    FILE *const stream)
+{
+  g_assert(batch);
+  g_assert(stream);
+
+  switch (format) {
+  case SOLVER_BATCH_FORMAT_CSV:
+    fprintf(stream, "id,empty_count,outcome,best_move,time,node_count,leaf_count,nodes_per_second\n");
+    for (int i = 0; i < batch->item_count; i++) {
+      const SolverBatchItem *const item = &batch->items[i];
+      if (item->is_solved) {
+        fprintf(stream, "%s,%d,%d,%s,%.6f,%" PRIu64 ",%" PRIu64 ",%.0f\n",
+                item->entry->id, item->empty_count, item->outcome, square_as_move_to_string(item->best_move),
+                item->time, item->node_count, item->leaf_count, item_nodes_per_second(item));
+      } else {
+        fprintf(stream, "%s,%d,,,,,,\n", item->entry->id, item->empty_count);
+      }
+    }
+    break;
+  case SOLVER_BATCH_FORMAT_JSON:
+    fprintf(stream, "[\n");
+    for (int i = 0; i < batch->item_count; i++) {
+      const SolverBatchItem *const item = &batch->items[i];
+      const gchar *const separator = i + 1 < batch->item_count ? "," : "";
+      if (item->is_solved) {
+        fprintf(stream, "  {\"id\": \"%s\", \"empty_count\": %d, \"outcome\": %d, \"best_move\": \"%s\", "
+                "\"time\": %.6f, \"node_count\": %" PRIu64 ", \"leaf_count\": %" PRIu64 ", \"nodes_per_second\": %.0f}%s\n",
+                item->entry->id, item->empty_count, item->outcome, square_as_move_to_string(item->best_move),
+                item->time, item->node_count, item->leaf_count, item_nodes_per_second(item), separator);
+      } else {
+        fprintf(stream, "  {\"id\": \"%s\", \"empty_count\": %d, \"outcome\": null, \"best_move\": null, "
+                "\"time\": null, \"node_count\": null, \"leaf_count\": null, \"nodes_per_second\": null}%s\n",
+                item->entry->id, item->empty_count, separator);
+      }
+    }
+    fprintf(stream, "]\n");
+    break;
+  default:
+    g_assert(FALSE);
+  }
+}
+
+
+
+/**
+ * @cond
+ */
+
+/*
+ * Internal functions.
+ */
+
+/*
+ * `GTraverseFunc` collecting the entries whose key matches the pattern.
+ */
+static gboolean
+select_entry (gchar *key,
+              GamePositionDbEntry *entry,
+              SelectData *data)
+{
+  if (!data->pattern || g_pattern_match_simple(data->pattern, key)) {
+    data->entries = g_slist_prepend(data->entries, entry);
+  }
+  return FALSE;
+}
+
+/*
+ * Orders items by decreasing empty count, then by decreasing mobility, then by id.
+ */
+static int
+compare_items_longest_first (const void *a,
+                             const void *b)
+{
+  const SolverBatchItem *const x = (const SolverBatchItem *) a;
+  const SolverBatchItem *const y = (const SolverBatchItem *) b;
+  if (x->empty_count != y->empty_count) return y->empty_count - x->empty_count;
+  if (x->mobility != y->mobility) return y->mobility - x->mobility;
+  return strcmp(x->entry->id, y->entry->id);
+}
+
+/*
+ * Body of the worker process, solves the item, writes the result to the pipe, and exits.
+ */
+static void
+worker_run (const SolverBatchItem *const item,
+            const SolverFunction solver,
+            const int fd)
+{
+  if (!freopen("/dev/null", "w", stdout)) _exit(1);
+
+  const gint64 start = g_get_monotonic_time();
+  ExactSolution *solution = solver(item->entry->game_position, NULL);
+  const gint64 end = g_get_monotonic_time();
+
+  WorkerResult wr;
+  memset(&wr, 0, sizeof(wr));
+  wr.outcome = solution->outcome;
+  wr.best_move = solution->pv[0];
+  wr.node_count = solution->node_count;
+  wr.leaf_count = solution->leaf_count;
+  wr.time = (end - start) / 1.0e6;
+  exact_solution_free(solution);
+
+  const ssize_t written = write(fd, &wr, sizeof(wr));
+  close(fd);
+  _exit(written == sizeof(wr) ? 0 : 1);
+}
+
+static double
+item_nodes_per_second (const SolverBatchItem *const item)
+{
+  return item->time > 0.0 ? item->node_count / item->time : 0.0;
+}
+
+/**
+ * @endcond
+ */
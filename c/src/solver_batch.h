@@ -0,0 +1,117 @@
+/**
+ * @file
+ *
+ * @brief Solver batch module definitions.
+ * @details This module solves a selection of the entries of a game position database
+ * on a pool of worker processes, and reports the results.
+ *
+ * @par solver_batch.h
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#ifndef SOLVER_BATCH_H
+#define SOLVER_BATCH_H
+
+#include <stdio.h>
+
+#include <glib.h>
+
+#include "board.h"
+#include "game_position_db.h"
+#include "game_tree_utils.h"
+
+
+
+/**********************************************/
+/* Type declarations.                         */
+/**********************************************/
+
+/**
+ * @brief The signature shared by the solvers.
+ */
+typedef ExactSolution *(*SolverFunction) (const GamePosition *const root,
+                                          const gchar *const log_file);
+
+/**
+ * @brief The format of the batch report.
+ */
+typedef enum {
+  SOLVER_BATCH_FORMAT_CSV,            /**< Comma separated values, one line per item, with a header. */
+  SOLVER_BATCH_FORMAT_JSON            /**< An array of objects, one per item. */
+} SolverBatchFormat;
+
+/**
+ * @brief A game position to be solved, and its result.
+ */
+typedef struct {
+  const GamePositionDbEntry *entry;         /**< @brief The database entry, not owned. */
+  int                        empty_count;   /**< @brief The count of empty squares. */
+  int                        mobility;      /**< @brief The count of legal moves. */
+  gboolean                   is_solved;     /**< @brief True when the worker returned a result. */
+  int                        outcome;       /**< @brief The game value. */
+  Square                     best_move;     /**< @brief The best move. */
+  uint64_t                   node_count;    /**< @brief The count of nodes searched. */
+  uint64_t                   leaf_count;    /**< @brief The count of leaves searched. */
+  double                     time;          /**< @brief The wall clock time spent by the solver, in seconds. */
+} SolverBatchItem;
+
+/**
+ * @brief A batch is the array of items being solved.
+ */
+typedef struct {
+  SolverBatchItem *items;             /**< @brief The items. */
+  int              item_count;        /**< @brief The count of items. */
+} SolverBatch;
+
+
+
+/********************************************************/
+/* Function implementations for the SolverBatch entity. */
+/********************************************************/
+
+extern SolverBatch *
+solver_batch_new (GamePositionDb *db,
+                  const gchar *const pattern);
+
+extern void
+solver_batch_free (SolverBatch *batch);
+
+extern void
+solver_batch_sort_longest_first (SolverBatch *const batch);
+
+extern void
+solver_batch_run (SolverBatch *const batch,
+                  const SolverFunction solver,
+                  const int worker_count);
+
+extern void
+solver_batch_write (const SolverBatch *const batch,
+                    const SolverBatchFormat format,
+                    FILE *const stream);
+
+
+
+#endif /* SOLVER_BATCH_H */
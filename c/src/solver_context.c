@@ -0,0 +1,237 @@
+/**
+ * @file
+ *
+ * @brief Solver context module implementation.
+ *
+ * @par solver_context.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <glib.h>
+
+#include "ab_solver.h"
+#include "exact_solver.h"
+#include "mcts_solver.h"
+#include "pab_solver.h"
+#include "solver_context.h"
+
+
+
+/**
+ * @cond
+ */
+
+/*
+ * Internal variables and constants.
+ */
+
+/* The clock is read once every 1024 nodes. */
+static const uint64_t time_check_interval = 1024;
+
+/**
+ * @endcond
+ */
+
+
+
+/**********************************************************/
+/* Function implementations for the SolverContext entity. */
+/**********************************************************/
+
+/**
+ * @brief Solver context structure constructor.
+ *
+ * @details The options are copied from the process wide ones: the win/loss/draw mode,
+ * the stability cutoff, the move ordering, the search budget, the default tables,
+ * and the settings of the es, ab, pab, and mcts solvers. The log is turned off, and one run is done.
+ *
+ * @return a pointer to a new solver context structure
+ */
+SolverContext *
+solver_context_new (void)
+{
+  SolverContext *ctx = (SolverContext *) malloc(sizeof(SolverContext));
+  g_assert(ctx);
+
+  ctx->log_file = NULL;
+  ctx->repeats = 1;
+  ctx->wld = exact_solution_wld_is_enabled();
+  ctx->stability_cutoff = node_info_stability_cutoff_is_enabled();
+  node_info_move_ordering_get(&ctx->move_ordering);
+  search_budget_get(&ctx->budget);
+  ctx->tt = transposition_table_get_default();
+  ctx->lfht = lock_free_hash_table_get_default();
+  ctx->ab_search_mode = ab_solver_get_search_mode();
+  ctx->ab_first_guess = ab_solver_get_first_guess();
+  ctx->ab_all_moves = ab_solver_all_moves_is_enabled();
+  ctx->pab_thread_count = pab_solver_get_thread_count();
+  ctx->pv_recording = exact_solver_get_pv_recording();
+  ctx->mcts_parallelism = mcts_solver_get_parallelism();
+  ctx->mcts_thread_count = mcts_solver_get_thread_count();
+  ctx->rng = NULL;
+
+  ctx->log_env = NULL;
+  ctx->call_count = 0;
+  ctx->gp_hash_stack[0] = 0;
+  ctx->gp_hash_stack_fill_point = 0;
+  ctx->sub_run_id = 0;
+  ctx->hash_is_on = FALSE;
+  ctx->pve = NULL;
+  ctx->budget_is_on = FALSE;
+  ctx->deadline = 0;
+  ctx->next_time_check = 0;
+  ctx->budget_exhausted = 0;
+
+  return ctx;
+}
+
+/**
+ * @brief Deallocates the memory previously allocated by a call to #solver_context_new.
+ *
+ * @details The tables are not owned, and are not freed.
+ * If a null pointer is passed as argument, no action occurs.
+ *
+ * @param [in,out] ctx the pointer to be deallocated
+ */
+void
+solver_context_free (SolverContext *ctx)
+{
+  if (ctx) {
+    if (ctx->rng) rng_free(ctx->rng);
+    free(ctx);
+  }
+}
+
+/**
+ * @brief Prepares the context for a new search.
+ *
+ * @details It is called by the solvers before searching. The logging environment is
+ * opened as selected by the `log_file` option, the counters are cleared, and the clock
+ * of the budget is started.
+ *
+ * @invariant Parameter `ctx` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] ctx the solver context
+ */
+void
+solver_context_search_start (SolverContext *const ctx)
+{
+  g_assert(ctx);
+
+  ctx->log_env = game_tree_log_init(ctx->log_file);
+  ctx->call_count = 0;
+  ctx->gp_hash_stack[0] = 0;
+  ctx->gp_hash_stack_fill_point = 0;
+  ctx->sub_run_id = 0;
+
+  g_assert(ctx->budget.time_limit >= 0.0);
+  g_atomic_int_set(&ctx->budget_exhausted, 0);
+  ctx->deadline = ctx->budget.time_limit > 0.0
+    ? g_get_monotonic_time() + (gint64) (ctx->budget.time_limit * 1.0e6)
+    : 0;
+  ctx->next_time_check = time_check_interval;
+  ctx->budget_is_on = ctx->budget.node_limit != 0 || ctx->deadline != 0;
+}
+
+/**
+ * @brief Releases the state of the search, closing the log.
+ *
+ * @invariant Parameter `ctx` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] ctx the solver context
+ */
+void
+solver_context_search_end (SolverContext *const ctx)
+{
+  g_assert(ctx);
+
+  if (ctx->log_env) game_tree_log_close(ctx->log_env);
+  ctx->log_env = NULL;
+}
+
+/**
+ * @brief Checks the budget, and returns true when the search has to stop.
+ *
+ * @details It is called on each node, `node_count` is the count of nodes visited by the search.
+ * The clock is read only once every 1024 nodes.
+ * Once exhausted, the budget stays exhausted until the next call to #solver_context_search_start.
+ * Threads sharing a context must not call the function concurrently.
+ *
+ * @param [in,out] ctx        the solver context
+ * @param [in]     node_count the count of nodes visited so far
+ * @return                    true when the budget is exhausted
+ */
+gboolean
+solver_context_budget_check (SolverContext *const ctx,
+                             const uint64_t node_count)
+{
+  if (g_atomic_int_get(&ctx->budget_exhausted)) return TRUE;
+  gboolean exhausted = ctx->budget.node_limit && node_count >= ctx->budget.node_limit;
+  if (!exhausted && ctx->deadline && node_count >= ctx->next_time_check) {
+    ctx->next_time_check = node_count + time_check_interval;
+    exhausted = g_get_monotonic_time() >= ctx->deadline;
+  }
+  if (exhausted) g_atomic_int_set(&ctx->budget_exhausted, 1);
+  return exhausted;
+}
+
+/**
+ * @brief Returns true when the running search is out of budget.
+ *
+ * @param [in] ctx the solver context
+ * @return         true when the budget is exhausted
+ */
+gboolean
+solver_context_budget_is_exhausted (SolverContext *const ctx)
+{
+  return g_atomic_int_get(&ctx->budget_exhausted);
+}
+
+/**
+ * @brief Returns the random number generator of the context, creating it when missing.
+ *
+ * @details The generator is seeded by #rng_random_seed, a repeatable sequence is obtained
+ * by assigning to the `rng` field a generator created with a given seed.
+ *
+ * @invariant Parameter `ctx` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] ctx the solver context
+ * @return             the random number generator
+ */
+RandomNumberGenerator *
+solver_context_get_rng (SolverContext *const ctx)
+{
+  g_assert(ctx);
+
+  if (!ctx->rng) ctx->rng = rng_new(rng_random_seed());
+  return ctx->rng;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file
+ *
+ * @brief Solver context module definitions.
+ * @details A solver context owns the options and the state of a search: the logging environment,
+ * the call counters, the principal variation environment, and the budget. Each solver has an entry
+ * point taking a context, solves running on distinct contexts can run concurrently in one process.
+ *
+ * The entry points taking a log file name, as #game_position_ab_solve, are wrappers that
+ * create a context from the process wide options, solve, and free it.
+ *
+ * @par solver_context.h
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#ifndef SOLVER_CONTEXT_H
+#define SOLVER_CONTEXT_H
+
+#include <glib.h>
+
+#include "board.h"
+#include "random.h"
+#include "game_tree_utils.h"
+#include "game_tree_logger.h"
+#include "transposition_table.h"
+#include "lock_free_hash_table.h"
+
+
+
+/**********************************************/
+/* Type declarations.                         */
+/**********************************************/
+
+/**
+ * @brief The search strategy applied by the alpha-beta solver.
+ */
+typedef enum {
+  AB_SOLVER_SEARCH_MODE_ALPHA_BETA,   /**< Plain alpha-beta on the full window. */
+  AB_SOLVER_SEARCH_MODE_PVS,          /**< Principal variation search, moves after the first are tested by a null window. */
+  AB_SOLVER_SEARCH_MODE_MTDF          /**< MTD(f), a sequence of null window searches converging on the game value. */
+} AbSolverSearchMode;
+
+/**
+ * @brief How much of the principal variation is collected by the es solver.
+ */
+typedef enum {
+  EXACT_SOLVER_PV_RECORDING_NONE,         /**< Only the best move of the root is reported. */
+  EXACT_SOLVER_PV_RECORDING_TRIANGULAR,   /**< The main line is collected by a fixed triangular array, without allocations. */
+  EXACT_SOLVER_PV_RECORDING_FULL          /**< The main line and the variants having the same value are collected by a #PVEnv. */
+} ExactSolverPVRecording;
+
+/**
+ * @brief How the threads of the mcts solver share the work.
+ */
+typedef enum {
+  MCTS_SOLVER_PARALLELISM_TREE,   /**< The threads grow one tree, spreading by means of a virtual loss. */
+  MCTS_SOLVER_PARALLELISM_ROOT    /**< Each thread grows its own tree, the root statistics are summed at the end. */
+} MctsSolverParallelism;
+
+/**
+ * @brief The options and the state of a search.
+ *
+ * @details The options are public, they are set by #solver_context_new from the process wide ones,
+ * and can be changed before solving. The tables are not owned, and must not be shared by contexts
+ * used concurrently. The other fields are the state of the running search, owned by the context.
+ */
+typedef struct {
+  const gchar        *log_file;                 /**< @brief Turns logging on when not `NULL`, it is the prefix of the file names. */
+  int                 repeats;                  /**< @brief The count of runs, used by the rand and rab solvers. */
+  gboolean            wld;                      /**< @brief True when the search proves only a win, a loss, or a draw. */
+  gboolean            stability_cutoff;         /**< @brief True when nodes are pruned by means of the stable discs. */
+  MoveOrdering        move_ordering;            /**< @brief The move ordering policy, used by the ab solver. */
+  SearchBudget        budget;                   /**< @brief The limits given to the search. */
+  TranspositionTable *tt;                       /**< @brief The transposition table, `NULL` when it is turned off. */
+  LockFreeHashTable  *lfht;                     /**< @brief The table shared by the threads of the pab solver, `NULL` when it is turned off. */
+  AbSolverSearchMode  ab_search_mode;           /**< @brief The search strategy of the ab solver. */
+  int                 ab_first_guess;           /**< @brief The first guess of the MTD(f) search. */
+  gboolean            ab_all_moves;             /**< @brief True when the ab solver scores every root move. */
+  int                 pab_thread_count;         /**< @brief The count of threads of the pab solver, zero means one for each processor. */
+  ExactSolverPVRecording pv_recording;          /**< @brief The principal variation collected by the es solver. */
+  MctsSolverParallelism mcts_parallelism;       /**< @brief How the threads of the mcts solver share the work. */
+  int                 mcts_thread_count;        /**< @brief The count of threads of the mcts solver, zero means one for each processor. */
+  RandomNumberGenerator *rng;                   /**< @brief The random number generator of the rand and rab solvers, created when needed. */
+  LogEnv             *log_env;                  /**< @brief The logging environment of the running search. */
+  uint64_t            call_count;               /**< @brief The count of calls to the recursive search function. */
+  uint64_t            gp_hash_stack[128];       /**< @brief The hash values of the game positions from the root to the current node. */
+  int                 gp_hash_stack_fill_point; /**< @brief The index of the last entry of the hash stack. */
+  int                 sub_run_id;               /**< @brief The run being logged. */
+  gboolean            hash_is_on;               /**< @brief True when the hash of the game positions is maintained. */
+  PVEnv              *pve;                      /**< @brief The principal variation environment, used by the es solver. */
+  gboolean            budget_is_on;             /**< @brief True when the search has a node or time budget. */
+  gint64              deadline;                 /**< @brief The monotonic time, in microseconds, when the search has to stop, zero means none. */
+  uint64_t            next_time_check;          /**< @brief The node count at which the clock is read next. */
+  volatile gint       budget_exhausted;         /**< @brief Set when the search is out of budget, shared by the threads of the pab solver. */
+} SolverContext;
+
+/**
+ * @brief The signature shared by the solver entry points taking a context.
+ */
+typedef ExactSolution *(*SolverContextFunction) (SolverContext *const ctx,
+                                                 const GamePosition *const root);
+
+
+
+/*****************************************************/
+/* Function prototypes for the SolverContext entity. */
+/*****************************************************/
+
+extern SolverContext *
+solver_context_new (void);
+
+extern void
+solver_context_free (SolverContext *ctx);
+
+extern void
+solver_context_search_start (SolverContext *const ctx);
+
+extern void
+solver_context_search_end (SolverContext *const ctx);
+
+extern gboolean
+solver_context_budget_check (SolverContext *const ctx,
+                             const uint64_t node_count);
+
+extern gboolean
+solver_context_budget_is_exhausted (SolverContext *const ctx);
+
+extern RandomNumberGenerator *
+solver_context_get_rng (SolverContext *const ctx);
+
+
+
+#endif /* SOLVER_CONTEXT_H */
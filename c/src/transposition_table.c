@@ -0,0 +1,341 @@
+/**
+ * @file
+ *
+ * @brief Transposition table module implementation.
+ *
+ * @details The table is sized as a power of two count of buckets, each holding
+ * #TRANSPOSITION_TABLE_BUCKET_SIZE entries. Entries are located by the full 64 bits hash.
+ *
+ * Solvers read the table assigned by #transposition_table_set_default at the start of
+ * the solve call, the solver is then responsible to probe it and to store into it.
+ *
+ * @par transposition_table.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <glib.h>
+
+#include "game_tree_utils.h"
+#include "transposition_table.h"
+
+
+
+/**
+ * @cond
+ */
+
+/*
+ * Internal variables and constants.
+ */
+
+/* The table used by the solvers, NULL when the table is turned off. */
+static TranspositionTable *default_table = NULL;
+
+/**
+ * @endcond
+ */
+
+
+
+/***************************************************************/
+/* Function implementations for the TranspositionTable entity. */
+/***************************************************************/
+
+/**
+ * @brief Transposition table structure constructor.
+ *
+ * @details The table has `2^size_log2` entries, grouped into buckets.
+ *
+ * @invariant Parameter `size_log2` must be in the range [2..40].
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] size_log2 the base two logarithm of the number of entries
+ * @return               a pointer to a new transposition table structure
+ */
+TranspositionTable *
+transposition_table_new (const int size_log2)
+{
+  g_assert(size_log2 >= 2 && size_log2 <= 40);
+
+  TranspositionTable *tt = (TranspositionTable *) malloc(sizeof(TranspositionTable));
+  g_assert(tt);
+
+  tt->bucket_count = ((size_t) 1 << size_log2) / TRANSPOSITION_TABLE_BUCKET_SIZE;
+  tt->mask = tt->bucket_count - 1;
+  tt->buckets = (TranspositionTableBucket *) malloc(tt->bucket_count * sizeof(TranspositionTableBucket));
+  g_assert(tt->buckets);
+
+  tt->generation = 0;
+  memset(&tt->stats, 0, sizeof(TranspositionTableStats));
+  transposition_table_clear(tt);
+
+  return tt;
+}
+
+/**
+ * @brief Deallocates the memory previously allocated by a call to #transposition_table_new.
+ *
+ * @details If a null pointer is passed as argument, no action occurs.
+ *
+ * @param [in,out] tt the pointer to be deallocated
+ */
+void
+transposition_table_free (TranspositionTable *tt)
+{
+  if (tt) {
+    free(tt->buckets);
+    free(tt);
+  }
+}
+
+/**
+ * @brief Removes all the entries, statistics are kept.
+ *
+ * @invariant Parameter `tt` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] tt the transposition table
+ */
+void
+transposition_table_clear (TranspositionTable *tt)
+{
+  g_assert(tt);
+
+  memset(tt->buckets, 0, tt->bucket_count * sizeof(TranspositionTableBucket));
+}
+
+/**
+ * @brief Marks the start of a new search.
+ *
+ * @details Entries written by the previous searches are kept and can be found by the probes,
+ * but they are the first ones to be replaced.
+ *
+ * @invariant Parameter `tt` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] tt the transposition table
+ */
+void
+transposition_table_new_search (TranspositionTable *tt)
+{
+  g_assert(tt);
+
+  tt->generation++;
+}
+
+/**
+ * @brief Looks up the game position identified by `hash`.
+ *
+ * @details The probe is successful when the entry is found, and it has been computed
+ * by a search at least `depth` deep. The entry is then copied into `entry`.
+ *
+ * @invariant Parameters `tt` and `entry` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] tt    the transposition table
+ * @param [in]     hash  the hash of the game position
+ * @param [in]     depth the depth of the search
+ * @param [out]    entry the entry found
+ * @return               true when the entry is found
+ */
+gboolean
+transposition_table_probe (TranspositionTable *const tt,
+                           const uint64_t hash,
+                           const int depth,
+                           TranspositionTableEntry *const entry)
+{
+  g_assert(tt);
+  g_assert(entry);
+
+  tt->stats.probe_count++;
+  const TranspositionTableBucket *const bucket = &tt->buckets[hash & tt->mask];
+  for (int i = 0; i < TRANSPOSITION_TABLE_BUCKET_SIZE; i++) {
+    const TranspositionTableEntry *const e = &bucket->entries[i];
+    if (e->hash == hash && e->depth >= depth && (e->depth || hash)) {
+      *entry = *e;
+      tt->stats.hit_count++;
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/**
+ * @brief Checks if the bounds of the entry decide the value of the node searched with the given window.
+ *
+ * @details It happens when the lower bound is not less than `beta`, when the upper bound
+ * is not greater than `alpha`, or when the value is exact.
+ *
+ * @invariant Parameters `tt`, `entry`, and `value` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] tt    the transposition table, the cutoff statistic is updated
+ * @param [in]     entry the entry returned by #transposition_table_probe
+ * @param [in]     alpha the lower limit of the search window
+ * @param [in]     beta  the upper limit of the search window
+ * @param [out]    value the node value to return when the function returns true
+ * @return               true when the node search can be skipped
+ */
+gboolean
+transposition_table_cutoff (TranspositionTable *const tt,
+                            const TranspositionTableEntry *const entry,
+                            const int alpha,
+                            const int beta,
+                            int *const value)
+{
+  g_assert(tt);
+  g_assert(entry);
+  g_assert(value);
+
+  if (entry->lower >= beta || entry->lower == entry->upper) {
+    *value = entry->lower;
+  } else if (entry->upper <= alpha) {
+    *value = entry->upper;
+  } else {
+    return FALSE;
+  }
+  tt->stats.cutoff_count++;
+  return TRUE;
+}
+
+/**
+ * @brief Stores the result of a search.
+ *
+ * @details The bound type is derived from the search window: a value not greater than `alpha`
+ * is an upper bound, a value not less than `beta` is a lower bound, any other value is exact.
+ * When the game position is already in the table, and the stored depth is the same,
+ * the bounds are intersected, otherwise the deeper search wins.
+ *
+ * @invariant Parameter `tt` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in,out] tt        the transposition table
+ * @param [in]     hash      the hash of the game position
+ * @param [in]     depth     the depth of the search
+ * @param [in]     alpha     the lower limit of the search window
+ * @param [in]     beta      the upper limit of the search window
+ * @param [in]     value     the value returned by the search
+ * @param [in]     best_move the best move found by the search
+ */
+void
+transposition_table_store (TranspositionTable *const tt,
+                           const uint64_t hash,
+                           const int depth,
+                           const int alpha,
+                           const int beta,
+                           const int value,
+                           const Square best_move)
+{
+  g_assert(tt);
+
+  const int lower = value <= alpha ? worst_score : value;
+  const int upper = value >= beta ? best_score : value;
+
+  tt->stats.store_count++;
+  TranspositionTableBucket *const bucket = &tt->buckets[hash & tt->mask];
+  TranspositionTableEntry *victim = &bucket->entries[0];
+  for (int i = 0; i < TRANSPOSITION_TABLE_BUCKET_SIZE; i++) {
+    TranspositionTableEntry *const e = &bucket->entries[i];
+    if (e->hash == hash && (e->depth || hash)) {
+      if (e->depth > depth) return;
+      if (e->depth == depth) {
+        e->lower = MAX(e->lower, lower);
+        e->upper = MIN(e->upper, upper);
+      } else {
+        e->lower = lower;
+        e->upper = upper;
+        e->depth = depth;
+      }
+      e->best_move = best_move;
+      e->generation = tt->generation;
+      return;
+    }
+    const gboolean e_is_stale = e->generation != tt->generation;
+    const gboolean v_is_stale = victim->generation != tt->generation;
+    if ((e_is_stale && !v_is_stale) || (e_is_stale == v_is_stale && e->depth < victim->depth)) victim = e;
+  }
+  if (victim->depth) tt->stats.replacement_count++;
+  victim->hash = hash;
+  victim->lower = lower;
+  victim->upper = upper;
+  victim->best_move = best_move;
+  victim->depth = depth;
+  victim->generation = tt->generation;
+}
+
+/**
+ * @brief Returns a formatted string describing the statistics of the table.
+ *
+ * @details The returned string has to be deallocated by the caller.
+ *
+ * @invariant Parameter `tt` must be not `NULL`.
+ * The invariant is guarded by an assertion.
+ *
+ * @param [in] tt the transposition table
+ * @return        a string describing the statistics
+ */
+gchar *
+transposition_table_stats_to_string (const TranspositionTable *const tt)
+{
+  g_assert(tt);
+
+  const TranspositionTableStats *const s = &tt->stats;
+  const double hit_rate = s->probe_count ? 100.0 * s->hit_count / s->probe_count : 0.0;
+  const double cutoff_rate = s->hit_count ? 100.0 * s->cutoff_count / s->hit_count : 0.0;
+  return g_strdup_printf("Transposition table: entries %zu, probes %" PRIu64 ", hits %" PRIu64 " (%.1f%%), "
+                         "cutoffs %" PRIu64 " (%.1f%% of hits), stores %" PRIu64 ", replacements %" PRIu64 "\n",
+                         tt->bucket_count * TRANSPOSITION_TABLE_BUCKET_SIZE, s->probe_count, s->hit_count, hit_rate,
+                         s->cutoff_count, cutoff_rate, s->store_count, s->replacement_count);
+}
+
+/**
+ * @brief Assigns the transposition table used by the solvers.
+ *
+ * @details The table is owned by the caller, `NULL` turns the table off.
+ *
+ * @param [in] tt the transposition table
+ */
+void
+transposition_table_set_default (TranspositionTable *tt)
+{
+  default_table = tt;
+}
+
+/**
+ * @brief Returns the transposition table used by the solvers.
+ *
+ * @return the transposition table, or `NULL` when the table is turned off
+ */
+TranspositionTable *
+transposition_table_get_default (void)
+{
+  return default_table;
+}
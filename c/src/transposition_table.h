@@ -0,0 +1,157 @@
+/**
+ * @file
+ *
+ * @brief Transposition table module definitions.
+ * @details This module defines a fixed size hash table that stores the bounds of the
+ * game position values computed by the solvers, together with the best move found.
+ *
+ * @par transposition_table.h
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <glib.h>
+
+#include "board.h"
+
+/**
+ * @brief The number of entries in a bucket, a bucket fills a 64 bytes cache line.
+ */
+#define TRANSPOSITION_TABLE_BUCKET_SIZE 4
+
+
+
+/**********************************************/
+/* Type declarations.                         */
+/**********************************************/
+
+/**
+ * @brief A transposition table entry.
+ *
+ * @details The value of the game position lies in the range [lower..upper],
+ * the two bounds are equal when the value is exact.
+ * The depth is the count of empty squares for the endgame solvers,
+ * a zero depth together with a zero hash marks an empty entry.
+ */
+typedef struct {
+  uint64_t hash;                      /**< @brief The hash of the game position. */
+  int8_t   lower;                     /**< @brief The lower bound of the game position value. */
+  int8_t   upper;                     /**< @brief The upper bound of the game position value. */
+  int8_t   best_move;                 /**< @brief The best move, or the refutation move, found by the search. */
+  uint8_t  depth;                     /**< @brief The depth of the search that computed the bounds. */
+  uint8_t  generation;                /**< @brief The generation of the table when the entry has been written. */
+} TranspositionTableEntry;
+
+/**
+ * @brief A bucket collects the entries sharing the same index.
+ */
+typedef struct {
+  TranspositionTableEntry entries[TRANSPOSITION_TABLE_BUCKET_SIZE]; /**< @brief The bucket entries. */
+} TranspositionTableBucket;
+
+/**
+ * @brief The statistics collected by the transposition table.
+ */
+typedef struct {
+  uint64_t probe_count;               /**< @brief The count of probes. */
+  uint64_t hit_count;                 /**< @brief The count of probes finding the game position. */
+  uint64_t cutoff_count;              /**< @brief The count of hits whose bounds decide the node value. */
+  uint64_t store_count;               /**< @brief The count of stores. */
+  uint64_t replacement_count;         /**< @brief The count of stores overwriting an entry of another game position. */
+} TranspositionTableStats;
+
+/**
+ * @brief A transposition table is an array of buckets, sized as a power of two.
+ *
+ * @details The hash selects the bucket, then the four entries are searched.
+ * When the game position is not found a new entry replaces the one having the lowest
+ * priority: entries written by a previous search, as marked by the generation, go first,
+ * then the ones having the smallest depth.
+ *
+ * The table is not thread safe.
+ */
+typedef struct {
+  size_t                    bucket_count; /**< @brief The count of buckets, a power of two. */
+  size_t                    mask;         /**< @brief The mask that maps a hash value to a bucket index. */
+  TranspositionTableBucket *buckets;      /**< @brief The array of buckets. */
+  uint8_t                   generation;   /**< @brief The current generation, incremented by each new search. */
+  TranspositionTableStats   stats;        /**< @brief The statistics. */
+} TranspositionTable;
+
+
+
+/***************************************************************/
+/* Function implementations for the TranspositionTable entity. */
+/***************************************************************/
+
+extern TranspositionTable *
+transposition_table_new (const int size_log2);
+
+extern void
+transposition_table_free (TranspositionTable *tt);
+
+extern void
+transposition_table_clear (TranspositionTable *tt);
+
+extern void
+transposition_table_new_search (TranspositionTable *tt);
+
+extern gboolean
+transposition_table_probe (TranspositionTable *const tt,
+                           const uint64_t hash,
+                           const int depth,
+                           TranspositionTableEntry *const entry);
+
+extern gboolean
+transposition_table_cutoff (TranspositionTable *const tt,
+                            const TranspositionTableEntry *const entry,
+                            const int alpha,
+                            const int beta,
+                            int *const value);
+
+extern void
+transposition_table_store (TranspositionTable *const tt,
+                           const uint64_t hash,
+                           const int depth,
+                           const int alpha,
+                           const int beta,
+                           const int value,
+                           const Square best_move);
+
+extern gchar *
+transposition_table_stats_to_string (const TranspositionTable *const tt);
+
+extern void
+transposition_table_set_default (TranspositionTable *tt);
+
+extern TranspositionTable *
+transposition_table_get_default (void);
+
+
+
+#endif /* TRANSPOSITION_TABLE_H */
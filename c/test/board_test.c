@@ -36,6 +36,7 @@
 
 #include <glib.h>
 
+#include "bit_works.h"
 #include "random.h"
 #include "board.h"
 
@@ -51,12 +52,14 @@ static void square_array_to_string_test (void);
 static void square_as_move_array_to_string_test (void);
 static void square_belongs_to_enum_set_test (void);
 static void square_is_valid_move_test (void);
+static void square_transform_test (void);
 
 static void square_set_to_pg_json_array_test (void);
 static void square_set_to_string_test (void);
 static void square_set_random_selection_test (void);
 static void square_set_to_array_test (void);
 static void square_set_from_array_test (void);
+static void square_set_transform_test (void);
 
 static void player_color_test (void);
 static void player_description_test (void);
@@ -65,6 +68,24 @@ static void player_opponent_test (void);
 static void direction_shift_square_set_test (void);
 static void direction_shift_square_set_by_amount_test (void);
 
+static void legal_move_generator_to_string_test (void);
+static void legal_move_generator_set_test (void);
+static void legal_move_generator_legal_moves_test (void);
+static void legal_move_generator_perf_test (void);
+
+static void legal_moves_batch_backend_to_string_test (void);
+static void legal_moves_batch_backend_set_test (void);
+static void legal_moves_batch_backend_legal_moves_test (void);
+static void legal_moves_batch_backend_perf_test (void);
+
+static void flip_backend_to_string_test (void);
+static void flip_backend_set_test (void);
+static void flip_backend_flips_test (void);
+static void flip_backend_perf_test (void);
+
+static void board_transformation_to_string_test (void);
+static void board_transformation_inverse_test (void);
+
 static void axis_shift_distance_test (void);
 static void axis_move_ordinal_position_in_bitrow_test (void);
 static void axis_transform_to_row_one_test (void);
@@ -78,6 +99,9 @@ static void board_new_test (void);
 static void board_print_test (void);
 static void board_is_move_legal_test (void);
 static void board_legal_moves_test (void);
+static void board_bitrow_changes_for_player_test (void);
+static void board_bitrow_changes_for_player_perf_test (void);
+static void board_stable_discs_test (void);
 
 static void game_position_print_test (void);
 static void game_position_to_string_test (void);
@@ -100,11 +124,18 @@ static void game_position_x_gpx_to_gp_test (void);
 static void game_position_x_copy_from_gp_test (void);
 static void game_position_x_pass_test (void);
 static void game_position_x_hash_test (void);
+static void game_position_x_delta_hash_test (void);
 static void game_position_x_final_value_test (void);
+static void game_position_x_stable_discs_test (void);
+static void game_position_x_stable_discs_perf_test (void);
+static void game_position_x_transform_test (void);
+static void game_position_x_canonical_test (void);
 static void game_position_x_has_any_legal_move_test (void);
 static void game_position_x_has_any_player_any_legal_move_test (void);
 static void game_position_x_is_move_legal_test (void);
 static void game_position_x_make_move_test (void);
+static void game_position_x_do_move_test (void);
+static void game_position_x_do_pass_test (void);
 
 int
 main (int   argc,
@@ -122,12 +153,14 @@ main (int   argc,
   g_test_add_func("/board/square_as_move_array_to_string_test", square_as_move_array_to_string_test);
   g_test_add_func("/board/square_belongs_to_enum_set_test", square_belongs_to_enum_set_test);
   g_test_add_func("/board/square_is_valid_move_test", square_is_valid_move_test);
+  g_test_add_func("/board/square_transform_test", square_transform_test);
 
   g_test_add_func("/board/square_set_to_pg_json_array_test", square_set_to_pg_json_array_test);
   g_test_add_func("/board/square_set_to_string_test", square_set_to_string_test);
   g_test_add_func("/board/square_set_random_selection_test", square_set_random_selection_test);
   g_test_add_func("/board/square_set_to_array_test", square_set_to_array_test);
   g_test_add_func("/board/square_set_from_array_test", square_set_from_array_test);
+  g_test_add_func("/board/square_set_transform_test", square_set_transform_test);
 
   g_test_add_func("/board/player_color_test", player_color_test);
   g_test_add_func("/board/player_description_test", player_description_test);
@@ -136,6 +169,21 @@ main (int   argc,
   g_test_add_func("/board/direction_shift_square_set_test", direction_shift_square_set_test);
   g_test_add_func("/board/direction_shift_square_set_by_amount_test", direction_shift_square_set_by_amount_test);
 
+  g_test_add_func("/board/legal_move_generator_to_string_test", legal_move_generator_to_string_test);
+  g_test_add_func("/board/legal_move_generator_set_test", legal_move_generator_set_test);
+  g_test_add_func("/board/legal_move_generator_legal_moves_test", legal_move_generator_legal_moves_test);
+
+  g_test_add_func("/board/legal_moves_batch_backend_to_string_test", legal_moves_batch_backend_to_string_test);
+  g_test_add_func("/board/legal_moves_batch_backend_set_test", legal_moves_batch_backend_set_test);
+  g_test_add_func("/board/legal_moves_batch_backend_legal_moves_test", legal_moves_batch_backend_legal_moves_test);
+
+  g_test_add_func("/board/flip_backend_to_string_test", flip_backend_to_string_test);
+  g_test_add_func("/board/flip_backend_set_test", flip_backend_set_test);
+  g_test_add_func("/board/flip_backend_flips_test", flip_backend_flips_test);
+
+  g_test_add_func("/board/board_transformation_to_string_test", board_transformation_to_string_test);
+  g_test_add_func("/board/board_transformation_inverse_test", board_transformation_inverse_test);
+
   g_test_add_func("/board/axis_shift_distance_test", axis_shift_distance_test);
   g_test_add_func("/board/axis_move_ordinal_position_in_bitrow_test", axis_move_ordinal_position_in_bitrow_test);
   g_test_add_func("/board/axis_transform_to_row_one_test", axis_transform_to_row_one_test);
@@ -149,6 +197,8 @@ main (int   argc,
   g_test_add_func("/board/board_print_test", board_print_test);
   g_test_add_func("/board/board_is_move_legal_test", board_is_move_legal_test);
   g_test_add_func("/board/board_legal_moves_test", board_legal_moves_test);
+  g_test_add_func("/board/board_bitrow_changes_for_player_test", board_bitrow_changes_for_player_test);
+  g_test_add_func("/board/board_stable_discs_test", board_stable_discs_test);
 
   g_test_add_func("/board/game_position_print_test", game_position_print_test);
   g_test_add_func("/board/game_position_to_string_test", game_position_to_string_test);
@@ -171,17 +221,102 @@ main (int   argc,
   g_test_add_func("/board/game_position_x_copy_from_gp_test", game_position_x_copy_from_gp_test);
   g_test_add_func("/board/game_position_x_pass_test", game_position_x_pass_test);
   g_test_add_func("/board/game_position_x_hash_test", game_position_x_hash_test);
+  g_test_add_func("/board/game_position_x_delta_hash_test", game_position_x_delta_hash_test);
   g_test_add_func("/board/game_position_x_final_value_test", game_position_x_final_value_test);
+  g_test_add_func("/board/game_position_x_stable_discs_test", game_position_x_stable_discs_test);
+  g_test_add_func("/board/game_position_x_transform_test", game_position_x_transform_test);
+  g_test_add_func("/board/game_position_x_canonical_test", game_position_x_canonical_test);
   g_test_add_func("/board/game_position_x_has_any_legal_move_test", game_position_x_has_any_legal_move_test);
   g_test_add_func("/board/game_position_x_has_any_player_any_legal_move_test", game_position_x_has_any_player_any_legal_move_test);
   g_test_add_func("/board/game_position_x_is_move_legal_test", game_position_x_is_move_legal_test);
   g_test_add_func("/board/game_position_x_make_move_test", game_position_x_make_move_test);
+  g_test_add_func("/board/game_position_x_do_move_test", game_position_x_do_move_test);
+  g_test_add_func("/board/game_position_x_do_pass_test", game_position_x_do_pass_test);
+
+  if (g_test_perf()) {
+    g_test_add_func("/board/legal_move_generator_perf_test", legal_move_generator_perf_test);
+    g_test_add_func("/board/legal_moves_batch_backend_perf_test", legal_moves_batch_backend_perf_test);
+    g_test_add_func("/board/flip_backend_perf_test", flip_backend_perf_test);
+    g_test_add_func("/board/board_bitrow_changes_for_player_perf_test", board_bitrow_changes_for_player_perf_test);
+    g_test_add_func("/board/game_position_x_stable_discs_perf_test", game_position_x_stable_discs_perf_test);
+  }
 
   return g_test_run();
 }
 
 
 
+/*
+ * Internal functions.
+ */
+
+/*
+ * Fills the `positions` array with the game positions met playing random games from the
+ * standard starting position. Returns the number of collected positions, being `size` or less.
+ */
+static int
+collect_random_game_positions (GamePositionX *positions,
+                               const int size,
+                               const int seed)
+{
+  RandomNumberGenerator *rng = rng_new(seed);
+  GamePositionX gpx = { 0x0000000810000000, 0x0000001008000000, BLACK_PLAYER };
+  GamePositionX next;
+  int count = 0;
+  while (count < size) {
+    positions[count++] = gpx;
+    const SquareSet moves = game_position_x_legal_moves(&gpx);
+    if (moves) {
+      game_position_x_make_move(&gpx, square_set_random_selection(rng, moves), &next);
+      gpx = next;
+    } else if (game_position_x_has_any_player_any_legal_move(&gpx)) {
+      game_position_x_pass(&gpx, &next);
+      gpx = next;
+    } else {
+      gpx.blacks = 0x0000000810000000;
+      gpx.whites = 0x0000001008000000;
+      gpx.player = BLACK_PLAYER;
+    }
+  }
+  rng_free(rng);
+  return count;
+}
+
+
+
+/*
+ * Fills the `array`, having 256 * 256 * 8 entries, with the player row after the move.
+ * The index is: player_row | (opponent_row << 8) | (move_position << 16).
+ *
+ * It is the reference implementation of the table formerly used by the board module.
+ */
+static void
+reference_bitrow_changes_for_player_array_init (uint8_t *array)
+{
+  for (int player_row = 0; player_row < 256; player_row++) {
+    for (int opponent_row = 0; opponent_row < 256; opponent_row++) {
+      const uint8_t filled_in_row = player_row | opponent_row;
+      const uint8_t empties_in_row = ~filled_in_row;
+      for (int move_position = 0; move_position < 8; move_position++) {
+        const uint8_t move = 1 << move_position;
+        const int array_index = player_row | (opponent_row << 8) | (move_position << 16);
+        uint8_t player_row_after_move = player_row;
+        if (((player_row & opponent_row) == 0) && ((move & filled_in_row) == 0)) {
+          player_row_after_move = player_row | move;
+          const uint8_t left_rank = bit_works_fill_in_between(bit_works_highest_bit_set_8(player_row & (move - 1)) | move);
+          if ((left_rank & empties_in_row) == 0x00) player_row_after_move |= left_rank;
+          const uint8_t right_rank = bit_works_fill_in_between(bit_works_lowest_bit_set_8(player_row & ~(move - 1)) | move);
+          if ((right_rank & empties_in_row) == 0x00) player_row_after_move |= right_rank;
+          if (player_row_after_move == (player_row | move)) player_row_after_move = player_row;
+        }
+        array[array_index] = player_row_after_move;
+      }
+    }
+  }
+}
+
+
+
 /*
  * Test functions.
  */
@@ -265,6 +400,37 @@ square_is_valid_move_test (void)
   //! [square_is_valid_move usage]
 }
 
+static void
+square_transform_test (void)
+{
+  g_assert(square_transform(A1, BOARD_TRANSFORMATION_IDENTITY) == A1);
+  g_assert(square_transform(A1, BOARD_TRANSFORMATION_ROTATE_90_CLOCKWISE) == H1);
+  g_assert(square_transform(H1, BOARD_TRANSFORMATION_ROTATE_90_CLOCKWISE) == H8);
+  g_assert(square_transform(A1, BOARD_TRANSFORMATION_ROTATE_180) == H8);
+  g_assert(square_transform(B1, BOARD_TRANSFORMATION_ROTATE_180) == G8);
+  g_assert(square_transform(A1, BOARD_TRANSFORMATION_ROTATE_90_ANTICLOCKWISE) == A8);
+  g_assert(square_transform(H1, BOARD_TRANSFORMATION_ROTATE_90_ANTICLOCKWISE) == A1);
+  g_assert(square_transform(B1, BOARD_TRANSFORMATION_FLIP_VERTICAL) == B8);
+  g_assert(square_transform(B1, BOARD_TRANSFORMATION_FLIP_HORIZONTAL) == G1);
+  g_assert(square_transform(B1, BOARD_TRANSFORMATION_FLIP_DIAG_A1_H8) == A2);
+  g_assert(square_transform(C4, BOARD_TRANSFORMATION_FLIP_DIAG_A1_H8) == D3);
+  g_assert(square_transform(A1, BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8) == H8);
+  g_assert(square_transform(B1, BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8) == H7);
+
+  for (BoardTransformation bt = BOARD_TRANSFORMATION_IDENTITY; bt <= BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8; bt++) {
+    g_assert(square_transform(pass_move, bt) == pass_move);
+    g_assert(square_transform(invalid_move, bt) == invalid_move);
+    SquareSet image = empty_square_set;
+    for (Square sq = A1; sq <= H8; sq++) {
+      const Square t = square_transform(sq, bt);
+      g_assert(square_belongs_to_enum_set(t));
+      image |= (SquareSet) 1 << t;
+      g_assert(square_transform(t, board_transformation_inverse(bt)) == sq);
+    }
+    g_assert(image == 0xFFFFFFFFFFFFFFFF);
+  }
+}
+
 
 
 /****************************************/
@@ -403,6 +569,40 @@ square_set_from_array_test (void)
   g_assert_cmpint(computed_2, ==, (SquareSet) 0);
 }
 
+static void
+square_set_transform_test (void)
+{
+  /* Row 1 goes to row 8, column H, column A, and row 1 reversed. */
+  g_assert(square_set_flip_vertical(0x00000000000000FF) == 0xFF00000000000000);
+  g_assert(square_set_rotate_90_clockwise(0x00000000000000FF) == 0x8080808080808080);
+  g_assert(square_set_rotate_90_anticlockwise(0x00000000000000FF) == 0x0101010101010101);
+  g_assert(square_set_flip_horizontal(0x0000000000000001) == 0x0000000000000080);
+  g_assert(square_set_flip_diag_a1_h8(0x8040201008040201) == 0x8040201008040201);
+  g_assert(square_set_flip_diag_h1_a8(0x0102040810204080) == 0x0102040810204080);
+  g_assert(square_set_flip_diag_a1_h8(0x00000000000000FF) == 0x0101010101010101);
+  g_assert(square_set_flip_diag_h1_a8(0x00000000000000FF) == 0x8080808080808080);
+  g_assert(square_set_rotate_180(0x000000000000000F) == 0xF000000000000000);
+
+  RandomNumberGenerator *rng = rng_new(2753);
+  for (int i = 0; i < 1000; i++) {
+    const SquareSet s = rng_random_choice_from_finite_set(rng, 0xFFFFFFFF) | (SquareSet) rng_random_choice_from_finite_set(rng, 0xFFFFFFFF) << 32;
+    const SquareSet r = square_set_rotate_90_clockwise(s);
+    g_assert(square_set_rotate_90_clockwise(square_set_rotate_90_clockwise(square_set_rotate_90_clockwise(r))) == s);
+    g_assert(square_set_rotate_90_clockwise(r) == square_set_rotate_180(s));
+    for (BoardTransformation bt = BOARD_TRANSFORMATION_IDENTITY; bt <= BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8; bt++) {
+      const SquareSet t = square_set_transform(s, bt);
+      g_assert(bit_works_popcount(t) == bit_works_popcount(s));
+      g_assert(square_set_transform(t, board_transformation_inverse(bt)) == s);
+      SquareSet expected = empty_square_set;
+      for (Square sq = A1; sq <= H8; sq++) {
+        if (s & ((SquareSet) 1 << sq)) expected |= (SquareSet) 1 << square_transform(sq, bt);
+      }
+      g_assert(t == expected);
+    }
+  }
+  rng_free(rng);
+}
+
 
 
 /*************************************/
@@ -438,6 +638,373 @@ player_opponent_test (void)
 
 
 
+/*************************************************/
+/* Unit tests for the LegalMoveGenerator entity. */
+/*************************************************/
+
+static void
+legal_move_generator_to_string_test (void)
+{
+  g_assert(g_strcmp0("wave", legal_move_generator_to_string(LEGAL_MOVE_GENERATOR_WAVE)) == 0);
+  g_assert(g_strcmp0("kogge-stone", legal_move_generator_to_string(LEGAL_MOVE_GENERATOR_KOGGE_STONE)) == 0);
+  g_assert(g_strcmp0("kogge-stone-avx2", legal_move_generator_to_string(LEGAL_MOVE_GENERATOR_KOGGE_STONE_AVX2)) == 0);
+}
+
+static void
+legal_move_generator_set_test (void)
+{
+  const LegalMoveGenerator selected = legal_move_generator_get();
+  g_assert(legal_move_generator_is_available(selected));
+
+  g_assert(legal_move_generator_is_available(LEGAL_MOVE_GENERATOR_WAVE));
+  g_assert(legal_move_generator_is_available(LEGAL_MOVE_GENERATOR_KOGGE_STONE));
+
+  for (LegalMoveGenerator lmg = LEGAL_MOVE_GENERATOR_WAVE; lmg <= LEGAL_MOVE_GENERATOR_KOGGE_STONE_AVX2; lmg++) {
+    const gboolean available = legal_move_generator_is_available(lmg);
+    g_assert(available == legal_move_generator_set(lmg));
+    if (available) {
+      g_assert(lmg == legal_move_generator_get());
+      GamePositionX gpx = { 0x0000000810000000, 0x0000001008000000, BLACK_PLAYER };
+      g_assert(0x0000102004080000 == game_position_x_legal_moves(&gpx));
+    }
+  }
+
+  g_assert(legal_move_generator_set(selected));
+}
+
+static void
+legal_move_generator_legal_moves_test (void)
+{
+  const int size = 100000;
+  GamePositionX *positions = malloc(size * sizeof(GamePositionX));
+  g_assert(positions);
+
+  const int count = collect_random_game_positions(positions, size, 7531);
+
+  for (int i = 0; i < count; i++) {
+    const SquareSet p = game_position_x_get_player(&positions[i]);
+    const SquareSet o = game_position_x_get_opponent(&positions[i]);
+    const SquareSet expected = legal_move_generator_legal_moves(LEGAL_MOVE_GENERATOR_WAVE, p, o);
+    const SquareSet expected_edges = legal_move_generator_legal_moves(LEGAL_MOVE_GENERATOR_WAVE, p, o & 0x8181818181818181);
+    for (LegalMoveGenerator lmg = LEGAL_MOVE_GENERATOR_KOGGE_STONE; lmg <= LEGAL_MOVE_GENERATOR_KOGGE_STONE_AVX2; lmg++) {
+      if (!legal_move_generator_is_available(lmg)) continue;
+      g_assert(expected == legal_move_generator_legal_moves(lmg, p, o));
+      g_assert(expected_edges == legal_move_generator_legal_moves(lmg, p, o & 0x8181818181818181));
+    }
+  }
+
+  free(positions);
+}
+
+static void
+legal_move_generator_perf_test (void)
+{
+  const int size = 1000000;
+  const int repeats = 10;
+  GamePositionX *positions = malloc(size * sizeof(GamePositionX));
+  g_assert(positions);
+
+  const int count = collect_random_game_positions(positions, size, 2468);
+
+  for (LegalMoveGenerator lmg = LEGAL_MOVE_GENERATOR_WAVE; lmg <= LEGAL_MOVE_GENERATOR_KOGGE_STONE_AVX2; lmg++) {
+    if (!legal_move_generator_is_available(lmg)) continue;
+    SquareSet checksum = empty_square_set;
+    g_test_timer_start();
+    for (int r = 0; r < repeats; r++) {
+      for (int i = 0; i < count; i++) {
+        checksum += legal_move_generator_legal_moves(lmg, positions[i].blacks, positions[i].whites);
+      }
+    }
+    const double elapsed = g_test_timer_elapsed();
+    g_test_minimized_result(elapsed, "Legal move generator %s: %d calls in %f seconds, %.1f Mcalls/s [checksum=%016llx]",
+                            legal_move_generator_to_string(lmg), count * repeats, elapsed,
+                            (count * repeats) / elapsed / 1.0e6, checksum);
+  }
+
+  free(positions);
+}
+
+
+
+/*****************************************************/
+/* Unit tests for the LegalMovesBatchBackend entity. */
+/*****************************************************/
+
+static void
+legal_moves_batch_backend_to_string_test (void)
+{
+  g_assert(g_strcmp0("scalar", legal_moves_batch_backend_to_string(LEGAL_MOVES_BATCH_SCALAR)) == 0);
+  g_assert(g_strcmp0("avx2", legal_moves_batch_backend_to_string(LEGAL_MOVES_BATCH_AVX2)) == 0);
+  g_assert(g_strcmp0("avx512", legal_moves_batch_backend_to_string(LEGAL_MOVES_BATCH_AVX512)) == 0);
+}
+
+static void
+legal_moves_batch_backend_set_test (void)
+{
+  const LegalMovesBatchBackend selected = legal_moves_batch_backend_get();
+  g_assert(legal_moves_batch_backend_is_available(selected));
+
+  g_assert(legal_moves_batch_backend_is_available(LEGAL_MOVES_BATCH_SCALAR));
+
+  const SquareSet p[] = { 0x0000000810000000, 0x0000001008000000 };
+  const SquareSet o[] = { 0x0000001008000000, 0x0000000810000000 };
+  for (LegalMovesBatchBackend lmbb = LEGAL_MOVES_BATCH_SCALAR; lmbb <= LEGAL_MOVES_BATCH_AVX512; lmbb++) {
+    const gboolean available = legal_moves_batch_backend_is_available(lmbb);
+    g_assert(available == legal_moves_batch_backend_set(lmbb));
+    if (available) {
+      g_assert(lmbb == legal_moves_batch_backend_get());
+      SquareSet legal_moves[2];
+      int mobility[2];
+      game_position_x_legal_moves_batch(2, p, o, legal_moves, mobility);
+      g_assert(0x0000102004080000 == legal_moves[0]);
+      g_assert(0x0000080420100000 == legal_moves[1]);
+      g_assert(4 == mobility[0]);
+      g_assert(4 == mobility[1]);
+    }
+  }
+
+  g_assert(legal_moves_batch_backend_set(selected));
+}
+
+static void
+legal_moves_batch_backend_legal_moves_test (void)
+{
+  const int size = 100003;
+  GamePositionX *positions = malloc(size * sizeof(GamePositionX));
+  SquareSet *p = malloc(size * sizeof(SquareSet));
+  SquareSet *o = malloc(size * sizeof(SquareSet));
+  SquareSet *legal_moves = malloc(size * sizeof(SquareSet));
+  int *mobility = malloc(size * sizeof(int));
+  g_assert(positions && p && o && legal_moves && mobility);
+
+  const int count = collect_random_game_positions(positions, size, 8642);
+  for (int i = 0; i < count; i++) {
+    p[i] = game_position_x_get_player(&positions[i]);
+    o[i] = game_position_x_get_opponent(&positions[i]);
+  }
+
+  for (LegalMovesBatchBackend lmbb = LEGAL_MOVES_BATCH_SCALAR; lmbb <= LEGAL_MOVES_BATCH_AVX512; lmbb++) {
+    if (!legal_moves_batch_backend_is_available(lmbb)) continue;
+
+    /* Batch sizes not multiple of the vector width exercise the scalar tail. */
+    for (int batch_size = 0; batch_size <= 17; batch_size++) {
+      for (int i = 0; i < batch_size; i++) legal_moves[i] = 0xFFFFFFFFFFFFFFFF;
+      legal_moves_batch_backend_legal_moves(lmbb, batch_size, p + 1, o + 1, legal_moves, NULL);
+      for (int i = 0; i < batch_size; i++) {
+        g_assert(legal_moves[i] == legal_move_generator_legal_moves(LEGAL_MOVE_GENERATOR_WAVE, p[i + 1], o[i + 1]));
+      }
+    }
+
+    legal_moves_batch_backend_legal_moves(lmbb, count, p, o, legal_moves, mobility);
+    for (int i = 0; i < count; i++) {
+      const SquareSet expected = legal_move_generator_legal_moves(LEGAL_MOVE_GENERATOR_WAVE, p[i], o[i]);
+      g_assert(expected == legal_moves[i]);
+      g_assert(bit_works_popcount(expected) == mobility[i]);
+    }
+  }
+
+  free(mobility);
+  free(legal_moves);
+  free(o);
+  free(p);
+  free(positions);
+}
+
+static void
+legal_moves_batch_backend_perf_test (void)
+{
+  const int size = 1000000;
+  const int repeats = 10;
+  GamePositionX *positions = malloc(size * sizeof(GamePositionX));
+  SquareSet *p = malloc(size * sizeof(SquareSet));
+  SquareSet *o = malloc(size * sizeof(SquareSet));
+  SquareSet *legal_moves = malloc(size * sizeof(SquareSet));
+  int *mobility = malloc(size * sizeof(int));
+  g_assert(positions && p && o && legal_moves && mobility);
+
+  const int count = collect_random_game_positions(positions, size, 1357);
+  for (int i = 0; i < count; i++) {
+    p[i] = game_position_x_get_player(&positions[i]);
+    o[i] = game_position_x_get_opponent(&positions[i]);
+  }
+
+  /* The baseline is the one position at a time call. */
+  SquareSet checksum = empty_square_set;
+  g_test_timer_start();
+  for (int r = 0; r < repeats; r++) {
+    for (int i = 0; i < count; i++) {
+      checksum += game_position_x_legal_moves(&positions[i]);
+    }
+  }
+  double elapsed = g_test_timer_elapsed();
+  g_test_minimized_result(elapsed, "Legal moves one at a time: %d positions in %f seconds, %.1f Mpositions/s [checksum=%016llx]",
+                          count * repeats, elapsed, (count * repeats) / elapsed / 1.0e6, checksum);
+
+  for (LegalMovesBatchBackend lmbb = LEGAL_MOVES_BATCH_SCALAR; lmbb <= LEGAL_MOVES_BATCH_AVX512; lmbb++) {
+    if (!legal_moves_batch_backend_is_available(lmbb)) continue;
+    for (int with_mobility = 0; with_mobility <= 1; with_mobility++) {
+      checksum = empty_square_set;
+      g_test_timer_start();
+      for (int r = 0; r < repeats; r++) {
+        legal_moves_batch_backend_legal_moves(lmbb, count, p, o, legal_moves, with_mobility ? mobility : NULL);
+        checksum += legal_moves[r];
+      }
+      elapsed = g_test_timer_elapsed();
+      g_test_minimized_result(elapsed, "Legal moves batch %s%s: %d positions in %f seconds, %.1f Mpositions/s [checksum=%016llx]",
+                              legal_moves_batch_backend_to_string(lmbb), with_mobility ? " with mobility" : "",
+                              count * repeats, elapsed, (count * repeats) / elapsed / 1.0e6, checksum);
+    }
+  }
+
+  free(mobility);
+  free(legal_moves);
+  free(o);
+  free(p);
+  free(positions);
+}
+
+
+
+/******************************************/
+/* Unit tests for the FlipBackend entity. */
+/******************************************/
+
+static void
+flip_backend_to_string_test (void)
+{
+  g_assert(g_strcmp0("bitrow-table", flip_backend_to_string(FLIP_BACKEND_BITROW_TABLE)) == 0);
+  g_assert(g_strcmp0("kogge-stone", flip_backend_to_string(FLIP_BACKEND_KOGGE_STONE)) == 0);
+  g_assert(g_strcmp0("carry", flip_backend_to_string(FLIP_BACKEND_CARRY)) == 0);
+  g_assert(g_strcmp0("per-square", flip_backend_to_string(FLIP_BACKEND_PER_SQUARE)) == 0);
+}
+
+static void
+flip_backend_set_test (void)
+{
+  const FlipBackend selected = flip_backend_get();
+
+  for (FlipBackend fb = FLIP_BACKEND_BITROW_TABLE; fb <= FLIP_BACKEND_PER_SQUARE; fb++) {
+    flip_backend_set(fb);
+    g_assert(fb == flip_backend_get());
+    GamePositionX current = { 0x0000000000000002, 0x0000000000000004, WHITE_PLAYER };
+    GamePositionX updated;
+    g_assert(0x0000000000000002 == game_position_x_flips(&current, 0));
+    game_position_x_make_move(&current, 0, &updated);
+    g_assert(0x0000000000000000 == updated.blacks);
+    g_assert(0x0000000000000007 == updated.whites);
+    g_assert(BLACK_PLAYER == updated.player);
+  }
+
+  flip_backend_set(selected);
+}
+
+static void
+flip_backend_flips_test (void)
+{
+  const int size = 20000;
+  GamePositionX *positions = malloc(size * sizeof(GamePositionX));
+  g_assert(positions);
+
+  const int count = collect_random_game_positions(positions, size, 8642);
+
+  for (int i = 0; i < count; i++) {
+    const SquareSet p = game_position_x_get_player(&positions[i]);
+    const SquareSet o = game_position_x_get_opponent(&positions[i]);
+    const SquareSet legal_moves = game_position_x_legal_moves(&positions[i]);
+    const SquareSet empties = game_position_x_empties(&positions[i]);
+    for (Square sq = A1; sq <= H8; sq++) {
+      const SquareSet sq_bit = (SquareSet) 1 << sq;
+      if (!(sq_bit & empties)) continue;
+      const SquareSet expected = flip_backend_flips(FLIP_BACKEND_BITROW_TABLE, p, o, sq);
+      g_assert((expected != empty_square_set) == ((legal_moves & sq_bit) != empty_square_set));
+      g_assert((expected & o) == expected);
+      for (FlipBackend fb = FLIP_BACKEND_KOGGE_STONE; fb <= FLIP_BACKEND_PER_SQUARE; fb++) {
+        g_assert(expected == flip_backend_flips(fb, p, o, sq));
+      }
+    }
+  }
+
+  free(positions);
+}
+
+static void
+flip_backend_perf_test (void)
+{
+  const int size = 200000;
+  const int repeats = 10;
+  GamePositionX *positions = malloc(size * sizeof(GamePositionX));
+  g_assert(positions);
+
+  const int count = collect_random_game_positions(positions, size, 1357);
+
+  int move_count = 0;
+  for (int i = 0; i < count; i++) move_count += bit_works_popcount(game_position_x_legal_moves(&positions[i]));
+
+  SquareSet *p_bit_boards = malloc(move_count * sizeof(SquareSet));
+  SquareSet *o_bit_boards = malloc(move_count * sizeof(SquareSet));
+  Square *moves = malloc(move_count * sizeof(Square));
+  g_assert(p_bit_boards && o_bit_boards && moves);
+
+  int k = 0;
+  for (int i = 0; i < count; i++) {
+    SquareSet legal_moves = game_position_x_legal_moves(&positions[i]);
+    while (legal_moves) {
+      const Square move = bit_works_bitscanLS1B_64(legal_moves);
+      legal_moves &= legal_moves - 1;
+      p_bit_boards[k] = game_position_x_get_player(&positions[i]);
+      o_bit_boards[k] = game_position_x_get_opponent(&positions[i]);
+      moves[k] = move;
+      k++;
+    }
+  }
+
+  for (FlipBackend fb = FLIP_BACKEND_BITROW_TABLE; fb <= FLIP_BACKEND_PER_SQUARE; fb++) {
+    SquareSet checksum = empty_square_set;
+    g_test_timer_start();
+    for (int r = 0; r < repeats; r++) {
+      for (int j = 0; j < move_count; j++) {
+        checksum += flip_backend_flips(fb, p_bit_boards[j], o_bit_boards[j], moves[j]);
+      }
+    }
+    const double elapsed = g_test_timer_elapsed();
+    g_test_minimized_result(elapsed, "Flip backend %s: %d calls in %f seconds, %.1f Mcalls/s [checksum=%016llx]",
+                            flip_backend_to_string(fb), move_count * repeats, elapsed,
+                            (move_count * repeats) / elapsed / 1.0e6, checksum);
+  }
+
+  free(p_bit_boards);
+  free(o_bit_boards);
+  free(moves);
+  free(positions);
+}
+
+
+
+/**************************************************/
+/* Unit tests for the BoardTransformation entity. */
+/**************************************************/
+
+static void
+board_transformation_to_string_test (void)
+{
+  g_assert(g_strcmp0("identity", board_transformation_to_string(BOARD_TRANSFORMATION_IDENTITY)) == 0);
+  g_assert(g_strcmp0("rotate-180", board_transformation_to_string(BOARD_TRANSFORMATION_ROTATE_180)) == 0);
+  g_assert(g_strcmp0("flip-diag-h1-a8", board_transformation_to_string(BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8)) == 0);
+}
+
+static void
+board_transformation_inverse_test (void)
+{
+  g_assert(board_transformation_inverse(BOARD_TRANSFORMATION_ROTATE_90_CLOCKWISE) == BOARD_TRANSFORMATION_ROTATE_90_ANTICLOCKWISE);
+  g_assert(board_transformation_inverse(BOARD_TRANSFORMATION_ROTATE_90_ANTICLOCKWISE) == BOARD_TRANSFORMATION_ROTATE_90_CLOCKWISE);
+  g_assert(board_transformation_inverse(BOARD_TRANSFORMATION_FLIP_DIAG_A1_H8) == BOARD_TRANSFORMATION_FLIP_DIAG_A1_H8);
+  for (BoardTransformation bt = BOARD_TRANSFORMATION_IDENTITY; bt <= BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8; bt++) {
+    g_assert(board_transformation_inverse(board_transformation_inverse(bt)) == bt);
+  }
+}
+
+
+
 /***********************************/
 /* Unit tests for the Axis entity. */
 /***********************************/
@@ -787,6 +1354,289 @@ board_legal_moves_test (void)
   board_free(b);
 }
 
+static void
+board_bitrow_changes_for_player_test (void)
+{
+  uint8_t *expected = malloc(256 * 256 * 8);
+  g_assert(expected);
+  reference_bitrow_changes_for_player_array_init(expected);
+
+  for (int player_row = 0; player_row < 256; player_row++) {
+    for (int opponent_row = 0; opponent_row < 256; opponent_row++) {
+      for (int move_position = 0; move_position < 8; move_position++) {
+        const int array_index = player_row | (opponent_row << 8) | (move_position << 16);
+        g_assert(expected[array_index] == board_bitrow_changes_for_player(player_row, opponent_row, move_position));
+      }
+    }
+  }
+
+  free(expected);
+}
+
+static void
+board_bitrow_changes_for_player_perf_test (void)
+{
+  const int size = 1 << 20;
+  const int repeats = 10;
+
+  /*
+   * Lookups are chained, each index depending on the previous result, and interleaved with reads
+   * into a 1.5MB buffer, that stands for the working set of a solver. Together with the reference
+   * table it overflows a 2MB L2 cache, while the compact tables leave it fitting. The benchmark
+   * exposes the latency of the cache misses caused by the table size.
+   */
+  const int working_set_size = 3 << 19;
+
+  uint8_t *reference_array = malloc(256 * 256 * 8);
+  uint8_t *working_set = malloc(working_set_size);
+  int *indexes = malloc(size * sizeof(int));
+  g_assert(reference_array && working_set && indexes);
+
+  /* The initialization of the reference table was executed by board_module_init at each process start. */
+  g_test_timer_start();
+  reference_bitrow_changes_for_player_array_init(reference_array);
+  double elapsed = g_test_timer_elapsed();
+  g_test_minimized_result(elapsed, "Reference 512kB table initialization: %f seconds", elapsed);
+
+  /* Random legal configurations: rows don't overlap and the move square is empty. */
+  RandomNumberGenerator *rng = rng_new(1122);
+  for (int i = 0; i < size; i++) {
+    const int move_position = rng_random_choice_from_finite_set(rng, 8);
+    const uint8_t filled = rng_random_choice_from_finite_set(rng, 256) & ~(1 << move_position);
+    const uint8_t player_row = filled & rng_random_choice_from_finite_set(rng, 256);
+    const uint8_t opponent_row = filled & ~player_row;
+    indexes[i] = player_row | (opponent_row << 8) | (move_position << 16);
+  }
+  for (int i = 0; i < working_set_size; i++) working_set[i] = rng_random_choice_from_finite_set(rng, 2);
+  rng_free(rng);
+
+  unsigned int checksum = 0;
+  g_test_timer_start();
+  for (int r = 0; r < repeats; r++) {
+    for (int i = 0; i < size; i++) {
+      const int index = indexes[i] ^ (checksum & 1);
+      checksum += reference_array[index];
+      checksum += working_set[(indexes[i] * 2654435761u + checksum) % working_set_size];
+    }
+  }
+  elapsed = g_test_timer_elapsed();
+  g_test_minimized_result(elapsed, "Reference 512kB table: %d lookups in %f seconds, %.1f Mlookups/s [checksum=%u]",
+                          size * repeats, elapsed, (size * repeats) / elapsed / 1.0e6, checksum);
+
+  checksum = 0;
+  g_test_timer_start();
+  for (int r = 0; r < repeats; r++) {
+    for (int i = 0; i < size; i++) {
+      const int index = indexes[i] ^ (checksum & 1);
+      checksum += board_bitrow_changes_for_player(index & 0xFF, (index >> 8) & 0xFF, index >> 16);
+      checksum += working_set[(indexes[i] * 2654435761u + checksum) % working_set_size];
+    }
+  }
+  elapsed = g_test_timer_elapsed();
+  g_test_minimized_result(elapsed, "Compact 2.5kB tables: %d lookups in %f seconds, %.1f Mlookups/s [checksum=%u]",
+                          size * repeats, elapsed, (size * repeats) / elapsed / 1.0e6, checksum);
+
+  free(indexes);
+  free(working_set);
+  free(reference_array);
+}
+
+static void
+board_stable_discs_test (void)
+{
+  Board *b;
+
+  b = board_new(0x0000000810000000, 0x0000001008000000);
+  g_assert(empty_square_set == board_stable_discs(b));
+  board_free(b);
+
+  b = board_new(0xFFFFFFFF00000000, 0x00000000FFFFFFFF);
+  g_assert(0xFFFFFFFFFFFFFFFF == board_stable_discs(b));
+  board_free(b);
+
+  /* Corners are always stable. */
+  b = board_new(0x8000000000000001, 0x0100000000000080);
+  g_assert(0x8100000000000081 == board_stable_discs(b));
+  board_free(b);
+
+  /* A run of discs from the corner along an edge is stable, the one beyond the gap is not. */
+  b = board_new(0x0000000000000017, 0x0000000000000000);
+  g_assert(0x0000000000000007 == board_stable_discs(b));
+  board_free(b);
+
+  /* The same holds for the columns, discs of the other color next to a corner can be flipped. */
+  b = board_new(0x0000000001010101, 0x8000000000000000);
+  g_assert(0x8000000001010101 == board_stable_discs(b));
+  board_free(b);
+  b = board_new(0x0080800000000000, 0x8000000000000000);
+  g_assert(0x8000000000000000 == board_stable_discs(b));
+  board_free(b);
+
+  /* A full edge is stable whatever the colors. */
+  b = board_new(0x00000000000000AA, 0x0000000000000055);
+  g_assert(0x00000000000000FF == board_stable_discs(b));
+  board_free(b);
+
+  /* B2 is stable when backed by stable discs in every direction, B3 and C3 are not. */
+  b = board_new(0x0000000000070303, 0x0000000000000000);
+  g_assert(0x0000000000010303 == board_stable_discs(b));
+  board_free(b);
+
+  /* Without the corner nothing is stable. */
+  b = board_new(0x0000000000070302, 0x0000000000000000);
+  g_assert(empty_square_set == board_stable_discs(b));
+  board_free(b);
+}
+
+static void
+game_position_x_stable_discs_test (void)
+{
+  const int size = 20000;
+  const int game_count = 8;
+  GamePositionX *positions = malloc(size * sizeof(GamePositionX));
+  g_assert(positions);
+
+  const int count = collect_random_game_positions(positions, size, 9731);
+  RandomNumberGenerator *rng = rng_new(4217);
+  int stable_disc_count = 0;
+
+  for (int i = 0; i < count; i++) {
+    const SquareSet stable = game_position_x_stable_discs(&positions[i]);
+    stable_disc_count += bit_works_popcount(stable);
+    g_assert((stable & ~(positions[i].blacks | positions[i].whites)) == empty_square_set);
+    const SquareSet stable_blacks = stable & positions[i].blacks;
+    const SquareSet stable_whites = stable & positions[i].whites;
+    for (int j = 0; j < game_count; j++) {
+      GamePositionX gpx = positions[i];
+      for (;;) {
+        const SquareSet moves = game_position_x_legal_moves(&gpx);
+        if (moves) {
+          game_position_x_do_move(&gpx, square_set_random_selection(rng, moves));
+        } else if (game_position_x_has_any_player_any_legal_move(&gpx)) {
+          game_position_x_do_pass(&gpx);
+        } else {
+          break;
+        }
+        g_assert((gpx.blacks & stable_blacks) == stable_blacks);
+        g_assert((gpx.whites & stable_whites) == stable_whites);
+      }
+    }
+  }
+  g_assert(stable_disc_count > count);
+
+  rng_free(rng);
+  free(positions);
+}
+
+static void
+game_position_x_transform_test (void)
+{
+  const int size = 20000;
+  GamePositionX *positions = malloc(size * sizeof(GamePositionX));
+  g_assert(positions);
+
+  const int count = collect_random_game_positions(positions, size, 6173);
+
+  for (int i = 0; i < count; i++) {
+    const GamePositionX *const gpx = &positions[i];
+    const SquareSet moves = game_position_x_legal_moves(gpx);
+    for (BoardTransformation bt = BOARD_TRANSFORMATION_IDENTITY; bt <= BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8; bt++) {
+      GamePositionX t, back;
+      game_position_x_transform(gpx, bt, &t);
+      g_assert(t.player == gpx->player);
+      g_assert(game_position_x_count_difference(&t) == game_position_x_count_difference(gpx));
+      g_assert(game_position_x_legal_moves(&t) == square_set_transform(moves, bt));
+      game_position_x_transform(&t, board_transformation_inverse(bt), &back);
+      g_assert(game_position_x_compare(&back, gpx) == 0);
+    }
+  }
+
+  free(positions);
+}
+
+static void
+game_position_x_canonical_test (void)
+{
+  GamePositionX initial = { 0x0000000810000000, 0x0000001008000000, BLACK_PLAYER };
+  GamePositionX canonical;
+  GamePositionX after_move;
+  GamePositionX expected;
+
+  /* The four first moves lead to the same canonical position. */
+  game_position_x_make_move(&initial, D3, &after_move);
+  game_position_x_canonical(&after_move, &expected);
+  const Square first_moves[] = { C4, E6, F5 };
+  for (int i = 0; i < 3; i++) {
+    game_position_x_make_move(&initial, first_moves[i], &after_move);
+    game_position_x_canonical(&after_move, &canonical);
+    g_assert(game_position_x_compare(&canonical, &expected) == 0);
+  }
+
+  const int size = 20000;
+  GamePositionX *positions = malloc(size * sizeof(GamePositionX));
+  g_assert(positions);
+
+  const int count = collect_random_game_positions(positions, size, 3821);
+
+  for (int i = 0; i < count; i++) {
+    const GamePositionX *const gpx = &positions[i];
+    const BoardTransformation bt = game_position_x_canonical(gpx, &canonical);
+    GamePositionX t;
+    game_position_x_transform(gpx, bt, &t);
+    g_assert(game_position_x_compare(&t, &canonical) == 0);
+
+    /* The canonical form is a fixed point, and it is shared by all the symmetric positions. */
+    GamePositionX c;
+    game_position_x_canonical(&canonical, &c);
+    g_assert(game_position_x_compare(&c, &canonical) == 0);
+    for (BoardTransformation s = BOARD_TRANSFORMATION_IDENTITY; s <= BOARD_TRANSFORMATION_FLIP_DIAG_H1_A8; s++) {
+      game_position_x_transform(gpx, s, &t);
+      g_assert(game_position_x_compare(&t, &canonical) >= 0);
+      game_position_x_canonical(&t, &c);
+      g_assert(game_position_x_compare(&c, &canonical) == 0);
+    }
+
+    /* Moves mapped to the canonical position lead to the canonical form of the child position. */
+    SquareSet moves = game_position_x_legal_moves(gpx);
+    while (moves) {
+      const Square move = bit_works_bitscanLS1B_64(moves);
+      moves &= moves - 1;
+      GamePositionX child, canonical_child;
+      game_position_x_make_move(gpx, move, &child);
+      game_position_x_canonical(&child, &expected);
+      game_position_x_make_move(&canonical, square_transform(move, bt), &child);
+      game_position_x_canonical(&child, &canonical_child);
+      g_assert(game_position_x_compare(&canonical_child, &expected) == 0);
+    }
+  }
+
+  free(positions);
+}
+
+static void
+game_position_x_stable_discs_perf_test (void)
+{
+  const int size = 1000000;
+  const int repeats = 10;
+  GamePositionX *positions = malloc(size * sizeof(GamePositionX));
+  g_assert(positions);
+
+  const int count = collect_random_game_positions(positions, size, 3579);
+
+  SquareSet checksum = empty_square_set;
+  g_test_timer_start();
+  for (int r = 0; r < repeats; r++) {
+    for (int i = 0; i < count; i++) {
+      checksum += game_position_x_stable_discs(&positions[i]);
+    }
+  }
+  const double elapsed = g_test_timer_elapsed();
+  g_test_minimized_result(elapsed, "Stable discs: %d calls in %f seconds, %.1f Mcalls/s [checksum=%016llx]",
+                          count * repeats, elapsed, (count * repeats) / elapsed / 1.0e6, checksum);
+
+  free(positions);
+}
+
 static void
 game_position_compare_test (void)
 {
@@ -1243,6 +2093,35 @@ game_position_x_hash_test (void)
   game_position_x_free(gpx);
 }
 
+static void
+game_position_x_delta_hash_test (void)
+{
+  const int size = 10000;
+  GamePositionX *positions = malloc(size * sizeof(GamePositionX));
+  g_assert(positions);
+
+  const int count = collect_random_game_positions(positions, size, 9753);
+
+  for (int i = 0; i < count; i++) {
+    GamePositionX gpx = positions[i];
+    const uint64_t hash = game_position_x_hash(&gpx);
+    game_position_x_do_pass(&gpx);
+    g_assert(~hash == game_position_x_hash(&gpx));
+    game_position_x_undo_pass(&gpx);
+    SquareSet legal_moves = game_position_x_legal_moves(&gpx);
+    while (legal_moves) {
+      const Square move = bit_works_bitscanLS1B_64(legal_moves);
+      legal_moves &= legal_moves - 1;
+      const Player player = gpx.player;
+      const SquareSet flips = game_position_x_do_move(&gpx, move);
+      g_assert(game_position_x_hash(&gpx) == game_position_x_delta_hash(hash, flips, move, player));
+      game_position_x_undo_move(&gpx, move, flips);
+    }
+  }
+
+  free(positions);
+}
+
 static void
 game_position_x_final_value_test (void)
 {
@@ -1384,3 +2263,60 @@ game_position_x_make_move_test (void)
   game_position_x_free(updated);
   game_position_x_free(expected);
 }
+
+static void
+game_position_x_do_move_test (void)
+{
+  GamePositionX gpx = { 0x0000000000000002, 0x0000000000000004, WHITE_PLAYER };
+
+  const SquareSet flips = game_position_x_do_move(&gpx, 0);
+  g_assert(0x0000000000000002 == flips);
+  g_assert(0x0000000000000000 == gpx.blacks);
+  g_assert(0x0000000000000007 == gpx.whites);
+  g_assert(BLACK_PLAYER == gpx.player);
+
+  game_position_x_undo_move(&gpx, 0, flips);
+  g_assert(0x0000000000000002 == gpx.blacks);
+  g_assert(0x0000000000000004 == gpx.whites);
+  g_assert(WHITE_PLAYER == gpx.player);
+
+  const int size = 10000;
+  GamePositionX *positions = malloc(size * sizeof(GamePositionX));
+  g_assert(positions);
+
+  const int count = collect_random_game_positions(positions, size, 4321);
+
+  for (int i = 0; i < count; i++) {
+    GamePositionX current = positions[i];
+    GamePositionX expected;
+    SquareSet legal_moves = game_position_x_legal_moves(&current);
+    while (legal_moves) {
+      const Square move = bit_works_bitscanLS1B_64(legal_moves);
+      legal_moves &= legal_moves - 1;
+      game_position_x_make_move(&positions[i], move, &expected);
+      const SquareSet f = game_position_x_do_move(&current, move);
+      g_assert(f == game_position_x_flips(&positions[i], move));
+      g_assert(0 == game_position_x_compare(&expected, &current));
+      game_position_x_undo_move(&current, move, f);
+      g_assert(0 == game_position_x_compare(&positions[i], &current));
+    }
+  }
+
+  free(positions);
+}
+
+static void
+game_position_x_do_pass_test (void)
+{
+  GamePositionX gpx = { 0x0000000000000002, 0x0000000000000004, WHITE_PLAYER };
+
+  game_position_x_do_pass(&gpx);
+  g_assert(0x0000000000000002 == gpx.blacks);
+  g_assert(0x0000000000000004 == gpx.whites);
+  g_assert(BLACK_PLAYER == gpx.player);
+
+  game_position_x_undo_pass(&gpx);
+  g_assert(0x0000000000000002 == gpx.blacks);
+  g_assert(0x0000000000000004 == gpx.whites);
+  g_assert(WHITE_PLAYER == gpx.player);
+}
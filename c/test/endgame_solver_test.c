@@ -33,6 +33,8 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
 
 #include <glib.h>
 
@@ -43,6 +45,13 @@
 #include "improved_fast_endgame_solver.h"
 #include "minimax_solver.h"
 #include "ab_solver.h"
+#include "rab_solver.h"
+#include "pab_solver.h"
+#include "transposition_table.h"
+#include "lock_free_hash_table.h"
+#include "random_game_sampler.h"
+#include "mcts_solver.h"
+#include "solver_context.h"
 
 
 /**
@@ -88,7 +97,7 @@ const TestCase ffo_01_19[] =
     { "ffo-01", 1, +18, { G8 } }, // ffo-01;..bbbbb..wwwbb.w.wwwbbwb.wbwbwbbwbbbwbbb..bwbwbb.bbbwww..wwwww..;b; G8:+18. H1:+12. H7:+6. A2:+6. A3:+4. B1:-4. A4:-22. G2:-24.;
     { "ffo-02", 1, +10, { A4 } }, // ffo-02;.bbbbbb...bwwww..bwbbwwb.wwwwwwwwwwwbbwwwwwbbwwb..bbww....bbbbb.;b; A4:+10. B2:+0. A3:-6. G7:-8. A7:-12. H7:-14. B7:-14. H2:-24.;
     { "ffo-03", 1,  +2, { D1 } }, // ffo-03;....wb....wwbb...wwwbb.bwwbbwwwwwbbwbbwwwbbbwwwwwbbbbwbw..wwwwwb;b; D1:+2. G3:+0. B8:-2. B1:-4. C1:-4. A2:-4. A3:-6. B2:-12.;
-    { "ffo-04", 1,  +0, { H8 } }, // ffo-04;.bbbbbb.b.bbbww.bwbbbwwbbbwbwwwb.wbwwbbb..wwwbbb..wwbb....bwbbw.;b; H8:+0. A5:+0. B6:-4. B7:-4. A6:-8. B2:-12. H2:-26.;
+    { "ffo-04", 2,  +0, { H8, A5 } }, // ffo-04;.bbbbbb.b.bbbww.bwbbbwwbbbwbwwwb.wbwwbbb..wwwbbb..wwbb....bwbbw.;b; H8:+0. A5:+0. B6:-4. B7:-4. A6:-8. B2:-12. H2:-26.;
     { "ffo-05", 1, +32, { G8 } }, // ffo-05;.wwwww....wbbw.bbbwbwbb.bbwbwbbwbbwwbwwwbbbbww.wb.bwww...bbbbb..;b; G8:+32. G2:+12. B2:-20. G6:-26. G1:-32. G7:-34.;
     { "ffo-06", 1, +14, { A1 } }, // ffo-06;..wbbb..wwwbbb..wwwbwbw.wwbwwwb.wwbbbbbbbwwbbwb..wwwwb...bbbbbb.;b; A1:+14. H3:+14. A8:+12. H2:+8. G2:+8. H4:+4. G7:+4. A7:-22. B1:-24.;
     { "ffo-07", 1,  +8, { A6 } }, // ffo-07;..wbbw..bwbbbb..bwwwbbbbbwwbbbbbbwwwwbbb.bbbbbbb..bbwww....bbww.;b; A6:+8. G1:+0. A1:-2. H8:-6. H7:-14. B1:-30.;
@@ -107,6 +116,17 @@ const TestCase ffo_01_19[] =
     {NULL, 0, 0, {A1}}
   };
 
+/**
+ * @brief A win, a draw, and a loss, taken from the French Federation Othello game positions.
+ */
+const TestCase ffo_wld[] =
+  {
+    { "ffo-03", 1,  +2, { D1 } },
+    { "ffo-04", 2,  +0, { H8, A5 } },
+    { "ffo-09", 1,  -8, { A4 } },
+    {NULL, 0, 0, {A1}}
+  };
+
 /**
  * @brief Expected results for test cases coming from French Federation Othello game positions, from number 20 to 29.
  */
@@ -234,6 +254,70 @@ static void
 game_position_ab_solve_test (GamePositionDbFixture *fixture,
                              gconstpointer test_data);
 
+static void
+game_position_ab_stability_cutoff_solve_test (GamePositionDbFixture *fixture,
+                                              gconstpointer test_data);
+
+static void
+game_position_ab_tt_solve_test (GamePositionDbFixture *fixture,
+                                gconstpointer test_data);
+
+static void
+game_position_ab_pvs_solve_test (GamePositionDbFixture *fixture,
+                                 gconstpointer test_data);
+
+static void
+game_position_ab_mtdf_solve_test (GamePositionDbFixture *fixture,
+                                  gconstpointer test_data);
+
+static void
+game_position_ab_move_ordering_solve_test (GamePositionDbFixture *fixture,
+                                           gconstpointer test_data);
+
+static void
+game_position_ab_all_moves_solve_test (GamePositionDbFixture *fixture,
+                                       gconstpointer test_data);
+
+static void
+game_position_wld_solve_test (GamePositionDbFixture *fixture,
+                              gconstpointer test_data);
+
+static void
+game_position_pab_solve_test (GamePositionDbFixture *fixture,
+                              gconstpointer test_data);
+
+static void
+game_position_pab_tt_solve_test (GamePositionDbFixture *fixture,
+                                 gconstpointer test_data);
+
+static void
+game_position_es_tt_solve_test (GamePositionDbFixture *fixture,
+                                gconstpointer test_data);
+
+static void
+game_position_es_pv_recording_solve_test (GamePositionDbFixture *fixture,
+                                          gconstpointer test_data);
+
+static void
+game_position_search_budget_solve_test (GamePositionDbFixture *fixture,
+                                        gconstpointer test_data);
+
+static void
+solver_context_concurrent_solve_test (GamePositionDbFixture *fixture,
+                                      gconstpointer test_data);
+
+static void
+game_position_rollout_test (GamePositionDbFixture *fixture,
+                            gconstpointer test_data);
+
+static void
+game_position_mcts_solve_test (GamePositionDbFixture *fixture,
+                               gconstpointer test_data);
+
+static void
+game_position_tree_size_estimate_test (GamePositionDbFixture *fixture,
+                                       gconstpointer test_data);
+
 
 
 /* Helper function prototypes. */
@@ -263,11 +347,24 @@ run_test_case_array (GamePositionDb *db,
                      ExactSolution* (*solver)(const GamePosition *const gp,
                                               const gchar *const log_file));
 
+static void
+run_wld_test_case_array (GamePositionDb *db,
+                         const TestCase tca[],
+                         ExactSolution* (*solver)(const GamePosition *const gp,
+                                                  const gchar *const log_file));
+
+static ExactSolution *
+rab_solve_once (const GamePosition *const root,
+                const gchar *const log_file);
+
 static void
 assert_move_is_part_of_array (const Square move,
                               const Square move_array[],
                               const int move_array_length);
 
+static gpointer
+solver_context_thread_run (gpointer data);
+
 
 
 int
@@ -306,6 +403,118 @@ main (int   argc,
              game_position_ab_solve_test,
              gpdb_fixture_teardown);
 
+  g_test_add("/ab_stability_cutoff/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             game_position_ab_stability_cutoff_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/ab_tt/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             game_position_ab_tt_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/ab_pvs/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             game_position_ab_pvs_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/ab_mtdf/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             game_position_ab_mtdf_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/ab_move_ordering/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             game_position_ab_move_ordering_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/ab_all_moves/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             game_position_ab_all_moves_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/wld/ffo_wld",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_wld,
+             gpdb_ffo_fixture_setup,
+             game_position_wld_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/pab/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             game_position_pab_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/pab_tt/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             game_position_pab_tt_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/es_tt/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             game_position_es_tt_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/es_pv_recording/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             game_position_es_pv_recording_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/search_budget/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             game_position_search_budget_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/solver_context/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             solver_context_concurrent_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/rollout/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             game_position_rollout_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/mcts/ffo_05",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_05,
+             gpdb_ffo_fixture_setup,
+             game_position_mcts_solve_test,
+             gpdb_fixture_teardown);
+
+  g_test_add("/tree_size/ffo_01_simplified_4",
+             GamePositionDbFixture,
+             (gconstpointer) ffo_01_simplified_4,
+             gpdb_sample_games_fixture_setup,
+             game_position_tree_size_estimate_test,
+             gpdb_fixture_teardown);
+
   if (g_test_slow ()) {
     g_test_add("/minimax/ffo_05",
                GamePositionDbFixture,
@@ -331,6 +540,49 @@ main (int   argc,
                gpdb_ffo_fixture_setup,
                game_position_ab_solve_test,
                gpdb_fixture_teardown);
+    g_test_add("/ab_stability_cutoff/ffo_01_19",
+               GamePositionDbFixture,
+               (gconstpointer) ffo_01_19,
+               gpdb_ffo_fixture_setup,
+               game_position_ab_stability_cutoff_solve_test,
+               gpdb_fixture_teardown);
+    g_test_add("/ab_tt/ffo_01_19",
+               GamePositionDbFixture,
+               (gconstpointer) ffo_01_19,
+               gpdb_ffo_fixture_setup,
+               game_position_ab_tt_solve_test,
+               gpdb_fixture_teardown);
+    g_test_add("/ab_pvs/ffo_01_19",
+               GamePositionDbFixture,
+               (gconstpointer) ffo_01_19,
+               gpdb_ffo_fixture_setup,
+               game_position_ab_pvs_solve_test,
+               gpdb_fixture_teardown);
+    g_test_add("/ab_mtdf/ffo_01_19",
+               GamePositionDbFixture,
+               (gconstpointer) ffo_01_19,
+               gpdb_ffo_fixture_setup,
+               game_position_ab_mtdf_solve_test,
+               gpdb_fixture_teardown);
+    g_test_add("/ab_move_ordering/ffo_01_19",
+               GamePositionDbFixture,
+               (gconstpointer) ffo_01_19,
+               gpdb_ffo_fixture_setup,
+               game_position_ab_move_ordering_solve_test,
+               gpdb_fixture_teardown);
+    g_test_add("/ab_all_moves/ffo_01_19",
+               GamePositionDbFixture,
+               (gconstpointer) ffo_01_19,
+               gpdb_ffo_fixture_setup,
+               game_position_ab_all_moves_solve_test,
+               gpdb_fixture_teardown);
+    g_test_add("/pab/ffo_01_19",
+               GamePositionDbFixture,
+               (gconstpointer) ffo_01_19,
+               gpdb_ffo_fixture_setup,
+               game_position_pab_tt_solve_test,
+               gpdb_fixture_teardown);
+
     g_test_add("/es/ffo_20_29",
                GamePositionDbFixture,
                (gconstpointer) ffo_20_29,
@@ -414,6 +666,334 @@ game_position_ab_solve_test (GamePositionDbFixture *fixture,
   run_test_case_array(db, tcap, game_position_ab_solve);
 }
 
+static void
+game_position_ab_stability_cutoff_solve_test (GamePositionDbFixture *fixture,
+                                              gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  node_info_stability_cutoff_set_enabled(TRUE);
+  run_test_case_array(db, tcap, game_position_ab_solve);
+  node_info_stability_cutoff_set_enabled(FALSE);
+}
+
+static void
+game_position_ab_tt_solve_test (GamePositionDbFixture *fixture,
+                                gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  TranspositionTable *tt = transposition_table_new(16);
+  transposition_table_set_default(tt);
+  run_test_case_array(db, tcap, game_position_ab_solve);
+  g_assert(tt->stats.cutoff_count > 0);
+  transposition_table_set_default(NULL);
+  transposition_table_free(tt);
+}
+
+static void
+game_position_ab_pvs_solve_test (GamePositionDbFixture *fixture,
+                                 gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  ab_solver_set_search_mode(AB_SOLVER_SEARCH_MODE_PVS);
+  run_test_case_array(db, tcap, game_position_ab_solve);
+  ab_solver_set_search_mode(AB_SOLVER_SEARCH_MODE_ALPHA_BETA);
+}
+
+/*
+ * The first guesses range from one end of the score interval to the other, the private table is used
+ * when the default one is turned off.
+ */
+static void
+game_position_ab_mtdf_solve_test (GamePositionDbFixture *fixture,
+                                  gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  static const int first_guesses[] = { worst_score, 0, best_score };
+  ab_solver_set_search_mode(AB_SOLVER_SEARCH_MODE_MTDF);
+  for (int i = 0; i < sizeof(first_guesses) / sizeof(first_guesses[0]); i++) {
+    ab_solver_set_first_guess(first_guesses[i]);
+    run_test_case_array(db, tcap, game_position_ab_solve);
+  }
+  TranspositionTable *tt = transposition_table_new(16);
+  transposition_table_set_default(tt);
+  ab_solver_set_first_guess(0);
+  run_test_case_array(db, tcap, game_position_ab_solve);
+  g_assert(tt->stats.cutoff_count > 0);
+  transposition_table_set_default(NULL);
+  transposition_table_free(tt);
+  ab_solver_set_search_mode(AB_SOLVER_SEARCH_MODE_ALPHA_BETA);
+}
+
+static void
+game_position_ab_move_ordering_solve_test (GamePositionDbFixture *fixture,
+                                           gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  static const MoveOrdering move_orderings[] = { { 0, 61, 61 }, { 61, 0, 61 }, { 61, 61, 0 }, { 8, 4, 0 } };
+  MoveOrdering saved;
+  node_info_move_ordering_get(&saved);
+  for (int i = 0; i < sizeof(move_orderings) / sizeof(move_orderings[0]); i++) {
+    node_info_move_ordering_set(&move_orderings[i]);
+    run_test_case_array(db, tcap, game_position_ab_solve);
+  }
+  node_info_move_ordering_set(&saved);
+}
+
+/*
+ * Every legal root move is scored, best first, and each move value found in the description
+ * of the database entry is matched.
+ */
+static void
+game_position_ab_all_moves_solve_test (GamePositionDbFixture *fixture,
+                                       gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  static const MoveOrdering move_ordering = { 8, 4, 0 };
+  MoveOrdering saved;
+  node_info_move_ordering_get(&saved);
+  node_info_move_ordering_set(&move_ordering);
+  ab_solver_all_moves_set_enabled(TRUE);
+  run_test_case_array(db, tcap, game_position_ab_solve);
+  for (const TestCase *tc = tcap; tc->gpdb_label; tc++) {
+    const GamePositionDbEntry *const entry = gpdb_lookup(db, tc->gpdb_label);
+    ExactSolution *const solution = game_position_ab_solve(entry->game_position, NULL);
+    const SquareSet moves = game_position_legal_moves(entry->game_position);
+    g_assert_cmpint(bit_works_popcount(moves), ==, solution->root_move_count);
+    for (int i = 0; i < solution->root_move_count; i++) {
+      g_assert(moves & ((SquareSet) 1 << solution->root_moves[i].move));
+      if (i > 0) g_assert(solution->root_moves[i - 1].value >= solution->root_moves[i].value);
+    }
+    gchar *root_moves_to_s = exact_solution_root_moves_to_string(solution);
+    gchar **root_moves = g_strsplit(root_moves_to_s, " ", -1);
+    gchar *desc = g_strstrip(g_strdup(entry->desc));
+    gchar **desc_moves = g_strsplit(desc, " ", -1);
+    for (gchar **dm = desc_moves; *dm; dm++) {
+      gboolean found = FALSE;
+      for (gchar **rm = root_moves; *rm; rm++) {
+        if (g_strcmp0(*dm, *rm) == 0) found = TRUE;
+      }
+      g_assert(found);
+    }
+    g_strfreev(desc_moves);
+    g_free(desc);
+    g_strfreev(root_moves);
+    g_free(root_moves_to_s);
+    exact_solution_free(solution);
+  }
+  ab_solver_all_moves_set_enabled(FALSE);
+  node_info_move_ordering_set(&saved);
+}
+
+static void
+game_position_wld_solve_test (GamePositionDbFixture *fixture,
+                              gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  exact_solution_wld_set_enabled(TRUE);
+  run_wld_test_case_array(db, tcap, game_position_solve);
+  run_wld_test_case_array(db, tcap, game_position_ifes_solve);
+  run_wld_test_case_array(db, tcap, game_position_ab_solve);
+  run_wld_test_case_array(db, tcap, rab_solve_once);
+  run_wld_test_case_array(db, tcap, game_position_pab_solve);
+  ab_solver_set_search_mode(AB_SOLVER_SEARCH_MODE_PVS);
+  run_wld_test_case_array(db, tcap, game_position_ab_solve);
+  ab_solver_set_search_mode(AB_SOLVER_SEARCH_MODE_ALPHA_BETA);
+  exact_solution_wld_set_enabled(FALSE);
+}
+
+/*
+ * The thread count is larger than the processor count on most machines, so that splits
+ * and aborts are exercised everywhere.
+ */
+static void
+game_position_pab_solve_test (GamePositionDbFixture *fixture,
+                              gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  for (int thread_count = 1; thread_count <= 8; thread_count *= 2) {
+    pab_solver_set_thread_count(thread_count);
+    run_test_case_array(db, tcap, game_position_pab_solve);
+  }
+  pab_solver_set_thread_count(0);
+}
+
+static void
+game_position_pab_tt_solve_test (GamePositionDbFixture *fixture,
+                                 gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  LockFreeHashTable *lfht = lock_free_hash_table_new(16);
+  lock_free_hash_table_set_default(lfht);
+  pab_solver_set_thread_count(4);
+  run_test_case_array(db, tcap, game_position_pab_solve);
+  pab_solver_set_thread_count(0);
+  lock_free_hash_table_set_default(NULL);
+  lock_free_hash_table_free(lfht);
+}
+
+static void
+game_position_es_tt_solve_test (GamePositionDbFixture *fixture,
+                                gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  TranspositionTable *tt = transposition_table_new(16);
+  transposition_table_set_default(tt);
+  run_test_case_array(db, tcap, game_position_solve);
+  g_assert(tt->stats.hit_count > 0);
+  g_assert(tt->stats.cutoff_count == 0);
+  transposition_table_set_default(NULL);
+  transposition_table_free(tt);
+}
+
+/*
+ * The triangular array collects the same main line as the full recording, visiting fewer nodes.
+ */
+static void
+game_position_es_pv_recording_solve_test (GamePositionDbFixture *fixture,
+                                          gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  const ExactSolverPVRecording levels[] =
+    { EXACT_SOLVER_PV_RECORDING_NONE, EXACT_SOLVER_PV_RECORDING_TRIANGULAR, EXACT_SOLVER_PV_RECORDING_FULL };
+  for (const TestCase *tc = tcap; tc->gpdb_label; tc++) {
+    const GamePosition *const gp = get_gp_from_db(db, tc->gpdb_label);
+    ExactSolution *solutions[3];
+    for (int i = 0; i < 3; i++) {
+      exact_solver_set_pv_recording(levels[i]);
+      solutions[i] = game_position_solve(gp, NULL);
+      g_assert_cmpint(tc->outcome, ==, solutions[i]->outcome);
+      assert_move_is_part_of_array(solutions[i]->pv[0], tc->best_move, tc->best_move_count);
+    }
+    g_assert(solutions[0]->pv_length == 0);
+    g_assert(solutions[1]->pv_length > 0);
+    g_assert_cmpint(solutions[1]->pv_length, ==, solutions[2]->pv_length);
+    for (int i = 0; i < solutions[1]->pv_length; i++) g_assert(solutions[1]->pv[i] == solutions[2]->pv[i]);
+    g_assert(solutions[0]->node_count == solutions[1]->node_count);
+    g_assert(solutions[1]->node_count < solutions[2]->node_count);
+    for (int i = 0; i < 3; i++) exact_solution_free(solutions[i]);
+  }
+  exact_solver_set_pv_recording(EXACT_SOLVER_PV_RECORDING_TRIANGULAR);
+}
+
+
+/*
+ * Searches stopped by the node limit are marked as incomplete, and their bounds hold the game value,
+ * a budget large enough lets the search complete.
+ */
+static void
+game_position_search_budget_solve_test (GamePositionDbFixture *fixture,
+                                        gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  ExactSolution* (*const solvers[])(const GamePosition *const gp, const gchar *const log_file) =
+    { game_position_solve, game_position_ifes_solve, game_position_minimax_solve,
+      game_position_ab_solve, rab_solve_once, game_position_pab_solve };
+  static const uint64_t node_limits[] = { 1, 500, 5000, 50000, 600000 };
+  /* The first root move searched by rab on ffo-05 is completed well within this count of nodes. */
+  static const uint64_t rab_root_move_node_limit = 600000;
+  const SearchBudget no_budget = { 0, 0.0 };
+  for (const TestCase *tc = tcap; tc->gpdb_label; tc++) {
+    GamePosition *gp = get_gp_from_db(db, tc->gpdb_label);
+    const SquareSet moves = game_position_legal_moves(gp);
+    for (int i = 0; i < sizeof(solvers) / sizeof(solvers[0]); i++) {
+      for (int j = 0; j < sizeof(node_limits) / sizeof(node_limits[0]); j++) {
+        const SearchBudget budget = { node_limits[j], 0.0 };
+        search_budget_set(&budget);
+        ExactSolution *const solution = solvers[i](gp, NULL);
+        if (solution->is_incomplete) {
+          g_assert(solution->lower_bound <= tc->outcome && tc->outcome <= solution->upper_bound);
+          g_assert(solution->outcome == solution->lower_bound);
+          g_assert(moves & ((SquareSet) 1 << solution->pv[0]));
+          if (solvers[i] == rab_solve_once && node_limits[j] >= rab_root_move_node_limit) {
+            g_assert(solution->lower_bound > worst_score);
+          }
+        } else {
+          g_assert(solution->outcome == tc->outcome);
+        }
+        if (node_limits[j] == 1) g_assert(solution->is_incomplete);
+        exact_solution_free(solution);
+      }
+    }
+    const SearchBudget budget = { 0, 3600.0 };
+    search_budget_set(&budget);
+    ExactSolution *const solution = game_position_ab_solve(gp, NULL);
+    g_assert(!solution->is_incomplete);
+    g_assert(solution->outcome == tc->outcome);
+    assert_move_is_part_of_array(solution->pv[0], tc->best_move, tc->best_move_count);
+    exact_solution_free(solution);
+  }
+  search_budget_set(&no_budget);
+}
+
+/*
+ * A search running on its own thread, and its own context.
+ */
+typedef struct {
+  SolverContextFunction  solver;
+  SolverContext         *ctx;
+  const GamePosition    *gp;
+  ExactSolution         *solution;
+} SolverContextRun;
+
+/*
+ * The solvers run at the same time, each one on a distinct context, the wld one
+ * is mixed with the others, and must not change their outcome.
+ */
+static void
+solver_context_concurrent_solve_test (GamePositionDbFixture *fixture,
+                                      gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  const SolverContextFunction solvers[] =
+    { game_position_solve_with_context, game_position_ifes_solve_with_context,
+      game_position_ab_solve_with_context, game_position_ab_solve_with_context,
+      game_position_rab_solve_with_context, game_position_pab_solve_with_context,
+      game_position_random_sampler_with_context };
+  enum { run_count = sizeof(solvers) / sizeof(solvers[0]) };
+  for (const TestCase *tc = tcap; tc->gpdb_label; tc++) {
+    SolverContextRun runs[run_count];
+    GThread *threads[run_count];
+    for (int i = 0; i < run_count; i++) {
+      runs[i].solver = solvers[i];
+      runs[i].ctx = solver_context_new();
+      runs[i].gp = get_gp_from_db(db, tc->gpdb_label);
+      runs[i].solution = NULL;
+    }
+    runs[3].ctx->wld = TRUE;
+    runs[5].ctx->pab_thread_count = 2;
+    runs[6].ctx->repeats = 20;
+    for (int i = 0; i < run_count; i++) threads[i] = g_thread_new("solver", solver_context_thread_run, &runs[i]);
+    for (int i = 0; i < run_count; i++) g_thread_join(threads[i]);
+    for (int i = 0; i < run_count; i++) {
+      ExactSolution *const solution = runs[i].solution;
+      if (runs[i].solver == game_position_random_sampler_with_context) {
+        g_assert(solution->leaf_count == 20);
+      } else if (runs[i].ctx->wld) {
+        g_assert(solution->is_wld);
+        g_assert_cmpint((tc->outcome > 0) - (tc->outcome < 0), ==, solution->outcome);
+      } else {
+        g_assert_cmpint(tc->outcome, ==, solution->outcome);
+        assert_move_is_part_of_array(solution->pv[0], tc->best_move, tc->best_move_count);
+      }
+      exact_solution_free(solution);
+      solver_context_free(runs[i].ctx);
+    }
+  }
+}
+
 
 
 /*
@@ -514,6 +1094,186 @@ run_test_case_array (GamePositionDb *db,
   }
 }
 
+/*
+ * The outcome must have the sign of the expected one. When the position is not lost, any move that
+ * keeps the outcome is a right one, it is verified by an exact solve of the position reached.
+ */
+static void
+run_wld_test_case_array (GamePositionDb *db,
+                         const TestCase tca[],
+                         ExactSolution* (*solver)(const GamePosition *const gp,
+                                                  const gchar *const log_file))
+{
+  for (const TestCase *tc = tca; tc->gpdb_label; tc++) {
+    const GamePosition *const gp = get_gp_from_db(db, tc->gpdb_label);
+    ExactSolution *const solution = (*solver)(gp, FALSE);
+    const int expected = (tc->outcome > 0) - (tc->outcome < 0);
+    g_assert(solution->is_wld);
+    g_assert_cmpint(expected, ==, solution->outcome);
+    g_assert(game_position_is_move_legal(gp, solution->pv[0]));
+    if (expected >= 0) {
+      GamePosition *const next = game_position_make_move(gp, solution->pv[0]);
+      exact_solution_wld_set_enabled(FALSE);
+      ExactSolution *const next_solution = game_position_ifes_solve(next, NULL);
+      exact_solution_wld_set_enabled(TRUE);
+      g_assert(-next_solution->outcome >= 0);
+      if (expected > 0) g_assert(-next_solution->outcome > 0);
+      exact_solution_free(next_solution);
+      game_position_free(next);
+    }
+    exact_solution_free(solution);
+  }
+}
+
+static ExactSolution *
+rab_solve_once (const GamePosition *const root,
+                const gchar *const log_file)
+{
+  return game_position_rab_solve(root, log_file, 1);
+}
+
+/*
+ * The statistics of the root are the sum of the ones of the moves, and a given
+ * seed and count of threads repeat the same games.
+ */
+static void
+game_position_rollout_test (GamePositionDbFixture *fixture,
+                            gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  const uint64_t game_count = 10000;
+  for (const TestCase *tc = tcap; tc->gpdb_label; tc++) {
+    const GamePosition *const gp = get_gp_from_db(db, tc->gpdb_label);
+    RolloutReport *reports[2];
+    for (int i = 0; i < 2; i++) {
+      SolverContext *ctx = solver_context_new();
+      ctx->rng = rng_new(1031);
+      reports[i] = game_position_rollout(ctx, gp, game_count, 3);
+      solver_context_free(ctx);
+    }
+    const RolloutStats *const rs = &reports[0]->root_stats;
+    g_assert(rs->game_count == game_count);
+    g_assert(rs->win_count + rs->draw_count + rs->loss_count == game_count);
+    g_assert(reports[0]->move_count == bit_works_popcount(game_position_legal_moves(gp)));
+    RolloutStats sum = { 0, 0, 0, 0, 0, 0 };
+    for (int j = 0; j < reports[0]->move_count; j++) {
+      const RolloutStats *const ms = &reports[0]->move_stats[j];
+      sum.game_count += ms->game_count;
+      sum.value_sum += ms->value_sum;
+      sum.win_count += ms->win_count;
+      g_assert(ms->game_count > 0);
+      g_assert(rollout_stats_variance(ms) >= 0.0);
+      g_assert(rollout_stats_mean(ms) >= worst_score && rollout_stats_mean(ms) <= best_score);
+    }
+    g_assert(sum.game_count == rs->game_count);
+    g_assert(sum.value_sum == rs->value_sum);
+    g_assert(sum.win_count == rs->win_count);
+    g_assert(memcmp(rs, &reports[1]->root_stats, sizeof(RolloutStats)) == 0);
+    g_assert(memcmp(reports[0]->move_stats, reports[1]->move_stats, sizeof(reports[0]->move_stats)) == 0);
+    for (int i = 0; i < 2; i++) rollout_report_free(reports[i]);
+  }
+}
+
+static void
+game_position_mcts_solve_test (GamePositionDbFixture *fixture,
+                               gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  const uint64_t playout_count = 20000;
+  const MctsSolverParallelism modes[] = { MCTS_SOLVER_PARALLELISM_TREE, MCTS_SOLVER_PARALLELISM_ROOT };
+  for (const TestCase *tc = tcap; tc->gpdb_label; tc++) {
+    const GamePosition *const gp = get_gp_from_db(db, tc->gpdb_label);
+    const SquareSet legal_moves = game_position_legal_moves(gp);
+    for (int i = 0; i < 2; i++) {
+      SolverContext *ctx = solver_context_new();
+      ctx->rng = rng_new(1031);
+      ctx->budget.node_limit = playout_count;
+      MctsTree *tree = mcts_tree_new(gp, modes[i], 3, 1 << 16);
+      mcts_tree_search(tree, ctx);
+      g_assert(tree->playout_count == playout_count);
+
+      uint64_t visit_sum = 0;
+      for (SquareSet s = legal_moves; s; s &= s - 1) {
+        uint64_t visit_count, score;
+        mcts_tree_root_move_stats(tree, bit_works_bitscanLS1B_64(s), &visit_count, &score);
+        g_assert(visit_count > 0);
+        g_assert(score <= 2 * visit_count);
+        visit_sum += visit_count;
+      }
+      g_assert(visit_sum == playout_count);
+
+      const Square best_move = mcts_tree_best_move(tree);
+      g_assert(legal_moves & ((SquareSet) 1 << best_move));
+      ExactSolution *solution = mcts_tree_to_exact_solution(tree);
+      g_assert(solution->is_incomplete);
+      g_assert(solution->pv[0] == best_move);
+      g_assert(solution->node_count == playout_count);
+      exact_solution_free(solution);
+
+      /* The subtree of the best move is kept, and grows on. */
+      uint64_t kept_visit_count, kept_score;
+      mcts_tree_root_move_stats(tree, best_move, &kept_visit_count, &kept_score);
+      g_assert(mcts_tree_advance(tree, best_move));
+      mcts_tree_search(tree, ctx);
+      GamePosition *next = game_position_make_move(gp, best_move);
+      visit_sum = 0;
+      for (SquareSet s = game_position_legal_moves(next); s; s &= s - 1) {
+        uint64_t visit_count, score;
+        mcts_tree_root_move_stats(tree, bit_works_bitscanLS1B_64(s), &visit_count, &score);
+        visit_sum += visit_count;
+      }
+      g_assert(visit_sum > playout_count && visit_sum < playout_count + kept_visit_count);
+      game_position_free(next);
+
+      mcts_tree_free(tree);
+      solver_context_free(ctx);
+    }
+  }
+}
+
+static void
+game_position_tree_size_estimate_test (GamePositionDbFixture *fixture,
+                                       gconstpointer test_data)
+{
+  GamePositionDb *db = fixture->db;
+  TestCase *tcap = (TestCase *) test_data;
+  const uint64_t probe_count = 100000;
+  for (const TestCase *tc = tcap; tc->gpdb_label; tc++) {
+    const GamePosition *const gp = get_gp_from_db(db, tc->gpdb_label);
+    ExactSolution *solution = game_position_minimax_solve(gp, NULL);
+    SolverContext *ctx = solver_context_new();
+    ctx->rng = rng_new(1031);
+    TreeSizeReport *report = game_position_tree_size_estimate(ctx, gp, probe_count);
+    g_assert(report->minimax_nodes.probe_count == probe_count);
+
+    /* The minimax counts fall in three half widths of the confidence interval. */
+    const double nodes = tree_size_stats_mean(&report->minimax_nodes);
+    const double leaves = tree_size_stats_mean(&report->minimax_leaves);
+    g_assert(fabs(nodes - solution->node_count) < 3.0 * tree_size_stats_confidence(&report->minimax_nodes));
+    g_assert(fabs(leaves - solution->leaf_count) < 3.0 * tree_size_stats_confidence(&report->minimax_leaves));
+
+    /* The minimal alpha-beta tree is smaller than the minimax one. */
+    g_assert(tree_size_stats_mean(&report->ab_nodes) >= 1.0);
+    g_assert(tree_size_stats_mean(&report->ab_nodes) < nodes);
+    g_assert(tree_size_stats_mean(&report->ab_leaves) < leaves);
+    g_assert(tree_size_stats_mean(&report->ab_leaves) < tree_size_stats_mean(&report->ab_nodes));
+
+    tree_size_report_free(report);
+    solver_context_free(ctx);
+    exact_solution_free(solution);
+  }
+}
+
+static gpointer
+solver_context_thread_run (gpointer data)
+{
+  SolverContextRun *const run = (SolverContextRun *) data;
+  run->solution = run->solver(run->ctx, run->gp);
+  return NULL;
+}
+
 static void
 assert_move_is_part_of_array (const Square move,
                               const Square move_array[],
@@ -36,6 +36,8 @@
 
 #include <glib.h>
 
+#include "bit_works.h"
+#include "board.h"
 #include "game_tree_utils.h"
 
 
@@ -46,6 +48,15 @@ static void dummy_test (void);
 static void pve_create_test (void);
 static void pve_internals_to_string_test (void);
 static void pve_verify_consistency_test (void);
+static void node_info_order_moves_test (void);
+
+
+
+/* Helper function prototypes. */
+
+static void
+node_info_init_after_moves (GameTreeStack *const stack,
+                            const int move_count);
 
 
 int
@@ -54,10 +65,13 @@ main (int   argc,
 {
   g_test_init (&argc, &argv, NULL);
 
+  board_module_init();
+
   g_test_add_func("/game_tree_utils/dummy", dummy_test);
   g_test_add_func("/game_tree_utils/pve_create_test", pve_create_test);
   g_test_add_func("/game_tree_utils/pve_internals_to_string_test", pve_internals_to_string_test);
   g_test_add_func("/game_tree_utils/pve_verify_consistency_test", pve_verify_consistency_test);
+  g_test_add_func("/game_tree_utils/node_info_order_moves_test", node_info_order_moves_test);
 
   return g_test_run();
 }
@@ -127,3 +141,103 @@ pve_internals_to_string_test (void)
 
   g_assert(TRUE);
 }
+
+static void
+node_info_order_moves_test (void)
+{
+  GameTreeStack *stack = game_tree_stack_new();
+  NodeInfo *const current = &stack->nodes[1];
+  NodeInfo *const next = &stack->nodes[2];
+  node_info_init_after_moves(stack, 16);
+  const GamePositionX *const gpx = &current->gpx;
+  const SquareSet move_set = game_position_x_legal_moves(gpx);
+  const SquareSet empties = game_position_x_empties(gpx);
+  const int empty_count = bit_works_popcount(empties);
+  g_assert(bit_works_popcount(move_set) > 4);
+
+  /* All methods off, the natural order is kept. */
+  const MoveOrdering natural = { 61, 61, 61 };
+  legal_move_list_from_set(move_set, current, next);
+  node_info_order_moves(current, next, &natural, invalid_move);
+  for (int i = 1; i < current->move_count; i++) {
+    g_assert(current->head_of_legal_move_list[i - 1] < current->head_of_legal_move_list[i]);
+  }
+
+  /* The first move goes to the head. */
+  const Square last = current->head_of_legal_move_list[current->move_count - 1];
+  node_info_order_moves(current, next, &natural, last);
+  g_assert(current->head_of_legal_move_list[0] == last);
+
+  /* Fastest first, the opponent mobility never decreases, the moves are the same. */
+  const MoveOrdering fastest_first = { empty_count, 61, 61 };
+  legal_move_list_from_set(move_set, current, next);
+  node_info_order_moves(current, next, &fastest_first, invalid_move);
+  SquareSet sorted_set = empty_square_set;
+  int previous_mobility = 0;
+  for (int i = 0; i < current->move_count; i++) {
+    const Square move = current->head_of_legal_move_list[i];
+    sorted_set |= (SquareSet) 1 << move;
+    GamePositionX next_gpx;
+    game_position_x_make_move(gpx, move, &next_gpx);
+    const int mobility = bit_works_popcount(game_position_x_legal_moves(&next_gpx));
+    g_assert(mobility >= previous_mobility);
+    previous_mobility = mobility;
+  }
+  g_assert(sorted_set == move_set);
+
+  /* Above the threshold fastest first doesn't apply, parity does, moves in odd quadrants go first. */
+  const MoveOrdering parity = { empty_count + 1, empty_count, 61 };
+  static const SquareSet quadrants[] = { 0x000000000F0F0F0F, 0x00000000F0F0F0F0, 0x0F0F0F0F00000000, 0xF0F0F0F000000000 };
+  SquareSet odd = empty_square_set;
+  for (int q = 0; q < 4; q++) if (bit_works_popcount(empties & quadrants[q]) & 1) odd |= quadrants[q];
+  legal_move_list_from_set(move_set, current, next);
+  node_info_order_moves(current, next, &parity, invalid_move);
+  const int odd_count = bit_works_popcount(move_set & odd);
+  g_assert(odd_count > 0 && odd_count < current->move_count);
+  for (int i = 0; i < current->move_count; i++) {
+    const SquareSet m = (SquareSet) 1 << current->head_of_legal_move_list[i];
+    g_assert((i < odd_count) == ((m & odd) != 0));
+  }
+
+  /* The static priority searches the central squares first, and the X squares last. */
+  const MoveOrdering priority = { 61, 61, 0 };
+  legal_move_list_from_set(move_set, current, next);
+  node_info_order_moves(current, next, &priority, invalid_move);
+  static const SquareSet x_squares = 0x0042000000004200;
+  gboolean x_square_found = FALSE;
+  for (int i = 0; i < current->move_count; i++) {
+    const SquareSet m = (SquareSet) 1 << current->head_of_legal_move_list[i];
+    if (m & x_squares) x_square_found = TRUE;
+    else g_assert(!x_square_found);
+  }
+
+  game_tree_stack_free(stack);
+}
+
+
+
+/*
+ * Internal functions.
+ */
+
+/*
+ * Loads into the first node of the stack the game position reached from the initial one
+ * playing `move_count` moves, alternately the legal move having the lowest and the highest square index.
+ */
+static void
+node_info_init_after_moves (GameTreeStack *const stack,
+                            const int move_count)
+{
+  GamePositionX gpx = { 0x0000000810000000, 0x0000001008000000, BLACK_PLAYER };
+  for (int i = 0; i < move_count; i++) {
+    const SquareSet moves = game_position_x_legal_moves(&gpx);
+    g_assert(moves);
+    GamePositionX next;
+    const Square move = (i & 1) ? bit_works_bitscanMS1B_64(moves) : bit_works_bitscanLS1B_64(moves);
+    game_position_x_make_move(&gpx, move, &next);
+    gpx = next;
+  }
+  stack->nodes[1].gpx = gpx;
+  stack->nodes[1].head_of_legal_move_list = &stack->legal_move_stack[0];
+  stack->fill_index = 1;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file
+ *
+ * @brief Last moves solver unit test suite.
+ * @details Collects tests and helper methods for the last moves solver module.
+ *
+ * @par last_moves_solver_test.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <glib.h>
+
+#include "bit_works.h"
+#include "random.h"
+#include "board.h"
+#include "game_tree_utils.h"
+#include "last_moves_solver.h"
+
+
+
+/* Test function prototypes. */
+
+static void last_moves_solver_count_flips_test (void);
+static void last_moves_solver_solve_test (void);
+
+
+
+/* Helper function prototypes. */
+
+static void
+random_game_position (RandomNumberGenerator *const rng,
+                      const int empty_count,
+                      GamePositionX *const gpx);
+
+static int
+negamax (const GamePositionX *const gpx,
+         const gboolean passed);
+
+
+
+int
+main (int   argc,
+      char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  board_module_init();
+
+  g_test_add_func("/last_moves_solver/last_moves_solver_count_flips_test", last_moves_solver_count_flips_test);
+  g_test_add_func("/last_moves_solver/last_moves_solver_solve_test", last_moves_solver_solve_test);
+
+  return g_test_run();
+}
+
+
+
+/*
+ * Test functions.
+ */
+
+static void
+last_moves_solver_count_flips_test (void)
+{
+  RandomNumberGenerator *rng = rng_new(3571);
+  for (int i = 0; i < 2000; i++) {
+    const Square move = rng_random_choice_from_finite_set(rng, 64);
+    const SquareSet move_bit = (SquareSet) 1 << move;
+    SquareSet p = empty_square_set;
+    for (int j = 0; j < 64; j++) {
+      if (rng_random_choice_from_finite_set(rng, 2)) p |= (SquareSet) 1 << j;
+    }
+    p &= ~move_bit;
+    const SquareSet o = ~(p | move_bit);
+    g_assert(last_moves_solver_count_flips(p, move) == bit_works_popcount(square_set_flips(p, o, move)));
+    g_assert(last_moves_solver_count_flips(o, move) == bit_works_popcount(square_set_flips(o, p, move)));
+  }
+  rng_free(rng);
+}
+
+static void
+last_moves_solver_solve_test (void)
+{
+  RandomNumberGenerator *rng = rng_new(8117);
+  for (int empty_count = 0; empty_count <= LAST_MOVES_SOLVER_MAX_EMPTIES; empty_count++) {
+    for (int i = 0; i < 200; i++) {
+      GamePositionX gpx;
+      random_game_position(rng, empty_count, &gpx);
+      const SquareSet p = game_position_x_get_player(&gpx);
+      const SquareSet o = game_position_x_get_opponent(&gpx);
+      const int expected = negamax(&gpx, FALSE);
+      uint64_t node_count = 0;
+      uint64_t leaf_count = 0;
+
+      g_assert(last_moves_solver_solve(p, o, worst_score - 1, best_score + 1, &node_count, &leaf_count) == expected);
+      g_assert(leaf_count > 0);
+      if (empty_count == 0) g_assert(node_count == 0);
+
+      const int alpha = (int) rng_random_choice_from_finite_set(rng, 129) - 65;
+      const int beta = alpha + 1 + (int) rng_random_choice_from_finite_set(rng, 8);
+      const int value = last_moves_solver_solve(p, o, alpha, beta, &node_count, &leaf_count);
+      if (value <= alpha) g_assert(expected <= value);
+      else if (value >= beta) g_assert(expected >= value);
+      else g_assert(expected == value);
+    }
+  }
+  rng_free(rng);
+}
+
+
+
+/*
+ * Internal functions.
+ */
+
+/*
+ * Plays random moves from the initial position, until the count of empty squares is reached.
+ * Games ending earlier are discarded.
+ */
+static void
+random_game_position (RandomNumberGenerator *const rng,
+                      const int empty_count,
+                      GamePositionX *const gpx)
+{
+  const GamePositionX initial = { 0x0000000810000000, 0x0000001008000000, BLACK_PLAYER };
+  for (;;) {
+    *gpx = initial;
+    while (bit_works_popcount(game_position_x_empties(gpx)) > empty_count) {
+      SquareSet moves = game_position_x_legal_moves(gpx);
+      if (!moves) {
+        GamePositionX next;
+        game_position_x_pass(gpx, &next);
+        if (!game_position_x_legal_moves(&next)) break;
+        *gpx = next;
+        moves = game_position_x_legal_moves(gpx);
+      }
+      const Square move = square_set_random_selection(rng, moves);
+      GamePositionX next;
+      game_position_x_make_move(gpx, move, &next);
+      *gpx = next;
+    }
+    if (bit_works_popcount(game_position_x_empties(gpx)) == empty_count) return;
+  }
+}
+
+/*
+ * Computes the game value by a full minimax search.
+ */
+static int
+negamax (const GamePositionX *const gpx,
+         const gboolean passed)
+{
+  const SquareSet moves = game_position_x_legal_moves(gpx);
+  if (!moves) {
+    if (passed) return game_position_x_final_value(gpx);
+    GamePositionX next;
+    game_position_x_pass(gpx, &next);
+    return -negamax(&next, TRUE);
+  }
+  int best_value = out_of_range_defeat_score;
+  for (SquareSet s = moves; s; s &= s - 1) {
+    GamePositionX next;
+    game_position_x_make_move(gpx, bit_works_bitscanLS1B_64(s), &next);
+    const int value = -negamax(&next, FALSE);
+    if (value > best_value) best_value = value;
+  }
+  return best_value;
+}
@@ -0,0 +1,351 @@
+/**
+ * @file
+ *
+ * @brief Lock free hash table unit test suite.
+ * @details Collects tests and helper methods for the lock free hash table module.
+ *
+ * @par lock_free_hash_table_test.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <glib.h>
+
+#include "lock_free_hash_table.h"
+
+
+
+/*
+ * A worker of the multi threaded tests.
+ */
+typedef struct {
+  LockFreeHashTable *lfht;          /* The shared table. */
+  uint64_t           seed;          /* The seed of the worker random sequence. */
+  int                key_count;     /* Keys are drawn from the range [0..key_count). */
+  int                iterations;    /* The count of operations. */
+  int                store_percent; /* The share of stores among the operations. */
+  uint64_t           hit_count;     /* The count of successful probes. */
+  uint64_t           error_count;   /* The count of probes returning data not belonging to the key. */
+} Worker;
+
+
+
+/* Test function prototypes. */
+
+static void dummy_test (void);
+static void lock_free_hash_table_new_test (void);
+static void lock_free_hash_table_store_probe_test (void);
+static void lock_free_hash_table_torn_entry_test (void);
+static void lock_free_hash_table_replacement_test (void);
+static void lock_free_hash_table_stress_test (void);
+static void lock_free_hash_table_perf_test (void);
+
+
+
+/* Helper function prototypes. */
+
+static uint64_t
+key_hash (const uint64_t key);
+
+static uint64_t
+xorshift (uint64_t *const state);
+
+static gpointer
+worker_run (gpointer data);
+
+static void
+run_workers (LockFreeHashTable *const lfht,
+             const int thread_count,
+             const int key_count,
+             const int iterations,
+             const int store_percent,
+             uint64_t *const hit_count,
+             uint64_t *const error_count);
+
+
+
+int
+main (int   argc,
+      char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func("/lock_free_hash_table/dummy", dummy_test);
+  g_test_add_func("/lock_free_hash_table/lock_free_hash_table_new_test", lock_free_hash_table_new_test);
+  g_test_add_func("/lock_free_hash_table/lock_free_hash_table_store_probe_test", lock_free_hash_table_store_probe_test);
+  g_test_add_func("/lock_free_hash_table/lock_free_hash_table_torn_entry_test", lock_free_hash_table_torn_entry_test);
+  g_test_add_func("/lock_free_hash_table/lock_free_hash_table_replacement_test", lock_free_hash_table_replacement_test);
+  g_test_add_func("/lock_free_hash_table/lock_free_hash_table_stress_test", lock_free_hash_table_stress_test);
+
+  if (g_test_perf()) {
+    g_test_add_func("/lock_free_hash_table/lock_free_hash_table_perf_test", lock_free_hash_table_perf_test);
+  }
+
+  return g_test_run();
+}
+
+
+
+/*
+ * Test functions.
+ */
+
+static void
+dummy_test (void)
+{
+  g_assert(TRUE);
+}
+
+static void
+lock_free_hash_table_new_test (void)
+{
+  LockFreeHashTable *lfht = lock_free_hash_table_new(10);
+  g_assert(lfht);
+  g_assert(lfht->bucket_count * LOCK_FREE_HASH_TABLE_BUCKET_SIZE == 1024);
+  g_assert(sizeof(LockFreeHashTableEntry) == 16);
+  g_assert(sizeof(LockFreeHashTableBucket) == 64);
+  g_assert(((uintptr_t) lfht->buckets & 63) == 0);
+
+  /* An empty entry never verifies, not even for the zero hash. */
+  LockFreeHashTableData data;
+  g_assert(!lock_free_hash_table_probe(lfht, 0, 0, &data));
+  g_assert(!lock_free_hash_table_probe(lfht, 0x1234567890ABCDEF, 0, &data));
+
+  lock_free_hash_table_free(lfht);
+  lock_free_hash_table_free(NULL);
+}
+
+static void
+lock_free_hash_table_store_probe_test (void)
+{
+  LockFreeHashTable *lfht = lock_free_hash_table_new(10);
+  LockFreeHashTableData data;
+  const uint64_t hash = 0xFEDCBA9876543210;
+
+  lock_free_hash_table_store(lfht, hash, 12, -10, +10, -4, C4);
+  g_assert(lock_free_hash_table_probe(lfht, hash, 12, &data));
+  g_assert(data.lower == -4 && data.upper == -4 && data.best_move == C4 && data.depth == 12);
+  g_assert(!lock_free_hash_table_probe(lfht, hash, 13, &data));
+
+  /* Bounds computed at the same depth are intersected. */
+  lock_free_hash_table_store(lfht, hash + 1, 8, -20, +2, +2, B2);
+  lock_free_hash_table_store(lfht, hash + 1, 8, +6, +20, +6, G7);
+  g_assert(lock_free_hash_table_probe(lfht, hash + 1, 8, &data));
+  g_assert(data.lower == +2 && data.upper == +6 && data.best_move == G7);
+
+  /* A shallower search does not overwrite the entry. */
+  lock_free_hash_table_store(lfht, hash + 1, 6, -64, +64, -30, H8);
+  g_assert(lock_free_hash_table_probe(lfht, hash + 1, 8, &data));
+  g_assert(data.lower == +2 && data.upper == +6);
+
+  lock_free_hash_table_clear(lfht);
+  g_assert(!lock_free_hash_table_probe(lfht, hash, 0, &data));
+
+  lock_free_hash_table_free(lfht);
+}
+
+static void
+lock_free_hash_table_torn_entry_test (void)
+{
+  LockFreeHashTable *lfht = lock_free_hash_table_new(2);
+  LockFreeHashTableData data;
+  const uint64_t hash_a = 0x0123456789ABCDEF;
+  const uint64_t hash_b = 0x1111111111111111;
+
+  lock_free_hash_table_store(lfht, hash_a, 10, -64, +64, +8, A1);
+  lock_free_hash_table_store(lfht, hash_b, 10, -64, +64, -8, H8);
+
+  /* Simulates two writers interleaving: the key of the first store, the data of the second one. */
+  LockFreeHashTableEntry *const e = &lfht->buckets[0].entries[0];
+  LockFreeHashTableEntry *const f = &lfht->buckets[0].entries[1];
+  g_assert(lock_free_hash_table_probe(lfht, hash_a, 10, &data));
+  e->data = f->data;
+  g_assert(!lock_free_hash_table_probe(lfht, hash_a, 0, &data));
+  g_assert(lock_free_hash_table_probe(lfht, hash_b, 10, &data));
+  g_assert(data.lower == -8 && data.best_move == H8);
+
+  lock_free_hash_table_free(lfht);
+}
+
+static void
+lock_free_hash_table_replacement_test (void)
+{
+  LockFreeHashTable *lfht = lock_free_hash_table_new(2);
+  LockFreeHashTableData data;
+  g_assert(lfht->bucket_count == 1);
+
+  lock_free_hash_table_new_search(lfht);
+  for (int i = 0; i < LOCK_FREE_HASH_TABLE_BUCKET_SIZE; i++) {
+    lock_free_hash_table_store(lfht, 100 + i, 10 + i, -64, +64, 0, A1);
+  }
+  for (int i = 0; i < LOCK_FREE_HASH_TABLE_BUCKET_SIZE; i++) {
+    g_assert(lock_free_hash_table_probe(lfht, 100 + i, 0, &data));
+  }
+
+  /* The shallowest entry of the current search is replaced. */
+  lock_free_hash_table_store(lfht, 200, 20, -64, +64, 0, A1);
+  g_assert(!lock_free_hash_table_probe(lfht, 100, 0, &data));
+  g_assert(lock_free_hash_table_probe(lfht, 101, 0, &data));
+
+  /* Entries of the previous search go first, even if deeper. */
+  lock_free_hash_table_new_search(lfht);
+  lock_free_hash_table_store(lfht, 200, 20, -64, +64, 0, A1);
+  lock_free_hash_table_store(lfht, 300, 5, -64, +64, 0, A1);
+  g_assert(!lock_free_hash_table_probe(lfht, 101, 0, &data));
+  g_assert(lock_free_hash_table_probe(lfht, 102, 0, &data));
+  g_assert(lock_free_hash_table_probe(lfht, 200, 0, &data));
+  g_assert(lock_free_hash_table_probe(lfht, 300, 0, &data));
+
+  lock_free_hash_table_free(lfht);
+}
+
+/*
+ * Many threads hammer a small table with stores and probes of keys that collide on
+ * a few buckets. The data stored for a key is a function of the key, so every
+ * successful probe can be checked.
+ */
+static void
+lock_free_hash_table_stress_test (void)
+{
+  const int thread_count = 8;
+  LockFreeHashTable *lfht = lock_free_hash_table_new(6);
+  uint64_t hit_count, error_count;
+
+  run_workers(lfht, thread_count, 256, 200000, 50, &hit_count, &error_count);
+  g_assert(error_count == 0);
+  g_assert(hit_count > 0);
+
+  lock_free_hash_table_free(lfht);
+}
+
+static void
+lock_free_hash_table_perf_test (void)
+{
+  const int size_log2 = 22;
+  const int key_count = 1 << 22;
+  const int iterations = 10000000;
+  const int thread_count = g_get_num_processors();
+
+  LockFreeHashTable *lfht = lock_free_hash_table_new(size_log2);
+  uint64_t hit_count, error_count;
+  run_workers(lfht, 1, key_count, key_count, 100, &hit_count, &error_count);
+
+  for (int t = 1; t <= thread_count; t = t < thread_count && t * 2 > thread_count ? thread_count : t * 2) {
+    g_test_timer_start();
+    run_workers(lfht, t, key_count, iterations, 0, &hit_count, &error_count);
+    const double elapsed = g_test_timer_elapsed();
+    g_assert(error_count == 0);
+    const double probes_per_second = (double) t * iterations / elapsed;
+    g_test_maximized_result(probes_per_second, "Lock free hash table, threads %d: %.1f Mprobes/s, hit rate %.1f%%",
+                            t, probes_per_second / 1.0e6, 100.0 * hit_count / ((double) t * iterations));
+    if (t == thread_count) break;
+  }
+
+  lock_free_hash_table_free(lfht);
+}
+
+
+
+/*
+ * Internal functions.
+ */
+
+/*
+ * Spreads the keys over the whole 64 bits range (splitmix64 finalizer).
+ */
+static uint64_t
+key_hash (const uint64_t key)
+{
+  uint64_t z = key + 0x9E3779B97F4A7C15;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+  return z ^ (z >> 31);
+}
+
+static uint64_t
+xorshift (uint64_t *const state)
+{
+  uint64_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return *state = x;
+}
+
+static gpointer
+worker_run (gpointer data)
+{
+  Worker *const w = (Worker *) data;
+  uint64_t state = w->seed;
+  for (int i = 0; i < w->iterations; i++) {
+    const uint64_t r = xorshift(&state);
+    const int key = r % w->key_count;
+    const uint64_t hash = key_hash(key);
+    const int value = (int) (hash % 129) - 64;
+    const int depth = 1 + (int) ((hash >> 8) % 60);
+    const Square move = (Square) ((hash >> 16) % 64);
+    if ((int) ((r >> 32) % 100) < w->store_percent) {
+      lock_free_hash_table_store(w->lfht, hash, depth, -65, +65, value, move);
+    } else {
+      LockFreeHashTableData d;
+      if (lock_free_hash_table_probe(w->lfht, hash, depth, &d)) {
+        w->hit_count++;
+        if (d.lower != value || d.upper != value || d.best_move != move || d.depth != depth) w->error_count++;
+      }
+    }
+  }
+  return NULL;
+}
+
+static void
+run_workers (LockFreeHashTable *const lfht,
+             const int thread_count,
+             const int key_count,
+             const int iterations,
+             const int store_percent,
+             uint64_t *const hit_count,
+             uint64_t *const error_count)
+{
+  Worker *workers = (Worker *) malloc(thread_count * sizeof(Worker));
+  GThread **threads = (GThread **) malloc(thread_count * sizeof(GThread *));
+  g_assert(workers && threads);
+  for (int i = 0; i < thread_count; i++) {
+    workers[i] = (Worker) { lfht, key_hash(1000 + i) | 1, key_count, iterations, store_percent, 0, 0 };
+    threads[i] = g_thread_new("lfht", worker_run, &workers[i]);
+  }
+  *hit_count = 0;
+  *error_count = 0;
+  for (int i = 0; i < thread_count; i++) {
+    g_thread_join(threads[i]);
+    *hit_count += workers[i].hit_count;
+    *error_count += workers[i].error_count;
+  }
+  free(threads);
+  free(workers);
+}
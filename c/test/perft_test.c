@@ -0,0 +1,195 @@
+/**
+ * @file
+ *
+ * @brief Perft utils unit test suite.
+ * @details Collects tests and helper methods for the perft utils module.
+ *
+ * @par perft_test.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <glib.h>
+
+#include "board.h"
+#include "perft_utils.h"
+
+
+
+/*
+ * The published leaf counts from the initial position, index is the depth.
+ */
+static const uint64_t initial_position_leaf_counts[] =
+  {
+    1ULL, 4ULL, 12ULL, 56ULL, 244ULL, 1396ULL, 8200ULL, 55092ULL, 390216ULL,
+    3005288ULL, 24571284ULL, 212258800ULL, 1939886636ULL
+  };
+
+static const GamePositionX initial_position = { 0x0000000810000000, 0x0000001008000000, BLACK_PLAYER };
+
+
+
+/* Test function prototypes. */
+
+static void dummy_test (void);
+static void perft_initial_position_test (void);
+static void perft_cache_test (void);
+static void perft_threads_test (void);
+static void perft_initial_position_slow_test (void);
+static void perft_perf_test (void);
+
+
+int
+main (int   argc,
+      char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  board_module_init();
+
+  g_test_add_func("/perft/dummy", dummy_test);
+  g_test_add_func("/perft/perft_initial_position_test", perft_initial_position_test);
+  g_test_add_func("/perft/perft_cache_test", perft_cache_test);
+  g_test_add_func("/perft/perft_threads_test", perft_threads_test);
+
+  if (g_test_slow()) {
+    g_test_add_func("/perft/perft_initial_position_slow_test", perft_initial_position_slow_test);
+  }
+
+  if (g_test_perf()) {
+    g_test_add_func("/perft/perft_perf_test", perft_perf_test);
+  }
+
+  return g_test_run();
+}
+
+
+
+/*
+ * Test functions.
+ */
+
+static void
+dummy_test (void)
+{
+  g_assert(TRUE);
+}
+
+static void
+perft_initial_position_test (void)
+{
+  for (int depth = 0; depth <= 9; depth++) {
+    PerftResult result = { 0, 0, 0, 0, 0 };
+    game_position_x_perft(&initial_position, depth, NULL, 1, &result);
+    g_assert(result.leaf_count == initial_position_leaf_counts[depth]);
+    g_assert(result.cache_hit_count == 0);
+    if (depth < 9) g_assert(result.game_over_count == 0);
+  }
+
+  /* The shortest game lasts nine moves, so nodes are the sum of the leaves of each depth. */
+  PerftResult result = { 0, 0, 0, 0, 0 };
+  game_position_x_perft(&initial_position, 9, NULL, 1, &result);
+  g_assert(result.game_over_count == 0);
+  uint64_t node_count = 0;
+  for (int depth = 0; depth <= 9; depth++) node_count += initial_position_leaf_counts[depth];
+  g_assert(result.node_count == node_count);
+
+  result = (PerftResult) { 0, 0, 0, 0, 0 };
+  game_position_x_perft(&initial_position, 10, NULL, 1, &result);
+  g_assert(result.leaf_count == initial_position_leaf_counts[10]);
+  g_assert(result.game_over_count > 0);
+}
+
+static void
+perft_cache_test (void)
+{
+  for (int size_log2 = 0; size_log2 <= 16; size_log2 += 8) {
+    PerftCache *cache = perft_cache_new(size_log2);
+    for (int depth = 1; depth <= 9; depth++) {
+      PerftResult plain = { 0, 0, 0, 0, 0 };
+      PerftResult cached = { 0, 0, 0, 0, 0 };
+      game_position_x_perft(&initial_position, depth, NULL, 1, &plain);
+      game_position_x_perft(&initial_position, depth, cache, 1, &cached);
+      g_assert(cached.leaf_count == plain.leaf_count);
+      g_assert(cached.pass_count == plain.pass_count);
+      g_assert(cached.game_over_count == plain.game_over_count);
+      g_assert(cached.node_count == plain.node_count);
+      if (depth >= 6 && size_log2 > 0) g_assert(cached.cache_hit_count > 0);
+    }
+    perft_cache_free(cache);
+  }
+}
+
+static void
+perft_threads_test (void)
+{
+  PerftCache *cache = perft_cache_new(16);
+  for (int thread_count = 1; thread_count <= 8; thread_count *= 2) {
+    for (int depth = 0; depth <= 9; depth++) {
+      PerftResult result = { 0, 0, 0, 0, 0 };
+      game_position_x_perft(&initial_position, depth, NULL, thread_count, &result);
+      g_assert(result.leaf_count == initial_position_leaf_counts[depth]);
+      result = (PerftResult) { 0, 0, 0, 0, 0 };
+      game_position_x_perft(&initial_position, depth, cache, thread_count, &result);
+      g_assert(result.leaf_count == initial_position_leaf_counts[depth]);
+    }
+  }
+  perft_cache_free(cache);
+}
+
+static void
+perft_initial_position_slow_test (void)
+{
+  const int thread_count = g_get_num_processors();
+  PerftCache *cache = perft_cache_new(20);
+  for (int depth = 11; depth <= 12; depth++) {
+    PerftResult result = { 0, 0, 0, 0, 0 };
+    game_position_x_perft(&initial_position, depth, cache, thread_count, &result);
+    g_assert(result.leaf_count == initial_position_leaf_counts[depth]);
+  }
+  perft_cache_free(cache);
+}
+
+static void
+perft_perf_test (void)
+{
+  const int depth = 10;
+  const int thread_count = g_get_num_processors();
+
+  for (int t = 1; t <= thread_count; t = t < thread_count && t * 2 > thread_count ? thread_count : t * 2) {
+    PerftResult result = { 0, 0, 0, 0, 0 };
+    g_test_timer_start();
+    game_position_x_perft(&initial_position, depth, NULL, t, &result);
+    const double elapsed = g_test_timer_elapsed();
+    g_assert(result.leaf_count == initial_position_leaf_counts[depth]);
+    g_test_minimized_result(elapsed, "Perft depth %d, threads %d: %" PRIu64 " nodes in %f seconds, %.1f Mnodes/s",
+                            depth, t, result.node_count, elapsed, result.node_count / elapsed / 1.0e6);
+    if (t == thread_count) break;
+  }
+}
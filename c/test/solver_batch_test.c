@@ -0,0 +1,255 @@
+/**
+ * @file
+ *
+ * @brief Solver batch unit test suite.
+ * @details Collects tests and helper methods for the solver batch module.
+ *
+ * @par solver_batch_test.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "board.h"
+#include "game_position_db.h"
+#include "exact_solver.h"
+#include "solver_batch.h"
+
+
+
+/**
+ * @brief GamePositionDb fixture
+ */
+typedef struct {
+  GamePositionDb *db;
+} GamePositionDbFixture;
+
+
+
+/* Test function prototypes. */
+
+static void solver_batch_new_test (GamePositionDbFixture *fixture, gconstpointer test_data);
+static void solver_batch_sort_longest_first_test (GamePositionDbFixture *fixture, gconstpointer test_data);
+static void solver_batch_run_test (GamePositionDbFixture *fixture, gconstpointer test_data);
+static void solver_batch_write_test (GamePositionDbFixture *fixture, gconstpointer test_data);
+
+
+
+/* Helper function prototypes. */
+
+static void
+gpdb_ffo_fixture_setup (GamePositionDbFixture *fixture,
+                        gconstpointer test_data);
+
+static void
+gpdb_fixture_teardown (GamePositionDbFixture *fixture,
+                       gconstpointer test_data);
+
+static const SolverBatchItem *
+solver_batch_get_item (const SolverBatch *const batch,
+                       const gchar *const id);
+
+
+
+int
+main (int   argc,
+      char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  board_module_init();
+
+  g_test_add("/solver_batch/solver_batch_new_test",
+             GamePositionDbFixture, NULL, gpdb_ffo_fixture_setup, solver_batch_new_test, gpdb_fixture_teardown);
+  g_test_add("/solver_batch/solver_batch_sort_longest_first_test",
+             GamePositionDbFixture, NULL, gpdb_ffo_fixture_setup, solver_batch_sort_longest_first_test, gpdb_fixture_teardown);
+  g_test_add("/solver_batch/solver_batch_run_test",
+             GamePositionDbFixture, NULL, gpdb_ffo_fixture_setup, solver_batch_run_test, gpdb_fixture_teardown);
+  g_test_add("/solver_batch/solver_batch_write_test",
+             GamePositionDbFixture, NULL, gpdb_ffo_fixture_setup, solver_batch_write_test, gpdb_fixture_teardown);
+
+  return g_test_run();
+}
+
+
+
+/*
+ * Test functions.
+ */
+
+static void
+solver_batch_new_test (GamePositionDbFixture *fixture,
+                       gconstpointer test_data)
+{
+  SolverBatch *batch = solver_batch_new(fixture->db, NULL);
+  g_assert(batch->item_count == gpdb_length(fixture->db));
+  solver_batch_free(batch);
+
+  batch = solver_batch_new(fixture->db, "ffo-0?");
+  g_assert(batch->item_count == 9);
+  g_assert(g_strcmp0(batch->items[0].entry->id, "ffo-01") == 0);
+  g_assert(g_strcmp0(batch->items[8].entry->id, "ffo-09") == 0);
+  for (int i = 0; i < batch->item_count; i++) {
+    g_assert(!batch->items[i].is_solved);
+    g_assert(batch->items[i].empty_count > 0);
+    g_assert(batch->items[i].mobility > 0);
+  }
+  solver_batch_free(batch);
+
+  batch = solver_batch_new(fixture->db, "no-such-entry");
+  g_assert(batch->item_count == 0);
+  solver_batch_free(batch);
+
+  solver_batch_free(NULL);
+}
+
+static void
+solver_batch_sort_longest_first_test (GamePositionDbFixture *fixture,
+                                      gconstpointer test_data)
+{
+  SolverBatch *batch = solver_batch_new(fixture->db, "ffo-*");
+  solver_batch_sort_longest_first(batch);
+  for (int i = 1; i < batch->item_count; i++) {
+    const SolverBatchItem *const a = &batch->items[i - 1];
+    const SolverBatchItem *const b = &batch->items[i];
+    g_assert(a->empty_count >= b->empty_count);
+    if (a->empty_count == b->empty_count) g_assert(a->mobility >= b->mobility);
+  }
+  solver_batch_free(batch);
+}
+
+static void
+solver_batch_run_test (GamePositionDbFixture *fixture,
+                       gconstpointer test_data)
+{
+  SolverBatch *batch = solver_batch_new(fixture->db, "ffo-0?");
+  solver_batch_sort_longest_first(batch);
+  solver_batch_run(batch, game_position_solve, 3);
+  for (int i = 0; i < batch->item_count; i++) {
+    g_assert(batch->items[i].is_solved);
+    g_assert(batch->items[i].node_count > 0);
+  }
+  const SolverBatchItem *item = solver_batch_get_item(batch, "ffo-01");
+  g_assert(item->outcome == 18 && item->best_move == G8);
+  item = solver_batch_get_item(batch, "ffo-02");
+  g_assert(item->outcome == 10 && item->best_move == A4);
+  item = solver_batch_get_item(batch, "ffo-05");
+  g_assert(item->outcome == 32 && item->best_move == G8);
+  solver_batch_free(batch);
+}
+
+static void
+solver_batch_write_test (GamePositionDbFixture *fixture,
+                         gconstpointer test_data)
+{
+  SolverBatch *batch = solver_batch_new(fixture->db, "ffo-01");
+  g_assert(batch->item_count == 1);
+  solver_batch_run(batch, game_position_solve, 1);
+
+  char buffer[1024];
+  FILE *stream = tmpfile();
+  g_assert(stream);
+  solver_batch_write(batch, SOLVER_BATCH_FORMAT_CSV, stream);
+  rewind(stream);
+  g_assert(fgets(buffer, sizeof(buffer), stream));
+  g_assert(g_strcmp0(buffer, "id,empty_count,outcome,best_move,time,node_count,leaf_count,nodes_per_second\n") == 0);
+  g_assert(fgets(buffer, sizeof(buffer), stream));
+  g_assert(g_str_has_prefix(buffer, "ffo-01,14,18,G8,"));
+  g_assert(!fgets(buffer, sizeof(buffer), stream));
+  fclose(stream);
+
+  stream = tmpfile();
+  g_assert(stream);
+  solver_batch_write(batch, SOLVER_BATCH_FORMAT_JSON, stream);
+  rewind(stream);
+  g_assert(fgets(buffer, sizeof(buffer), stream));
+  g_assert(g_strcmp0(buffer, "[\n") == 0);
+  g_assert(fgets(buffer, sizeof(buffer), stream));
+  g_assert(g_str_has_prefix(buffer, "  {\"id\": \"ffo-01\", \"empty_count\": 14, \"outcome\": 18, \"best_move\": \"G8\", "));
+  g_assert(fgets(buffer, sizeof(buffer), stream));
+  g_assert(g_strcmp0(buffer, "]\n") == 0);
+  fclose(stream);
+
+  /* An item not solved has empty result fields. */
+  batch->items[0].is_solved = FALSE;
+  stream = tmpfile();
+  g_assert(stream);
+  solver_batch_write(batch, SOLVER_BATCH_FORMAT_CSV, stream);
+  rewind(stream);
+  g_assert(fgets(buffer, sizeof(buffer), stream));
+  g_assert(fgets(buffer, sizeof(buffer), stream));
+  g_assert(g_strcmp0(buffer, "ffo-01,14,,,,,,\n") == 0);
+  fclose(stream);
+
+  solver_batch_free(batch);
+}
+
+
+
+/*
+ * Internal functions.
+ */
+
+static void
+gpdb_ffo_fixture_setup (GamePositionDbFixture *fixture,
+                        gconstpointer test_data)
+{
+  gchar *source = g_strdup("db/gpdb-ffo.txt");
+  FILE *fp = fopen(source, "r");
+  g_assert(fp);
+  GamePositionDb *db = gpdb_new(g_strdup(source));
+  GamePositionDbSyntaxErrorLog *syntax_error_log = NULL;
+  GError *error = NULL;
+  gpdb_load(fp, source, db, &syntax_error_log, &error);
+  fclose(fp);
+  g_free(source);
+  g_free(error);
+  if (syntax_error_log) gpdb_syntax_error_log_free(syntax_error_log);
+  fixture->db = db;
+}
+
+static void
+gpdb_fixture_teardown (GamePositionDbFixture *fixture,
+                       gconstpointer test_data)
+{
+  g_assert(fixture->db != NULL);
+  gpdb_free(fixture->db, TRUE);
+}
+
+static const SolverBatchItem *
+solver_batch_get_item (const SolverBatch *const batch,
+                       const gchar *const id)
+{
+  for (int i = 0; i < batch->item_count; i++) {
+    if (g_strcmp0(batch->items[i].entry->id, id) == 0) return &batch->items[i];
+  }
+  g_assert(FALSE);
+  return NULL;
+}
@@ -0,0 +1,225 @@
+/**
+ * @file
+ *
+ * @brief Transposition table unit test suite.
+ * @details Collects tests and helper methods for the transposition table module.
+ *
+ * @par transposition_table_test.c
+ * <tt>
+ * This file is part of the reversi program
+ * http://github.com/rcrr/reversi
+ * </tt>
+ * @author Roberto Corradini mailto:rob_corradini@yahoo.it
+ * @copyright 2014 Roberto Corradini. All rights reserved.
+ *
+ * @par License
+ * <tt>
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 3, or (at your option) any
+ * later version.
+ * \n
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * \n
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ * or visit the site <http://www.gnu.org/licenses/>.
+ * </tt>
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <glib.h>
+
+#include "transposition_table.h"
+
+
+
+/* Test function prototypes. */
+
+static void dummy_test (void);
+static void transposition_table_new_test (void);
+static void transposition_table_store_probe_test (void);
+static void transposition_table_cutoff_test (void);
+static void transposition_table_bounds_merge_test (void);
+static void transposition_table_replacement_test (void);
+static void transposition_table_set_default_test (void);
+
+
+int
+main (int   argc,
+      char *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+  g_test_add_func("/transposition_table/dummy", dummy_test);
+  g_test_add_func("/transposition_table/transposition_table_new_test", transposition_table_new_test);
+  g_test_add_func("/transposition_table/transposition_table_store_probe_test", transposition_table_store_probe_test);
+  g_test_add_func("/transposition_table/transposition_table_cutoff_test", transposition_table_cutoff_test);
+  g_test_add_func("/transposition_table/transposition_table_bounds_merge_test", transposition_table_bounds_merge_test);
+  g_test_add_func("/transposition_table/transposition_table_replacement_test", transposition_table_replacement_test);
+  g_test_add_func("/transposition_table/transposition_table_set_default_test", transposition_table_set_default_test);
+
+  return g_test_run();
+}
+
+
+
+/*
+ * Test functions.
+ */
+
+static void
+dummy_test (void)
+{
+  g_assert(TRUE);
+}
+
+static void
+transposition_table_new_test (void)
+{
+  TranspositionTable *tt = transposition_table_new(10);
+  g_assert(tt);
+  g_assert(tt->bucket_count * TRANSPOSITION_TABLE_BUCKET_SIZE == 1024);
+  g_assert(sizeof(TranspositionTableBucket) == 64);
+  g_assert(tt->stats.probe_count == 0);
+
+  TranspositionTableEntry entry;
+  g_assert(!transposition_table_probe(tt, 0x1234567890ABCDEF, 0, &entry));
+  g_assert(tt->stats.probe_count == 1);
+  g_assert(tt->stats.hit_count == 0);
+
+  transposition_table_free(tt);
+  transposition_table_free(NULL);
+}
+
+static void
+transposition_table_store_probe_test (void)
+{
+  TranspositionTable *tt = transposition_table_new(10);
+  TranspositionTableEntry entry;
+  const uint64_t hash = 0xFEDCBA9876543210;
+
+  /* Exact value. */
+  transposition_table_store(tt, hash, 12, -10, +10, +4, C4);
+  g_assert(transposition_table_probe(tt, hash, 12, &entry));
+  g_assert(entry.lower == +4 && entry.upper == +4 && entry.best_move == C4 && entry.depth == 12);
+
+  /* A deeper search is not satisfied by the entry. */
+  g_assert(!transposition_table_probe(tt, hash, 13, &entry));
+  g_assert(transposition_table_probe(tt, hash, 11, &entry));
+
+  /* Fail high gives a lower bound, fail low an upper bound. */
+  transposition_table_store(tt, hash + 1, 12, -10, +10, +12, D3);
+  g_assert(transposition_table_probe(tt, hash + 1, 12, &entry));
+  g_assert(entry.lower == +12 && entry.upper == 64);
+  transposition_table_store(tt, hash + 2, 12, -10, +10, -10, E6);
+  g_assert(transposition_table_probe(tt, hash + 2, 12, &entry));
+  g_assert(entry.lower == -64 && entry.upper == -10);
+
+  g_assert(tt->stats.store_count == 3);
+  g_assert(tt->stats.hit_count == 4);
+
+  /* Clear removes entries and keeps statistics. */
+  transposition_table_clear(tt);
+  g_assert(!transposition_table_probe(tt, hash, 12, &entry));
+  g_assert(tt->stats.store_count == 3);
+
+  transposition_table_free(tt);
+}
+
+static void
+transposition_table_cutoff_test (void)
+{
+  TranspositionTable *tt = transposition_table_new(4);
+  int value = 0;
+
+  TranspositionTableEntry exact = { 1, +6, +6, A1, 10, 0 };
+  g_assert(transposition_table_cutoff(tt, &exact, -64, +64, &value) && value == +6);
+
+  TranspositionTableEntry lower = { 1, +6, +64, A1, 10, 0 };
+  g_assert(transposition_table_cutoff(tt, &lower, -2, +6, &value) && value == +6);
+  g_assert(!transposition_table_cutoff(tt, &lower, -2, +8, &value));
+
+  TranspositionTableEntry upper = { 1, -64, -4, A1, 10, 0 };
+  g_assert(transposition_table_cutoff(tt, &upper, -4, +2, &value) && value == -4);
+  g_assert(!transposition_table_cutoff(tt, &upper, -6, +2, &value));
+
+  g_assert(tt->stats.cutoff_count == 3);
+
+  transposition_table_free(tt);
+}
+
+static void
+transposition_table_bounds_merge_test (void)
+{
+  TranspositionTable *tt = transposition_table_new(4);
+  TranspositionTableEntry entry;
+  const uint64_t hash = 0x0123456789ABCDEF;
+
+  /* A lower and an upper bound at the same depth are intersected. */
+  transposition_table_store(tt, hash, 8, -20, +2, +2, B2);
+  transposition_table_store(tt, hash, 8, +6, +20, +6, G7);
+  g_assert(transposition_table_probe(tt, hash, 8, &entry));
+  g_assert(entry.lower == +2 && entry.upper == +6 && entry.best_move == G7);
+
+  /* A shallower search does not overwrite the entry, a deeper one does. */
+  transposition_table_store(tt, hash, 6, -64, +64, -30, H8);
+  g_assert(transposition_table_probe(tt, hash, 8, &entry));
+  g_assert(entry.lower == +2 && entry.upper == +6);
+  transposition_table_store(tt, hash, 9, -64, +64, +4, A8);
+  g_assert(transposition_table_probe(tt, hash, 9, &entry));
+  g_assert(entry.lower == +4 && entry.upper == +4 && entry.best_move == A8);
+
+  transposition_table_free(tt);
+}
+
+static void
+transposition_table_replacement_test (void)
+{
+  /* A table of four entries is made by a single bucket. */
+  TranspositionTable *tt = transposition_table_new(2);
+  TranspositionTableEntry entry;
+  g_assert(tt->bucket_count == 1);
+
+  transposition_table_new_search(tt);
+  for (int i = 0; i < TRANSPOSITION_TABLE_BUCKET_SIZE; i++) {
+    transposition_table_store(tt, 100 + i, 10 + i, -64, +64, 0, A1);
+  }
+  g_assert(tt->stats.replacement_count == 0);
+
+  /* The shallowest entry of the current search is replaced. */
+  transposition_table_store(tt, 200, 20, -64, +64, 0, A1);
+  g_assert(tt->stats.replacement_count == 1);
+  g_assert(!transposition_table_probe(tt, 100, 0, &entry));
+  g_assert(transposition_table_probe(tt, 101, 0, &entry));
+  g_assert(transposition_table_probe(tt, 200, 0, &entry));
+
+  /* Entries of the previous search go first, even if deeper. */
+  transposition_table_new_search(tt);
+  transposition_table_store(tt, 200, 20, -64, +64, 0, A1);
+  transposition_table_store(tt, 300, 5, -64, +64, 0, A1);
+  g_assert(transposition_table_probe(tt, 200, 0, &entry));
+  g_assert(!transposition_table_probe(tt, 101, 0, &entry));
+  g_assert(transposition_table_probe(tt, 102, 0, &entry));
+  g_assert(transposition_table_probe(tt, 300, 0, &entry));
+
+  transposition_table_free(tt);
+}
+
+static void
+transposition_table_set_default_test (void)
+{
+  g_assert(transposition_table_get_default() == NULL);
+  TranspositionTable *tt = transposition_table_new(4);
+  transposition_table_set_default(tt);
+  g_assert(transposition_table_get_default() == tt);
+  transposition_table_set_default(NULL);
+  g_assert(transposition_table_get_default() == NULL);
+  transposition_table_free(tt);
+}